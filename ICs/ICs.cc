@@ -29,6 +29,9 @@ ICsData cosmo_get_ICsData(
 
   icd.viol_amp = cosmo_ICs_db->getDouble("IC_viol_amp");
 
+  // generate random fields with a slab-decomposed FFT
+  icd.distributed_fft = cosmo_ICs_db->getBoolWithDefault("distributed_fft", false);
+
   return icd;
 }
 
@@ -64,6 +67,12 @@ void set_gaussian_random_field(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
   idx_t ln, idx_t f_id, ICsData *icd)
 {
+  if(icd->distributed_fft)
+  {
+    set_gaussian_random_field_distributed(hierarchy, ln, f_id, icd);
+    return;
+  }
+
   idx_t i, j, k;
   real_t px, py, pz, pmag;
   real_t scale;
@@ -234,5 +243,336 @@ void set_gaussian_random_field(
   return;
 }
 
+/**
+ * @brief First index of a block decomposition of n items over n_procs ranks
+ * @return first index owned by rank r (n for r = n_procs)
+ */
+static inline idx_t grf_slab_start(idx_t n, int n_procs, int r)
+{
+  return (idx_t)((long long)n * r / n_procs);
+}
+
+/**
+ * @brief Rank owning index i in the block decomposition of grf_slab_start
+ */
+static inline int grf_slab_owner(idx_t n, int n_procs, idx_t i)
+{
+  int r = (int)((long long)i * n_procs / n);
+  while(r > 0 && grf_slab_start(n, n_procs, r) > i) r--;
+  while(r < n_procs - 1 && grf_slab_start(n, n_procs, r + 1) <= i) r++;
+  return r;
+}
+
+/**
+ * @brief Distributed version of set_gaussian_random_field
+ * @details No rank holds the full NX*NY*NZ grid. The half-complex spectrum
+ *  is split in slabs of kx; every rank draws its own modes, transforms them
+ *  along y, and a single all-to-all transposes the data into slabs of y,
+ *  where the x transform and the final c2r transform along z are done.
+ *  Patch ghost boxes (with periodic wrapping) are then gathered from the
+ *  ranks owning the corresponding y slabs.
+ *
+ *  Modes are drawn from a generator seeded by their (px, py) line rather
+ *  than from one sequential stream, so the realization does not depend on
+ *  the number of ranks and there is no limit on the grid size, but it
+ *  differs from the one set_gaussian_random_field produces otherwise.
+ */
+void set_gaussian_random_field_distributed(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, idx_t f_id, ICsData *icd)
+{
+  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
+    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
+      hierarchy->getGridGeometry()));
+  TBOX_ASSERT(grid_geometry_);
+  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
+
+  const double * domain_lower = &grid_geometry.getXLower()[0];
+  const double * domain_upper = &grid_geometry.getXUpper()[0];
+
+  real_t L[3];
+
+  for(int i = 0 ; i < 3; i++)
+    L[i] = domain_upper[i] - domain_lower[i];
+
+  const double * dx = &grid_geometry.getDx()[0];
+
+  idx_t NX = round(L[0] / dx[0]);
+  idx_t NY = round(L[1] / dx[1]);
+  idx_t NZ = round(L[2] / dx[2]);
+  idx_t NZC = NZ/2 + 1;
+
+  std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+  const int n_procs = mpi.getSize(), my_rank = mpi.getRank();
+
+  // spectrum is split in slabs of kx, real space field in slabs of y
+  const idx_t x_lo = grf_slab_start(NX, n_procs, my_rank);
+  const idx_t x_n = grf_slab_start(NX, n_procs, my_rank + 1) - x_lo;
+  const idx_t y_lo = grf_slab_start(NY, n_procs, my_rank);
+  const idx_t y_n = grf_slab_start(NY, n_procs, my_rank + 1) - y_lo;
+
+  fftw_complex *k_slab = (fftw_complex *) fftw_malloc(
+    std::max(x_n*NY*NZC, 1) * ((long long) sizeof(fftw_complex)));
+  fftw_complex *t_slab = (fftw_complex *) fftw_malloc(
+    std::max(NX*y_n*NZC, 1) * ((long long) sizeof(fftw_complex)));
+  double *r_slab = new double[std::max(NX*y_n*NZ, 1)];
+
+  // plans for taking FFTs, made before filling the arrays since
+  // FFTW_MEASURE overwrites them
+  fftw_plan p_y = NULL, p_x = NULL, p_c2r = NULL;
+  if(x_n > 0)
+  {
+    fftw_iodim y_dim = {NY, NZC, NZC};
+    fftw_iodim loop_dims[2] = {{x_n, NY*NZC, NY*NZC}, {NZC, 1, 1}};
+    p_y = fftw_plan_guru_dft(1, &y_dim, 2, loop_dims, k_slab, k_slab,
+                             FFTW_BACKWARD, FFTW_MEASURE);
+  }
+  if(y_n > 0)
+  {
+    int n_x = NX, n_z = NZ;
+    p_x = fftw_plan_many_dft(1, &n_x, y_n*NZC,
+                             t_slab, NULL, y_n*NZC, 1,
+                             t_slab, NULL, y_n*NZC, 1,
+                             FFTW_BACKWARD, FFTW_MEASURE);
+    p_c2r = fftw_plan_many_dft_c2r(1, &n_z, NX*y_n,
+                                   t_slab, NULL, 1, NZC,
+                                   r_slab, NULL, 1, NZ,
+                                   FFTW_MEASURE);
+  }
+
+  // scale amplitudes in fourier space; every (px, py) line has its own
+  // generator so lines can be drawn independently on any rank / thread
+#pragma omp parallel for collapse(2)
+  for(idx_t i = 0; i < x_n; i++)
+  {
+    for(idx_t j = 0; j < NY; j++)
+    {
+      idx_t px = (x_lo + i <= NX/2 ? x_lo + i : x_lo + i - NX);
+      idx_t py = (j <= NY/2 ? j : j - NY);
+
+      std::seed_seq seeds{9, px, py};
+      std::mt19937 gen(seeds);
+      std::normal_distribution<real_t> gaussian_distribution;
+      std::uniform_real_distribution<double> angular_distribution(0.0, 2.0*PI);
+
+      for(idx_t k = 0; k < NZC; k++)
+      {
+        real_t rand_mag = gaussian_distribution(gen);
+        real_t rand_phase = angular_distribution(gen);
+
+        real_t pmag = sqrt(
+          pw2((real_t) px)
+          + pw2((real_t) py * ( (real_t) NX / (real_t) NY ))
+          + pw2((real_t) k * ( (real_t) NX / (real_t) NZ ))
+        );
+
+        // Scale by power spectrum
+        // don't want much power on scales smaller than ~3 pixels
+        real_t cutoff = 1.0 / (
+          1.0 + exp(10.0*(pmag - icd->ic_spec_cut))
+        );
+        real_t scale = cutoff*sqrt(cosmo_power_spectrum(pmag, icd));
+
+        idx_t idx = (i*NY + j)*NZC + k;
+        k_slab[idx][0] = scale*rand_mag*cos(rand_phase);
+        k_slab[idx][1] = scale*rand_mag*sin(rand_phase);
+      }
+    }
+  }
+
+  // zero-mode (mean density)... set this to something later
+  if(x_lo == 0 && x_n > 0)
+  {
+    k_slab[0][0] = 0;
+    k_slab[0][1] = 0;
+  }
+
+  if(p_y != NULL)
+    fftw_execute(p_y);
+
+  // transpose kx slabs into y slabs; data is exchanged in units of z lines
+  MPI_Datatype z_line_t;
+  MPI_Type_contiguous(2*NZC, MPI_DOUBLE, &z_line_t);
+  MPI_Type_commit(&z_line_t);
+
+  std::vector<int> send_counts(n_procs), send_displs(n_procs);
+  std::vector<int> recv_counts(n_procs), recv_displs(n_procs);
+  for(int r = 0; r < n_procs; r++)
+  {
+    idx_t r_y_lo = grf_slab_start(NY, n_procs, r);
+    idx_t r_x_lo = grf_slab_start(NX, n_procs, r);
+    send_displs[r] = x_n * r_y_lo;
+    send_counts[r] = x_n * (grf_slab_start(NY, n_procs, r + 1) - r_y_lo);
+    recv_displs[r] = r_x_lo * y_n;
+    recv_counts[r] = (grf_slab_start(NX, n_procs, r + 1) - r_x_lo) * y_n;
+  }
+
+  fftw_complex *send_buf = (fftw_complex *) fftw_malloc(
+    std::max(x_n*NY*NZC, 1) * ((long long) sizeof(fftw_complex)));
+
+  // lines bound to rank r are the y range of r in every local kx plane
+#pragma omp parallel for
+  for(int r = 0; r < n_procs; r++)
+  {
+    idx_t r_y_lo = grf_slab_start(NY, n_procs, r);
+    idx_t r_y_n = grf_slab_start(NY, n_procs, r + 1) - r_y_lo;
+    for(idx_t i = 0; i < x_n; i++)
+      memcpy(send_buf[(send_displs[r] + i * r_y_n) * NZC],
+             k_slab[(i*NY + r_y_lo)*NZC],
+             r_y_n * NZC * sizeof(fftw_complex));
+  }
+
+  MPI_Alltoallv(send_buf, &send_counts[0], &send_displs[0], z_line_t,
+                t_slab, &recv_counts[0], &recv_displs[0], z_line_t,
+                mpi.getCommunicator());
+
+  MPI_Type_free(&z_line_t);
+  fftw_free(send_buf);
+  fftw_free(k_slab);
+
+  // FFT back; r_slab now holds the y slab of a gaussian random field
+  // with power spectrum given by cosmo_power_spectrum.
+  if(p_x != NULL)
+  {
+    fftw_execute(p_x);
+    fftw_execute(p_c2r);
+  }
+  fftw_free(t_slab);
+
+  // request (y, x range, z range) rows of every local ghost box from the
+  // ranks owning them; both sides walk the requests in the same order
+  std::vector<std::vector<int> > requests(n_procs);
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+
+    const hier::Box& box = patch->getPatchData(f_id)->getGhostBox();
+    const int * lower = &box.lower()[0];
+    const int * upper = &box.upper()[0];
+
+    for(int j = lower[1]; j <= upper[1]; j++)
+    {
+      idx_t jj = ((j % NY) + NY) % NY;
+      std::vector<int> & req = requests[grf_slab_owner(NY, n_procs, jj)];
+      req.push_back(jj);
+      req.push_back(lower[0]);
+      req.push_back(upper[0]);
+      req.push_back(lower[2]);
+      req.push_back(upper[2]);
+    }
+  }
+
+  std::vector<int> req_buf, req_send_counts(n_procs), req_send_displs(n_procs);
+  std::vector<int> req_recv_counts(n_procs), req_recv_displs(n_procs, 0);
+  for(int r = 0; r < n_procs; r++)
+  {
+    req_send_displs[r] = req_buf.size();
+    req_send_counts[r] = requests[r].size();
+    req_buf.insert(req_buf.end(), requests[r].begin(), requests[r].end());
+  }
+
+  MPI_Alltoall(&req_send_counts[0], 1, MPI_INT,
+               &req_recv_counts[0], 1, MPI_INT, mpi.getCommunicator());
+
+  for(int r = 1; r < n_procs; r++)
+    req_recv_displs[r] = req_recv_displs[r - 1] + req_recv_counts[r - 1];
+
+  std::vector<int> recv_req(
+    req_recv_displs[n_procs - 1] + req_recv_counts[n_procs - 1]);
+
+  MPI_Alltoallv(req_buf.data(), &req_send_counts[0], &req_send_displs[0], MPI_INT,
+                recv_req.data(), &req_recv_counts[0], &req_recv_displs[0], MPI_INT,
+                mpi.getCommunicator());
+
+  // answer requests of every rank, x running fastest
+  std::vector<double> val_buf;
+  std::vector<int> val_send_counts(n_procs), val_send_displs(n_procs);
+  for(int r = 0; r < n_procs; r++)
+  {
+    val_send_displs[r] = val_buf.size();
+    for(int n = req_recv_displs[r]; n < req_recv_displs[r] + req_recv_counts[r]; n += 5)
+    {
+      idx_t jl = recv_req[n] - y_lo;
+      for(int k = recv_req[n + 3]; k <= recv_req[n + 4]; k++)
+      {
+        idx_t kk = ((k % NZ) + NZ) % NZ;
+        for(int i = recv_req[n + 1]; i <= recv_req[n + 2]; i++)
+        {
+          idx_t ii = ((i % NX) + NX) % NX;
+          val_buf.push_back(r_slab[(ii*y_n + jl)*NZ + kk]);
+        }
+      }
+    }
+    val_send_counts[r] = val_buf.size() - val_send_displs[r];
+  }
+
+  delete [] r_slab;
+
+  std::vector<int> val_recv_counts(n_procs, 0), val_recv_displs(n_procs, 0);
+  for(int r = 0; r < n_procs; r++)
+    for(idx_t n = 0; n < (idx_t)requests[r].size(); n += 5)
+      val_recv_counts[r] += (requests[r][n + 2] - requests[r][n + 1] + 1)
+        * (requests[r][n + 4] - requests[r][n + 3] + 1);
+
+  for(int r = 1; r < n_procs; r++)
+    val_recv_displs[r] = val_recv_displs[r - 1] + val_recv_counts[r - 1];
+
+  std::vector<double> vals(
+    val_recv_displs[n_procs - 1] + val_recv_counts[n_procs - 1]);
+
+  MPI_Alltoallv(val_buf.data(), &val_send_counts[0], &val_send_displs[0], MPI_DOUBLE,
+                vals.data(), &val_recv_counts[0], &val_recv_displs[0], MPI_DOUBLE,
+                mpi.getCommunicator());
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+
+    std::shared_ptr<pdat::CellData<double> > f_pdata(
+      SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+        patch->getPatchData(f_id)));
+
+    const hier::Box& box = f_pdata->getGhostBox();
+
+    MDA_Access<double, 3, MDA_OrderColMajor<3>> field =
+      pdat::ArrayDataAccess::access<3,double>(
+        f_pdata->getArrayData());
+
+    const int * lower = &box.lower()[0];
+    const int * upper = &box.upper()[0];
+
+    for(int j = lower[1]; j <= upper[1]; j++)
+    {
+      idx_t jj = ((j % NY) + NY) % NY;
+      int & pos = val_recv_displs[grf_slab_owner(NY, n_procs, jj)];
+      for(int k = lower[2]; k <= upper[2]; k++)
+      {
+        for(int i = lower[0]; i <= upper[0]; i++)
+        {
+          field(i, j, k) = vals[pos++];
+          if(tbox::MathUtilities< double >::isNaN(field(i, j, k)))
+          {
+            TBOX_ERROR("Error: NaN field at "<<i<<" "<<j<<" "<<k<<"\n");
+          }
+        }
+      }
+    }
+  }
+
+  if(p_y != NULL)
+    fftw_destroy_plan(p_y);
+  if(p_x != NULL)
+  {
+    fftw_destroy_plan(p_x);
+    fftw_destroy_plan(p_c2r);
+  }
+  return;
+}
+
 
 } // namespace cosmo
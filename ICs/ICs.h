@@ -21,6 +21,9 @@ real_t cosmo_power_spectrum(real_t k, ICsData *icd);
 void set_gaussian_random_field(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
   idx_t ln, idx_t f_id, ICsData *icd);
+void set_gaussian_random_field_distributed(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, idx_t f_id, ICsData *icd);
  
 
 } // namespace cosmo
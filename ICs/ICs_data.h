@@ -18,6 +18,9 @@ typedef struct {
   // constraint violating term amplitude
   real_t viol_amp;
 
+  // decompose the random field FFT over ranks
+  bool distributed_fft;
+
 } ICsData;
 
 } /* namespace cosmo */
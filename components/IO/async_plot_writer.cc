@@ -0,0 +1,188 @@
+#include "../../cosmo_includes.h"
+#include "async_plot_writer.h"
+#include "SAMRAI/tbox/HDFDatabase.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+AsyncPlotWriter::AsyncPlotWriter(
+  const std::string & basename_in):
+  basename(basename_in),
+  staged_step(0),
+  staged_time(0)
+{
+}
+
+AsyncPlotWriter::~AsyncPlotWriter()
+{
+  wait();
+}
+
+/**
+ * @brief wait until the previously staged dump is on disk, errors of the
+ *        background thread are raised here
+ */
+void AsyncPlotWriter::wait()
+{
+  if(writer.joinable())
+    writer.join();
+
+  if(!write_error.empty())
+  {
+    std::string error;
+    error.swap(write_error);
+    TBOX_ERROR(error);
+  }
+}
+
+/**
+ * @brief copy fields to the staging buffer and start writing them in the
+ *        background, has to be called by all ranks
+ *
+ * @param hierarchy
+ * @param names names of the fields in the file
+ * @param idx patch data indices of the fields
+ * @param step_num
+ * @param time
+ */
+void AsyncPlotWriter::stage(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  const std::vector<std::string> & names,
+  const std::vector<idx_t> & idx,
+  idx_t step_num,
+  real_t time)
+{
+  TBOX_ASSERT(names.size() == idx.size());
+
+  if(names.empty()) return;
+
+  // single staging buffer, the previous dump has to be finished
+  wait();
+
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  std::string dump_dirname = basename;
+  dump_dirname += ".async/dump." + tbox::Utilities::intToString(step_num, 5);
+
+  tbox::Utilities::recursiveMkdir(dump_dirname);
+
+  staged_filename = dump_dirname + "/proc."
+    + tbox::Utilities::intToString(mpi.getRank(), 5) + ".hdf";
+  staged_names = names;
+  staged_step = step_num;
+  staged_time = time;
+  staged_patches.clear();
+
+  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln++)
+  {
+    std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+
+      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+          patch->getPatchGeometry()));
+
+      const hier::Box& box = patch->getBox();
+
+      staged_patches.push_back(staged_patch_t());
+      staged_patch_t & sp = staged_patches.back();
+
+      sp.level = ln;
+      for(int d = 0; d < 3; d++)
+      {
+        sp.lower[d] = box.lower()[d];
+        sp.upper[d] = box.upper()[d];
+        sp.x_lo[d] = patch_geom->getXLower()[d];
+        sp.dx[d] = patch_geom->getDx()[d];
+      }
+
+      const idx_t nx = sp.upper[0] - sp.lower[0] + 1;
+      const idx_t ny = sp.upper[1] - sp.lower[1] + 1;
+      const idx_t nz = sp.upper[2] - sp.lower[2] + 1;
+      const idx_t n_cells = nx * ny * nz;
+
+      sp.data.resize(n_cells * idx.size());
+
+      for(idx_t f = 0; f < (idx_t)idx.size(); f++)
+      {
+        std::shared_ptr<pdat::CellData<real_t> > pdata(
+          SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+            patch->getPatchData(idx[f])));
+
+        const hier::Box& ghost_box = pdata->getGhostBox();
+        const int * g_lower = &ghost_box.lower()[0];
+        const idx_t g_nx = ghost_box.upper()[0] - g_lower[0] + 1;
+        const idx_t g_ny = ghost_box.upper()[1] - g_lower[1] + 1;
+
+        const real_t * src = pdata->getPointer();
+        double * dst = &sp.data[f * n_cells];
+
+#pragma omp parallel for collapse(2)
+        for(int k = sp.lower[2]; k <= sp.upper[2]; k++)
+        {
+          for(int j = sp.lower[1]; j <= sp.upper[1]; j++)
+          {
+            const real_t * src_row = src
+              + (k - g_lower[2]) * g_nx * g_ny + (j - g_lower[1]) * g_nx
+              + (sp.lower[0] - g_lower[0]);
+            double * dst_row = dst
+              + ((k - sp.lower[2]) * ny + (j - sp.lower[1])) * nx;
+            for(idx_t i = 0; i < nx; i++)
+              dst_row[i] = src_row[i];
+          }
+        }
+      }
+    }
+  }
+
+  writer = std::thread(&AsyncPlotWriter::writeStaged, this);
+}
+
+/**
+ * @brief write the staging buffer, runs on the background thread
+ */
+void AsyncPlotWriter::writeStaged()
+{
+  std::shared_ptr<tbox::HDFDatabase > hdf (new tbox::HDFDatabase("plot"));
+
+  // TBOX_ERROR would abort from this thread while other ranks may be in
+  // a collective, leave the failure to wait()
+  if(!hdf->create(staged_filename))
+  {
+    write_error = "Failed to create file " + staged_filename + "\n";
+    return;
+  }
+
+  hdf->putInteger("step", staged_step);
+  hdf->putDouble("time", staged_time);
+  hdf->putStringVector("variables", staged_names);
+  hdf->putInteger("num_patches", staged_patches.size());
+
+  for(idx_t p = 0; p < (idx_t)staged_patches.size(); p++)
+  {
+    const staged_patch_t & sp = staged_patches[p];
+
+    std::shared_ptr<tbox::Database> patch_db(
+      hdf->putDatabase("patch." + tbox::Utilities::intToString(p, 5)));
+
+    patch_db->putInteger("level", sp.level);
+    patch_db->putIntegerArray("lower", sp.lower, 3);
+    patch_db->putIntegerArray("upper", sp.upper, 3);
+    patch_db->putDoubleArray("x_lo", sp.x_lo, 3);
+    patch_db->putDoubleArray("dx", sp.dx, 3);
+
+    const size_t n_cells = sp.data.size() / staged_names.size();
+    for(idx_t f = 0; f < (idx_t)staged_names.size(); f++)
+      patch_db->putDoubleArray(
+        staged_names[f], &sp.data[f * n_cells], n_cells);
+  }
+
+  hdf->close();
+}
+
+}
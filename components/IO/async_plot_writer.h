@@ -0,0 +1,63 @@
+#ifndef COSMO_ASYNC_PLOT_WRITER_H
+#define COSMO_ASYNC_PLOT_WRITER_H
+
+#include "../../cosmo_includes.h"
+#include <thread>
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief Plot file writer that does not block the evolution
+ * @details stage() copies the interior of the requested cell fields of all
+ *  local patches into a staging buffer and returns; the buffer is then
+ *  written by a background thread to one HDF5 file per rank,
+ *  <basename>.async/dump.<step>/proc.<rank>.hdf, while the next steps run.
+ *  The background thread does no MPI; main thread HDF5 use (restarts, other
+ *  dumps) has to call wait() first. Write failures are reported by wait()
+ *  on the main thread.
+ */
+class AsyncPlotWriter
+{
+ public:
+  AsyncPlotWriter(const std::string & basename_in);
+  ~AsyncPlotWriter();
+
+  void stage(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    const std::vector<std::string> & names,
+    const std::vector<idx_t> & idx,
+    idx_t step_num,
+    real_t time);
+
+  void wait();
+
+ private:
+  /**
+   * @brief staged interior data and geometry of one patch
+   */
+  struct staged_patch_t
+  {
+    int level;
+    int lower[3], upper[3];
+    double x_lo[3], dx[3];
+    std::vector<double> data;  ///< all fields, one after another
+  };
+
+  std::string basename;
+  std::vector<std::string> staged_names;
+  std::vector<staged_patch_t> staged_patches;
+  std::string staged_filename;
+  idx_t staged_step;
+  real_t staged_time;
+
+  std::thread writer;
+  // set by the background thread when writing fails
+  std::string write_error;
+
+  void writeStaged();
+};
+
+}
+#endif
@@ -0,0 +1,557 @@
+#include "../../cosmo_includes.h"
+#include "checkpoint.h"
+#include "parallel_hdf5_utils.h"
+#include <cstring>
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+#ifdef H5_HAVE_PARALLEL
+
+static std::string ckpt_field_name(int id)
+{
+  std::shared_ptr<hier::Variable> var;
+  hier::VariableDatabase::getDatabase()->mapIndexToVariable(id, var);
+  TBOX_ASSERT(var);
+  return var->getName();
+}
+
+static std::string ckpt_level_name(idx_t ln)
+{
+  return "level_" + tbox::Utilities::intToString(ln, 2);
+}
+
+/**
+ * @brief FNV-1a style hash of doubles, one 64 bit word at a time
+ */
+static unsigned long long ckpt_hash(
+  unsigned long long h, const double * data, idx_t n)
+{
+  for(idx_t i = 0; i < n; i++)
+  {
+    unsigned long long w;
+    memcpy(&w, &data[i], sizeof(w));
+    h = (h ^ w) * 1099511628211ULL;
+  }
+  return h;
+}
+
+static const unsigned long long ckpt_hash_seed = 14695981039346656037ULL;
+
+static const idx_t ckpt_chunk_size = 1 << 20;
+
+/**
+ * @brief rounding down integer division, for coarsening cell indices
+ */
+static int ckpt_floor_div(int a, int r)
+{
+  return a >= 0 ? a / r : -((-a + r - 1) / r);
+}
+
+/**
+ * @brief copy cells [lower, upper] between patch data and a packed box
+ *        [b_lower, b_upper] (x index fastest), in either direction
+ */
+static void ckpt_copy_cells(
+  const std::shared_ptr<pdat::CellData<real_t> > & pdata,
+  double * packed, const int * b_lower, const int * b_upper,
+  const int * lower, const int * upper, bool to_packed)
+{
+  const hier::Box& ghost_box = pdata->getGhostBox();
+  const int * g_lower = &ghost_box.lower()[0];
+  const idx_t g_nx = ghost_box.upper()[0] - g_lower[0] + 1;
+  const idx_t g_ny = ghost_box.upper()[1] - g_lower[1] + 1;
+  const idx_t b_nx = b_upper[0] - b_lower[0] + 1;
+  const idx_t b_ny = b_upper[1] - b_lower[1] + 1;
+  const idx_t nx = upper[0] - lower[0] + 1;
+
+  real_t * data = pdata->getPointer();
+
+#pragma omp parallel for collapse(2)
+  for(int k = lower[2]; k <= upper[2]; k++)
+  {
+    for(int j = lower[1]; j <= upper[1]; j++)
+    {
+      real_t * data_row = data
+        + (k - g_lower[2]) * g_nx * g_ny + (j - g_lower[1]) * g_nx
+        + (lower[0] - g_lower[0]);
+      double * packed_row = packed
+        + ((k - b_lower[2]) * b_ny + (j - b_lower[1])) * b_nx
+        + (lower[0] - b_lower[0]);
+      if(to_packed)
+        for(idx_t i = 0; i < nx; i++) packed_row[i] = data_row[i];
+      else
+        for(idx_t i = 0; i < nx; i++) data_row[i] = packed_row[i];
+    }
+  }
+}
+
+/**
+ * @brief hash of the interior of a patch, equal to ckpt_hash of its packed
+ *        cells
+ */
+static unsigned long long ckpt_patch_hash(
+  const std::shared_ptr<pdat::CellData<real_t> > & pdata,
+  const int * lower, const int * upper)
+{
+  const hier::Box& ghost_box = pdata->getGhostBox();
+  const int * g_lower = &ghost_box.lower()[0];
+  const idx_t g_nx = ghost_box.upper()[0] - g_lower[0] + 1;
+  const idx_t g_ny = ghost_box.upper()[1] - g_lower[1] + 1;
+  const real_t * data = pdata->getPointer();
+
+  unsigned long long h = ckpt_hash_seed;
+  for(int k = lower[2]; k <= upper[2]; k++)
+    for(int j = lower[1]; j <= upper[1]; j++)
+      h = ckpt_hash(h, data + (k - g_lower[2]) * g_nx * g_ny
+                    + (j - g_lower[1]) * g_nx + (lower[0] - g_lower[0]),
+                    upper[0] - lower[0] + 1);
+  return h;
+}
+
+Checkpoint::Checkpoint(
+  const std::string & basename_in, bool incremental_in):
+  basename(basename_in),
+  incremental(incremental_in),
+  in_file(-1),
+  in_step(0),
+  in_time(0)
+{
+}
+
+Checkpoint::~Checkpoint()
+{
+  close();
+}
+
+/**
+ * @brief collectively write the interior of patch data ids on all levels,
+ *        has to be called by all ranks
+ *
+ * @param hierarchy
+ * @param ids patch data indices, stored under their variable names
+ * @param step_num
+ * @param time
+ * @param scalars extra values stored as attributes of the file
+ */
+void Checkpoint::write(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  const std::vector<int> & ids,
+  idx_t step_num,
+  real_t time,
+  const std::map<std::string, double> & scalars)
+{
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  std::string dump_dirname = basename + ".checkpoint";
+  tbox::Utilities::recursiveMkdir(dump_dirname);
+  mpi.Barrier();
+
+  std::string short_filename =
+    "ckpt." + tbox::Utilities::intToString(step_num, 5) + ".h5";
+
+  hid_t file = phdf5_create_file(mpi, dump_dirname + "/" + short_filename);
+
+  int step = step_num, num_levels = hierarchy->getNumberOfLevels();
+  double t = time;
+  phdf5_put_attribute(file, "step", H5T_NATIVE_INT, &step);
+  phdf5_put_attribute(file, "time", H5T_NATIVE_DOUBLE, &t);
+  phdf5_put_attribute(file, "num_levels", H5T_NATIVE_INT, &num_levels);
+
+  for(std::map<std::string, double>::const_iterator it = scalars.begin();
+      it != scalars.end(); ++it)
+    phdf5_put_attribute(file, it->first.c_str(), H5T_NATIVE_DOUBLE,
+                        &it->second);
+
+  level_hash.resize(num_levels, 0);
+  level_file.resize(num_levels);
+
+  idx_t n_linked = 0;
+
+  for(int ln = 0; ln < num_levels; ln++)
+  {
+    std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+    std::vector<long long> patches;
+    // checksums of the local patches, field by field
+    std::vector<std::vector<unsigned long long> > checksums(ids.size());
+    long n_cells = 0;
+    unsigned long long hash = 0;
+
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+      const hier::Box& box = patch->getBox();
+      const int * lower = &box.lower()[0];
+      const int * upper = &box.upper()[0];
+
+      for(int d = 0; d < 3; d++)
+        patches.push_back(lower[d]);
+      for(int d = 0; d < 3; d++)
+        patches.push_back(upper[d]);
+      patches.push_back(mpi.getRank());
+      patches.push_back(n_cells);  // shifted to a global offset below
+
+      n_cells += (long)(upper[0] - lower[0] + 1)
+        * (upper[1] - lower[1] + 1) * (upper[2] - lower[2] + 1);
+
+      double box_d[6];
+      for(int d = 0; d < 6; d++)
+        box_d[d] = patches[patches.size() - 8 + d];
+      unsigned long long patch_hash = ckpt_hash(ckpt_hash_seed, box_d, 6);
+
+      for(idx_t f = 0; f < (idx_t)ids.size(); f++)
+      {
+        std::shared_ptr<pdat::CellData<real_t> > pdata(
+          SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+            patch->getPatchData(ids[f])));
+
+        checksums[f].push_back(ckpt_patch_hash(pdata, lower, upper));
+        patch_hash = (patch_hash ^ checksums[f].back()) * 1099511628211ULL;
+      }
+
+      // independent of the order of patches and ranks
+      hash += patch_hash;
+    }
+
+    const long n_patches = patches.size() / 8;
+
+    unsigned long long level_total_hash = 0;
+    mpi.Allreduce(&hash, &level_total_hash, 1,
+                  MPI_UNSIGNED_LONG_LONG, MPI_SUM);
+
+    const std::string group_name = ckpt_level_name(ln);
+
+    if(incremental && !level_file[ln].empty()
+       && level_hash[ln] == level_total_hash)
+    {
+      // unchanged since an earlier checkpoint, which keeps the data
+      H5Lcreate_external(level_file[ln].c_str(), ("/" + group_name).c_str(),
+                         file, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+      n_linked++;
+      continue;
+    }
+
+    level_hash[ln] = level_total_hash;
+    level_file[ln] = short_filename;
+
+    hsize_t patch_offset, patch_total, cell_offset, cell_total;
+    phdf5_offsets(mpi, n_patches, patch_offset, patch_total);
+    phdf5_offsets(mpi, n_cells, cell_offset, cell_total);
+
+    for(long p = 0; p < n_patches; p++)
+      patches[8 * p + 7] += cell_offset;
+
+    hid_t group = H5Gcreate2(file, group_name.c_str(),
+                             H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    long long num_patches = patch_total;
+    phdf5_put_attribute(group, "num_patches", H5T_NATIVE_LLONG,
+                        &num_patches);
+
+    phdf5_write_rows(group, "patches", H5T_NATIVE_LLONG,
+                     n_patches ? &patches[0] : NULL, 8,
+                     n_patches, patch_offset, patch_total,
+                     ckpt_chunk_size, 0);
+
+    std::vector<double> buf(n_cells);
+
+    for(idx_t f = 0; f < (idx_t)ids.size(); f++)
+    {
+      idx_t p = 0;
+      for( hier::PatchLevel::iterator pit(level->begin());
+           pit != level->end(); ++pit, ++p)
+      {
+        std::shared_ptr<pdat::CellData<real_t> > pdata(
+          SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+            (*pit)->getPatchData(ids[f])));
+
+        const int * lower = &(*pit)->getBox().lower()[0];
+        const int * upper = &(*pit)->getBox().upper()[0];
+
+        ckpt_copy_cells(pdata, &buf[patches[8 * p + 7] - cell_offset],
+                        lower, upper, lower, upper, true);
+      }
+
+      const std::string name = ckpt_field_name(ids[f]);
+
+      phdf5_write_rows(group, name, H5T_NATIVE_DOUBLE,
+                       n_cells ? &buf[0] : NULL, 1,
+                       n_cells, cell_offset, cell_total,
+                       ckpt_chunk_size, 0);
+      phdf5_write_rows(group, name + ".checksum", H5T_NATIVE_ULLONG,
+                       n_patches ? &checksums[f][0] : NULL, 1,
+                       n_patches, patch_offset, patch_total,
+                       ckpt_chunk_size, 0);
+    }
+
+    H5Gclose(group);
+  }
+
+  H5Fclose(file);
+
+  tbox::plog << "Wrote checkpoint " << short_filename << ", "
+             << n_linked << "/" << num_levels
+             << " levels linked to earlier checkpoints\n";
+}
+
+/**
+ * @brief open a checkpoint for restarting and read its patch layout, has to
+ *        be called by all ranks
+ */
+void Checkpoint::open(
+  const tbox::SAMRAI_MPI& mpi,
+  const std::string & filename)
+{
+  close();
+
+  hid_t file = phdf5_open_file(mpi, filename);
+  in_file = file;
+
+  int num_levels = 0;
+  if(!phdf5_get_attribute(file, "step", H5T_NATIVE_INT, &in_step)
+     || !phdf5_get_attribute(file, "time", H5T_NATIVE_DOUBLE, &in_time)
+     || !phdf5_get_attribute(file, "num_levels", H5T_NATIVE_INT, &num_levels))
+    TBOX_ERROR("File "<<filename<<" is not a checkpoint!\n");
+
+  in_patches.resize(num_levels);
+
+  for(int ln = 0; ln < num_levels; ln++)
+  {
+    hid_t group = H5Gopen2(file, ckpt_level_name(ln).c_str(), H5P_DEFAULT);
+    if(group < 0)
+      TBOX_ERROR("Cannot open level "<<ln<<" of checkpoint "<<filename
+                 <<", are the earlier checkpoints it links to missing?\n");
+
+    long long num_patches = 0;
+    phdf5_get_attribute(group, "num_patches", H5T_NATIVE_LLONG, &num_patches);
+
+    in_patches[ln].resize(8 * num_patches);
+    if(num_patches > 0)
+      phdf5_read_rows(group, "patches", H5T_NATIVE_LLONG,
+                      &in_patches[ln][0], 8, num_patches, 0);
+
+    H5Gclose(group);
+  }
+
+  tbox::pout << "Restarting from checkpoint " << filename
+             << " with step " << in_step << "\n";
+}
+
+void Checkpoint::close()
+{
+  if(in_file >= 0)
+    H5Fclose(in_file);
+  in_file = -1;
+  in_patches.clear();
+}
+
+/**
+ * @brief extra value stored by write(), or default_value if absent
+ */
+double Checkpoint::getScalar(const std::string & name, double default_value)
+{
+  double value = default_value;
+  if(in_file >= 0)
+    phdf5_get_attribute(in_file, name.c_str(), H5T_NATIVE_DOUBLE, &value);
+  return value;
+}
+
+/**
+ * @brief tag the cells of level ln covered by level ln + 1 of the checkpoint
+ */
+void Checkpoint::tagLevel(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, idx_t tag_index)
+{
+  std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+  const bool has_finer = ln + 1 < (idx_t)in_patches.size();
+  const idx_t n_fine = has_finer ? in_patches[ln + 1].size() / 8 : 0;
+  const long long * fine_patches = n_fine ? &in_patches[ln + 1][0] : NULL;
+
+  int ratio[3] = {1, 1, 1};
+  if(has_finer)
+    for(int d = 0; d < DIM; d++)
+      ratio[d] = hierarchy->getRatioToCoarserLevel(ln + 1)[d];
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+
+    std::shared_ptr<pdat::CellData<int> > tag_pdata(
+      SAMRAI_SHARED_PTR_CAST<pdat::CellData<int>, hier::PatchData>(
+        patch->getPatchData(tag_index)));
+
+    tag_pdata->fillAll(0);
+
+    const hier::Box& box = patch->getBox();
+    const hier::Box& ghost_box = tag_pdata->getGhostBox();
+    const int * g_lower = &ghost_box.lower()[0];
+    const idx_t g_nx = ghost_box.upper()[0] - g_lower[0] + 1;
+    const idx_t g_ny = ghost_box.upper()[1] - g_lower[1] + 1;
+    int * tag = tag_pdata->getPointer();
+
+    for(idx_t p = 0; p < n_fine; p++)
+    {
+      int lower[3], upper[3];
+      bool overlaps = true;
+      for(int d = 0; d < 3; d++)
+      {
+        lower[d] = std::max(
+          ckpt_floor_div(fine_patches[8 * p + d], ratio[d]), box.lower()[d]);
+        upper[d] = std::min(
+          ckpt_floor_div(fine_patches[8 * p + 3 + d], ratio[d]),
+          box.upper()[d]);
+        overlaps = overlaps && lower[d] <= upper[d];
+      }
+      if(!overlaps) continue;
+
+      for(int k = lower[2]; k <= upper[2]; k++)
+        for(int j = lower[1]; j <= upper[1]; j++)
+          for(int i = lower[0]; i <= upper[0]; i++)
+            tag[(i - g_lower[0]) + ((j - g_lower[1])
+                                    + (k - g_lower[2]) * g_ny) * g_nx] = 1;
+    }
+  }
+}
+
+/**
+ * @brief fill the interior of patch data ids on level ln from the saved
+ *        patches overlapping it, has to be called by all ranks
+ * @return false if the checkpoint has no level ln
+ */
+bool Checkpoint::readLevel(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, const std::vector<int> & ids)
+{
+  if(in_file < 0 || ln >= (idx_t)in_patches.size())
+    return false;
+
+  std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+  const std::vector<long long> & saved = in_patches[ln];
+  const idx_t n_saved = saved.size() / 8;
+
+  hid_t group = H5Gopen2(in_file, ckpt_level_name(ln).c_str(), H5P_DEFAULT);
+
+  std::vector<std::vector<unsigned long long> > checksums(ids.size());
+  for(idx_t f = 0; f < (idx_t)ids.size(); f++)
+  {
+    checksums[f].resize(n_saved);
+    if(n_saved > 0)
+      phdf5_read_rows(group, ckpt_field_name(ids[f]) + ".checksum",
+                      H5T_NATIVE_ULLONG, &checksums[f][0], 1, n_saved, 0);
+  }
+
+  std::vector<double> buf;
+
+  for(idx_t s = 0; s < n_saved; s++)
+  {
+    int s_lower[3], s_upper[3];
+    for(int d = 0; d < 3; d++)
+    {
+      s_lower[d] = saved[8 * s + d];
+      s_upper[d] = saved[8 * s + 3 + d];
+    }
+
+    std::vector<std::shared_ptr<hier::Patch> > targets;
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const hier::Box& box = (*pit)->getBox();
+      bool overlaps = true;
+      for(int d = 0; d < 3; d++)
+        overlaps = overlaps && s_lower[d] <= box.upper()[d]
+          && s_upper[d] >= box.lower()[d];
+      if(overlaps)
+        targets.push_back(*pit);
+    }
+    if(targets.empty()) continue;
+
+    const idx_t n_cells = (idx_t)(s_upper[0] - s_lower[0] + 1)
+      * (s_upper[1] - s_lower[1] + 1) * (s_upper[2] - s_lower[2] + 1);
+    buf.resize(n_cells);
+
+    for(idx_t f = 0; f < (idx_t)ids.size(); f++)
+    {
+      const std::string name = ckpt_field_name(ids[f]);
+
+      phdf5_read_rows(group, name, H5T_NATIVE_DOUBLE, &buf[0],
+                      1, n_cells, saved[8 * s + 7]);
+
+      if(ckpt_hash(ckpt_hash_seed, &buf[0], n_cells) != checksums[f][s])
+        TBOX_ERROR("Checksum mismatch of field "<<name<<" in patch "<<s
+                   <<" of level "<<ln<<" of the checkpoint!\n");
+
+      for(idx_t t = 0; t < (idx_t)targets.size(); t++)
+      {
+        const hier::Box& box = targets[t]->getBox();
+        int lower[3], upper[3];
+        for(int d = 0; d < 3; d++)
+        {
+          lower[d] = std::max(s_lower[d], box.lower()[d]);
+          upper[d] = std::min(s_upper[d], box.upper()[d]);
+        }
+
+        std::shared_ptr<pdat::CellData<real_t> > pdata(
+          SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+            targets[t]->getPatchData(ids[f])));
+
+        ckpt_copy_cells(pdata, &buf[0], s_lower, s_upper,
+                        lower, upper, false);
+      }
+    }
+  }
+
+  H5Gclose(group);
+
+  return true;
+}
+
+#else
+
+Checkpoint::Checkpoint(
+  const std::string & basename_in, bool incremental_in):
+  basename(basename_in),
+  incremental(incremental_in),
+  in_file(-1),
+  in_step(0),
+  in_time(0)
+{
+  TBOX_ERROR("Checkpoints require HDF5 built with parallel support!\n");
+}
+
+Checkpoint::~Checkpoint() {}
+
+void Checkpoint::write(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  const std::vector<int> & ids, idx_t step_num, real_t time,
+  const std::map<std::string, double> & scalars) {}
+
+void Checkpoint::open(
+  const tbox::SAMRAI_MPI& mpi, const std::string & filename) {}
+
+void Checkpoint::close() {}
+
+double Checkpoint::getScalar(const std::string & name, double default_value)
+{
+  return default_value;
+}
+
+void Checkpoint::tagLevel(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, idx_t tag_index) {}
+
+bool Checkpoint::readLevel(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, const std::vector<int> & ids)
+{
+  return false;
+}
+
+#endif
+
+}
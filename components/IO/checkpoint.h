@@ -0,0 +1,73 @@
+#ifndef COSMO_CHECKPOINT_H
+#define COSMO_CHECKPOINT_H
+
+#include "../../cosmo_includes.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief Checkpoints of the hierarchy in single files shared by all ranks
+ * @details write() collectively stores the interior of the given patch data
+ *  on every level, the patch layout and per-patch checksums to
+ *  <basename>.checkpoint/ckpt.<step>.h5 (same level layout as the
+ *  ParallelHDF5Writer plot files). With incremental writing, a level whose
+ *  layout and data did not change since the last checkpoint is stored as an
+ *  external link to the file holding it, so earlier checkpoints have to be
+ *  kept.
+ *
+ *  A checkpoint can be read back on any number of ranks: the hierarchy is
+ *  rebuilt by the gridding algorithm, with tagLevel() reproducing the saved
+ *  refined regions, and readLevel() fills the new patches from the saved
+ *  patches overlapping them, verifying their checksums.
+ *  Requires HDF5 built with parallel support.
+ */
+class Checkpoint
+{
+ public:
+  Checkpoint(const std::string & basename_in, bool incremental_in);
+  ~Checkpoint();
+
+  void write(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    const std::vector<int> & ids,
+    idx_t step_num,
+    real_t time,
+    const std::map<std::string, double> & scalars);
+
+  void open(
+    const tbox::SAMRAI_MPI& mpi,
+    const std::string & filename);
+  void close();
+  bool isOpen() { return in_file >= 0; }
+
+  idx_t getStep() { return in_step; }
+  real_t getTime() { return in_time; }
+  double getScalar(const std::string & name, double default_value);
+
+  void tagLevel(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t ln, idx_t tag_index);
+
+  bool readLevel(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t ln, const std::vector<int> & ids);
+
+ private:
+  std::string basename;
+  bool incremental;
+
+  // layout hash of every written level and the file holding its data
+  std::vector<unsigned long long> level_hash;
+  std::vector<std::string> level_file;
+
+  long long in_file;  ///< hid_t of the checkpoint read from, -1 if none
+  int in_step;
+  double in_time;
+  /// patch tables of the levels of the checkpoint read from
+  std::vector<std::vector<long long> > in_patches;
+};
+
+}
+#endif
@@ -0,0 +1,283 @@
+#include "../../cosmo_includes.h"
+#include "insitu_output.h"
+#include "SAMRAI/tbox/HDFDatabase.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief read products from insitu_db
+ * @details insitu_db lists the products in product_names; each of them is a
+ *  sub-database with
+ *  - type: "slice", "cube" or "line"
+ *  - field: name of the cell variable (ACTIVE context) to sample
+ *  - interval: output interval in steps
+ *  - resolution: number of points along each sampled direction, in
+ *    increasing axis order (2 for slices, 3 or 1 for cubes, 1 for lines)
+ *  - axis: normal of a slice or direction of a line
+ *  - position: coordinate of a slice along axis, or coordinates of a line
+ *    along the other two axes in increasing axis order
+ */
+InSituOutput::InSituOutput(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  const std::shared_ptr<tbox::Database> & insitu_db,
+  const std::string & basename_in):
+  basename(basename_in)
+{
+  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry(
+    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
+      hierarchy->getGridGeometry()));
+  TBOX_ASSERT(grid_geometry);
+
+  const double * lower = &grid_geometry->getXLower()[0];
+  const double * upper = &grid_geometry->getXUpper()[0];
+
+  for(int d = 0; d < DIM; d++)
+    domain_lower[d] = lower[d];
+
+  hier::VariableDatabase* variable_db = hier::VariableDatabase::getDatabase();
+
+  std::vector<std::string> names = insitu_db->getStringVector("product_names");
+
+  for(idx_t p = 0; p < (idx_t)names.size(); p++)
+  {
+    std::shared_ptr<tbox::Database> db(insitu_db->getDatabase(names[p]));
+
+    insitu_product_t product;
+    product.name = names[p];
+    product.type = db->getString("type");
+    product.field = db->getString("field");
+    product.interval = db->getIntegerWithDefault("interval", 1);
+
+    if(product.interval <= 0)
+      TBOX_ERROR("In-situ product "<<product.name
+                 <<" needs a positive interval!\n");
+
+    if(variable_db->getVariable(product.field) == NULL)
+      TBOX_ERROR("Cannot find variable "<<product.field
+                 <<" for in-situ product "<<product.name<<"!\n");
+
+    product.field_idx = variable_db->mapVariableAndContextToIndex(
+      variable_db->getVariable(product.field),
+      variable_db->getContext("ACTIVE"));
+
+    std::vector<int> resolution = db->getIntegerVector("resolution");
+
+    // directions that are sampled, the others are fixed by position
+    bool sampled[3] = {true, true, true};
+    std::vector<double> position;
+
+    if(product.type == "slice")
+    {
+      int axis = db->getInteger("axis");
+      if(axis < 0 || axis >= DIM)
+        TBOX_ERROR("Invalid axis for in-situ product "<<product.name<<"!\n");
+      sampled[axis] = false;
+      position.push_back(db->getDouble("position"));
+    }
+    else if(product.type == "line")
+    {
+      int axis = db->getInteger("axis");
+      if(axis < 0 || axis >= DIM)
+        TBOX_ERROR("Invalid axis for in-situ product "<<product.name<<"!\n");
+      for(int d = 0; d < DIM; d++)
+        sampled[d] = (d == axis);
+      position = db->getDoubleVector("position");
+    }
+    else if(product.type == "cube")
+    {
+      if(resolution.size() == 1)
+        resolution.assign(DIM, resolution[0]);
+    }
+    else
+      TBOX_ERROR("Unknown in-situ product type "<<product.type<<"!\n");
+
+    idx_t r = 0, q = 0;
+    for(int d = 0; d < DIM; d++)
+    {
+      if(sampled[d])
+      {
+        if(r >= (idx_t)resolution.size() || resolution[r] <= 0)
+          TBOX_ERROR("Invalid resolution for in-situ product "
+                     <<product.name<<"!\n");
+        // points at the centers of a uniform grid covering the domain
+        product.n[d] = resolution[r++];
+        product.spacing[d] = (upper[d] - lower[d]) / product.n[d];
+        product.origin[d] = lower[d] + 0.5 * product.spacing[d];
+      }
+      else
+      {
+        if(q >= (idx_t)position.size()
+           || position[q] < lower[d] || position[q] >= upper[d])
+          TBOX_ERROR("Invalid position for in-situ product "
+                     <<product.name<<"!\n");
+        product.n[d] = 1;
+        product.spacing[d] = 0;
+        product.origin[d] = position[q++];
+      }
+    }
+
+    products.push_back(product);
+  }
+}
+
+/**
+ * @brief whether any product has to be written at step_num
+ */
+bool InSituOutput::needsOutput(idx_t step_num)
+{
+  for(idx_t p = 0; p < (idx_t)products.size(); p++)
+    if(step_num % products[p].interval == 0)
+      return true;
+  return false;
+}
+
+/**
+ * @brief sample and write all products due at step_num, has to be called by
+ *        all ranks
+ */
+void InSituOutput::output(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t step_num,
+  real_t time)
+{
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  std::string dump_dirname = basename + ".insitu";
+  tbox::Utilities::recursiveMkdir(dump_dirname);
+
+  for(idx_t p = 0; p < (idx_t)products.size(); p++)
+  {
+    const insitu_product_t & product = products[p];
+
+    if(step_num % product.interval != 0) continue;
+
+    std::vector<double> values;
+    sample(hierarchy, product, values);
+
+    if(mpi.getRank() != 0) continue;
+
+    std::string filename = dump_dirname + "/" + product.name + "."
+      + tbox::Utilities::intToString(step_num, 5) + ".hdf";
+
+    std::shared_ptr<tbox::HDFDatabase > hdf (
+      new tbox::HDFDatabase(product.name));
+
+    if(!hdf->create(filename))
+      TBOX_ERROR("Failed to create file "<<filename<<"\n");
+
+    int n[3] = {(int)product.n[0], (int)product.n[1], (int)product.n[2]};
+
+    hdf->putInteger("step", step_num);
+    hdf->putDouble("time", time);
+    hdf->putString("type", product.type);
+    hdf->putString("field", product.field);
+    hdf->putIntegerArray("n", n, 3);
+    hdf->putDoubleArray("origin", product.origin, 3);
+    hdf->putDoubleArray("spacing", product.spacing, 3);
+    hdf->putDoubleArray(product.field, &values[0], values.size());
+
+    hdf->close();
+  }
+
+  tbox::plog << "Wrote in-situ products for step " << step_num << '\n';
+}
+
+/**
+ * @brief collect the values of product.field at the sampling points of
+ *        product, on rank 0 (x index fastest)
+ * @details Levels are visited from coarse to fine, so each rank keeps the
+ *  finest local value of every point; a max reduction of the levels then
+ *  lets only the finest contribution survive the sum reduction.
+ */
+void InSituOutput::sample(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  const insitu_product_t & product,
+  std::vector<double> & values)
+{
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  const idx_t nx = product.n[0], ny = product.n[1], nz = product.n[2];
+  const idx_t n_pts = nx * ny * nz;
+
+  std::vector<int> pt_level(n_pts, -1), finest_level(n_pts);
+  std::vector<double> local_values(n_pts, 0);
+
+  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln++)
+  {
+    std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+
+      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+          patch->getPatchGeometry()));
+
+      const double * dx = &patch_geom->getDx()[0];
+      const hier::Box& box = patch->getBox();
+
+      // points inside the box and the cells containing them, per direction
+      std::vector<idx_t> pts[3], cells[3];
+      for(int d = 0; d < DIM; d++)
+      {
+        for(idx_t i = 0; i < product.n[d]; i++)
+        {
+          int c = (int)floor(
+            (product.origin[d] + i * product.spacing[d] - domain_lower[d])
+            / dx[d]);
+          if(c >= box.lower()[d] && c <= box.upper()[d])
+          {
+            pts[d].push_back(i);
+            cells[d].push_back(c);
+          }
+        }
+      }
+
+      if(pts[0].empty() || pts[1].empty() || pts[2].empty()) continue;
+
+      std::shared_ptr<pdat::CellData<real_t> > pdata(
+        SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+          patch->getPatchData(product.field_idx)));
+
+      const hier::Box& ghost_box = pdata->getGhostBox();
+      const int * g_lower = &ghost_box.lower()[0];
+      const idx_t g_nx = ghost_box.upper()[0] - g_lower[0] + 1;
+      const idx_t g_ny = ghost_box.upper()[1] - g_lower[1] + 1;
+
+      const real_t * src = pdata->getPointer();
+
+#pragma omp parallel for collapse(2)
+      for(idx_t c = 0; c < (idx_t)pts[2].size(); c++)
+      {
+        for(idx_t b = 0; b < (idx_t)pts[1].size(); b++)
+        {
+          for(idx_t a = 0; a < (idx_t)pts[0].size(); a++)
+          {
+            idx_t pt = pts[0][a] + (pts[1][b] + pts[2][c] * ny) * nx;
+            pt_level[pt] = ln;
+            local_values[pt] = src[
+              (cells[0][a] - g_lower[0])
+              + ((cells[1][b] - g_lower[1])
+                 + (cells[2][c] - g_lower[2]) * g_ny) * g_nx];
+          }
+        }
+      }
+    }
+  }
+
+  mpi.Allreduce(&pt_level[0], &finest_level[0], n_pts, MPI_INT, MPI_MAX);
+
+#pragma omp parallel for
+  for(idx_t pt = 0; pt < n_pts; pt++)
+    if(pt_level[pt] != finest_level[pt])
+      local_values[pt] = 0;
+
+  values.assign(n_pts, 0);
+  mpi.Reduce(&local_values[0], &values[0], n_pts, MPI_DOUBLE, MPI_SUM, 0);
+}
+
+}
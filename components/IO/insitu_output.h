@@ -0,0 +1,58 @@
+#ifndef COSMO_INSITU_OUTPUT_H
+#define COSMO_INSITU_OUTPUT_H
+
+#include "../../cosmo_includes.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief Reduced output products computed from the hierarchy while running
+ * @details Every product samples one cell field on a uniform grid of points
+ *  covering the domain: an axis-aligned slice, a fixed-resolution cube or a
+ *  line-out. Each point takes the value of the cell containing it on the
+ *  finest level that covers it. Products have their own output intervals and
+ *  are written by rank 0 to <basename>.insitu/<product>.<step>.hdf.
+ */
+class InSituOutput
+{
+ public:
+  InSituOutput(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    const std::shared_ptr<tbox::Database> & insitu_db,
+    const std::string & basename_in);
+
+  bool needsOutput(idx_t step_num);
+
+  void output(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t step_num,
+    real_t time);
+
+ private:
+  /**
+   * @brief sampling points and output settings of one product
+   */
+  struct insitu_product_t
+  {
+    std::string name, type, field;
+    idx_t field_idx;
+    idx_t interval;
+    idx_t n[3];          ///< number of points in each direction
+    double origin[3];    ///< first point
+    double spacing[3];   ///< distance between points
+  };
+
+  std::string basename;
+  std::vector<insitu_product_t> products;
+  double domain_lower[3];
+
+  void sample(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    const insitu_product_t & product,
+    std::vector<double> & values);
+};
+
+}
+#endif
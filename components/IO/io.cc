@@ -8,14 +8,29 @@ namespace cosmo{
 CosmoIO::CosmoIO(
   const tbox::Dimension& dim_in,
   std::shared_ptr<tbox::Database> cosmo_io_db_in,
-  std::ostream* l_stream_in):
+  std::ostream* l_stream_in,
+  const std::string & vis_filename_in):
   dim(dim_in),
   cosmo_io_db(cosmo_io_db_in),
   lstream(l_stream_in),
+  async_output(cosmo_io_db_in->getBoolWithDefault("async_output", false)),
+  parallel_hdf5_output(
+    cosmo_io_db_in->getBoolWithDefault("parallel_hdf5_output", false)),
+  vis_filename(vis_filename_in),
   is_empty(true)
 {
   output_list = cosmo_io_db->getStringVector("output_list");
   output_interval = cosmo_io_db->getIntegerVector("output_interval");
+  if(async_output)
+    async_writer.reset(new AsyncPlotWriter(vis_filename_in));
+  if(parallel_hdf5_output)
+  {
+    if(async_output)
+      TBOX_ERROR("async_output and parallel_hdf5_output cannot be combined!\n");
+    parallel_writer.reset(new ParallelHDF5Writer(
+      cosmo_io_db->getIntegerWithDefault("hdf5_chunk_size", 65536),
+      cosmo_io_db->getIntegerWithDefault("hdf5_compression_level", 0)));
+  }
 #if !USE_COSMOTRACE
   output_null_geodesic = false;
   output_null_geodesic_interval = 0;
@@ -72,6 +87,8 @@ void CosmoIO::registerVariablesWithPlotter(
 {
   hier::VariableDatabase* variable_db = hier::VariableDatabase::getDatabase();
   is_empty = 1;
+  plot_names.clear();
+  plot_idx.clear();
   for(idx_t i = 0; i < static_cast<idx_t>(output_list.size()); i ++)
   {
     if(step % output_interval[i] != 0 ) continue;
@@ -91,6 +108,11 @@ void CosmoIO::registerVariablesWithPlotter(
 
     if(variable_db->getVariable(output_list[i]) == NULL)
     {
+      if(async_output || parallel_hdf5_output)
+        TBOX_ERROR("async_output and parallel_hdf5_output cannot write "
+                   "derived variable "
+                   << output_list[i] << "!\n");
+
       tbox::plog<<"Cannot find variable" <<output_list[i]<<" in theoutput list!"
                 <<" Registed as derived variable!\n";
 
@@ -114,6 +136,9 @@ void CosmoIO::registerVariablesWithPlotter(
       0,
       1.0,
       "CELL");
+
+    plot_names.push_back(output_list[i]);
+    plot_idx.push_back(idx);
   }
 
 }
@@ -126,7 +151,68 @@ void CosmoIO::dumpData(
 {
   //TBOX_ASSERT(visit_writer);
 
+  dumpInSitu(hierarchy, step_num, time);
+
   if(is_empty) return;
+
+  writePlotData(hierarchy, visit_writer, step_num, time);
+}
+
+/**
+ * @brief write in-situ products listed in the insitu_products database of
+ *        the IO block that are due at step_num
+ */
+void CosmoIO::dumpInSitu(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t step_num,
+  real_t time)
+{
+  if(!cosmo_io_db->isDatabase("insitu_products")) return;
+
+  if(!insitu_output)
+    insitu_output.reset(new InSituOutput(
+      hierarchy, cosmo_io_db->getDatabase("insitu_products"), vis_filename));
+
+  if(!insitu_output->needsOutput(step_num)) return;
+
+  // HDF5 is only used by one thread at a time
+  waitForOutput();
+
+  insitu_output->output(hierarchy, step_num, time);
+}
+
+/**
+ * @brief write registered fields with the writer selected in the input
+ */
+void CosmoIO::writePlotData(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  appu::VisItDataWriter& visit_writer,
+  idx_t step_num,
+  real_t time)
+{
+  if(async_output)
+  {
+    async_writer->stage(hierarchy, plot_names, plot_idx, step_num, time);
+    tbox::plog << "Staged viz file for grid number "
+               << step_num << '\n';
+    return;
+  }
+
+  if(parallel_hdf5_output)
+  {
+    std::string dump_dirname = vis_filename + ".h5";
+    tbox::Utilities::recursiveMkdir(dump_dirname);
+    hierarchy->getMPI().Barrier();
+
+    parallel_writer->writePlot(
+      hierarchy, plot_names, plot_idx, step_num, time,
+      dump_dirname + "/plot." + tbox::Utilities::intToString(step_num, 5)
+      + ".h5");
+
+    tbox::plog << "Wrote parallel HDF5 file for grid number "
+               << step_num << '\n';
+    return;
+  }
   
   visit_writer.writePlotData(
     hierarchy,
@@ -137,6 +223,16 @@ void CosmoIO::dumpData(
              << step_num << '\n';
 }
 
+/**
+ * @brief block until staged plot data is written, needed before other
+ *        HDF5 output and at the end of the run
+ */
+void CosmoIO::waitForOutput()
+{
+  if(async_writer)
+    async_writer->wait();
+}
+
 #if USE_COSMOTRACE
 void CosmoIO::dumpData(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
@@ -147,50 +243,19 @@ void CosmoIO::dumpData(
   std::string hdf_filename_in)
 {
   //TBOX_ASSERT(visit_writer);
-  if(!is_empty)
-  {
-  
-    visit_writer.writePlotData(
-      hierarchy,
-      step_num,
-      time);
+  dumpInSitu(hierarchy, step_num, time);
 
-    tbox::plog << "Wrote viz file for grid number "
-               << step_num << '\n';
-  }
+  if(!is_empty)
+    writePlotData(hierarchy, visit_writer, step_num, time);
 
   const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
 
   if(step_num % output_null_geodesic_interval != 0)
     return;
 
-  std::string dump_dirname = hdf_filename_in;
-  dump_dirname += ".hdf/hdf_dump." + tbox::Utilities::intToString(step_num, 5);
+  // HDF5 is only used by one thread at a time
+  waitForOutput();
 
-  tbox::Utilities::recursiveMkdir(dump_dirname);
-  
-  std::string filename = dump_dirname + "/null_geodesic_proc_";
-  filename += tbox::Utilities::intToString(mpi.getRank(), 5);
-  filename += ".hdf";
-  std::shared_ptr<tbox::HDFDatabase > hdf (new tbox::HDFDatabase("null_geodesic"));
-
-  std::ifstream file(filename);
-
-  // if(file)
-  //   if(!remove(filename.c_str()))
-  //     TBOX_ERROR("Failed to remove file "<<filename<<"\n");
-  hdf->create(filename);
-    
-  if(!hdf->open(filename, true))
-    TBOX_ERROR("Failed to open file "<<filename<<"\n");
-
-  // int my_proc = mpi.getRank();
-  // char temp_buf[20];
-  // sprintf(temp_buf, "processor.%05d", my_proc);
-  // std::shared_ptr<tbox::Database> processor_HDFGroup(
-  //   hdf->putDatabase(std::string(temp_buf)));
-
-  
   int particle_cnt = 0;
 
   std::vector<double> all_info;
@@ -225,8 +290,8 @@ void CosmoIO::dumpData(
         
         //        double p_info[PARTICLE_NUMBER_OF_STATES + PARTICLE_INT_PROPERTIES];
         
-        for(std::list<RKParticle>::iterator it=id.p_list.begin();
-            it != id.p_list.end(); it++)
+        for(ParticleContainer::iterator it=id.begin();
+            it != id.end(); it++)
         {
           for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i ++)
             all_info.push_back((*it).x_a[i]);
@@ -244,6 +309,48 @@ void CosmoIO::dumpData(
   //   std::cout<<all_info[i]<<" ";
   // std::cout<<"\n";
 
+  if(parallel_hdf5_output)
+  {
+    std::string dump_dirname = hdf_filename_in + ".h5";
+    tbox::Utilities::recursiveMkdir(dump_dirname);
+    mpi.Barrier();
+
+    parallel_writer->writeParticles(
+      mpi, "null_geodesic", all_info,
+      PARTICLE_NUMBER_OF_STATES + PARTICLE_REAL_PROPERTIES
+      + PARTICLE_INT_PROPERTIES,
+      step_num, time,
+      dump_dirname + "/null_geodesic." + tbox::Utilities::intToString(step_num, 5)
+      + ".h5");
+    return;
+  }
+
+  std::string dump_dirname = hdf_filename_in;
+  dump_dirname += ".hdf/hdf_dump." + tbox::Utilities::intToString(step_num, 5);
+
+  tbox::Utilities::recursiveMkdir(dump_dirname);
+  
+  std::string filename = dump_dirname + "/null_geodesic_proc_";
+  filename += tbox::Utilities::intToString(mpi.getRank(), 5);
+  filename += ".hdf";
+  std::shared_ptr<tbox::HDFDatabase > hdf (new tbox::HDFDatabase("null_geodesic"));
+
+  std::ifstream file(filename);
+
+  // if(file)
+  //   if(!remove(filename.c_str()))
+  //     TBOX_ERROR("Failed to remove file "<<filename<<"\n");
+  hdf->create(filename);
+    
+  if(!hdf->open(filename, true))
+    TBOX_ERROR("Failed to open file "<<filename<<"\n");
+
+  // int my_proc = mpi.getRank();
+  // char temp_buf[20];
+  // sprintf(temp_buf, "processor.%05d", my_proc);
+  // std::shared_ptr<tbox::Database> processor_HDFGroup(
+  //   hdf->putDatabase(std::string(temp_buf)));
+
   if(all_info.size() > 0)
   {
     hdf->putDoubleArray("null_geodesic", &all_info[0], all_info.size());
@@ -3,6 +3,9 @@
 
 #include "../../cosmo_includes.h"
 #include "stdio.h"
+#include "async_plot_writer.h"
+#include "parallel_hdf5_writer.h"
+#include "insitu_output.h"
 #if USE_COSMOTRACE
 #include "../geodesic/geodesic.h"
 #endif
@@ -17,7 +20,8 @@ class CosmoIO:public appu::VisDerivedDataStrategy
   CosmoIO(
     const tbox::Dimension& dim_in,
     std::shared_ptr<tbox::Database> cosmo_io_db_in,
-    std::ostream* l_stream_in);
+    std::ostream* l_stream_in,
+    const std::string & vis_filename_in = std::string());
   
   const tbox::Dimension& dim;
   std::shared_ptr<tbox::Database> &cosmo_io_db;
@@ -26,6 +30,24 @@ class CosmoIO:public appu::VisDerivedDataStrategy
 
   std::vector<std::string> output_list;
   std::vector<idx_t> output_interval;
+
+  // write plot files from a background thread instead of VisItDataWriter
+  bool async_output;
+  std::shared_ptr<AsyncPlotWriter> async_writer;
+
+  // write every dump to a single file with collective parallel HDF5
+  bool parallel_hdf5_output;
+  std::shared_ptr<ParallelHDF5Writer> parallel_writer;
+
+  std::string vis_filename;
+
+  // slices, resampled cubes and line-outs written at their own intervals,
+  // created at the first dump when all fields are registered
+  std::shared_ptr<InSituOutput> insitu_output;
+
+  // fields registered for the current step, used by async_writer
+  std::vector<std::string> plot_names;
+  std::vector<idx_t> plot_idx;
   
   virtual bool
    packDerivedDataIntoDoubleBuffer(
@@ -45,6 +67,16 @@ class CosmoIO:public appu::VisDerivedDataStrategy
     appu::VisItDataWriter& visit_writer,
     idx_t step_num,
     real_t time);
+  void dumpInSitu(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t step_num,
+    real_t time);
+  void writePlotData(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    appu::VisItDataWriter& visit_writer,
+    idx_t step_num,
+    real_t time);
+  void waitForOutput();
   void printPatch(
     const std::shared_ptr<hier::Patch> & patch,
     std::ostream &os,
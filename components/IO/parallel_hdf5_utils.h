@@ -0,0 +1,44 @@
+#ifndef COSMO_PARALLEL_HDF5_UTILS_H
+#define COSMO_PARALLEL_HDF5_UTILS_H
+
+#include "../../cosmo_includes.h"
+#include <hdf5.h>
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+#ifdef H5_HAVE_PARALLEL
+
+// helpers for files shared by all ranks, implemented in
+// parallel_hdf5_writer.cc
+
+void phdf5_offsets(
+  const tbox::SAMRAI_MPI& mpi, long local_rows,
+  hsize_t & offset, hsize_t & total);
+
+hid_t phdf5_create_file(
+  const tbox::SAMRAI_MPI& mpi, const std::string & filename);
+
+hid_t phdf5_open_file(
+  const tbox::SAMRAI_MPI& mpi, const std::string & filename);
+
+void phdf5_put_attribute(
+  hid_t loc, const char * name, hid_t type, const void * value);
+
+bool phdf5_get_attribute(
+  hid_t loc, const char * name, hid_t type, void * value);
+
+void phdf5_write_rows(
+  hid_t loc, const std::string & name, hid_t type, const void * buf,
+  hsize_t n_cols, hsize_t local_rows, hsize_t offset, hsize_t total,
+  idx_t chunk_size, idx_t compression_level);
+
+void phdf5_read_rows(
+  hid_t loc, const std::string & name, hid_t type, void * buf,
+  hsize_t n_cols, hsize_t n_rows, hsize_t offset);
+
+#endif
+
+}
+#endif
@@ -0,0 +1,410 @@
+#include "../../cosmo_includes.h"
+#include "parallel_hdf5_writer.h"
+#include "parallel_hdf5_utils.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+#ifdef H5_HAVE_PARALLEL
+
+/**
+ * @brief offset of the local rows in a dataset shared by all ranks, and
+ *        total number of rows
+ */
+void phdf5_offsets(
+  const tbox::SAMRAI_MPI& mpi, long local_rows,
+  hsize_t & offset, hsize_t & total)
+{
+  std::vector<long> all_rows(mpi.getSize());
+
+  mpi.Allgather(&local_rows, 1, MPI_LONG, &all_rows[0], 1, MPI_LONG);
+
+  offset = total = 0;
+  for(int r = 0; r < mpi.getSize(); r++)
+  {
+    if(r < mpi.getRank())
+      offset += all_rows[r];
+    total += all_rows[r];
+  }
+}
+
+hid_t phdf5_create_file(
+  const tbox::SAMRAI_MPI& mpi, const std::string & filename)
+{
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_fapl_mpio(fapl, mpi.getCommunicator(), MPI_INFO_NULL);
+
+  hid_t file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  H5Pclose(fapl);
+
+  if(file < 0)
+    TBOX_ERROR("Failed to create file "<<filename<<"\n");
+
+  return file;
+}
+
+/**
+ * @brief open an existing file for reading by all ranks
+ */
+hid_t phdf5_open_file(
+  const tbox::SAMRAI_MPI& mpi, const std::string & filename)
+{
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_fapl_mpio(fapl, mpi.getCommunicator(), MPI_INFO_NULL);
+
+  hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, fapl);
+  H5Pclose(fapl);
+
+  if(file < 0)
+    TBOX_ERROR("Failed to open file "<<filename<<"\n");
+
+  return file;
+}
+
+/**
+ * @brief read a scalar attribute, returns false if it does not exist
+ */
+bool phdf5_get_attribute(
+  hid_t loc, const char * name, hid_t type, void * value)
+{
+  if(H5Aexists(loc, name) <= 0)
+    return false;
+
+  hid_t attr = H5Aopen(loc, name, H5P_DEFAULT);
+  H5Aread(attr, type, value);
+  H5Aclose(attr);
+  return true;
+}
+
+/**
+ * @brief attributes are written collectively, every rank has to pass the
+ *        same value
+ */
+void phdf5_put_attribute(
+  hid_t loc, const char * name, hid_t type, const void * value)
+{
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t attr = H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, value);
+  H5Aclose(attr);
+  H5Sclose(space);
+}
+
+/**
+ * @brief collectively write a [total][n_cols] dataset, each rank
+ *        contributing local_rows rows starting at row offset
+ */
+void phdf5_write_rows(
+  hid_t loc, const std::string & name, hid_t type, const void * buf,
+  hsize_t n_cols, hsize_t local_rows, hsize_t offset, hsize_t total,
+  idx_t chunk_size, idx_t compression_level)
+{
+  const int rank = n_cols > 1 ? 2 : 1;
+  hsize_t dims[2] = {total, n_cols};
+
+  hid_t filespace = H5Screate_simple(rank, dims, NULL);
+
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  if(total > 0)
+  {
+    hsize_t chunk[2] = {std::min(total, (hsize_t)chunk_size), n_cols};
+    H5Pset_chunk(dcpl, rank, chunk);
+#if H5_VERSION_GE(1,10,2)
+    if(compression_level > 0)
+      H5Pset_deflate(dcpl, compression_level);
+#endif
+  }
+
+  hid_t dset = H5Dcreate2(loc, name.c_str(), type, filespace,
+                          H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+  if(total > 0)
+  {
+    hsize_t start[2] = {offset, 0};
+    hsize_t count[2] = {local_rows, n_cols};
+    hsize_t one = 1;
+
+    hid_t memspace;
+    if(local_rows > 0)
+    {
+      H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+      memspace = H5Screate_simple(rank, count, NULL);
+    }
+    else
+    {
+      H5Sselect_none(filespace);
+      memspace = H5Screate_simple(1, &one, NULL);
+      H5Sselect_none(memspace);
+    }
+
+    hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+
+    H5Dwrite(dset, type, memspace, filespace, dxpl, buf);
+
+    H5Pclose(dxpl);
+    H5Sclose(memspace);
+  }
+
+  H5Dclose(dset);
+  H5Pclose(dcpl);
+  H5Sclose(filespace);
+}
+
+/**
+ * @brief independently read n_rows rows of a [total][n_cols] dataset,
+ *        starting at row offset
+ */
+void phdf5_read_rows(
+  hid_t loc, const std::string & name, hid_t type, void * buf,
+  hsize_t n_cols, hsize_t n_rows, hsize_t offset)
+{
+  hid_t dset = H5Dopen2(loc, name.c_str(), H5P_DEFAULT);
+  if(dset < 0)
+    TBOX_ERROR("Cannot find dataset "<<name<<"!\n");
+
+  hid_t filespace = H5Dget_space(dset);
+  const int rank = H5Sget_simple_extent_ndims(filespace);
+
+  hsize_t start[2] = {offset, 0};
+  hsize_t count[2] = {n_rows, n_cols};
+  H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+  hid_t memspace = H5Screate_simple(rank, count, NULL);
+
+  H5Dread(dset, type, memspace, filespace, H5P_DEFAULT, buf);
+
+  H5Sclose(memspace);
+  H5Sclose(filespace);
+  H5Dclose(dset);
+}
+
+#endif
+
+ParallelHDF5Writer::ParallelHDF5Writer(
+  idx_t chunk_size_in, idx_t compression_level_in):
+  chunk_size(chunk_size_in),
+  compression_level(compression_level_in)
+{
+#ifndef H5_HAVE_PARALLEL
+  TBOX_ERROR("Parallel HDF5 output requires HDF5 built with parallel support!\n");
+#else
+  if(chunk_size <= 0)
+    TBOX_ERROR("hdf5_chunk_size has to be positive!\n");
+#if !H5_VERSION_GE(1,10,2)
+  if(compression_level > 0)
+    TBOX_ERROR("Compressed parallel HDF5 output requires HDF5 >= 1.10.2!\n");
+#endif
+#endif
+}
+
+/**
+ * @brief collectively write interior of fields idx on all levels to a single
+ *        file, has to be called by all ranks
+ *
+ * @param hierarchy
+ * @param names names of the datasets
+ * @param idx patch data indices of the fields
+ * @param step_num
+ * @param time
+ * @param filename
+ */
+void ParallelHDF5Writer::writePlot(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  const std::vector<std::string> & names,
+  const std::vector<idx_t> & idx,
+  idx_t step_num,
+  real_t time,
+  const std::string & filename)
+{
+#ifdef H5_HAVE_PARALLEL
+  TBOX_ASSERT(names.size() == idx.size());
+
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  hid_t file = phdf5_create_file(mpi, filename);
+
+  int step = step_num, num_levels = hierarchy->getNumberOfLevels();
+  double t = time;
+  phdf5_put_attribute(file, "step", H5T_NATIVE_INT, &step);
+  phdf5_put_attribute(file, "time", H5T_NATIVE_DOUBLE, &t);
+  phdf5_put_attribute(file, "num_levels", H5T_NATIVE_INT, &num_levels);
+
+  for(int ln = 0; ln < num_levels; ln++)
+  {
+    std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+    std::vector<long long> patches;
+    std::vector<double> geometry;
+    long n_cells = 0;
+
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+
+      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+          patch->getPatchGeometry()));
+
+      const hier::Box& box = patch->getBox();
+
+      for(int d = 0; d < 3; d++)
+        patches.push_back(box.lower()[d]);
+      for(int d = 0; d < 3; d++)
+        patches.push_back(box.upper()[d]);
+      patches.push_back(mpi.getRank());
+      patches.push_back(n_cells);  // shifted to a global offset below
+
+      for(int d = 0; d < 3; d++)
+        geometry.push_back(patch_geom->getXLower()[d]);
+      for(int d = 0; d < 3; d++)
+        geometry.push_back(patch_geom->getDx()[d]);
+
+      n_cells += (long)(box.upper()[0] - box.lower()[0] + 1)
+        * (box.upper()[1] - box.lower()[1] + 1)
+        * (box.upper()[2] - box.lower()[2] + 1);
+    }
+
+    const long n_patches = patches.size() / 8;
+
+    hsize_t patch_offset, patch_total, cell_offset, cell_total;
+    phdf5_offsets(mpi, n_patches, patch_offset, patch_total);
+    phdf5_offsets(mpi, n_cells, cell_offset, cell_total);
+
+    for(long p = 0; p < n_patches; p++)
+      patches[8 * p + 7] += cell_offset;
+
+    hid_t group = H5Gcreate2(
+      file, ("level_" + tbox::Utilities::intToString(ln, 2)).c_str(),
+      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    phdf5_write_rows(group, "patches", H5T_NATIVE_LLONG,
+                     n_patches ? &patches[0] : NULL, 8,
+                     n_patches, patch_offset, patch_total,
+                     chunk_size, compression_level);
+    phdf5_write_rows(group, "geometry", H5T_NATIVE_DOUBLE,
+                     n_patches ? &geometry[0] : NULL, 6,
+                     n_patches, patch_offset, patch_total,
+                     chunk_size, compression_level);
+
+    // one field at a time, only the interior cells are packed
+    std::vector<double> buf(n_cells);
+
+    for(idx_t f = 0; f < (idx_t)idx.size(); f++)
+    {
+      long cell = 0;
+      for( hier::PatchLevel::iterator pit(level->begin());
+           pit != level->end(); ++pit)
+      {
+        const std::shared_ptr<hier::Patch> & patch = *pit;
+
+        std::shared_ptr<pdat::CellData<real_t> > pdata(
+          SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+            patch->getPatchData(idx[f])));
+
+        const hier::Box& box = patch->getBox();
+        const hier::Box& ghost_box = pdata->getGhostBox();
+        const int * lower = &box.lower()[0];
+        const int * upper = &box.upper()[0];
+        const int * g_lower = &ghost_box.lower()[0];
+        const long nx = upper[0] - lower[0] + 1;
+        const long ny = upper[1] - lower[1] + 1;
+        const long g_nx = ghost_box.upper()[0] - g_lower[0] + 1;
+        const long g_ny = ghost_box.upper()[1] - g_lower[1] + 1;
+
+        const real_t * src = pdata->getPointer();
+        double * dst = &buf[cell];
+
+#pragma omp parallel for collapse(2)
+        for(int k = lower[2]; k <= upper[2]; k++)
+        {
+          for(int j = lower[1]; j <= upper[1]; j++)
+          {
+            const real_t * src_row = src
+              + (k - g_lower[2]) * g_nx * g_ny + (j - g_lower[1]) * g_nx
+              + (lower[0] - g_lower[0]);
+            double * dst_row = dst + ((k - lower[2]) * ny + (j - lower[1])) * nx;
+            for(long i = 0; i < nx; i++)
+              dst_row[i] = src_row[i];
+          }
+        }
+
+        cell += nx * ny * (upper[2] - lower[2] + 1);
+      }
+
+      phdf5_write_rows(group, names[f], H5T_NATIVE_DOUBLE,
+                       n_cells ? &buf[0] : NULL, 1,
+                       n_cells, cell_offset, cell_total,
+                       chunk_size, compression_level);
+    }
+
+    H5Gclose(group);
+  }
+
+  H5Fclose(file);
+#else
+  NULL_USE(hierarchy);
+  NULL_USE(names);
+  NULL_USE(idx);
+  NULL_USE(step_num);
+  NULL_USE(time);
+  NULL_USE(filename);
+#endif
+}
+
+/**
+ * @brief collectively write a [n_particles][n_per_particle] table of the
+ *        particles of all ranks to a single file
+ *
+ * @param mpi
+ * @param name name of the dataset
+ * @param data local particles, n_per_particle values each
+ * @param n_per_particle
+ * @param step_num
+ * @param time
+ * @param filename
+ */
+void ParallelHDF5Writer::writeParticles(
+  const tbox::SAMRAI_MPI& mpi,
+  const std::string & name,
+  const std::vector<double> & data,
+  idx_t n_per_particle,
+  idx_t step_num,
+  real_t time,
+  const std::string & filename)
+{
+#ifdef H5_HAVE_PARALLEL
+  hid_t file = phdf5_create_file(mpi, filename);
+
+  const long n_particles = data.size() / n_per_particle;
+
+  hsize_t offset, total;
+  phdf5_offsets(mpi, n_particles, offset, total);
+
+  int step = step_num;
+  double t = time;
+  long long num_particles = total;
+  phdf5_put_attribute(file, "step", H5T_NATIVE_INT, &step);
+  phdf5_put_attribute(file, "time", H5T_NATIVE_DOUBLE, &t);
+  phdf5_put_attribute(file, "num_of_particles", H5T_NATIVE_LLONG,
+                      &num_particles);
+
+  phdf5_write_rows(file, name, H5T_NATIVE_DOUBLE,
+                   n_particles ? &data[0] : NULL, n_per_particle,
+                   n_particles, offset, total,
+                   chunk_size, compression_level);
+
+  H5Fclose(file);
+#else
+  NULL_USE(mpi);
+  NULL_USE(name);
+  NULL_USE(data);
+  NULL_USE(n_per_particle);
+  NULL_USE(step_num);
+  NULL_USE(time);
+  NULL_USE(filename);
+#endif
+}
+
+}
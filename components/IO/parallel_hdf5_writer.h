@@ -0,0 +1,50 @@
+#ifndef COSMO_PARALLEL_HDF5_WRITER_H
+#define COSMO_PARALLEL_HDF5_WRITER_H
+
+#include "../../cosmo_includes.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief Writer putting the data of all ranks into a single HDF5 file with
+ *        collective MPI-IO
+ * @details Plot files contain one group level_<ln> per level with
+ *  - "patches": long long table [n_patches][8], lower[3], upper[3], owner
+ *    rank and offset of the first cell of the patch in the field datasets
+ *  - "geometry": double table [n_patches][6], x_lo[3] and dx[3] of the patch
+ *  - one 1D double dataset per field, holding the interior cells of all
+ *    patches one after another (x index fastest)
+ *  Datasets are chunked and, with HDF5 >= 1.10.2, optionally deflated.
+ *  Requires HDF5 built with parallel support.
+ */
+class ParallelHDF5Writer
+{
+ public:
+  ParallelHDF5Writer(idx_t chunk_size_in, idx_t compression_level_in);
+
+  void writePlot(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    const std::vector<std::string> & names,
+    const std::vector<idx_t> & idx,
+    idx_t step_num,
+    real_t time,
+    const std::string & filename);
+
+  void writeParticles(
+    const tbox::SAMRAI_MPI& mpi,
+    const std::string & name,
+    const std::vector<double> & data,
+    idx_t n_per_particle,
+    idx_t step_num,
+    real_t time,
+    const std::string & filename);
+
+ private:
+  idx_t chunk_size;         ///< maximal number of rows per chunk
+  idx_t compression_level;  ///< deflate level, 0 for no compression
+};
+
+}
+#endif
@@ -1,6 +1,7 @@
 #include "bssn.h"
 #include "../../cosmo_includes.h"
 #include "../../utils/math.h"
+#include "../statistic/hierarchy_reduction.h"
 
 
 using namespace SAMRAI;
@@ -8,6 +9,28 @@ using namespace SAMRAI;
 namespace cosmo
 {
 
+// Carpenter & Kennedy (1994) five-stage, fourth-order 2N-storage RK;
+// lsrk_C holds the stage times with the end of the step appended
+static const real_t lsrk_A[LSRK_N_STAGES] = {
+  0.0,
+  -567301805773.0/1357537059087.0,
+  -2404267990393.0/2016746695238.0,
+  -3550918686646.0/2091501179385.0,
+  -1275806237668.0/842570457699.0 };
+static const real_t lsrk_B[LSRK_N_STAGES] = {
+  1432997174477.0/9575080441755.0,
+  5161836677717.0/13612068292357.0,
+  1720146321549.0/2090206949498.0,
+  3134564353537.0/4481467310338.0,
+  2277821191437.0/14882151754819.0 };
+static const real_t lsrk_C[LSRK_N_STAGES + 1] = {
+  0.0,
+  1432997174477.0/9575080441755.0,
+  2526269341429.0/6820363962896.0,
+  2006345519317.0/3224310063776.0,
+  2802321613138.0/2924317926251.0,
+  1.0 };
+
 /**
  * @brief Constructor for BSSN class
  */
@@ -29,10 +52,38 @@ BSSN::BSSN(
   Z4c_K2_DAMPING_AMPLITUDE(cosmo_bssn_db->getDoubleWithDefault("z4c_k2", 0.0)),
   chi_lower_bd(cosmo_bssn_db->getDoubleWithDefault("chi_lower_bd", 0)),
   alpha_lower_bd_for_L2(cosmo_bssn_db->getDoubleWithDefault("alpha_lower_bd_for_L2", 0.3)),
-  K0(cosmo_bssn_db->getDoubleWithDefault("K0", 0))
+  K0(cosmo_bssn_db->getDoubleWithDefault("K0", 0)),
+  use_pencil_rhs(false),
+  rhs_pencil_length(cosmo_bssn_db->getIntegerWithDefault("rhs_pencil_length", 32)),
+  use_low_storage_rk(false),
+  lsrk_stage_A(0),
+  use_tiled_level(cosmo_bssn_db->getBoolWithDefault("tiled_level_executor", false)),
+  tile_size(cosmo_bssn_db->getIntegerWithDefault("tile_size", 16)),
+  fuse_rk_finalize(cosmo_bssn_db->getBoolWithDefault("fuse_rk_finalize", false)),
+  rotate_rk_registers(cosmo_bssn_db->getBoolWithDefault("rotate_rk_registers", false))
 {
   if(!USE_Z4C)
     Z4c_K1_DAMPING_AMPLITUDE = Z4c_K2_DAMPING_AMPLITUDE = 0;
+
+  std::string rhs_kernel =
+    cosmo_bssn_db->getStringWithDefault("rhs_kernel", "pointwise");
+  if(rhs_kernel == "pencil")
+    use_pencil_rhs = true;
+  else if(rhs_kernel != "pointwise")
+    TBOX_ERROR("Error: unknown BSSN rhs_kernel: `" << rhs_kernel << "`!\n");
+  if(rhs_pencil_length <= 0)
+    TBOX_ERROR("Error: BSSN rhs_pencil_length must be positive!\n");
+  if(tile_size <= 0)
+    TBOX_ERROR("Error: BSSN tile_size must be positive!\n");
+
+  std::string rk_scheme =
+    cosmo_bssn_db->getStringWithDefault("rk_scheme", "RK4");
+  if(rk_scheme == "LSRK4")
+    use_low_storage_rk = true;
+  else if(rk_scheme != "RK4")
+    TBOX_ERROR("Error: unknown BSSN rk_scheme: `" << rk_scheme << "`!\n");
+  if(use_low_storage_rk && rotate_rk_registers)
+    TBOX_ERROR("Error: rotate_rk_registers needs rk_scheme = \"RK4\"!\n");
   
   BSSN_APPLY_TO_FIELDS(VAR_INIT);
   BSSN_APPLY_TO_SOURCES(VAR_INIT);
@@ -56,6 +107,8 @@ BSSN::BSSN(
     variable_db->getContext("RK_K3"));
   std::shared_ptr<hier::VariableContext> context_k4(
     variable_db->getContext("RK_K4"));
+  std::shared_ptr<hier::VariableContext> context_spare(
+    variable_db->getContext("RK_SPARE"));
 #if USE_BACKUP_FIELDS
   std::shared_ptr<hier::VariableContext> context_b(
     variable_db->getContext("BACKUP"));
@@ -69,6 +122,8 @@ BSSN::BSSN(
   BSSN_APPLY_TO_FIELDS_ARGS(REG_TO_CONTEXT, context_k2, k2, GHOST_WIDTH);
   BSSN_APPLY_TO_FIELDS_ARGS(REG_TO_CONTEXT, context_k3, k3, GHOST_WIDTH);
   BSSN_APPLY_TO_FIELDS_ARGS(REG_TO_CONTEXT, context_k4, k4, GHOST_WIDTH);
+  // never allocated, only holds parked _p data with rotate_rk_registers
+  BSSN_APPLY_TO_FIELDS_ARGS(REG_TO_CONTEXT, context_spare, spare, GHOST_WIDTH);
 #if USE_BACKUP_FIELDS
   BSSN_APPLY_TO_FIELDS_ARGS(REG_TO_CONTEXT, context_b, b, GHOST_WIDTH);
 #endif
@@ -111,65 +166,74 @@ void BSSN::set_norm(
     {
       for(int i = lower[0]; i <= upper[0]; i++)
       {
-        // 1 - det(1 + DiffGamma)
-        if(normalize_gammaij)
-        {
-          real_t one_minus_det_gamma = -1.0*(
-            DIFFgamma11_a(i,j,k) + DIFFgamma22_a(i,j,k) + DIFFgamma33_a(i,j,k)
-            - pw2(DIFFgamma12_a(i,j,k)) - pw2(DIFFgamma13_a(i,j,k)) - pw2(DIFFgamma23_a(i,j,k))
-            + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k)
-            + DIFFgamma11_a(i,j,k)*DIFFgamma33_a(i,j,k)
-            + DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k)
-            - pw2(DIFFgamma23_a(i,j,k))*DIFFgamma11_a(i,j,k)
-            - pw2(DIFFgamma13_a(i,j,k))*DIFFgamma22_a(i,j,k)
-            - pw2(DIFFgamma12_a(i,j,k))*DIFFgamma33_a(i,j,k)
-            + 2.0*DIFFgamma12_a(i,j,k)*DIFFgamma13_a(i,j,k)*DIFFgamma23_a(i,j,k)
-            + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k)
-          );
-
-          // accurately compute 1 - det(g)^(1/3), without roundoff error
-          // = -( det(g)^(1/3) - 1 )
-          // = -( exp{log[det(g)^(1/3)]} - 1 )
-          // = -( expm1{log[det(g)]/3} )
-          // = -expm1{log1p[-one_minus_det_gamma]/3.0}
-          real_t one_minus_det_gamma_thirdpow = -1.0*expm1(log1p(-1.0*one_minus_det_gamma)/3.0);
-
-          // Perform the equivalent of re-scaling the conformal metric so det(gamma) = 1
-          // gamma -> gamma / det(gamma)^(1/3)
-          // DIFFgamma -> (delta + DiffGamma) / det(gamma)^(1/3) - delta
-          //            = ( DiffGamma + delta*[1 - det(gamma)^(1/3)] ) / ( 1 - [1 - det(1 + DiffGamma)^1/3] )
-          DIFFgamma11_a(i,j,k) = (DIFFgamma11_a(i,j,k) + one_minus_det_gamma_thirdpow) / (1.0 - one_minus_det_gamma_thirdpow);
-          DIFFgamma22_a(i,j,k) = (DIFFgamma22_a(i,j,k) + one_minus_det_gamma_thirdpow) / (1.0 - one_minus_det_gamma_thirdpow);
-          DIFFgamma33_a(i,j,k) = (DIFFgamma33_a(i,j,k) + one_minus_det_gamma_thirdpow) / (1.0 - one_minus_det_gamma_thirdpow);
-          DIFFgamma12_a(i,j,k) = (DIFFgamma12_a(i,j,k)) / (1.0 - one_minus_det_gamma_thirdpow);
-          DIFFgamma13_a(i,j,k) = (DIFFgamma13_a(i,j,k)) / (1.0 - one_minus_det_gamma_thirdpow);
-          DIFFgamma23_a(i,j,k) = (DIFFgamma23_a(i,j,k)) / (1.0 - one_minus_det_gamma_thirdpow);
-        }
-        if(normalize_Aij)
-        {
-          // re-scale A_ij / ensure it is trace-free
-          // need inverse gamma for finding Tr(A)
-          real_t gammai11 = 1.0 + DIFFgamma22_a(i,j,k) + DIFFgamma33_a(i,j,k) - pw2(DIFFgamma23_a(i,j,k)) + DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k);
-          real_t gammai22 = 1.0 + DIFFgamma11_a(i,j,k) + DIFFgamma33_a(i,j,k) - pw2(DIFFgamma13_a(i,j,k)) + DIFFgamma11_a(i,j,k)*DIFFgamma33_a(i,j,k);
-          real_t gammai33 = 1.0 + DIFFgamma11_a(i,j,k) + DIFFgamma22_a(i,j,k) - pw2(DIFFgamma12_a(i,j,k)) + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k);
-          real_t gammai12 = DIFFgamma13_a(i,j,k)*DIFFgamma23_a(i,j,k) - DIFFgamma12_a(i,j,k)*(1.0 + DIFFgamma33_a(i,j,k));
-          real_t gammai13 = DIFFgamma12_a(i,j,k)*DIFFgamma23_a(i,j,k) - DIFFgamma13_a(i,j,k)*(1.0 + DIFFgamma22_a(i,j,k));
-          real_t gammai23 = DIFFgamma12_a(i,j,k)*DIFFgamma13_a(i,j,k) - DIFFgamma23_a(i,j,k)*(1.0 + DIFFgamma11_a(i,j,k));
-          real_t trA = gammai11*A11_a(i,j,k) + gammai22*A22_a(i,j,k) + gammai33*A33_a(i,j,k)
-            + 2.0*(gammai12*A12_a(i,j,k) + gammai13*A13_a(i,j,k) + gammai23*A23_a(i,j,k));
-          // A_ij -> ( A_ij - 1/3 gamma_ij A )
-          A11_a(i,j,k) = ( A11_a(i,j,k) - 1.0/3.0*(1.0 + DIFFgamma11_a(i,j,k))*trA ) ;
-          A22_a(i,j,k) = ( A22_a(i,j,k) - 1.0/3.0*(1.0 + DIFFgamma22_a(i,j,k))*trA ) ;
-          A33_a(i,j,k) = ( A33_a(i,j,k) - 1.0/3.0*(1.0 + DIFFgamma33_a(i,j,k))*trA ) ;
-          A12_a(i,j,k) = ( A12_a(i,j,k) - 1.0/3.0*DIFFgamma12_a(i,j,k)*trA ) ;
-          A13_a(i,j,k) = ( A13_a(i,j,k) - 1.0/3.0*DIFFgamma13_a(i,j,k)*trA ) ;
-          A23_a(i,j,k) = ( A23_a(i,j,k) - 1.0/3.0*DIFFgamma23_a(i,j,k)*trA ) ;
-        }
+        set_norm_pt(i, j, k);
       }
     }
   }
 
 }
+/**
+ * @brief  normalize Aij or gammaij or both at a single point,
+ *         initPData() and initMDA() must have been called
+ */
+void BSSN::set_norm_pt(idx_t i, idx_t j, idx_t k)
+{
+  // 1 - det(1 + DiffGamma)
+  if(normalize_gammaij)
+  {
+    real_t one_minus_det_gamma = -1.0*(
+      DIFFgamma11_a(i,j,k) + DIFFgamma22_a(i,j,k) + DIFFgamma33_a(i,j,k)
+      - pw2(DIFFgamma12_a(i,j,k)) - pw2(DIFFgamma13_a(i,j,k)) - pw2(DIFFgamma23_a(i,j,k))
+      + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k)
+      + DIFFgamma11_a(i,j,k)*DIFFgamma33_a(i,j,k)
+      + DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k)
+      - pw2(DIFFgamma23_a(i,j,k))*DIFFgamma11_a(i,j,k)
+      - pw2(DIFFgamma13_a(i,j,k))*DIFFgamma22_a(i,j,k)
+      - pw2(DIFFgamma12_a(i,j,k))*DIFFgamma33_a(i,j,k)
+      + 2.0*DIFFgamma12_a(i,j,k)*DIFFgamma13_a(i,j,k)*DIFFgamma23_a(i,j,k)
+      + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k)
+    );
+
+    // accurately compute 1 - det(g)^(1/3), without roundoff error
+    // = -( det(g)^(1/3) - 1 )
+    // = -( exp{log[det(g)^(1/3)]} - 1 )
+    // = -( expm1{log[det(g)]/3} )
+    // = -expm1{log1p[-one_minus_det_gamma]/3.0}
+    real_t one_minus_det_gamma_thirdpow = -1.0*expm1(log1p(-1.0*one_minus_det_gamma)/3.0);
+
+    // Perform the equivalent of re-scaling the conformal metric so det(gamma) = 1
+    // gamma -> gamma / det(gamma)^(1/3)
+    // DIFFgamma -> (delta + DiffGamma) / det(gamma)^(1/3) - delta
+    //            = ( DiffGamma + delta*[1 - det(gamma)^(1/3)] ) / ( 1 - [1 - det(1 + DiffGamma)^1/3] )
+    DIFFgamma11_a(i,j,k) = (DIFFgamma11_a(i,j,k) + one_minus_det_gamma_thirdpow) / (1.0 - one_minus_det_gamma_thirdpow);
+    DIFFgamma22_a(i,j,k) = (DIFFgamma22_a(i,j,k) + one_minus_det_gamma_thirdpow) / (1.0 - one_minus_det_gamma_thirdpow);
+    DIFFgamma33_a(i,j,k) = (DIFFgamma33_a(i,j,k) + one_minus_det_gamma_thirdpow) / (1.0 - one_minus_det_gamma_thirdpow);
+    DIFFgamma12_a(i,j,k) = (DIFFgamma12_a(i,j,k)) / (1.0 - one_minus_det_gamma_thirdpow);
+    DIFFgamma13_a(i,j,k) = (DIFFgamma13_a(i,j,k)) / (1.0 - one_minus_det_gamma_thirdpow);
+    DIFFgamma23_a(i,j,k) = (DIFFgamma23_a(i,j,k)) / (1.0 - one_minus_det_gamma_thirdpow);
+  }
+  if(normalize_Aij)
+  {
+    // re-scale A_ij / ensure it is trace-free
+    // need inverse gamma for finding Tr(A)
+    real_t gammai11 = 1.0 + DIFFgamma22_a(i,j,k) + DIFFgamma33_a(i,j,k) - pw2(DIFFgamma23_a(i,j,k)) + DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k);
+    real_t gammai22 = 1.0 + DIFFgamma11_a(i,j,k) + DIFFgamma33_a(i,j,k) - pw2(DIFFgamma13_a(i,j,k)) + DIFFgamma11_a(i,j,k)*DIFFgamma33_a(i,j,k);
+    real_t gammai33 = 1.0 + DIFFgamma11_a(i,j,k) + DIFFgamma22_a(i,j,k) - pw2(DIFFgamma12_a(i,j,k)) + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k);
+    real_t gammai12 = DIFFgamma13_a(i,j,k)*DIFFgamma23_a(i,j,k) - DIFFgamma12_a(i,j,k)*(1.0 + DIFFgamma33_a(i,j,k));
+    real_t gammai13 = DIFFgamma12_a(i,j,k)*DIFFgamma23_a(i,j,k) - DIFFgamma13_a(i,j,k)*(1.0 + DIFFgamma22_a(i,j,k));
+    real_t gammai23 = DIFFgamma12_a(i,j,k)*DIFFgamma13_a(i,j,k) - DIFFgamma23_a(i,j,k)*(1.0 + DIFFgamma11_a(i,j,k));
+    real_t trA = gammai11*A11_a(i,j,k) + gammai22*A22_a(i,j,k) + gammai33*A33_a(i,j,k)
+      + 2.0*(gammai12*A12_a(i,j,k) + gammai13*A13_a(i,j,k) + gammai23*A23_a(i,j,k));
+    // A_ij -> ( A_ij - 1/3 gamma_ij A )
+    A11_a(i,j,k) = ( A11_a(i,j,k) - 1.0/3.0*(1.0 + DIFFgamma11_a(i,j,k))*trA ) ;
+    A22_a(i,j,k) = ( A22_a(i,j,k) - 1.0/3.0*(1.0 + DIFFgamma22_a(i,j,k))*trA ) ;
+    A33_a(i,j,k) = ( A33_a(i,j,k) - 1.0/3.0*(1.0 + DIFFgamma33_a(i,j,k))*trA ) ;
+    A12_a(i,j,k) = ( A12_a(i,j,k) - 1.0/3.0*DIFFgamma12_a(i,j,k)*trA ) ;
+    A13_a(i,j,k) = ( A13_a(i,j,k) - 1.0/3.0*DIFFgamma13_a(i,j,k)*trA ) ;
+    A23_a(i,j,k) = ( A23_a(i,j,k) - 1.0/3.0*DIFFgamma23_a(i,j,k)*trA ) ;
+  }
+}
+
 /**
  * @brief  normalize Aij or gammaij or both
  */
@@ -355,7 +419,15 @@ void BSSN::allocField(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t ln)
 {
   std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
-  BSSN_APPLY_TO_FIELDS(RK4_ARRAY_ALLOC);
+  // k1-k4 registers are only needed by the classical RK4
+  if(use_low_storage_rk)
+  {
+    BSSN_APPLY_TO_FIELDS(LSRK_ARRAY_ALLOC);
+  }
+  else
+  {
+    BSSN_APPLY_TO_FIELDS(RK4_ARRAY_ALLOC);
+  }
 }
 
 void BSSN::allocSrc(
@@ -385,7 +457,14 @@ void BSSN::clearField(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t ln)
 {
   math::HierarchyCellDataOpsReal<double> hcellmath(hierarchy, ln, ln);
-  BSSN_APPLY_TO_FIELDS_ARGS(RK4_ARRAY_ZERO, hcellmath);
+  if(use_low_storage_rk)
+  {
+    BSSN_APPLY_TO_FIELDS_ARGS(LSRK_ARRAY_ZERO, hcellmath);
+  }
+  else
+  {
+    BSSN_APPLY_TO_FIELDS_ARGS(RK4_ARRAY_ZERO, hcellmath);
+  }
 }
 
   
@@ -674,12 +753,6 @@ void BSSN::RKEvolvePatch(
   initPData(patch);
   initMDA(patch);
 
-  const hier::Box& box = patch->getBox();
-  
-  const int * lower = &box.lower()[0];
-  const int * upper = &box.upper()[0];
-
-  
   const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(  
     SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
       patch->getPatchGeometry()));
@@ -687,8 +760,70 @@ void BSSN::RKEvolvePatch(
   //initialize dx for each patch
   const real_t * dx = &(patch_geom->getDx())[0];
 
+  RKEvolveBox(patch->getBox(), dx, dt);
+}
+
+/**
+ * @brief RK evolve the cells of the patch that are within GHOST_WIDTH of
+ *        its border, i.e. all cells that ghost cells of other patches
+ *        are filled from
+ */
+void BSSN::RKEvolvePatchBorder(
+  const std::shared_ptr<hier::Patch> & patch, real_t dt)
+{
+  initPData(patch);
+  initMDA(patch);
+
+  const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+    SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+      patch->getPatchGeometry()));
+
+  const real_t * dx = &(patch_geom->getDx())[0];
+
+  hier::BoxContainer border_boxes(patch->getBox());
+  border_boxes.removeIntersections(getDeepInteriorBox(patch));
+
+  for(hier::BoxContainer::iterator bit(border_boxes.begin());
+      bit != border_boxes.end(); ++bit)
+  {
+    RKEvolveBox(*bit, dx, dt);
+  }
+}
+
+/**
+ * @brief get the part of the patch interior that no ghost cell of other
+ *        patches is filled from
+ */
+hier::Box BSSN::getDeepInteriorBox(
+  const std::shared_ptr<hier::Patch> & patch)
+{
+  hier::Box deep_box(patch->getBox());
+  deep_box.grow(hier::IntVector(dim, -GHOST_WIDTH));
+  return deep_box;
+}
+
+/**
+ * @brief RK evolve cells in box, initPData() and initMDA() must have been
+ *        called for the patch containing it
+ *
+ * @param box part of patch interior
+ * @param dx grid spacing
+ * @param dt time step
+ */
+void BSSN::RKEvolveBox(
+  const hier::Box & box, const real_t dx[], real_t dt)
+{
+  if(box.empty()) return;
+
+  if(use_pencil_rhs)
+  {
+    RKEvolveBoxPencil(box, dx, dt);
+    return;
+  }
+
+  const int * lower = &box.lower()[0];
+  const int * upper = &box.upper()[0];
 
-  bool flag = 0;
 #pragma omp parallel for collapse(2)
   for(int k = lower[2]; k <= upper[2]; k++)
   {
@@ -698,6 +833,7 @@ void BSSN::RKEvolvePatch(
       {
         BSSNData bd = {0};
         set_bd_values(i, j, k, &bd, dx);
+        calculate_advection_dissipation(&bd, dx);
         BSSN_RK_EVOLVE_PT;
       }
     }
@@ -747,6 +883,7 @@ void BSSN::RKEvolvePt(
   idx_t i, idx_t j, idx_t k, BSSNData &bd, const real_t dx[], real_t dt)
 {
   set_bd_values(i, j, k, &bd, dx);
+  calculate_advection_dissipation(&bd, dx);
   BSSN_RK_EVOLVE_PT;
 #if USE_DUST_FLUID
   bd.dchidt = DIFFchi_s(bd.i, bd.j, bd.k) / dt;
@@ -1004,6 +1141,203 @@ void BSSN::prepareForK4(
   }
 }  
 
+/**
+ * @brief calculate the n-th RK4 increment on coarser level for a finer
+ *        step from "from_t" to "to_t" of arbitrary length, using the dense
+ *        output of the coarser step
+ *
+ * @param level coarser level
+ * @param n RK4 stage (1-4)
+ * @param from_t starting time of the finer step
+ * @param to_t ending time of the finer step
+ */
+void BSSN::prepareForK(
+  const std::shared_ptr<hier::PatchLevel> & level,
+  int n, real_t from_t, real_t to_t)
+{
+  if(level == NULL) return;
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+    initPData(patch);
+    initMDA(patch);
+
+    const hier::Box& box = patch->getBox();
+
+    const int * lower = &box.lower()[0];
+    const int * upper = &box.upper()[0];
+
+    real_t coarse_from_t = patch->getPatchData(DIFFchi_p_idx)->getTime();
+    real_t coarse_dt = patch->getPatchData(DIFFchi_a_idx)->getTime()
+      - coarse_from_t;
+
+    if(coarse_dt < EPS)
+      TBOX_ERROR("Coarser level has not been advanced, check your code!");
+
+    real_t theta = (from_t - coarse_from_t) / coarse_dt;
+    real_t h = (to_t - from_t) / coarse_dt;
+
+    if(theta < -EPS || theta + h > 1.0 + EPS)
+      TBOX_ERROR("Current step is not covered by the step of its father, check your code!");
+
+#pragma omp parallel for collapse(2)
+    for(int k = lower[2]; k <= upper[2]; k++)
+    {
+      for(int j = lower[1]; j <= upper[1]; j++)
+      {
+        for(int i = lower[0]; i <= upper[0]; i++)
+        {
+          switch(n)
+          {
+            case 1:
+              BSSN_APPLY_TO_FIELDS_ARGS(RK4_INIT_K1, theta, h);
+              break;
+            case 2:
+              BSSN_APPLY_TO_FIELDS_ARGS(RK4_INIT_K2, theta, h);
+              break;
+            case 3:
+              BSSN_APPLY_TO_FIELDS_ARGS(RK4_INIT_K3, theta, h);
+              break;
+            default:
+              BSSN_APPLY_TO_FIELDS_ARGS(RK4_INIT_K4, theta, h);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief set the coefficient for accumulating the previous increment
+ *        in _s during the given low-storage RK stage
+ */
+void BSSN::setLSRKStage(int stage)
+{
+  lsrk_stage_A = lsrk_A[stage];
+}
+
+/**
+ * @brief calculate the increment of the given low-storage RK stage on
+ *        coarser level, so that after finalizing the stage the ghost cells
+ *        of the finer level hold the coarse solution interpolated linearly
+ *        to the end of that stage
+ *
+ * @param level coarser level
+ * @param stage stage number
+ * @param dt time step of the finer level
+ */
+void BSSN::prepareForLSRKStage(
+  const std::shared_ptr<hier::PatchLevel> & level,
+  int stage, real_t dt)
+{
+  if(level == NULL) return;
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+    initPData(patch);
+    initMDA(patch);
+
+    const hier::Box& box = patch->getBox();
+
+    const int * lower = &box.lower()[0];
+    const int * upper = &box.upper()[0];
+
+    real_t coarse_dt = patch->getPatchData(DIFFchi_a_idx)->getTime()
+      - patch->getPatchData(DIFFchi_p_idx)->getTime();
+
+    if(coarse_dt < EPS)
+      TBOX_ERROR("Coarser level has not been advanced, check your code!");
+
+    real_t coef = (lsrk_C[stage + 1] - lsrk_C[stage])
+      / lsrk_B[stage] * dt / coarse_dt;
+
+#pragma omp parallel for collapse(2)
+    for(int k = lower[2]; k <= upper[2]; k++)
+    {
+      for(int j = lower[1]; j <= upper[1]; j++)
+      {
+        for(int i = lower[0]; i <= upper[0]; i++)
+        {
+          BSSN_APPLY_TO_FIELDS_ARGS(LSRK_INIT_FIELD, coef);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief get the maximal characteristic speed (in coordinate units) on
+ *        the level, bounding light, 1+log lapse and Gamma-driver speeds
+ *        by |beta^i| + sqrt(gammai^ii) * max(alpha sqrt(chi), sqrt(2 alpha chi), 1)
+ *
+ * @param level
+ */
+real_t BSSN::maxCharacteristicSpeed(
+  const std::shared_ptr<hier::PatchLevel> & level)
+{
+  real_t max_v = 0;
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+    initPData(patch);
+    initMDA(patch);
+
+    const hier::Box& box = patch->getBox();
+
+    const int * lower = &box.lower()[0];
+    const int * upper = &box.upper()[0];
+
+#pragma omp parallel for collapse(2) reduction(max : max_v)
+    for(int k = lower[2]; k <= upper[2]; k++)
+    {
+      for(int j = lower[1]; j <= upper[1]; j++)
+      {
+        for(int i = lower[0]; i <= upper[0]; i++)
+        {
+          real_t chi = tbox::MathUtilities<real_t>::Max(
+            DIFFchi_a(i,j,k) + 1.0, chi_lower_bd);
+          real_t alpha = tbox::MathUtilities<real_t>::Max(
+            DIFFalpha_a(i,j,k) + 1.0, 0.0);
+
+          real_t c = tbox::MathUtilities<real_t>::Max(
+            alpha * sqrt(chi), sqrt(2.0 * alpha * chi));
+#if USE_GAMMA_DRIVER
+          c = tbox::MathUtilities<real_t>::Max(c, 1.0);
+#endif
+          real_t gammai11 = 1.0 + DIFFgamma22_a(i,j,k) + DIFFgamma33_a(i,j,k) - pw2(DIFFgamma23_a(i,j,k)) + DIFFgamma22_a(i,j,k)*DIFFgamma33_a(i,j,k);
+          real_t gammai22 = 1.0 + DIFFgamma11_a(i,j,k) + DIFFgamma33_a(i,j,k) - pw2(DIFFgamma13_a(i,j,k)) + DIFFgamma11_a(i,j,k)*DIFFgamma33_a(i,j,k);
+          real_t gammai33 = 1.0 + DIFFgamma11_a(i,j,k) + DIFFgamma22_a(i,j,k) - pw2(DIFFgamma12_a(i,j,k)) + DIFFgamma11_a(i,j,k)*DIFFgamma22_a(i,j,k);
+
+          real_t v1 = c * sqrt(tbox::MathUtilities<real_t>::Abs(gammai11));
+          real_t v2 = c * sqrt(tbox::MathUtilities<real_t>::Abs(gammai22));
+          real_t v3 = c * sqrt(tbox::MathUtilities<real_t>::Abs(gammai33));
+#if USE_BSSN_SHIFT
+          v1 += tbox::MathUtilities<real_t>::Abs(beta1_a(i,j,k));
+          v2 += tbox::MathUtilities<real_t>::Abs(beta2_a(i,j,k));
+          v3 += tbox::MathUtilities<real_t>::Abs(beta3_a(i,j,k));
+#endif
+          max_v = tbox::MathUtilities<real_t>::Max(
+            max_v, tbox::MathUtilities<real_t>::Max(
+              v1, tbox::MathUtilities<real_t>::Max(v2, v3)));
+        }
+      }
+    }
+  }
+
+  const tbox::SAMRAI_MPI& mpi(level->getBoxLevel()->getMPI());
+  if (mpi.getSize() > 1) {
+    mpi.AllReduce(&max_v, 1, MPI_MAX);
+  }
+
+  return max_v;
+}
+
 /**
  * @brief register "active" component of the fields to refiner
  * 
@@ -1032,6 +1366,21 @@ void BSSN::registerRKRefiner(
 }
 
 
+/**
+ * @brief register "scratch" component of the fields to refiner, leaving
+ *  the interpolation of all of them to one fused refine strategy
+ * 
+ * @param refiner
+ * @param fused_strategy strategy the schedules must be created with
+ */
+void BSSN::registerRKRefinerFused(
+  xfer::RefineAlgorithm& refiner,
+  geom::CartesianCellDoubleFusedRefineStrategy& fused_strategy)
+{
+  BSSN_APPLY_TO_FIELDS_ARGS(REGISTER_SPACE_REFINE_S_FUSED, refiner, fused_strategy);
+}
+
+
 /**
  * @brief register "active" component of the fields to coarsener 
  * 
@@ -1045,6 +1394,20 @@ void BSSN::registerCoarsenActive(
   BSSN_APPLY_TO_FIELDS_ARGS(REGISTER_COARSEN_A, coarsener, coarsen_op);
 }
 
+/**
+ * @brief register "active" component of the fields to coarsener, leaving
+ *  the restriction of all of them to one fused coarsen strategy
+ * 
+ * @param coarsener
+ * @param fused_strategy strategy the schedules must be created with
+ */
+void BSSN::registerCoarsenActiveFused(
+  xfer::CoarsenAlgorithm& coarsener,
+  geom::CartesianCellDoubleFusedCoarsenStrategy& fused_strategy)
+{
+  BSSN_APPLY_TO_FIELDS_ARGS(REGISTER_COARSEN_A_FUSED, coarsener, fused_strategy);
+}
+
 
 
 
@@ -1059,6 +1422,68 @@ void BSSN::copyAToP(
   BSSN_APPLY_TO_FIELDS(COPY_A_TO_P);
 }
 
+/**
+ * @brief normalize and copy active component to previous component of all
+ *        BSSN fields in one sweep, same result as set_norm() followed
+ *        by copyAToP()
+ */
+void BSSN::normalizeAndCopyAToP(
+  const std::shared_ptr<hier::PatchLevel>& level)
+{
+  const bool need_norm = (normalize_Aij || normalize_gammaij);
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+    initPData(patch);
+    initMDA(patch);
+
+    const hier::Box& box = DIFFchi_a_pdata->getGhostBox();
+
+    const int * lower = &box.lower()[0];
+    const int * upper = &box.upper()[0];
+
+#pragma omp parallel for collapse(2)
+    for(int k = lower[2]; k <= upper[2]; k++)
+    {
+      for(int j = lower[1]; j <= upper[1]; j++)
+      {
+        for(int i = lower[0]; i <= upper[0]; i++)
+        {
+          if(need_norm) set_norm_pt(i, j, k);
+          BSSN_APPLY_TO_FIELDS(COPY_A_TO_P_PT);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief make _p the active component of all BSSN fields without copying,
+ *        _p and _a share the same patch data until detachAFromP()
+ */
+void BSSN::rotateAToP(
+  const std::shared_ptr<hier::PatchLevel>& level)
+{
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+    BSSN_APPLY_TO_FIELDS(ROTATE_A_TO_P);
+  }
+}
+
+/**
+ * @brief give _a its own patch data back after rotateAToP(), the content
+ *        is stale and has to be overwritten (K1 finalize does)
+ */
+void BSSN::detachAFromP(
+  const std::shared_ptr<hier::Patch>& patch)
+{
+  BSSN_APPLY_TO_FIELDS(DETACH_A_FROM_P);
+}
+
 #if USE_BACKUP_FIELDS
 
 void BSSN::copyPToB(
@@ -1090,7 +1515,14 @@ void BSSN::copyBToA(
 void BSSN::initPData(
   const std::shared_ptr<hier::Patch> & patch)
 {
-  BSSN_APPLY_TO_FIELDS(PDATA_ALL_INIT);
+  if(use_low_storage_rk)
+  {
+    BSSN_APPLY_TO_FIELDS(LSRK_PDATA_ALL_INIT);
+  }
+  else
+  {
+    BSSN_APPLY_TO_FIELDS(PDATA_ALL_INIT);
+  }
   BSSN_APPLY_TO_SOURCES_ARGS(PDATA_INIT, a);
   BSSN_APPLY_TO_GEN1_EXTRAS_ARGS(PDATA_INIT, a);
 }
@@ -1103,7 +1535,14 @@ void BSSN::initPData(
 void BSSN::initMDA(
   const std::shared_ptr<hier::Patch> & patch)
 {
-  BSSN_APPLY_TO_FIELDS(MDA_ACCESS_ALL_INIT);
+  if(use_low_storage_rk)
+  {
+    BSSN_APPLY_TO_FIELDS(LSRK_MDA_ACCESS_ALL_INIT);
+  }
+  else
+  {
+    BSSN_APPLY_TO_FIELDS(MDA_ACCESS_ALL_INIT);
+  }
 
   BSSN_APPLY_TO_SOURCES_ARGS(MDA_ACCESS_INIT, a);
   
@@ -1119,6 +1558,17 @@ void BSSN::setLevelTime(
   double from_t, double to_t)
 {
   BSSN_APPLY_TO_FIELDS_ARGS(SET_LEVEL_TIME, from_t, to_t);
+
+  // parked data becomes _a at the K1 finalize
+  if(rotate_rk_registers)
+  {
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+      BSSN_APPLY_TO_FIELDS_ARGS(SET_SPARE_TIME, to_t);
+    }
+  }
 }
 
 /**
@@ -1128,6 +1578,9 @@ void BSSN::setLevelTime(
 void BSSN::K1FinalizePatch(
   const std::shared_ptr<hier::Patch> & patch)
 {
+  if(rotate_rk_registers)
+    detachAFromP(patch);
+
   initPData(patch);
   initMDA(patch);
   
@@ -1136,6 +1589,10 @@ void BSSN::K1FinalizePatch(
   const int * lower = &box.lower()[0];
   const int * upper = &box.upper()[0];
 
+  // normalize in the same sweep instead of a separate set_norm pass
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
     #pragma omp parallel for collapse(2)
   for(int k = lower[2]; k <= upper[2]; k++)
   {
@@ -1144,6 +1601,7 @@ void BSSN::K1FinalizePatch(
       for(int i = lower[0]; i <= upper[0]; i++)
       {
         BSSN_FINALIZE_K(1);
+        if(fuse_norm) set_norm_pt(i, j, k);
       }
     }
   }
@@ -1160,6 +1618,9 @@ void BSSN::K2FinalizePatch(
   const int * lower = &box.lower()[0];
   const int * upper = &box.upper()[0];
 
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
   #pragma omp parallel for collapse(2)  
   for(int k = lower[2]; k <= upper[2]; k++)
   {
@@ -1168,6 +1629,7 @@ void BSSN::K2FinalizePatch(
       for(int i = lower[0]; i <= upper[0]; i++)
       {
         BSSN_FINALIZE_K(2);
+        if(fuse_norm) set_norm_pt(i, j, k);
       }
     }
   }
@@ -1185,6 +1647,9 @@ void BSSN::K3FinalizePatch(
   const int * lower = &box.lower()[0];
   const int * upper = &box.upper()[0];
 
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
     #pragma omp parallel for collapse(2)
   for(int k = lower[2]; k <= upper[2]; k++)
   {
@@ -1193,6 +1658,7 @@ void BSSN::K3FinalizePatch(
       for(int i = lower[0]; i <= upper[0]; i++)
       {
         BSSN_FINALIZE_K(3);
+        if(fuse_norm) set_norm_pt(i, j, k);
       }
     }
   }
@@ -1212,6 +1678,9 @@ void BSSN::K4FinalizePatch(
   const int * lower = &box.lower()[0];
   const int * upper = &box.upper()[0];
 
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
   const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
     SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
       patch->getPatchGeometry()));
@@ -1226,6 +1695,7 @@ void BSSN::K4FinalizePatch(
       for(int i = lower[0]; i <= upper[0]; i++)
       {
         BSSN_FINALIZE_K(4);
+        if(fuse_norm) set_norm_pt(i, j, k);
       }
     }
   }
@@ -1244,6 +1714,9 @@ void BSSN::K4FinalizePatch(
   const int * lower = &box.lower()[0];
   const int * upper = &box.upper()[0];
 
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
   #pragma omp parallel for collapse(2)  
   for(int k = lower[2]; k <= upper[2]; k++)
   {
@@ -1252,12 +1725,103 @@ void BSSN::K4FinalizePatch(
       for(int i = lower[0]; i <= upper[0]; i++)
       {
         BSSN_FINALIZE_K(4);
+        if(fuse_norm) set_norm_pt(i, j, k);
+      }
+    }
+  }
+}
+
+
+
+/**
+ * @brief  finalize one low-storage RK stage on both interior and boundary
+ *
+ */
+void BSSN::LSRKFinalizePatch(
+  const std::shared_ptr<hier::Patch> & patch, int stage)
+{
+  initPData(patch);
+  initMDA(patch);
+
+  const hier::Box& box = DIFFchi_a_pdata->getGhostBox();
+
+  const int * lower = &box.lower()[0];
+  const int * upper = &box.upper()[0];
+
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
+  const real_t B = lsrk_B[stage];
+
+  #pragma omp parallel for collapse(2)
+  for(int k = lower[2]; k <= upper[2]; k++)
+  {
+    for(int j = lower[1]; j <= upper[1]; j++)
+    {
+      for(int i = lower[0]; i <= upper[0]; i++)
+      {
+        BSSN_FINALIZE_LSRK(B);
+        if(fuse_norm) set_norm_pt(i, j, k);
       }
     }
   }
 }
 
+/**
+ * @brief finalize kn step for RK on cells in box (no threading),
+ *        initPData() and initMDA() must have been called
+ */
+void BSSN::KFinalizeBox(const hier::Box & box, int n)
+{
+  const int * lower = &box.lower()[0];
+  const int * upper = &box.upper()[0];
+
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
+#define BSSN_K_FINALIZE_BOX_LOOP(n)                     \
+  for(int k = lower[2]; k <= upper[2]; k++)             \
+    for(int j = lower[1]; j <= upper[1]; j++)           \
+      for(int i = lower[0]; i <= upper[0]; i++)         \
+      {                                                 \
+        BSSN_FINALIZE_K(n);                             \
+        if(fuse_norm) set_norm_pt(i, j, k);             \
+      }
+
+  switch(n)
+  {
+    case 1: BSSN_K_FINALIZE_BOX_LOOP(1); break;
+    case 2: BSSN_K_FINALIZE_BOX_LOOP(2); break;
+    case 3: BSSN_K_FINALIZE_BOX_LOOP(3); break;
+    case 4: BSSN_K_FINALIZE_BOX_LOOP(4); break;
+    default:
+      TBOX_ERROR("Error: unknown RK4 stage " << n << "!\n");
+  }
 
+#undef BSSN_K_FINALIZE_BOX_LOOP
+}
+
+/**
+ * @brief finalize one low-storage RK stage on cells in box (no threading),
+ *        initPData() and initMDA() must have been called
+ */
+void BSSN::LSRKFinalizeBox(const hier::Box & box, int stage)
+{
+  const int * lower = &box.lower()[0];
+  const int * upper = &box.upper()[0];
+
+  const real_t B = lsrk_B[stage];
+  const bool fuse_norm =
+    fuse_rk_finalize && (normalize_Aij || normalize_gammaij);
+
+  for(int k = lower[2]; k <= upper[2]; k++)
+    for(int j = lower[1]; j <= upper[1]; j++)
+      for(int i = lower[0]; i <= upper[0]; i++)
+      {
+        BSSN_FINALIZE_LSRK(B);
+        if(fuse_norm) set_norm_pt(i, j, k);
+      }
+}
 
 /*
 ******************************************************************************
@@ -1358,16 +1922,20 @@ void BSSN::set_bd_values_for_dust_fluid(idx_t i, idx_t j, idx_t k, BSSNData *bd,
 
 
 #if USE_COSMOTRACE
-void BSSN::set_bd_values_for_ray_tracing(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[])
+void BSSN::set_bd_values_for_ray_tracing(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[],
+                                         bool check_stencil)
 {
-  for(int si = -2; si <= 2; si++)
-    for(int sj = -2; sj <= 2; sj++)
-      for(int sk = -2; sk <= 2; sk++)
-      {
-        hier::Index temp_idx(i+si, j+sj, k+sk);
-        if(DIFFchi_a_pdata->getGhostBox().contains(temp_idx) == false)
-          TBOX_ERROR("EEEEEEEEEEEEEEEEEEEE\n");
-      }
+  if(check_stencil)
+  {
+    for(int si = -2; si <= 2; si++)
+      for(int sj = -2; sj <= 2; sj++)
+        for(int sk = -2; sk <= 2; sk++)
+        {
+          hier::Index temp_idx(i+si, j+sj, k+sk);
+          if(DIFFchi_a_pdata->getGhostBox().contains(temp_idx) == false)
+            TBOX_ERROR("EEEEEEEEEEEEEEEEEEEE\n");
+        }
+  }
   bd->i = i;
   bd->j = j;
   bd->k = k;
@@ -1407,6 +1975,42 @@ void BSSN::set_bd_values_for_ray_tracing(idx_t i, idx_t j, idx_t k, BSSNData *bd
  * @param bd BSSNData struct to populate
  */
 void BSSN::set_bd_values(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[])
+{
+  set_bd_pointwise_values(i, j, k, bd, dx);
+
+  // pre-compute re-used quantities
+  // gammas & derivs first
+  calculate_dgamma(bd,dx);
+  calculate_ddgamma(bd,dx);
+  calculate_dalpha_dchi(bd,dx);
+  calculate_ddalpha(bd,dx);
+  calculate_dK(bd,dx);
+  calculate_dGamma(bd,dx);
+# if USE_BSSN_SHIFT
+  calculate_dbeta(bd,dx);
+  calculate_ddbeta(bd,dx);
+# endif
+# if USE_Z4C
+  calculate_dtheta(bd,dx);
+# endif
+
+  // #if USE_EXPANSION
+  // calculate_dexpN(bd,dx);
+  // #endif
+
+  set_bd_derived_values(bd,dx);
+}
+
+/**
+ * @brief Populate the BSSNData values that only need field values at
+ * (i, j, k), no finite differencing
+ *
+ * @param i x-index
+ * @param j y-index
+ * @param k z-index
+ * @param bd BSSNData struct to populate
+ */
+void BSSN::set_bd_pointwise_values(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[])
 {
   bd->i = i;
   bd->j = j;
@@ -1440,21 +2044,18 @@ void BSSN::set_bd_values(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t d
   bd->r        =   bd->DIFFr + bd->rho_FRW;
   bd->S        =   bd->DIFFS + bd->S_FRW;
   bd->alpha    =   bd->DIFFalpha + 1.0;
-  
-  // pre-compute re-used quantities
-  // gammas & derivs first
+
   calculate_Acont(bd,dx);
-  calculate_dgamma(bd,dx);
-  calculate_ddgamma(bd,dx);
-  calculate_dalpha_dchi(bd,dx);
-  calculate_dK(bd,dx);
-# if USE_BSSN_SHIFT
-  calculate_dbeta(bd,dx);
-# endif
+}
 
-  // #if USE_EXPANSION
-  // calculate_dexpN(bd,dx);
-  // #endif
+/**
+ * @brief Compute the quantities that depend on already-stored partial
+ * derivatives (christoffels, covariant derivatives, Ricci)
+ *
+ * @param bd BSSNData struct with local values and partial derivatives set
+ */
+void BSSN::set_bd_derived_values(BSSNData *bd, const real_t dx[])
+{
   // Christoffels depend on metric & derivs.
   calculate_conformal_christoffels(bd,dx);
   // DDw depend on christoffels, metric, and derivs
@@ -1463,10 +2064,6 @@ void BSSN::set_bd_values(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t d
   // Ricci depends on DDchi
   calculateRicciTF(bd,dx);
 
-# if USE_Z4C
-  calculate_dtheta(bd,dx);
-# endif
-
   if(bd->chi < chi_lower_bd) bd->chi = chi_lower_bd;
 }
 
@@ -1571,6 +2168,30 @@ void BSSN::calculate_dalpha_dchi(BSSNData *bd, const real_t dx[])
   bd->d3a = derivative(bd->i, bd->j, bd->k, 3, DIFFalpha_a, dx);
 }
 
+/**
+ * @brief Compute second partial derivatives of the lapse, store in a
+ * BSSNData instance
+ *
+ * @param bd BSSNData struct reference
+ */
+void BSSN::calculate_ddalpha(BSSNData *bd, const real_t dx[])
+{
+  BSSN_APPLY_TO_IJ_PERMS(BSSN_CALCULATE_DIDJALPHA_PARTIAL)
+}
+
+/**
+ * @brief Compute partial derivatives of the evolved christoffel contraction
+ * \f$\bar{\Gamma}^i\f$, store in a BSSNData instance
+ *
+ * @param bd BSSNData struct reference
+ */
+void BSSN::calculate_dGamma(BSSNData *bd, const real_t dx[])
+{
+  BSSN_CALCULATE_DGAMMAI(1);
+  BSSN_CALCULATE_DGAMMAI(2);
+  BSSN_CALCULATE_DGAMMAI(3);
+}
+
 /**
  * @brief Compute partial derivatives of the trace of the extrinsic curvature,
  * store in a BSSNData instance
@@ -1610,6 +2231,28 @@ void BSSN::calculate_dbeta(BSSNData *bd, const real_t dx[])
 }
 #endif
 
+#if USE_BSSN_SHIFT
+void BSSN::calculate_ddbeta(BSSNData *bd, const real_t dx[])
+{
+  BSSN_APPLY_TO_IJ_PERMS(BSSN_CALCULATE_DIDJBETA)
+}
+#endif
+
+/**
+ * @brief Compute the upwinded advection and Kreiss-Oliger dissipation terms
+ * of the evolved fields, store in a BSSNData instance
+ * @details Only needed when evaluating the RHS (ev_* functions).
+ *
+ * @param bd BSSNData struct reference, with shift already set
+ */
+void BSSN::calculate_advection_dissipation(BSSNData *bd, const real_t dx[])
+{
+# if USE_BSSN_SHIFT
+  BSSN_APPLY_TO_ADVECTED_FIELDS(BSSN_CALCULATE_ADVECTION)
+# endif
+  BSSN_APPLY_TO_DISSIPATED_FIELDS(BSSN_CALCULATE_DISSIPATION)
+}
+
 // #if USE_EXPANSION
 // void BSSN::calculate_dexpN(BSSNData *bd, const real_t dx[])
 // {
@@ -1753,23 +2396,23 @@ Evolution equation calculations
 ******************************************************************************
 */
 
-real_t BSSN::ev_DIFFgamma11(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(1, 1)  - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma11_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma12(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(1, 2)  - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma12_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma13(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(1, 3)  - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma13_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma22(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(2, 2)  - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma22_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma23(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(2, 3)  - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma23_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma33(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(3, 3)  - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma33_a, dx, KO_damping_coefficient); }
+real_t BSSN::ev_DIFFgamma11(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(1, 1)  - bd->DIFFgamma11_KO; }
+real_t BSSN::ev_DIFFgamma12(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(1, 2)  - bd->DIFFgamma12_KO; }
+real_t BSSN::ev_DIFFgamma13(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(1, 3)  - bd->DIFFgamma13_KO; }
+real_t BSSN::ev_DIFFgamma22(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(2, 2)  - bd->DIFFgamma22_KO; }
+real_t BSSN::ev_DIFFgamma23(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(2, 3)  - bd->DIFFgamma23_KO; }
+real_t BSSN::ev_DIFFgamma33(BSSNData *bd, const real_t dx[]) { return BSSN_DT_DIFFGAMMAIJ(3, 3)  - bd->DIFFgamma33_KO; }
 
-real_t BSSN::ev_A11(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(1, 1) - KO_dissipation_Q(bd->i, bd->j, bd->k, A11_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_A12(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(1, 2) - KO_dissipation_Q(bd->i, bd->j, bd->k, A12_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_A13(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(1, 3) - KO_dissipation_Q(bd->i, bd->j, bd->k, A13_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_A22(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(2, 2) - KO_dissipation_Q(bd->i, bd->j, bd->k, A22_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_A23(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(2, 3) - KO_dissipation_Q(bd->i, bd->j, bd->k, A23_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_A33(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(3, 3) - KO_dissipation_Q(bd->i, bd->j, bd->k, A33_a, dx, KO_damping_coefficient); }
+real_t BSSN::ev_A11(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(1, 1) - bd->A11_KO; }
+real_t BSSN::ev_A12(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(1, 2) - bd->A12_KO; }
+real_t BSSN::ev_A13(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(1, 3) - bd->A13_KO; }
+real_t BSSN::ev_A22(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(2, 2) - bd->A22_KO; }
+real_t BSSN::ev_A23(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(2, 3) - bd->A23_KO; }
+real_t BSSN::ev_A33(BSSNData *bd, const real_t dx[]) { return BSSN_DT_AIJ(3, 3) - bd->A33_KO; }
 
-real_t BSSN::ev_Gamma1(BSSNData *bd, const real_t dx[]) { return BSSN_DT_GAMMAI(1) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma1_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_Gamma2(BSSNData *bd, const real_t dx[]) { return BSSN_DT_GAMMAI(2) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma2_a, dx, KO_damping_coefficient); }
-real_t BSSN::ev_Gamma3(BSSNData *bd, const real_t dx[]) { return BSSN_DT_GAMMAI(3) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma3_a, dx, KO_damping_coefficient); }
+real_t BSSN::ev_Gamma1(BSSNData *bd, const real_t dx[]) { return BSSN_DT_GAMMAI(1) - bd->Gamma1_KO; }
+real_t BSSN::ev_Gamma2(BSSNData *bd, const real_t dx[]) { return BSSN_DT_GAMMAI(2) - bd->Gamma2_KO; }
+real_t BSSN::ev_Gamma3(BSSNData *bd, const real_t dx[]) { return BSSN_DT_GAMMAI(3) - bd->Gamma3_KO; }
 
 
 real_t BSSN::ev_DIFFK(BSSNData *bd, const real_t dx[])
@@ -1789,12 +2432,10 @@ real_t BSSN::ev_DIFFK(BSSNData *bd, const real_t dx[])
     )
     + 4.0*PI*bd->alpha*(bd->r + bd->S)
 #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFK_a, dx, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFK_a, dx, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFK_a, dx, bd->beta3)
+    + bd->DIFFK_adv
 #endif
     - bd->alpha*Z4c_K1_DAMPING_AMPLITUDE*(1.0 - Z4c_K2_DAMPING_AMPLITUDE)*bd->theta
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFK_a, dx, KO_damping_coefficient)
+    - bd->DIFFK_KO
   );
 }
 
@@ -1809,11 +2450,9 @@ real_t BSSN::ev_DIFFchi(BSSNData *bd, const real_t dx[])
       #endif
     )
     #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFchi_a, dx, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFchi_a, dx, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFchi_a, dx, bd->beta3)
+    + bd->DIFFchi_adv
     #endif
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFchi_a, dx, KO_damping_coefficient)
+    - bd->DIFFchi_KO
   );
 }
 
@@ -1821,11 +2460,9 @@ real_t BSSN::ev_DIFFalpha(BSSNData *bd, const real_t dx[])
 {
   return gaugeHandler->ev_lapse(bd)
     #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFalpha_a, dx, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFalpha_a, dx, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFalpha_a, dx, bd->beta3)
+    + bd->DIFFalpha_adv
     #endif
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFalpha_a, dx, KO_damping_coefficient);
+    - bd->DIFFalpha_KO;
 }
 
 
@@ -1837,12 +2474,10 @@ real_t BSSN::ev_theta(BSSNData *bd, const real_t dx[])
       bd->ricci + 2.0/3.0*pw2(bd->K + 2.0 * bd->theta)
       - bd->AijAij - 16.0*PI* bd->r)
     #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, theta_a, dx, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, theta_a, dx, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, theta_a, dx, bd->beta3)
+    + bd->theta_adv
     #endif
     - bd->alpha*Z4c_K1_DAMPING_AMPLITUDE*(2.0 + Z4c_K2_DAMPING_AMPLITUDE)*bd->theta
-  ) - KO_dissipation_Q(bd->i, bd->j, bd->k, theta_a, dx, KO_damping_coefficient);
+  ) - bd->theta_KO;
   #endif
   return 0;
 }
@@ -1855,7 +2490,7 @@ real_t BSSN::ev_beta1(BSSNData *bd, const real_t dx[])
     //+ upwind_derivative(bd->i, bd->j, bd->k, 1, beta1_a, dx, bd->beta1)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 2, beta1_a, dx, bd->beta2)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 3, beta1_a, dx, bd->beta3)
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta1_a, dx, KO_damping_coefficient);
+    - bd->beta1_KO;
 }
 
 real_t BSSN::ev_beta2(BSSNData *bd, const real_t dx[])
@@ -1864,7 +2499,7 @@ real_t BSSN::ev_beta2(BSSNData *bd, const real_t dx[])
     //+ upwind_derivative(bd->i, bd->j, bd->k, 1, beta2_a, dx, bd->beta1)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 2, beta2_a, dx, bd->beta2)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 3, beta2_a, dx, bd->beta3)
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta2_a, dx, KO_damping_coefficient);
+    - bd->beta2_KO;
 }
 
 real_t BSSN::ev_beta3(BSSNData *bd, const real_t dx[])
@@ -1873,7 +2508,7 @@ real_t BSSN::ev_beta3(BSSNData *bd, const real_t dx[])
     //+ upwind_derivative(bd->i, bd->j, bd->k, 1, beta3_a, dx, bd->beta1)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 2, beta3_a, dx, bd->beta2)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 3, beta3_a, dx, bd->beta3)
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta3_a, dx, KO_damping_coefficient);
+    - bd->beta3_KO;
 }
 #endif
 
@@ -1881,11 +2516,9 @@ real_t BSSN::ev_beta3(BSSNData *bd, const real_t dx[])
 real_t BSSN::ev_expN(BSSNData *bd, const real_t dx[])
 {
   return
-      upwind_derivative(bd->i, bd->j, bd->k, 1, expN_a, dx, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, expN_a, dx, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, expN_a, dx, bd->beta3)
+      bd->expN_adv
     -bd->alpha * bd->K/3.0
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, expN_a, dx, KO_damping_coefficient);
+    - bd->expN_KO;
 }
 #endif
 
@@ -1898,7 +2531,7 @@ real_t BSSN::ev_auxB1(BSSNData *bd, const real_t dx[])
     //+ upwind_derivative(bd->i, bd->j, bd->k, 2, auxB1_a, dx, bd->beta2)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 3, auxB1_a, dx, bd->beta3)
     - gd_eta * bd->auxB1
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, auxB1_a, dx, KO_damping_coefficient);
+    - bd->auxB1_KO;
 }
 
 real_t BSSN::ev_auxB2(BSSNData *bd, const real_t dx[])
@@ -1908,7 +2541,7 @@ real_t BSSN::ev_auxB2(BSSNData *bd, const real_t dx[])
     //+ upwind_derivative(bd->i, bd->j, bd->k, 2, auxB2_a, dx, bd->beta2)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 3, auxB2_a, dx, bd->beta3)
     - gd_eta * bd->auxB2
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, auxB2_a, dx, KO_damping_coefficient);
+    - bd->auxB2_KO;
 }
 
 real_t BSSN::ev_auxB3(BSSNData *bd, const real_t dx[])
@@ -1918,7 +2551,7 @@ real_t BSSN::ev_auxB3(BSSNData *bd, const real_t dx[])
     //+ upwind_derivative(bd->i, bd->j, bd->k, 2, auxB3_a, dx, bd->beta2)
     //+ upwind_derivative(bd->i, bd->j, bd->k, 3, auxB3_a, dx, bd->beta3)
     - gd_eta * bd->auxB3
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, auxB3_a, dx, KO_damping_coefficient);
+    - bd->auxB3_KO;
 }
 #endif
 
@@ -2264,116 +2897,105 @@ void BSSN::output_max_H_constaint(
   return;
 }
 
-void BSSN::output_L2_H_constaint(
-  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
-  idx_t weight_idx,   CosmoPatchStrategy * cosmoPS, double exclude_radius)
-{ 
-  double H_L2=0;
-
-  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
-    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
-      hierarchy->getGridGeometry()));
-  TBOX_ASSERT(grid_geometry_);
-  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
-  const double * dx = &grid_geometry.getDx()[0];
-
-  const int base_nx = round(L[0] / dx[0]);
-  const int base_ny = round(L[1] / dx[1]);
-  const int base_nz = round(L[2] / dx[2]);
-  
-  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
+/**
+ * @brief L2 norm of the Hamiltonian constraint over cells with
+ *        alpha > alpha_lower_bd_for_L2 outside exclude_radius
+ */
+class L2HConstraintKernel : public ReductionKernel
+{
+ public:
+  L2HConstraintKernel(
+    BSSN *bssn_in, idx_t weight_idx_in, const int base_n_in[],
+    bool skip_bd_in, double exclude_radius_in):
+    bssn(bssn_in),
+    weight_idx(weight_idx_in),
+    skip_bd(skip_bd_in),
+    exclude_radius(exclude_radius_in)
   {
-    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
-
-    
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
-    {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
+    for(int d = 0; d < DIM; d++)
+      base_n[d] = base_n_in[d];
+  }
 
-      const hier::Box& box = patch->getBox();
+  void initPatch(const std::shared_ptr<hier::Patch> & patch, idx_t ln)
+  {
+    const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+      SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+        patch->getPatchGeometry()));
 
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
+    for(int d = 0; d < DIM; d++)
+      dx[d] = patch_geom->getDx()[d];
 
-      initPData(patch);
-
-      initMDA(patch);
+    bssn->initPData(patch);
+    bssn->initMDA(patch);
 
+    std::shared_ptr<pdat::CellData<double> > weight(
+      SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+        patch->getPatchData(weight_idx)));
 
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
+    weight_array =
+      pdat::ArrayDataAccess::access<DIM, double>(
+        weight->getArrayData());
+  }
 
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
+  void accumulate(idx_t i, idx_t j, idx_t k, double * sums, double * maxima)
+  {
+    if(skip_bd &&
+       (i < GHOST_WIDTH || i >= base_n[0] - GHOST_WIDTH ||
+        j < GHOST_WIDTH || j >= base_n[1] - GHOST_WIDTH ||
+        k < GHOST_WIDTH || k >= base_n[2] - GHOST_WIDTH))
+      return;
 
+    const real_t * L = bssn->L;
 
-      
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
-      
-      const double *dx = &patch_geom->getDx()[0];
+    BSSNData bd = {0};
 
-      
+    bssn->set_bd_values(i,j,k,&bd,dx);
 
-#pragma omp parallel for collapse(2) reduction(+:H_L2)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-            if(cosmoPS->is_time_dependent &&
-               (i < GHOST_WIDTH || i >= base_nx - GHOST_WIDTH ||
-                j < GHOST_WIDTH || j >= base_ny - GHOST_WIDTH ||
-                k < GHOST_WIDTH || k >= base_nz - GHOST_WIDTH))
-              continue;
-            
-            BSSNData bd = {0};
+    double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
+    double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
+    double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
+    double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
 
-            set_bd_values(i,j,k,&bd,dx);
+    if(weight_array(i,j,k) > 0
+       && bssn->DIFFalpha_a(i,j,k) > bssn->alpha_lower_bd_for_L2 - 1.0
+       && r > exclude_radius)
+    {
+      real_t h = bssn->hamiltonianConstraintCalc(&bd, dx);
+      sums[0] += pw2(h) * weight_array(i,j,k) / (L[0] * L[1] * L[2]);
+    }
+  }
 
-            double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
-            double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
-            double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
-            double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
+  void finalize(const double * sums, const double * maxima)
+  {
+    double H_L2 = sqrt(sums[0]);
 
-            if(weight_array(i,j,k) > 0 && DIFFalpha_a(i,j,k) > alpha_lower_bd_for_L2 - 1.0
-            && r > exclude_radius)
-            {
-              real_t h = hamiltonianConstraintCalc(&bd, dx);
-              H_L2 += pw2(h) * weight_array(i,j,k) / (L[0] * L[1] * L[2]);
-            }
-          }
-        }
-      }
-     }
-  }
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&H_L2, 1, MPI_SUM);
+    tbox::pout<<"L2 norm of Hamiltonian constraint is "<<H_L2<<"\n";
   }
 
-  H_L2 = sqrt(H_L2);
-  
-  tbox::pout<<"L2 norm of Hamiltonian constraint is "<<H_L2<<"\n";
-
-  
-  return;
-}
+ private:
+  BSSN *bssn;
+  idx_t weight_idx;
+  int base_n[DIM];
+  bool skip_bd;
+  double exclude_radius;
 
+  real_t dx[DIM];
+  arr_t weight_array;
+};
 
-void BSSN::output_L2_H_constaint(
+/**
+ * @brief register the L2 norm of the Hamiltonian constraint with a
+ *        reduction, it is written to pout when the reduction is swept;
+ *        set_bd_values also fills AijAij_a and ricci_a of the swept cells
+ *        for kernels added after this one
+ *
+ * @param exclude_radius only count cells outside, all for a negative value
+ */
+void BSSN::addL2HConstraintKernel(
+  HierarchyReduction & reduction,
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
-  idx_t weight_idx,   CosmoPatchStrategy * cosmoPS)
+  idx_t weight_idx, CosmoPatchStrategy * cosmoPS, double exclude_radius)
 {
-  double H_L2=0;
-
   std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
     SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
       hierarchy->getGridGeometry()));
@@ -2381,88 +3003,36 @@ void BSSN::output_L2_H_constaint(
   geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
   const double * dx = &grid_geometry.getDx()[0];
 
-  const int base_nx = round(L[0] / dx[0]);
-  const int base_ny = round(L[1] / dx[1]);
-  const int base_nz = round(L[2] / dx[2]);
-  
-  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
-  {
-    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
-
-    
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
-    {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
-
-      const hier::Box& box = patch->getBox();
-
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
-
-      initPData(patch);
-
-      initMDA(patch);
-
-
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
-
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
-
-
-      
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
-      
-      const double *dx = &patch_geom->getDx()[0];
-
-      
-
-#pragma omp parallel for collapse(2) reduction(+:H_L2)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-            if(cosmoPS->is_time_dependent &&
-               (i < GHOST_WIDTH || i >= base_nx - GHOST_WIDTH ||
-                j < GHOST_WIDTH || j >= base_ny - GHOST_WIDTH ||
-                k < GHOST_WIDTH || k >= base_nz - GHOST_WIDTH))
-              continue;
-            
-            BSSNData bd = {0};
+  const int base_n[DIM] = {
+    (int)round(L[0] / dx[0]),
+    (int)round(L[1] / dx[1]),
+    (int)round(L[2] / dx[2]) };
 
-            set_bd_values(i,j,k,&bd,dx);
+  reduction.addKernel(
+    std::shared_ptr<ReductionKernel>(
+      new L2HConstraintKernel(
+        this, weight_idx, base_n, cosmoPS->is_time_dependent, exclude_radius)),
+    1, 0);
+}
 
-            if(weight_array(i,j,k) > 0 && DIFFalpha_a(i,j,k) > alpha_lower_bd_for_L2 - 1.0)
-            {
-              real_t h = hamiltonianConstraintCalc(&bd, dx);
-              H_L2 += pw2(h) * weight_array(i,j,k) / (L[0] * L[1] * L[2]);
-            }
-          }
-        }
-      }
-     }
-  }
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&H_L2, 1, MPI_SUM);
-  }
+void BSSN::output_L2_H_constaint(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t weight_idx,   CosmoPatchStrategy * cosmoPS, double exclude_radius)
+{ 
+  HierarchyReduction reduction;
+  addL2HConstraintKernel(
+    reduction, hierarchy, weight_idx, cosmoPS, exclude_radius);
+  reduction.sweep(hierarchy);
+}
 
-  H_L2 = sqrt(H_L2);
-  
-  tbox::pout<<"L2 norm of Hamiltonian constraint is "<<H_L2<<"\n";
 
-  
-  return;
+void BSSN::output_L2_H_constaint(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t weight_idx,   CosmoPatchStrategy * cosmoPS)
+{
+  HierarchyReduction reduction;
+  addL2HConstraintKernel(reduction, hierarchy, weight_idx, cosmoPS);
+  reduction.sweep(hierarchy);
 }
 
 
@@ -8,12 +8,16 @@
 #include "SAMRAI/xfer/CoarsenAlgorithm.h"
 #include "SAMRAI/xfer/RefinePatchStrategy.h"
 #include "SAMRAI/math/HierarchyCellDataOpsReal.h"
+#include "../../utils/CartesianCellDoubleFusedRefineStrategy.h"
+#include "../../utils/CartesianCellDoubleFusedCoarsenStrategy.h"
 
 using namespace SAMRAI;
 
 namespace cosmo
 {
 
+class HierarchyReduction;
+
 /**
  * @brief BSSN Class: evolves BSSN metric fields, computes derived quantities
  */
@@ -46,6 +50,7 @@ public:
   ~BSSN();
 
   BSSN_APPLY_TO_FIELDS(RK4_IDX_ALL_CREATE)
+  BSSN_APPLY_TO_FIELDS_ARGS(RK4_IDX_CREATE,spare)
   BSSN_APPLY_TO_SOURCES_ARGS(RK4_IDX_CREATE,a)
   BSSN_APPLY_TO_GEN1_EXTRAS_ARGS(RK4_IDX_CREATE,a)
   
@@ -67,8 +72,12 @@ public:
 
   void set_norm(
     const std::shared_ptr<hier::PatchLevel>& level);
+
+  real_t maxCharacteristicSpeed(
+    const std::shared_ptr<hier::PatchLevel> & level);
   void set_norm(
     const std::shared_ptr<hier::Patch>& patch, bool need_init_arr);
+  void set_norm_pt(idx_t i, idx_t j, idx_t k);
 
   void rescale_lapse(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy, int weight_idx);
@@ -77,6 +86,22 @@ public:
 
   void RKEvolvePatch(
     const std::shared_ptr<hier::Patch> & patch, real_t dt);
+  void RKEvolvePatchBorder(
+    const std::shared_ptr<hier::Patch> & patch, real_t dt);
+  hier::Box getDeepInteriorBox(
+    const std::shared_ptr<hier::Patch> & patch);
+  void RKEvolveBox(
+    const hier::Box & box, const real_t dx[], real_t dt);
+  void RKEvolveBoxPencil(
+    const hier::Box & box, const real_t dx[], real_t dt);
+  void initLevelViews(
+    const std::shared_ptr<hier::PatchLevel> & level,
+    std::vector<BSSN> & views);
+  void RKEvolveLevelTasks(
+    const std::shared_ptr<hier::PatchLevel> & level, real_t dt,
+    bool deep_interior_only);
+  void RKEvolveLevelTiled(
+    const std::shared_ptr<hier::PatchLevel> & level, real_t dt);
   void RKEvolvePt(
     idx_t i, idx_t j, idx_t k, BSSNData &bd, const real_t dx[], real_t dt);
   void RKEvolvePtBd(
@@ -93,6 +118,14 @@ public:
   void prepareForK4(
     const std::shared_ptr<hier::PatchLevel> & level, real_t to_t);
 
+  void prepareForK(
+    const std::shared_ptr<hier::PatchLevel> & level,
+    int n, real_t from_t, real_t to_t);
+
+  void setLSRKStage(int stage);
+  void prepareForLSRKStage(
+    const std::shared_ptr<hier::PatchLevel> & level, int stage, real_t dt);
+
   void allocField(  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t ln);
   void allocSrc(  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t ln);
   void allocGen1(  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t ln);
@@ -115,12 +148,24 @@ public:
   void registerRKRefinerActive(
     xfer::RefineAlgorithm& refiner,
     std::shared_ptr<hier::RefineOperator> &space_refine_op);
+  void registerRKRefinerFused(
+    xfer::RefineAlgorithm& refiner,
+    geom::CartesianCellDoubleFusedRefineStrategy& fused_strategy);
 
   void registerCoarsenActive(
     xfer::CoarsenAlgorithm& coarsener,
     std::shared_ptr<hier::CoarsenOperator>& coarsen_op);
+  void registerCoarsenActiveFused(
+    xfer::CoarsenAlgorithm& coarsener,
+    geom::CartesianCellDoubleFusedCoarsenStrategy& fused_strategy);
   void copyAToP(
     math::HierarchyCellDataOpsReal<real_t> & hcellmath);
+  void normalizeAndCopyAToP(
+    const std::shared_ptr<hier::PatchLevel>& level);
+  void rotateAToP(
+    const std::shared_ptr<hier::PatchLevel>& level);
+  void detachAFromP(
+    const std::shared_ptr<hier::Patch>& patch);
 #if USE_BACKUP_FIELDS
   void copyBToP(
     math::HierarchyCellDataOpsReal<real_t> & hcellmath);
@@ -146,14 +191,24 @@ public:
     const std::shared_ptr<hier::Patch> & patch, int ln, int max_ln);
   void K4FinalizePatch(
     const std::shared_ptr<hier::Patch> & patch);
+  void LSRKFinalizePatch(
+    const std::shared_ptr<hier::Patch> & patch, int stage);
+  void KFinalizeBox(const hier::Box & box, int n);
+  void LSRKFinalizeBox(const hier::Box & box, int stage);
+  void KFinalizeLevelTiled(
+    const std::shared_ptr<hier::PatchLevel> & level, int n);
 
   void set_bd_values_bd(
     idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[]);
   void set_bd_values(
     idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[]);
+  void set_bd_pointwise_values(
+    idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[]);
+  void set_bd_derived_values(BSSNData *bd, const real_t dx[]);
 
 #if USE_COSMOTRACE
-  void set_bd_values_for_ray_tracing(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[]);
+  void set_bd_values_for_ray_tracing(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[],
+                                     bool check_stencil = true);
 #endif
 
   void set_bd_values_for_dust_fluid(idx_t i, idx_t j, idx_t k, BSSNData *bd, const real_t dx[], bool cal_derivatives = true);
@@ -170,7 +225,11 @@ public:
 
   void calculate_dalpha_dchi(BSSNData *bd, const real_t dx[]);
 
+  void calculate_ddalpha(BSSNData *bd, const real_t dx[]);
+
   void calculate_dK(BSSNData *bd, const real_t dx[]);
+
+  void calculate_dGamma(BSSNData *bd, const real_t dx[]);
   
 #ifdef USE_Z4C
   void calculate_dtheta(BSSNData *bd, const real_t dx[]);
@@ -178,8 +237,11 @@ public:
 
 #ifdef USE_BSSN_SHIFT
   void calculate_dbeta(BSSNData *bd, const real_t dx[]);
+  void calculate_ddbeta(BSSNData *bd, const real_t dx[]);
 #endif
 
+  void calculate_advection_dissipation(BSSNData *bd, const real_t dx[]);
+
 /* #ifdef USE_EXPANSION */
 /*   void calculate_dexpN(BSSNData *bd, const real_t dx[]); */
 /* #endif */
@@ -297,6 +359,11 @@ public:
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
     idx_t weight_idx, CosmoPatchStrategy * cosmoPS);
 
+  void addL2HConstraintKernel(
+    HierarchyReduction & reduction,
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t weight_idx, CosmoPatchStrategy * cosmoPS, double exclude_radius = -1);
+
   /* constraint violation calculations */
 
   real_t hamiltonianConstraintCalc(BSSNData *bd, const real_t dx[]);
@@ -334,6 +401,28 @@ public:
 
   double K0;
   double K_avg;
+
+  // RHS kernel selection ("pointwise" or "pencil") and pencil length
+  bool use_pencil_rhs;
+  idx_t rhs_pencil_length;
+
+  // low-storage RK ("LSRK4") keeps only _a, _s and _p;
+  // lsrk_stage_A is the coefficient of the current stage
+  bool use_low_storage_rk;
+  real_t lsrk_stage_A;
+
+  // tiled level executor: patches of a level are cut into tiles of at most
+  // tile_size^3 cells which are scheduled as OpenMP tasks
+  bool use_tiled_level;
+  idx_t tile_size;
+
+  // normalize Aij / gammaij inside the RK finalize sweeps and together
+  // with the copy of _a to _p, instead of in separate set_norm passes
+  bool fuse_rk_finalize;
+
+  // replace copyAToP by handing the patch data of _a to _p, _a gets the
+  // old _p patch data back at the next K1 finalize (RK4 only)
+  bool rotate_rk_registers;
 };
 
 }
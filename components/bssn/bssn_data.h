@@ -84,6 +84,12 @@ typedef struct {
     real_t d1a, ///< partial of alpha, \f$\partial_1 \alpha\f$
            d2a, ///< partial of alpha, \f$\partial_2 \alpha\f$
            d3a; ///< partial of alpha, \f$\partial_3 \alpha\f$
+    real_t d1d1a, ///< second partial of alpha, \f$\partial_1 \partial_1 \alpha\f$
+           d1d2a, ///< second partial of alpha, \f$\partial_1 \partial_2 \alpha\f$
+           d1d3a, ///< second partial of alpha, \f$\partial_1 \partial_3 \alpha\f$
+           d2d2a, ///< second partial of alpha, \f$\partial_2 \partial_2 \alpha\f$
+           d2d3a, ///< second partial of alpha, \f$\partial_2 \partial_3 \alpha\f$
+           d3d3a; ///< second partial of alpha, \f$\partial_3 \partial_3 \alpha\f$
 
 
     // covariant double-derivatives 
@@ -159,6 +165,17 @@ typedef struct {
          GL323, ///< Conformal christoffel symbol of the second kind, \f$ \bar{\Gamma}_{323} \f$
          GL333; ///< Conformal christoffel symbol of the second kind, \f$ \bar{\Gamma}_{333} \f$
 
+  // derivatives of the evolved christoffel contraction, d_i Gamma^j
+  real_t d1Gamma1, ///< \f$\partial_1 \bar{\Gamma}^1\f$
+         d2Gamma1, ///< \f$\partial_2 \bar{\Gamma}^1\f$
+         d3Gamma1, ///< \f$\partial_3 \bar{\Gamma}^1\f$
+         d1Gamma2, ///< \f$\partial_1 \bar{\Gamma}^2\f$
+         d2Gamma2, ///< \f$\partial_2 \bar{\Gamma}^2\f$
+         d3Gamma2, ///< \f$\partial_3 \bar{\Gamma}^2\f$
+         d1Gamma3, ///< \f$\partial_1 \bar{\Gamma}^3\f$
+         d2Gamma3, ///< \f$\partial_2 \bar{\Gamma}^3\f$
+         d3Gamma3; ///< \f$\partial_3 \bar{\Gamma}^3\f$
+
   // contraction of christoffel symbols ("Gamma_d" in Z4c)
   real_t Gammad1, ///< Contraction of christoffel symbol (non-dynamical), \f$\bar{\gamma}^{ij} \bar{\Gamma}^{1}_{ij}\f$
          Gammad2, ///< Contraction of christoffel symbol (non-dynamical), \f$\bar{\gamma}^{ij} \bar{\Gamma}^{2}_{ij}\f$
@@ -224,6 +241,10 @@ typedef struct {
          d3d3g33; ///< Second partial derivative of the conformal metric, \f$\partial_3 \partial_3 \bar{\gamma}_{33}\f$
 
 
+  // upwinded advection (field_adv) and KO dissipation (field_KO) terms,
+  // filled in by BSSN::calculate_advection_dissipation or the pencil kernel
+  BSSN_APPLY_TO_DISSIPATED_FIELDS(BSSN_DECLARE_ADV_KO)
+
   // H constraint calc.
   real_t H; ///< Hamiltonian constraint violation
   // Misc. debugging calc
@@ -250,6 +271,12 @@ typedef struct {
   real_t d1beta3, ///< derivative of shift, \f$ \partial_1 \beta^3 \f$
          d2beta3, ///< derivative of shift, \f$ \partial_2 \beta^3 \f$
          d3beta3; ///< derivative of shift, \f$ \partial_3 \beta^3 \f$
+  #if USE_BSSN_SHIFT
+  // second derivatives of shift, d_i d_j beta^k (only i <= j stored)
+  real_t d1d1beta1, d1d2beta1, d1d3beta1, d2d2beta1, d2d3beta1, d3d3beta1;
+  real_t d1d1beta2, d1d2beta2, d1d3beta2, d2d2beta2, d2d3beta2, d3d3beta2;
+  real_t d1d1beta3, d1d2beta3, d1d3beta3, d2d2beta3, d2d3beta3, d3d3beta3;
+  #endif
   #if !USE_BSSN_SHIFT
     real_t beta1; ///< shift, \f$\beta^1\f$
     real_t beta2; ///< shift, \f$\beta^2\f$
@@ -288,6 +315,25 @@ typedef struct {
   
 } BSSNData;
 
+/**
+ * @struct BSSNPencilData
+ * @brief Thread-local scratch for the pencil RHS kernel: contiguous
+ * buffers (one value per cell along an x-pencil) holding the finite
+ * differences of the BSSN fields, so that stencils are evaluated in
+ * unit-stride loops instead of once per cell and per use.
+ */
+typedef struct {
+  idx_t n_slots; ///< number of buffers of length pencil_length
+
+  // first derivatives, d1_field ... d3_field
+  BSSN_APPLY_TO_PENCIL_D_FIELDS(BSSN_PENCIL_DECLARE_D)
+  // second derivatives, d1d1_field ... d3d3_field
+  BSSN_APPLY_TO_PENCIL_DD_FIELDS(BSSN_PENCIL_DECLARE_DD)
+  // upwinded advection and KO dissipation terms
+  BSSN_APPLY_TO_ADVECTED_FIELDS(BSSN_PENCIL_DECLARE_ADV)
+  BSSN_APPLY_TO_DISSIPATED_FIELDS(BSSN_PENCIL_DECLARE_KO)
+} BSSNPencilData;
+
 } /* namespace cosmo */
 
 #endif
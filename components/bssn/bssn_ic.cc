@@ -2,6 +2,8 @@
 #include "../../cosmo_includes.h"
 #include "SAMRAI/tbox/HDFDatabase.h"
 #include "../elliptic_solver/full_multigrid.h"
+#include "../elliptic_solver/samrai_multigrid.h"
+#include "../../utils/math.h"
 #include "../elliptic_solver/multigrid_bd_handler.h"
 
 using namespace SAMRAI;
@@ -1391,6 +1393,383 @@ void bssn_ic_static_BHL_CTT(
 }
 
 
+/**
+ * @brief Add the hamiltonian and momentum constraint equations of the
+ *  kerr BHL CTT initial data to a (replicated or distributed) FAS solver
+ */
+template<class MG>
+static void kerr_BHL_CTT_init_eqns(MG & multigrid)
+{
+  atom atom_tmp = {0};
+
+  multigrid.eqns[0][0].init(1, 1);
+  //adding laplacian term
+  atom_tmp.type =  MG::lap;
+  atom_tmp.u_id = 0;
+  multigrid.eqns[0][0].add_atom(atom_tmp);
+
+  //adding \Psi^-7 term
+  for(int i = 1; i <= 3; i++)
+    for(int j = 1; j <= 3; j++)
+    {
+      atom_tmp.type = i+1;
+      atom_tmp.u_id = j;
+      if(i == j)
+        multigrid.eqns[0][3*(i-1)+j].init(3, 0.5 - 1.0/6.0);
+      else
+        multigrid.eqns[0][3*(i-1)+j].init(3, 0.25);
+      multigrid.eqns[0][3*(i-1)+j].add_atom(atom_tmp);
+
+      multigrid.eqns[0][3*(i-1)+j].add_atom(atom_tmp);
+
+      atom_tmp.type = 1;
+      atom_tmp.u_id = 0;
+      atom_tmp.value = -7;
+      multigrid.eqns[0][3*(i-1)+j].add_atom(atom_tmp);
+    }
+  for(int i = 1; i <= 3; i++)
+    for(int j = i+1; j <= 3; j++)
+    {
+      atom_tmp.type = i+1;
+      atom_tmp.u_id = j;
+      multigrid.eqns[0][(9 + i+j - 2)].init(3, 0.5);
+      multigrid.eqns[0][(9 + i+j - 2)].add_atom(atom_tmp);
+    
+      atom_tmp.type = j+1;
+      atom_tmp.u_id = i;
+      multigrid.eqns[0][(9 + i+j - 2)].add_atom(atom_tmp);
+
+      atom_tmp.type = 1;
+      atom_tmp.u_id = 0;
+      atom_tmp.value = -7;
+      multigrid.eqns[0][(9 + i+j - 2)].add_atom(atom_tmp);
+    }
+
+  for(int i = 1; i <= 3; i++)
+    for(int j = i+1; j <= 3; j++)
+    {
+      multigrid.eqns[0][(12 + i+j - 2)].init(3, -1.0/3.0);
+      atom_tmp.type = i+1;
+      atom_tmp.u_id = i;
+      multigrid.eqns[0][(12+i+j-2)].add_atom(atom_tmp);
+
+      atom_tmp.type = j+1;
+      atom_tmp.u_id = j;
+      multigrid.eqns[0][(12+i+j-2)].add_atom(atom_tmp);
+
+      atom_tmp.type = 1;
+      atom_tmp.u_id = 0;
+      atom_tmp.value = -7;
+      multigrid.eqns[0][(12 + i+j - 2)].add_atom(atom_tmp);
+    }
+
+  // adding \partial X \partial S terms
+  // where S is divergen shift
+  for(int i = 1; i <= 3; i++)
+    for(int j = 1; j <= 3; j++)
+    {
+      if( i == 3 && j == 3) continue;
+
+      multigrid.eqns[0][15+3*(i-1)+j].init(2, 1.0);
+      
+      atom_tmp.type = i+1;
+      atom_tmp.u_id = j;
+      multigrid.eqns[0][15+3*(i-1)+j].add_atom(atom_tmp);
+
+      atom_tmp.type = 1;
+      atom_tmp.u_id = 0;
+      atom_tmp.value = -7;
+      multigrid.eqns[0][15+3*(i-1)+j].add_atom(atom_tmp);
+    }
+
+  // adding pure \partial S terms
+  multigrid.eqns[0][24].init(1, 1.0);
+  atom_tmp.type = 1;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = -7;
+  multigrid.eqns[0][24].add_atom(atom_tmp);
+
+  multigrid.eqns[0][25].init(1, 1.0);
+
+  // adding \Psi^5 terms
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 5;
+  multigrid.eqns[0][25].add_atom(atom_tmp);
+
+  // adding Lap(divergence part) as a ^0 polynomial
+  multigrid.eqns[0][26].init(1, 1.0);
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 0;
+  multigrid.eqns[0][26].add_atom(atom_tmp);
+  
+  // start adding momentum constraints
+  multigrid.eqns[1][0].init(1, 1.0);
+  multigrid.eqns[1][1].init(1, 1.0/3.0);
+  multigrid.eqns[1][2].init(1, 1.0/3.0);
+  multigrid.eqns[1][3].init(1, 1.0/3.0);
+  
+  multigrid.eqns[1][4].init(1, 1.0);
+  multigrid.eqns[1][5].init(1, 1.0);
+
+  multigrid.eqns[2][0].init(1, 1.0);
+  multigrid.eqns[2][1].init(1, 1.0/3.0);
+  multigrid.eqns[2][2].init(1, 1.0/3.0);
+  multigrid.eqns[2][3].init(1, 1.0/3.0);
+  multigrid.eqns[2][4].init(1, 1.0);
+  multigrid.eqns[2][5].init(1, 1.0);
+
+
+  multigrid.eqns[3][0].init(1, 1.0);
+  multigrid.eqns[3][1].init(1, 1.0/3.0);
+  multigrid.eqns[3][2].init(1, 1.0/3.0);
+  multigrid.eqns[3][3].init(1, 1.0/3.0);
+  multigrid.eqns[3][4].init(1, 1.0);
+  multigrid.eqns[3][5].init(1, 1.0);
+
+
+
+  //adding terms to eqn 1
+  atom_tmp.type = MG::lap;
+  atom_tmp.u_id = 1;
+  multigrid.eqns[1][0].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der11;
+  atom_tmp.u_id = 1;
+  multigrid.eqns[1][1].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der12;
+  atom_tmp.u_id = 2;
+  multigrid.eqns[1][2].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der13;
+  atom_tmp.u_id = 3;
+  multigrid.eqns[1][3].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 6;
+  multigrid.eqns[1][4].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 0;
+  multigrid.eqns[1][5].add_atom(atom_tmp);
+
+
+  //adding terms to eqn 2
+  atom_tmp.type = MG::lap;
+  atom_tmp.u_id = 2;
+  multigrid.eqns[2][0].add_atom(atom_tmp);
+
+
+  atom_tmp.type = MG::der12;
+  atom_tmp.u_id = 1;
+  multigrid.eqns[2][1].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der22;
+  atom_tmp.u_id = 2;
+  multigrid.eqns[2][2].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der23;
+  atom_tmp.u_id = 3;
+  multigrid.eqns[2][3].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 6;
+  multigrid.eqns[2][4].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 0;
+  multigrid.eqns[2][5].add_atom(atom_tmp);
+
+  
+  //adding terms to eqn 3
+  atom_tmp.type = MG::lap;
+  atom_tmp.u_id = 3;
+  multigrid.eqns[3][0].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der13;
+  atom_tmp.u_id = 1;
+  multigrid.eqns[3][1].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der23;
+  atom_tmp.u_id = 2;
+  multigrid.eqns[3][2].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::der33;
+  atom_tmp.u_id = 3;
+  multigrid.eqns[3][3].add_atom(atom_tmp);
+
+  
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 0;
+  multigrid.eqns[3][5].add_atom(atom_tmp);
+
+  atom_tmp.type = MG::poly;
+  atom_tmp.u_id = 0;
+  atom_tmp.value = 6;
+  multigrid.eqns[3][4].add_atom(atom_tmp);
+}
+
+/**
+ * @brief Source terms and shift functions of the kerr BHL CTT equations
+ *  at a point, handed to set_poly_src(eqn_id, mol_id, value) and
+ *  set_shift_src(u_id, value)
+ */
+template<class PolySrcF, class ShiftSrcF>
+static void kerr_BHL_CTT_set_src_pt(
+  real_t x, real_t y, real_t z, real_t M, real_t a, real_t K_c,
+  double l, double sigma, PolySrcF set_poly_src, ShiftSrcF set_shift_src)
+{
+  real_t r = sqrt(pw2(x ) + pw2(y ) + pw2(z ));
+  real_t phi = atan(y / x);
+  real_t theta = acos(z / sqrt(pw2(x) + pw2(y) + pw2(z))); 
+
+  real_t W = 0;
+  real_t lap_Wr = 0, dx_K = 0, dy_K = 0, dz_K = 0;
+  real_t sup_X1 = 0, sup_X2 = 0, sup_X3 = 0;
+
+  real_t ds = (l-r+sigma)/sigma;
+
+  real_t d1S1 = 0, d1S2 = 0, d1S3 = 0, d2S1 = 0, d2S2 = 0,
+    d2S3 = 0, d3S1 = 0, d3S2 = 0, d3S3 = 0;
+  
+  if(r < l)
+  {
+    W = 0;
+    d1S1 = - 3.0 * a * x * y / pow(r, 5.0);
+    d1S2 = - a * (r*r - 3 * x * x) / pow(r, 5.0);
+    d2S1 = a * (r*r - 3 * y * y) / pow(r, 5.0);
+    d2S2 = 3.0 * a * x * y / pow(r, 5.0);
+    d3S1 = -3.0 * a * z * y / pow(r, 5.0);
+    d3S2 = 3.0 * a * x * z / pow(r, 5.0);
+  }
+  else if(r<l+sigma)
+  {
+    W = std::pow(pow((r-l-sigma)/(sigma),6) - 1.0, 6 );
+    // calculating derivative of W(r)/r
+    lap_Wr = 90.0 * pow( (l-r+sigma) / sigma, 4.0)
+      * pow(pow((r-l-sigma)/(sigma), 6) - 1.0, 4.0)
+      * (-1.0+ 7 * pow( (l-r+sigma) / sigma, 6.0)) / (r * pw2(sigma));
+    // calculating derivative of K
+    dx_K = -36.0 * K_c * x * pow((l-r+sigma)/sigma,5.0)
+      * pow(pow((r-l-sigma)/(sigma), 6) - 1.0 , 5) / (r * sigma);
+    dy_K = -36.0 * K_c * y * pow((l-r+sigma)/sigma,5.0)
+      * pow(pow((r-l-sigma)/(sigma), 6) - 1.0 , 5) / (r * sigma);
+    dz_K = -36.0 * K_c * z * pow((l-r+sigma)/sigma,5.0)
+      * pow(pow((r-l-sigma)/(sigma), 6) - 1.0 , 5) / (r * sigma);
+
+    sup_X1 = - 36.0 * a * y * pow(ds, 4) * pow( 1.0 - pow(ds, 6), 4)
+      * (30.0 * r * pow(ds, 6) - 5.0 * r * (1- pow(ds, 6))
+         - 2.0 * (l-r+sigma) * (1.0 - pow(ds, 6.0))) / pow(r, 4.0) / sigma / sigma; 
+
+    sup_X2 = 36.0 * a * x * pow(ds, 4) * pow( 1.0 - pow(ds, 6), 4)
+      * (30.0 * r * pow(ds, 6) - 5.0 * r * (1- pow(ds, 6))
+         - 2.0 * (l-r+sigma) * (1.0 - pow(ds, 6.0))) / pow(r, 4.0) / sigma / sigma;
+    
+    sup_X3 = 0;
+
+
+    d1S1 = 3*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+    d1S2 = a*pow(r,-5)*(36*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(x,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) - pow(r,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)) + 
+                        3*pow(x,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)));
+    d2S1 = -(a*pow(r,-5)*(36*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(y,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) - pow(r,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)) + 
+                          3*pow(y,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6))));
+    d2S2 = -3*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+
+    d3S1 = 3*a*y*z*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+
+    d3S2 = -3*a*x*z*pow(r,-5)*pow(sigma,-36)*(-pow(sigma,36) - 12*r*pow(l - r + sigma,5)*pow(pow(sigma,6) - pow(l - r + sigma,6),5) + pow(pow(sigma,6) - pow(l - r + sigma,6),6));
+    
+  }
+  else
+    W = 1;
+  
+
+  real_t K = K_c * W;
+
+
+  // set coeficient of \Psi^5
+  set_poly_src(0, 25, -K*K / 12.0);
+  
+  set_poly_src(0, 26, -M * lap_Wr);
+  real_t const_f_of_psi7;
+  const_f_of_psi7 = 
+    + (2.0 * (d1S1*d1S1 + d2S2*d2S2 + d3S3*d3S3)
+    + d1S2*d1S2 + d2S1*d2S1 + d1S3*d1S3 + d3S1*d3S1 + d2S3*d2S3 + d3S2*d3S2
+    + d1S2*d2S1 + d2S1*d1S2 + d1S3*d3S1 + d3S1*d1S3 + d2S3*d3S2 + d3S2*d2S3)/4.0;
+  
+  set_poly_src(0, 24, const_f_of_psi7); 
+
+  set_poly_src(0, 16, d1S1); // coef of d1X1
+  set_poly_src(0, 17, 0.5*(d1S2 + d2S1)); // coef of d1X2
+  set_poly_src(0, 18, 0.5*d3S1); // coef of d1X3
+
+  set_poly_src(0, 19, 0.5*(d2S1 + d1S2)); // coef of d2X1
+  set_poly_src(0, 20, d2S2); // coef of d2X2
+  set_poly_src(0, 21, 0.5*d3S2); // coef of d2X3
+
+  set_poly_src(0, 22, 0.5*d3S1); // coef of d3X1
+  set_poly_src(0, 23, 0.5*d3S2); // coef of d3X2
+  
+  set_poly_src(1, 4, -2.0 * dx_K / 3.0);
+  set_poly_src(2, 4, -2.0 * dy_K / 3.0); 
+  set_poly_src(3, 4, -2.0 * dz_K / 3.0);
+
+  set_poly_src(1, 5, sup_X1);
+  set_poly_src(2, 5, sup_X2);
+  set_poly_src(3, 5, sup_X3);
+  
+  set_shift_src(0, M / (2.0 * r) * (1 - W));
+  
+  set_shift_src(1, a * y * (1 - W) / pw3(r));
+  set_shift_src(2, - a * x * (1 - W) / pw3(r));
+  set_shift_src(3, 0);
+}
+
+/**
+ * @brief Smoothing function W(r) and analytic part sA_ij of the
+ *  extrinsic curvature of the kerr BHL CTT initial data
+ */
+static void kerr_BHL_CTT_sA(
+  real_t x, real_t y, real_t z, real_t r, real_t a, double l, double sigma,
+  real_t & W, real_t & sA11, real_t & sA12, real_t & sA13,
+  real_t & sA22, real_t & sA23, real_t & sA33)
+{
+  W = 0;
+  sA11 = sA12 = sA13 = sA22 = sA23 = sA33 = 0;
+
+  if(r < l)
+  {
+    W = 0;
+    sA11 = -6.0 * a * x * y/ pow(r, 5.0);
+    sA12 = 3.0 * a * (pw2(x) - pw2(y)) / pow(r, 5.0);
+    sA13 = -3.0 * a * y * z/ pow(r, 5.0);
+    sA22 = 6.0 * a * x * y/ pow(r, 5.0);
+    sA23 = 3.0 * a * x * z/ pow(r, 5.0);
+  }
+  else if(r<l+sigma)
+  {
+    W = std::pow(pow((r-l-sigma)/(sigma),6) - 1.0, 6 );
+    sA11 = 
+      +6*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+    sA12 =                
+       + 3*a*pow(r,-5)*(12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(x,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(y,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + 
+                        pow(x,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)) - pow(y,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)));
+    sA13 = +3*a*y*z*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+    sA22 =              
+      -6*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+    sA23 = -3*a*x*z*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+  }
+  else
+    W = 1;
+}
+
 // constructing kerr blackhole lattice initial data
 // with conformal transverse-traceless decomposition
 void bssn_ic_kerr_BHL_CTT(
@@ -1403,7 +1782,8 @@ void bssn_ic_kerr_BHL_CTT(
   idx_t num_vcycles,
   idx_t max_depth,
   double l,
-  double sigma)
+  double sigma,
+  bool distributed_multigrid)
 {
   const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
   hier::VariableDatabase* variable_db = hier::VariableDatabase::getDatabase();
@@ -1493,430 +1873,180 @@ void bssn_ic_kerr_BHL_CTT(
    idx_t NZ = round(L[2] / dx[2]);
 
 
-    // initializing solution vector
-   CosmoArray<idx_t, real_t> * X = new CosmoArray<idx_t, real_t> [4];
-
-   bool flag = false;
-
-    X[0].init(NX, NY, NZ);
-    X[1].init(NX, NY, NZ);
-    X[2].init(NX, NY, NZ);
-    X[3].init(NX, NY, NZ);
+    bool flag = false;
 
     idx_t molecule_n[4] = {27, 6, 6, 6};
 
-    atom atom_tmp = {0};
-    
-    FASMultigrid multigrid(
-      X, 4, molecule_n, max_depth, 2, relaxation_tolerance, L, NX, NY, NZ, bd_handler);
-
-    /***********start initializaing equations **********************/
-
-    multigrid.eqns[0][0].init(1, 1);
-    //adding laplacian term
-    atom_tmp.type =  multigrid.atom_type::lap;
-    atom_tmp.u_id = 0;
-    multigrid.eqns[0][0].add_atom(atom_tmp);
+    FASMultigrid * multigrid = NULL;
+    SAMRAIFASMultigrid * samrai_multigrid = NULL;
+    CosmoArray<idx_t, real_t> * X = NULL;
 
-    //adding \Psi^-7 term
-    for(int i = 1; i <= 3; i++)
-      for(int j = 1; j <= 3; j++)
-      {
-        atom_tmp.type = i+1;
-        atom_tmp.u_id = j;
-        if(i == j)
-          multigrid.eqns[0][3*(i-1)+j].init(3, 0.5 - 1.0/6.0);
-        else
-          multigrid.eqns[0][3*(i-1)+j].init(3, 0.25);
-        multigrid.eqns[0][3*(i-1)+j].add_atom(atom_tmp);
-
-        multigrid.eqns[0][3*(i-1)+j].add_atom(atom_tmp);
-
-        atom_tmp.type = 1;
-        atom_tmp.u_id = 0;
-        atom_tmp.value = -7;
-        multigrid.eqns[0][3*(i-1)+j].add_atom(atom_tmp);
-      }
-    for(int i = 1; i <= 3; i++)
-      for(int j = i+1; j <= 3; j++)
-      {
-        atom_tmp.type = i+1;
-        atom_tmp.u_id = j;
-        multigrid.eqns[0][(9 + i+j - 2)].init(3, 0.5);
-        multigrid.eqns[0][(9 + i+j - 2)].add_atom(atom_tmp);
-      
-        atom_tmp.type = j+1;
-        atom_tmp.u_id = i;
-        multigrid.eqns[0][(9 + i+j - 2)].add_atom(atom_tmp);
+    if(distributed_multigrid)
+    {
+      // solving on the patches of level ln, nothing is replicated
+      samrai_multigrid = new SAMRAIFASMultigrid(
+        hierarchy, ln, 4, molecule_n, max_depth, 2, relaxation_tolerance);
 
-        atom_tmp.type = 1;
-        atom_tmp.u_id = 0;
-        atom_tmp.value = -7;
-        multigrid.eqns[0][(9 + i+j - 2)].add_atom(atom_tmp);
-      }
+      kerr_BHL_CTT_init_eqns(*samrai_multigrid);
 
-    for(int i = 1; i <= 3; i++)
-      for(int j = i+1; j <= 3; j++)
+      for( hier::PatchLevel::iterator pit(level->begin());
+           pit != level->end(); ++pit)
       {
-        multigrid.eqns[0][(12 + i+j - 2)].init(3, -1.0/3.0);
-        atom_tmp.type = i+1;
-        atom_tmp.u_id = i;
-        multigrid.eqns[0][(12+i+j-2)].add_atom(atom_tmp);
+        hier::Patch & patch = **pit;
 
-        atom_tmp.type = j+1;
-        atom_tmp.u_id = j;
-        multigrid.eqns[0][(12+i+j-2)].add_atom(atom_tmp);
+        arr_t X_a[4], X_shift_a[4];
+        std::vector<std::vector<arr_t> > rho_a(4);
+        for(int u_id = 0; u_id < 4; u_id++)
+        {
+          X_a[u_id] = samrai_multigrid->getSolutionArray(patch, u_id);
+          X_shift_a[u_id] = samrai_multigrid->getShiftArray(patch, u_id);
+          rho_a[u_id].resize(molecule_n[u_id]);
+        }
 
-        atom_tmp.type = 1;
-        atom_tmp.u_id = 0;
-        atom_tmp.value = -7;
-        multigrid.eqns[0][(12 + i+j - 2)].add_atom(atom_tmp);
-      }
+        // molecules set by kerr_BHL_CTT_set_src_pt
+        for(int mol_id = 16; mol_id < molecule_n[0]; mol_id++)
+          rho_a[0][mol_id] = samrai_multigrid->getPolySrcArray(patch, 0, mol_id);
+        for(int u_id = 1; u_id < 4; u_id++)
+          for(int mol_id = 4; mol_id < molecule_n[u_id]; mol_id++)
+            rho_a[u_id][mol_id] =
+              samrai_multigrid->getPolySrcArray(patch, u_id, mol_id);
 
-    // adding \partial X \partial S terms
-    // where S is divergen shift
-    for(int i = 1; i <= 3; i++)
-      for(int j = 1; j <= 3; j++)
-      {
-        if( i == 3 && j == 3) continue;
+        const int * lower = &patch.getBox().lower()[0];
+        const int * upper = &patch.getBox().upper()[0];
 
-        multigrid.eqns[0][15+3*(i-1)+j].init(2, 1.0);
-        
-        atom_tmp.type = i+1;
-        atom_tmp.u_id = j;
-        multigrid.eqns[0][15+3*(i-1)+j].add_atom(atom_tmp);
+        for(int k = lower[2]; k <= upper[2]; k++)
+        for(int j = lower[1]; j <= upper[1]; j++)
+        for(int i = lower[0]; i <= upper[0]; i++)
+        {
+          real_t x = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
+          real_t y = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
+          real_t z = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
 
-        atom_tmp.type = 1;
-        atom_tmp.u_id = 0;
-        atom_tmp.value = -7;
-        multigrid.eqns[0][15+3*(i-1)+j].add_atom(atom_tmp);
+          // initial guess
+          X_a[0](i, j, k) = 1.0;
+          X_a[1](i, j, k) = 0;
+          X_a[2](i, j, k) = 0;
+          X_a[3](i, j, k) = 0;
+
+          kerr_BHL_CTT_set_src_pt(
+            x, y, z, M, a, K_c, l, sigma,
+            [&](idx_t eqn_id, idx_t mol_id, real_t value)
+            { rho_a[eqn_id][mol_id](i, j, k) = value; },
+            [&](idx_t u_id, real_t value)
+            { X_shift_a[u_id](i, j, k) = value; });
+        }
       }
 
-    // adding pure \partial S terms
-    multigrid.eqns[0][24].init(1, 1.0);
-    atom_tmp.type = 1;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = -7;
-    multigrid.eqns[0][24].add_atom(atom_tmp);
-
-    multigrid.eqns[0][25].init(1, 1.0);
-
-    // adding \Psi^5 terms
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 5;
-    multigrid.eqns[0][25].add_atom(atom_tmp);
-
-    // adding Lap(divergence part) as a ^0 polynomial
-    multigrid.eqns[0][26].init(1, 1.0);
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 0;
-    multigrid.eqns[0][26].add_atom(atom_tmp);
-    
-    // start adding momentum constraints
-    multigrid.eqns[1][0].init(1, 1.0);
-    multigrid.eqns[1][1].init(1, 1.0/3.0);
-    multigrid.eqns[1][2].init(1, 1.0/3.0);
-    multigrid.eqns[1][3].init(1, 1.0/3.0);
-    
-    multigrid.eqns[1][4].init(1, 1.0);
-    multigrid.eqns[1][5].init(1, 1.0);
-
-    multigrid.eqns[2][0].init(1, 1.0);
-    multigrid.eqns[2][1].init(1, 1.0/3.0);
-    multigrid.eqns[2][2].init(1, 1.0/3.0);
-    multigrid.eqns[2][3].init(1, 1.0/3.0);
-    multigrid.eqns[2][4].init(1, 1.0);
-    multigrid.eqns[2][5].init(1, 1.0);
-
-
-    multigrid.eqns[3][0].init(1, 1.0);
-    multigrid.eqns[3][1].init(1, 1.0/3.0);
-    multigrid.eqns[3][2].init(1, 1.0/3.0);
-    multigrid.eqns[3][3].init(1, 1.0/3.0);
-    multigrid.eqns[3][4].init(1, 1.0);
-    multigrid.eqns[3][5].init(1, 1.0);
-
-
-
-    //adding terms to eqn 1
-    atom_tmp.type = multigrid.atom_type::lap;
-    atom_tmp.u_id = 1;
-    multigrid.eqns[1][0].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der11;
-    atom_tmp.u_id = 1;
-    multigrid.eqns[1][1].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der12;
-    atom_tmp.u_id = 2;
-    multigrid.eqns[1][2].add_atom(atom_tmp);
+      samrai_multigrid->initializeRhoHeirarchy();
 
-    atom_tmp.type = multigrid.atom_type::der13;
-    atom_tmp.u_id = 3;
-    multigrid.eqns[1][3].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 6;
-    multigrid.eqns[1][4].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 0;
-    multigrid.eqns[1][5].add_atom(atom_tmp);
-
-  
-    //adding terms to eqn 2
-    atom_tmp.type = multigrid.atom_type::lap;
-    atom_tmp.u_id = 2;
-    multigrid.eqns[2][0].add_atom(atom_tmp);
-
-
-    atom_tmp.type = multigrid.atom_type::der12;
-    atom_tmp.u_id = 1;
-    multigrid.eqns[2][1].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der22;
-    atom_tmp.u_id = 2;
-    multigrid.eqns[2][2].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der23;
-    atom_tmp.u_id = 3;
-    multigrid.eqns[2][3].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 6;
-    multigrid.eqns[2][4].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 0;
-    multigrid.eqns[2][5].add_atom(atom_tmp);
-
-    
-    //adding terms to eqn 3
-    atom_tmp.type = multigrid.atom_type::lap;
-    atom_tmp.u_id = 3;
-    multigrid.eqns[3][0].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der13;
-    atom_tmp.u_id = 1;
-    multigrid.eqns[3][1].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der23;
-    atom_tmp.u_id = 2;
-    multigrid.eqns[3][2].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::der33;
-    atom_tmp.u_id = 3;
-    multigrid.eqns[3][3].add_atom(atom_tmp);
-
-    
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 0;
-    multigrid.eqns[3][5].add_atom(atom_tmp);
-
-    atom_tmp.type = multigrid.atom_type::poly;
-    atom_tmp.u_id = 0;
-    atom_tmp.value = 6;
-    multigrid.eqns[3][4].add_atom(atom_tmp);
-
-  
-  /*********ending initializing equations************/
-    
-    for(int i=0; i<NX; ++i) 
-    for(int j=0; j<NY; ++j) 
-    for(int k=0; k<NZ; ++k)
+      samrai_multigrid->VCycles(num_vcycles);
+    }
+    else
     {
-      real_t x = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
-      real_t y = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
-      real_t z = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
+      // initializing solution vector
+      X = new CosmoArray<idx_t, real_t> [4];
 
-      real_t r = sqrt(pw2(x ) + pw2(y ) + pw2(z ));
-      real_t phi = atan(y / x);
-      real_t theta = acos(z / sqrt(pw2(x) + pw2(y) + pw2(z))); 
+      X[0].init(NX, NY, NZ);
+      X[1].init(NX, NY, NZ);
+      X[2].init(NX, NY, NZ);
+      X[3].init(NX, NY, NZ);
 
-      real_t W = 0;
-      real_t lap_Wr = 0, dx_K = 0, dy_K = 0, dz_K = 0;
-      real_t sup_X1 = 0, sup_X2 = 0, sup_X3 = 0;
+      multigrid = new FASMultigrid(
+        X, 4, molecule_n, max_depth, 2, relaxation_tolerance, L, NX, NY, NZ, bd_handler);
 
-      real_t ds = (l-r+sigma)/sigma;
+      kerr_BHL_CTT_init_eqns(*multigrid);
 
-      real_t d1S1 = 0, d1S2 = 0, d1S3 = 0, d2S1 = 0, d2S2 = 0,
-        d2S3 = 0, d3S1 = 0, d3S2 = 0, d3S3 = 0;
-      
-      if(r < l)
+      for(int i=0; i<NX; ++i) 
+      for(int j=0; j<NY; ++j) 
+      for(int k=0; k<NZ; ++k)
       {
-        W = 0;
-        d1S1 = - 3.0 * a * x * y / pow(r, 5.0);
-        d1S2 = - a * (r*r - 3 * x * x) / pow(r, 5.0);
-        d2S1 = a * (r*r - 3 * y * y) / pow(r, 5.0);
-        d2S2 = 3.0 * a * x * y / pow(r, 5.0);
-        d3S1 = -3.0 * a * z * y / pow(r, 5.0);
-        d3S2 = 3.0 * a * x * z / pow(r, 5.0);
-      }
-      else if(r<l+sigma)
-      {
-        W = std::pow(pow((r-l-sigma)/(sigma),6) - 1.0, 6 );
-        // calculating derivative of W(r)/r
-        lap_Wr = 90.0 * pow( (l-r+sigma) / sigma, 4.0)
-          * pow(pow((r-l-sigma)/(sigma), 6) - 1.0, 4.0)
-          * (-1.0+ 7 * pow( (l-r+sigma) / sigma, 6.0)) / (r * pw2(sigma));
-        // calculating derivative of K
-        dx_K = -36.0 * K_c * x * pow((l-r+sigma)/sigma,5.0)
-          * pow(pow((r-l-sigma)/(sigma), 6) - 1.0 , 5) / (r * sigma);
-        dy_K = -36.0 * K_c * y * pow((l-r+sigma)/sigma,5.0)
-          * pow(pow((r-l-sigma)/(sigma), 6) - 1.0 , 5) / (r * sigma);
-        dz_K = -36.0 * K_c * z * pow((l-r+sigma)/sigma,5.0)
-          * pow(pow((r-l-sigma)/(sigma), 6) - 1.0 , 5) / (r * sigma);
-
-        sup_X1 = - 36.0 * a * y * pow(ds, 4) * pow( 1.0 - pow(ds, 6), 4)
-          * (30.0 * r * pow(ds, 6) - 5.0 * r * (1- pow(ds, 6))
-             - 2.0 * (l-r+sigma) * (1.0 - pow(ds, 6.0))) / pow(r, 4.0) / sigma / sigma; 
-
-        sup_X2 = 36.0 * a * x * pow(ds, 4) * pow( 1.0 - pow(ds, 6), 4)
-          * (30.0 * r * pow(ds, 6) - 5.0 * r * (1- pow(ds, 6))
-             - 2.0 * (l-r+sigma) * (1.0 - pow(ds, 6.0))) / pow(r, 4.0) / sigma / sigma;
-        
-        sup_X3 = 0;
-
-
-        d1S1 = 3*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
-        d1S2 = a*pow(r,-5)*(36*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(x,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) - pow(r,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)) + 
-                            3*pow(x,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)));
-        d2S1 = -(a*pow(r,-5)*(36*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(y,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) - pow(r,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)) + 
-                              3*pow(y,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6))));
-        d2S2 = -3*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
-
-        d3S1 = 3*a*y*z*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
-
-        d3S2 = -3*a*x*z*pow(r,-5)*pow(sigma,-36)*(-pow(sigma,36) - 12*r*pow(l - r + sigma,5)*pow(pow(sigma,6) - pow(l - r + sigma,6),5) + pow(pow(sigma,6) - pow(l - r + sigma,6),6));
-        
+        real_t x = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
+        real_t y = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
+        real_t z = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
+
+        // initial guess
+        X[0][INDEX(i,j,k)] = 1.0;
+
+        X[1][INDEX(i,j,k)] = 0;
+        X[2][INDEX(i,j,k)] = 0;
+        X[3][INDEX(i,j,k)] = 0;
+
+        kerr_BHL_CTT_set_src_pt(
+          x, y, z, M, a, K_c, l, sigma,
+          [&](idx_t eqn_id, idx_t mol_id, real_t value)
+          { multigrid->setPolySrcAtPt(eqn_id, mol_id, i, j, k, value); },
+          [&](idx_t u_id, real_t value)
+          { multigrid->setShiftSrcAtPt(u_id, i, j, k, value); });
       }
-      else
-        W = 1;
-      
-
-      real_t K = K_c * W;
-
-
-      // initial guess
-      X[0][INDEX(i,j,k)] = 1.0;
-
-      X[1][INDEX(i,j,k)] = 0;
-      X[2][INDEX(i,j,k)] = 0;
-      X[3][INDEX(i,j,k)] = 0;
-      
-      // set coeficient of \Psi^5
-      multigrid.setPolySrcAtPt(0, 25, i, j, k, -K*K / 12.0);
-      
-      multigrid.setPolySrcAtPt(0, 26, i, j, k, -M * lap_Wr);
-      real_t const_f_of_psi7;
-      const_f_of_psi7 = 
-        + (2.0 * (d1S1*d1S1 + d2S2*d2S2 + d3S3*d3S3)
-        + d1S2*d1S2 + d2S1*d2S1 + d1S3*d1S3 + d3S1*d3S1 + d2S3*d2S3 + d3S2*d3S2
-        + d1S2*d2S1 + d2S1*d1S2 + d1S3*d3S1 + d3S1*d1S3 + d2S3*d3S2 + d3S2*d2S3)/4.0;
-      
-      multigrid.setPolySrcAtPt(0, 24, i, j, k, const_f_of_psi7); 
 
-      multigrid.setPolySrcAtPt(0, 16, i, j, k, d1S1); // coef of d1X1
-      multigrid.setPolySrcAtPt(0, 17, i, j, k, 0.5*(d1S2 + d2S1)); // coef of d1X2
-      multigrid.setPolySrcAtPt(0, 18, i, j, k, 0.5*d3S1); // coef of d1X3
-
-      multigrid.setPolySrcAtPt(0, 19, i, j, k, 0.5*(d2S1 + d1S2)); // coef of d2X1
-      multigrid.setPolySrcAtPt(0, 20, i, j, k, d2S2); // coef of d2X2
-      multigrid.setPolySrcAtPt(0, 21, i, j, k, 0.5*d3S2); // coef of d2X3
-
-      multigrid.setPolySrcAtPt(0, 22, i, j, k, 0.5*d3S1); // coef of d3X1
-      multigrid.setPolySrcAtPt(0, 23, i, j, k, 0.5*d3S2); // coef of d3X2
-      
-      multigrid.setPolySrcAtPt(1, 4, i, j, k, -2.0 * dx_K / 3.0);
-      multigrid.setPolySrcAtPt(2, 4, i, j, k, -2.0 * dy_K / 3.0); 
-      multigrid.setPolySrcAtPt(3, 4, i, j, k, -2.0 * dz_K / 3.0);
-
-      multigrid.setPolySrcAtPt(1, 5, i, j, k, sup_X1);
-      multigrid.setPolySrcAtPt(2, 5, i, j, k, sup_X2);
-      multigrid.setPolySrcAtPt(3, 5, i, j, k, sup_X3);
-      
-      multigrid.setShiftSrcAtPt(0, i, j, k, M / (2.0 * r) * (1 - W));
-      
-      multigrid.setShiftSrcAtPt(1, i, j, k, a * y * (1 - W) / pw3(r));
-      multigrid.setShiftSrcAtPt(2, i, j, k, - a * x * (1 - W) / pw3(r));
-      multigrid.setShiftSrcAtPt(3, i, j, k, 0);
-    }
-
-    bd_handler->fillBoundary(X[0]._array, X[0].nx, X[0].ny, X[0].nz);
-    bd_handler->fillBoundary(X[1]._array, X[1].nx, X[1].ny, X[1].nz);
-    bd_handler->fillBoundary(X[2]._array, X[2].nx, X[2].ny, X[2].nz);
-    bd_handler->fillBoundary(X[3]._array, X[3].nx, X[3].ny, X[3].nz);
+      bd_handler->fillBoundary(X[0]._array, X[0].nx, X[0].ny, X[0].nz);
+      bd_handler->fillBoundary(X[1]._array, X[1].nx, X[1].ny, X[1].nz);
+      bd_handler->fillBoundary(X[2]._array, X[2].nx, X[2].ny, X[2].nz);
+      bd_handler->fillBoundary(X[3]._array, X[3].nx, X[3].ny, X[3].nz);
     
-    multigrid.initializeRhoHeirarchy();
+      multigrid->initializeRhoHeirarchy();
 
-      
-    std::shared_ptr<tbox::HDFDatabase > hdf (new tbox::HDFDatabase("hdf_db"));
+      std::shared_ptr<tbox::HDFDatabase > hdf (new tbox::HDFDatabase("hdf_db"));
 
-    std::string filename = "h5_init_data";
+      std::string filename = "h5_init_data";
 
-    mpi.Barrier();
-    std::ifstream file(filename);
+      mpi.Barrier();
+      std::ifstream file(filename);
     
-    // if file exists, reading from file
-    // run multigrid solver otherwise
-    if(file)
-    {
-      int rank = 0;
-      while(rank < mpi.getSize())
+      // if file exists, reading from file
+      // run multigrid solver otherwise
+      if(file)
       {
-        if(rank == mpi.getRank())
+        int rank = 0;
+        while(rank < mpi.getSize())
         {
-          hdf->open(filename, 1);
-          const std::vector<double> & temp_X0 = hdf->getDoubleVector("X0");
-          const std::vector<double> & temp_X1 = hdf->getDoubleVector("X1");
-          const std::vector<double> & temp_X2 = hdf->getDoubleVector("X2");
-          const std::vector<double> & temp_X3 = hdf->getDoubleVector("X3");
+          if(rank == mpi.getRank())
+          {
+            hdf->open(filename, 1);
+            const std::vector<double> & temp_X0 = hdf->getDoubleVector("X0");
+            const std::vector<double> & temp_X1 = hdf->getDoubleVector("X1");
+            const std::vector<double> & temp_X2 = hdf->getDoubleVector("X2");
+            const std::vector<double> & temp_X3 = hdf->getDoubleVector("X3");
 
-          // if file exist but corresponding database not exist
-          if(temp_X0.empty())
-            TBOX_ERROR("Getting empty array from file "<<filename<<"\n");
+            // if file exist but corresponding database not exist
+            if(temp_X0.empty())
+              TBOX_ERROR("Getting empty array from file "<<filename<<"\n");
 
-          tbox::pout<<"Read initial configuration database "<<"\n";
+            tbox::pout<<"Read initial configuration database "<<"\n";
     
-          for(int i = 0; i < temp_X0.size(); i++)
-          {
-            X[0]._array[i] = temp_X0[i];
-            X[1]._array[i] = temp_X1[i];
-            X[2]._array[i] = temp_X2[i];
-            X[3]._array[i] = temp_X3[i];
+            for(int i = 0; i < temp_X0.size(); i++)
+            {
+              X[0]._array[i] = temp_X0[i];
+              X[1]._array[i] = temp_X1[i];
+              X[2]._array[i] = temp_X2[i];
+              X[3]._array[i] = temp_X3[i];
+            }
+            flag = true;
+            hdf->close();
           }
-          flag = true;
-          hdf->close();
+          mpi.Barrier();
+          rank ++;
         }
-        mpi.Barrier();
-        rank ++;
+        //      multigrid->VCycles(num_vcycles);
       }
-      //      multigrid.VCycles(num_vcycles);
-    }
-    else
-    {
-      multigrid.VCycles(num_vcycles);
-      if(mpi.getRank() == 0)
+      else
       {
-        // create and open the file
-        hdf->create(filename);
-        hdf->open(filename, 1);
+        multigrid->VCycles(num_vcycles);
+        if(mpi.getRank() == 0)
+        {
+          // create and open the file
+          hdf->create(filename);
+          hdf->open(filename, 1);
 
-        hdf->putDoubleArray("X0", X[0]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
-        hdf->putDoubleArray("X1", X[1]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
-        hdf->putDoubleArray("X2", X[2]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
-        hdf->putDoubleArray("X3", X[3]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
-        hdf->close();
-      }
-      flag = true;
+          hdf->putDoubleArray("X0", X[0]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
+          hdf->putDoubleArray("X1", X[1]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
+          hdf->putDoubleArray("X2", X[2]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
+          hdf->putDoubleArray("X3", X[3]._array, (NX+2*STENCIL_ORDER)*(NY+2*STENCIL_ORDER)*(NZ+2*STENCIL_ORDER));
+          hdf->close();
+        }
+        flag = true;
       
+      }
     }
     /**************debuging *************/
     
@@ -2054,6 +2184,11 @@ void bssn_ic_kerr_BHL_CTT(
       pdat::ArrayDataAccess::access<DIM, real_t>(
         DIFFK_a_pdata->getArrayData());
     
+    arr_t X_a[4];
+    if(distributed_multigrid)
+      for(int u_id = 0; u_id < 4; u_id++)
+        X_a[u_id] = samrai_multigrid->getSolutionArray(*patch, u_id);
+
     const hier::Box& inner_box = patch->getBox();
 
     const int * lower = &box.lower()[0];
@@ -2078,85 +2213,49 @@ void bssn_ic_kerr_BHL_CTT(
           real_t phi = atan(y / x);
           real_t theta = acos(z / sqrt(pw2(x) + pw2(y) + pw2(z))); 
 
-          real_t W = 0;
-          real_t sA11 = 0, sA12 = 0, sA13 = 0, sA22 = 0, sA33 = 0, sA23 = 0;
+          real_t W, sA11, sA12, sA13, sA22, sA23, sA33;
+          kerr_BHL_CTT_sA(x, y, z, r, a, l, sigma,
+                          W, sA11, sA12, sA13, sA22, sA23, sA33);
 
-          if(r < l)
+          real_t K = K_c * W;
+
+          // solution and its derivatives, dX[d][u] = \partial_d X_u
+          real_t X0, dX[4][4];
+          if(distributed_multigrid)
           {
-            W = 0;
-            sA11 = -6.0 * a * x * y/ pow(r, 5.0);
-            sA12 = 3.0 * a * (pw2(x) - pw2(y)) / pow(r, 5.0);
-            sA13 = -3.0 * a * y * z/ pow(r, 5.0);
-            sA22 = 6.0 * a * x * y/ pow(r, 5.0);
-            sA23 = 3.0 * a * x * z/ pow(r, 5.0);
+            X0 = X_a[0](i, j, k);
+            for(int d = 1; d <= 3; d++)
+              for(int u_id = 1; u_id <= 3; u_id++)
+                dX[d][u_id] = derivative(i, j, k, d, X_a[u_id], dx);
           }
-          else if(r<l+sigma)
+          else
           {
-            W = std::pow(pow((r-l-sigma)/(sigma),6) - 1.0, 6 );
-            sA11 = 
-              +6*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
-            sA12 =                
-               + 3*a*pow(r,-5)*(12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(x,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(y,2)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + 
-                                pow(x,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)) - pow(y,2)*(1 - pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6)));
-            sA13 = +3*a*y*z*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
-            sA22 =              
-              -6*a*x*y*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
-            sA23 = -3*a*x*z*pow(r,-5)*(-1 - 12*r*pow(sigma,-6)*pow(l - r + sigma,5)*pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),5) + pow(1 - pow(sigma,-6)*pow(l - r + sigma,6),6));
+            X0 = X[0][INDEX(i, j, k)];
+            for(int d = 1; d <= 3; d++)
+              for(int u_id = 1; u_id <= 3; u_id++)
+                dX[d][u_id] = multigrid->derivative(i, j, k, NX, NY, NZ, d, X[u_id]);
           }
-          else
-            W = 1;
-          real_t K = K_c * W;
 
-          real_t ds = (l-r+sigma)/sigma;
-          
+          real_t psi = X0 + M / (2.0 * r) * (1 - W);
+
           DIFFK_a(i, j, k) = K;
-          DIFFchi_a(i,j,k) = 1.0 / pw2(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W)) - 1.0;
+          DIFFchi_a(i,j,k) = 1.0 / pw2(psi) - 1.0;
           //          DIFFalpha_a(i, j, k) = DIFFchi_a(i, j, k);
-          
-          
-          real_t temp = 0.0;
-
-          for(idx_t kk = 1; kk <=3; kk++)
-            temp += multigrid.derivative(i, j, k, NX, NY, NZ, kk, X[kk]);
-
-          
-          A11_a(i, j, k) = std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0)
-            * (multigrid.derivative(i, j, k, NX, NY, NZ, 1, X[1])
-               + multigrid.derivative(i, j, k, NX, NY, NZ, 1, X[1])
-               - 2.0 * temp / 3.0);
-
-          // if(i == (inner_upper[1] + 1)/2 && j == (inner_upper[1] + 1)/2 && k ==(inner_upper[1] + 1)/2)
-          //   std::cout<<"!@!!! "<<X[0][INDEX(i, j, k)]<<"\n";
-          
-          A12_a(i, j, k) = std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0)
-            * (multigrid.derivative(i, j, k, NX, NY, NZ, 1, X[2])
-               + multigrid.derivative(i, j, k, NX, NY, NZ, 2, X[1]));
-
-          
-          A13_a(i, j, k) = std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) *
-            (multigrid.derivative(i, j, k, NX, NY, NZ, 1, X[3])
-             + multigrid.derivative(i, j, k, NX, NY, NZ, 3, X[1]));
 
-          
-          A22_a(i, j, k) = std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) *
-            (multigrid.derivative(i, j, k, NX, NY, NZ, 2, X[2])
-             + multigrid.derivative(i, j, k, NX, NY, NZ, 2, X[2])
-             - 2.0 * temp / 3.0);
-          
-          A23_a(i, j, k) = std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) *
-            (multigrid.derivative(i, j, k, NX, NY, NZ, 2, X[3])
-             + multigrid.derivative(i, j, k, NX, NY, NZ, 3, X[2]));
-          
-          A33_a(i, j, k) = std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) *
-            (multigrid.derivative(i, j, k, NX, NY, NZ, 3, X[3])
-             + multigrid.derivative(i, j, k, NX, NY, NZ, 3, X[3])
-             - 2.0 * temp / 3.0);
-
-          A11_a(i, j, k) += std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) * sA11;
-          A12_a(i, j, k) += std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) * sA12;
-          A13_a(i, j, k) += std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) * sA13;
-          A22_a(i, j, k) += std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) * sA22;
-          A23_a(i, j, k) += std::pow(X[0][INDEX(i, j, k)] + M / (2.0 * r) * (1 - W), -6.0) * sA23;
+          real_t temp = dX[1][1] + dX[2][2] + dX[3][3];
+
+          A11_a(i, j, k) = std::pow(psi, -6.0)
+            * (dX[1][1] + dX[1][1] - 2.0 * temp / 3.0 + sA11);
+          A12_a(i, j, k) = std::pow(psi, -6.0)
+            * (dX[1][2] + dX[2][1] + sA12);
+          A13_a(i, j, k) = std::pow(psi, -6.0)
+            * (dX[1][3] + dX[3][1] + sA13);
+          A22_a(i, j, k) = std::pow(psi, -6.0)
+            * (dX[2][2] + dX[2][2] - 2.0 * temp / 3.0 + sA22);
+          A23_a(i, j, k) = std::pow(psi, -6.0)
+            * (dX[2][3] + dX[3][2] + sA23);
+          A33_a(i, j, k) = std::pow(psi, -6.0)
+            * (dX[3][3] + dX[3][3] - 2.0 * temp / 3.0 + sA33);
         }
       }
     }
@@ -2239,7 +2338,8 @@ void bssn_ic_kerr_BHL_CTT(
 
   }
 
-
+  delete multigrid;
+  delete samrai_multigrid;
 }
 
   //http://arxiv.org/abs/1001.4077v1
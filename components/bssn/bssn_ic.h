@@ -58,7 +58,8 @@ void bssn_ic_kerr_BHL_CTT(
   idx_t num_vcycles,
   idx_t max_depth,
   double l,
-  double sigma);
+  double sigma,
+  bool distributed_multigrid = false);
 
 void bssn_ic_static_BHL_CTT(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
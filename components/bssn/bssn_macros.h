@@ -11,6 +11,14 @@
   function(theta, __VA_ARGS__);
 
 
+// theta only carries dynamics (and derivatives) in the Z4c formulation
+#if USE_Z4C
+  #define Z4C_APPLY_TO_EVOLVED_FIELDS(function) \
+    function(theta);
+#else
+  #define Z4C_APPLY_TO_EVOLVED_FIELDS(function)
+#endif
+
 #if USE_BSSN_SHIFT
   #define BSSN_APPLY_TO_SHIFT(function)  \
     function(beta1); \
@@ -209,18 +217,120 @@
   function(3, 3, 3);
 
 
+// fields carrying an upwinded advection term, beta^i d_i (field)
+#define BSSN_APPLY_TO_ADVECTED_FIELDS(function) \
+  function(DIFFgamma11);                        \
+  function(DIFFgamma12);                        \
+  function(DIFFgamma13);                        \
+  function(DIFFgamma22);                        \
+  function(DIFFgamma23);                        \
+  function(DIFFgamma33);                        \
+  function(DIFFchi);                            \
+  function(A11);                                \
+  function(A12);                                \
+  function(A13);                                \
+  function(A22);                                \
+  function(A23);                                \
+  function(A33);                                \
+  function(DIFFK);                              \
+  function(Gamma1);                             \
+  function(Gamma2);                             \
+  function(Gamma3);                             \
+  function(DIFFalpha);                          \
+  Z4C_APPLY_TO_EVOLVED_FIELDS(function)         \
+  BSSN_APPLY_TO_EXP_N(function)
+
+// fields carrying Kreiss-Oliger dissipation
+#define BSSN_APPLY_TO_DISSIPATED_FIELDS(function) \
+  BSSN_APPLY_TO_ADVECTED_FIELDS(function)         \
+  BSSN_APPLY_TO_SHIFT(function)                   \
+  BSSN_APPLY_TO_AUX_B(function)
+
+#define BSSN_DECLARE_ADV_KO(field) \
+  real_t field##_adv, field##_KO
+
+#define BSSN_CALCULATE_ADVECTION(field) \
+  bd->field##_adv = upwind_derivative(bd->i, bd->j, bd->k, 1, field##_a, dx, bd->beta1) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, field##_a, dx, bd->beta2) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, field##_a, dx, bd->beta3)
+
+#define BSSN_CALCULATE_DISSIPATION(field) \
+  bd->field##_KO = KO_dissipation_Q(bd->i, bd->j, bd->k, field##_a, dx, KO_damping_coefficient)
+
+#define BSSN_CALCULATE_DGAMMAI(I) \
+  bd->d1Gamma##I = derivative(bd->i, bd->j, bd->k, 1, Gamma##I##_a, dx); \
+  bd->d2Gamma##I = derivative(bd->i, bd->j, bd->k, 2, Gamma##I##_a, dx); \
+  bd->d3Gamma##I = derivative(bd->i, bd->j, bd->k, 3, Gamma##I##_a, dx)
+
+#define BSSN_CALCULATE_DIDJ_PERMS(I, J, field, name) \
+  bd->d##I##d##J##name = double_derivative(bd->i, bd->j, bd->k, I, J, field##_a, dx)
+
+#define BSSN_CALCULATE_DIDJALPHA_PARTIAL(I, J) \
+  BSSN_CALCULATE_DIDJ_PERMS(I, J, DIFFalpha, a)
+
+#define BSSN_CALCULATE_DIDJBETA(I, J) \
+  BSSN_CALCULATE_DIDJ_PERMS(I, J, beta1, beta1); \
+  BSSN_CALCULATE_DIDJ_PERMS(I, J, beta2, beta2); \
+  BSSN_CALCULATE_DIDJ_PERMS(I, J, beta3, beta3)
+
+
+// fields whose first / second derivatives are precomputed along a pencil
+#define BSSN_APPLY_TO_PENCIL_D_FIELDS(function) \
+  function(DIFFgamma11);                        \
+  function(DIFFgamma12);                        \
+  function(DIFFgamma13);                        \
+  function(DIFFgamma22);                        \
+  function(DIFFgamma23);                        \
+  function(DIFFgamma33);                        \
+  function(DIFFchi);                            \
+  function(DIFFalpha);                          \
+  function(DIFFK);                              \
+  function(Gamma1);                             \
+  function(Gamma2);                             \
+  function(Gamma3);                             \
+  Z4C_APPLY_TO_EVOLVED_FIELDS(function)         \
+  BSSN_APPLY_TO_SHIFT(function)
+
+#define BSSN_APPLY_TO_PENCIL_DD_FIELDS(function) \
+  function(DIFFgamma11);                         \
+  function(DIFFgamma12);                         \
+  function(DIFFgamma13);                         \
+  function(DIFFgamma22);                         \
+  function(DIFFgamma23);                         \
+  function(DIFFgamma33);                         \
+  function(DIFFchi);                             \
+  function(DIFFalpha);                           \
+  BSSN_APPLY_TO_SHIFT(function)
+
+#define BSSN_PENCIL_DECLARE_D(field) \
+  real_t *d1_##field, *d2_##field, *d3_##field
+
+#define BSSN_PENCIL_DECLARE_DD(field) \
+  real_t *d1d1_##field, *d1d2_##field, *d1d3_##field, \
+    *d2d2_##field, *d2d3_##field, *d3d3_##field
+
+#define BSSN_PENCIL_DECLARE_ADV(field) \
+  real_t *adv_##field
+
+#define BSSN_PENCIL_DECLARE_KO(field) \
+  real_t *KO_##field
+
+
 #define BSSN_DEBUG(field) \
   if(tbox::MathUtilities< double >::isNaN(field##_s(i,j,k)))  \
     std::cout<<i<<" "<<j<<" "<<k<<" "<<" "<<#field<<"\n";
 
     
 // Evolve all fields
+// (low-storage RK stages keep lsrk_stage_A * previous increment in _s)
 #define BSSN_RK_EVOLVE_PT_FIELD(field) \
-  field##_s(i,j,k) = ev_##field(&bd, dx) * dt;
+  field##_s(i,j,k) = ev_##field(&bd, dx) * dt \
+    + ((lsrk_stage_A != 0) ? lsrk_stage_A * field##_s(i,j,k) : 0);
 
 // Evolve all fields
 #define BSSN_RK_EVOLVE_BD_FIELD(field) \
-  field##_s(i,j,k) = ev_##field##_bd(&bd, dx, l_idx, codim) * dt;
+  field##_s(i,j,k) = ev_##field##_bd(&bd, dx, l_idx, codim) * dt \
+    + ((lsrk_stage_A != 0) ? lsrk_stage_A * field##_s(i,j,k) : 0);
 
 #define BSSN_RK_EVOLVE_PT \
   BSSN_APPLY_TO_FIELDS(BSSN_RK_EVOLVE_PT_FIELD)
@@ -232,6 +342,9 @@
 #define BSSN_FINALIZE_K(n) \
   BSSN_APPLY_TO_FIELDS(RK4_FINALIZE_FIELD##_##n)
 
+#define BSSN_FINALIZE_LSRK(B) \
+  BSSN_APPLY_TO_FIELDS_ARGS(LSRK_FINALIZE_FIELD, B)
+
 
 
 /*
@@ -260,7 +373,7 @@
 
 // needs the gamma*ldlphi vars defined:
 // not actually trace free yet!
-#define BSSN_CALCULATE_DIDJALPHA(I, J) bd->D##I##D##J##aTF = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFalpha_a, dx) - ( \
+#define BSSN_CALCULATE_DIDJALPHA(I, J) bd->D##I##D##J##aTF = bd->d##I##d##J##a - ( \
     (bd->G1##I##J - 1.0/bd->chi*( (1==I)*bd->d##J##chi + (1==J)*bd->d##I##chi - bd->gamma##I##J*gammai1ldlchi))*bd->d1a + \
     (bd->G2##I##J - 1.0/bd->chi*( (2==I)*bd->d##J##chi + (2==J)*bd->d##I##chi - bd->gamma##I##J*gammai2ldlchi))*bd->d2a + \
     (bd->G3##I##J - 1.0/bd->chi*( (3==I)*bd->d##J##chi + (3==J)*bd->d##I##chi - bd->gamma##I##J*gammai3ldlchi))*bd->d3a \
@@ -271,7 +384,7 @@
   bd->gammai##K##L*bd->d##K##d##L##g##I##J
 
 #define BSSN_CALCULATE_RICCI_UNITARY_TERM2(K, I, J) \
-  bd->gamma##K##I*derivative(bd->i, bd->j, bd->k, J, Gamma##K##_a, dx)
+  bd->gamma##K##I*bd->d##J##Gamma##K
 
 #define BSSN_CALCULATE_RICCI_UNITARY_TERM3(K, I, J) \
   bd->Gammad##K*bd->GL##I##J##K
@@ -318,9 +431,7 @@
 #if USE_BSSN_SHIFT
 #define BSSN_DT_DIFFGAMMAIJ(I, J) ( \
     - 2.0*bd->alpha*bd->A##I##J \
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFgamma##I##J##_a, dx, bd->beta1) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFgamma##I##J##_a, dx, bd->beta2) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFgamma##I##J##_a, dx, bd->beta3) \
+    + bd->DIFFgamma##I##J##_adv \
     + bd->gamma##I##1*bd->d##J##beta1 + bd->gamma##I##2*bd->d##J##beta2 + bd->gamma##I##3*bd->d##J##beta3 \
     + bd->gamma##J##1*bd->d##I##beta1 + bd->gamma##J##2*bd->d##I##beta2 + bd->gamma##J##3*bd->d##I##beta3 \
     - (2.0/3.0)*bd->gamma##I##J*(bd->d1beta1 + bd->d2beta2 + bd->d3beta3) \
@@ -356,9 +467,7 @@
     pw2(bd->chi)*( bd->alpha*(bd->ricciTF##I##J - 8.0*PI*bd->STF##I##J          \
     ) - bd->D##I##D##J##aTF )          \
     + bd->alpha*(BSSN_DT_AIJ_SECOND_ORDER_KA(I,J) - 2.0*BSSN_DT_AIJ_SECOND_ORDER_AA(I,J)) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, A##I##J##_a, dx, bd->beta1)     \
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, A##I##J##_a, dx, bd->beta2)     \
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, A##I##J##_a, dx, bd->beta3)     \
+    + bd->A##I##J##_adv \
     + bd->A##I##1*bd->d##J##beta1 + bd->A##I##2*bd->d##J##beta2 + bd->A##I##3*bd->d##J##beta3 \
     + bd->A##J##1*bd->d##I##beta1 + bd->A##J##2*bd->d##I##beta2 + bd->A##J##3*bd->d##I##beta3 \
     - (2.0/3.0)*bd->A##I##J*(bd->d1beta1 + bd->d2beta2 + bd->d3beta3) \
@@ -400,19 +509,17 @@
 
 #if USE_BSSN_SHIFT
 #define BSSN_DT_GAMMAI_SHIFT(I) ( \
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, Gamma##I##_a, dx, bd->beta1) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, Gamma##I##_a, dx, bd->beta2) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, Gamma##I##_a, dx, bd->beta3) \
+    + bd->Gamma##I##_adv \
     - bd->Gammad1*bd->d1beta##I - bd->Gammad2*bd->d2beta##I - bd->Gammad3*bd->d3beta##I \
     + (2.0/3.0) * bd->Gammad##I * (bd->d1beta1 + bd->d2beta2 + bd->d3beta3) \
     + (1.0/3.0) * ( \
-        bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 1, 1, beta1##_a, dx) + bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 2, 1, beta2##_a, dx) + bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 3, 1, beta3##_a, dx) +  \
-        bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 1, 2, beta1##_a, dx) + bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 2, 2, beta2##_a, dx) + bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 3, 2, beta3##_a, dx) +  \
-        bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 1, 3, beta1##_a, dx) + bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 2, 3, beta2##_a, dx) + bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 3, 3, beta3##_a, dx) \
+        bd->gammai##I##1*bd->d1d1beta1 + bd->gammai##I##1*bd->d1d2beta2 + bd->gammai##I##1*bd->d1d3beta3 +  \
+        bd->gammai##I##2*bd->d1d2beta1 + bd->gammai##I##2*bd->d2d2beta2 + bd->gammai##I##2*bd->d2d3beta3 +  \
+        bd->gammai##I##3*bd->d1d3beta1 + bd->gammai##I##3*bd->d2d3beta2 + bd->gammai##I##3*bd->d3d3beta3 \
       ) \
     + ( \
-        bd->gammai11*double_derivative(bd->i, bd->j, bd->k, 1, 1, beta##I##_a, dx) + bd->gammai22*double_derivative(bd->i, bd->j, bd->k, 2, 2, beta##I##_a, dx) + bd->gammai33*double_derivative(bd->i, bd->j, bd->k, 3, 3, beta##I##_a, dx) \
-        + 2.0*(bd->gammai12*double_derivative(bd->i, bd->j, bd->k, 1, 2, beta##I##_a, dx) + bd->gammai13*double_derivative(bd->i, bd->j, bd->k, 1, 3, beta##I##_a, dx) + bd->gammai23*double_derivative(bd->i, bd->j, bd->k, 2, 3, beta##I##_a, dx)) \
+        bd->gammai11*bd->d1d1beta##I + bd->gammai22*bd->d2d2beta##I + bd->gammai33*bd->d3d3beta##I \
+        + 2.0*(bd->gammai12*bd->d1d2beta##I + bd->gammai13*bd->d1d3beta##I + bd->gammai23*bd->d2d3beta##I) \
       ) \
 )
 #else
@@ -0,0 +1,107 @@
+#ifndef BSSN_PENCIL_MACROS
+#define BSSN_PENCIL_MACROS
+
+/*
+ * Buffer layout: every quantity gets one slot of length "len" in "buf"
+ */
+
+#define BSSN_PENCIL_COUNT_D(field) pd.n_slots += 3
+#define BSSN_PENCIL_COUNT_DD(field) pd.n_slots += 6
+#define BSSN_PENCIL_COUNT_ONE(field) pd.n_slots += 1
+
+#define BSSN_PENCIL_SLOT (&buf[(slot++)*len])
+
+#define BSSN_PENCIL_ASSIGN_D(field) \
+  pd.d1_##field = BSSN_PENCIL_SLOT;  \
+  pd.d2_##field = BSSN_PENCIL_SLOT;  \
+  pd.d3_##field = BSSN_PENCIL_SLOT
+
+#define BSSN_PENCIL_ASSIGN_DD(field) \
+  pd.d1d1_##field = BSSN_PENCIL_SLOT; \
+  pd.d1d2_##field = BSSN_PENCIL_SLOT; \
+  pd.d1d3_##field = BSSN_PENCIL_SLOT; \
+  pd.d2d2_##field = BSSN_PENCIL_SLOT; \
+  pd.d2d3_##field = BSSN_PENCIL_SLOT; \
+  pd.d3d3_##field = BSSN_PENCIL_SLOT
+
+#define BSSN_PENCIL_ASSIGN_ADV(field) pd.adv_##field = BSSN_PENCIL_SLOT
+#define BSSN_PENCIL_ASSIGN_KO(field) pd.KO_##field = BSSN_PENCIL_SLOT
+
+/*
+ * Stencil evaluation along the pencil [i0, i0 + n) at fixed (j, k);
+ * directions are literals so the stencil switches fold away and the
+ * loops vectorize over i (unit stride in the column-major arrays).
+ */
+
+#define BSSN_PENCIL_LOOP(out, expr) \
+  _Pragma("omp simd")               \
+  for(idx_t ii = 0; ii < n; ii++)   \
+    out[ii] = (expr)
+
+#define BSSN_PENCIL_CALCULATE_D(field) \
+  BSSN_PENCIL_LOOP(pd.d1_##field, derivative(i0 + ii, j, k, 1, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d2_##field, derivative(i0 + ii, j, k, 2, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d3_##field, derivative(i0 + ii, j, k, 3, field##_a, dx))
+
+#define BSSN_PENCIL_CALCULATE_DD(field) \
+  BSSN_PENCIL_LOOP(pd.d1d1_##field, double_derivative(i0 + ii, j, k, 1, 1, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d1d2_##field, double_derivative(i0 + ii, j, k, 1, 2, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d1d3_##field, double_derivative(i0 + ii, j, k, 1, 3, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d2d2_##field, double_derivative(i0 + ii, j, k, 2, 2, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d2d3_##field, double_derivative(i0 + ii, j, k, 2, 3, field##_a, dx)); \
+  BSSN_PENCIL_LOOP(pd.d3d3_##field, double_derivative(i0 + ii, j, k, 3, 3, field##_a, dx))
+
+#define BSSN_PENCIL_CALCULATE_ADV(field) \
+  BSSN_PENCIL_LOOP(pd.adv_##field, \
+    upwind_derivative(i0 + ii, j, k, 1, field##_a, dx, beta1_a(i0 + ii, j, k)) \
+    + upwind_derivative(i0 + ii, j, k, 2, field##_a, dx, beta2_a(i0 + ii, j, k)) \
+    + upwind_derivative(i0 + ii, j, k, 3, field##_a, dx, beta3_a(i0 + ii, j, k)))
+
+#define BSSN_PENCIL_CALCULATE_KO(field) \
+  BSSN_PENCIL_LOOP(pd.KO_##field, \
+    KO_dissipation_Q(i0 + ii, j, k, field##_a, dx, KO_damping_coefficient))
+
+/*
+ * Copy pencil values at offset ii into a BSSNData struct
+ */
+
+#define BSSN_PENCIL_SET_DGAMMA(I, J, K) \
+  bd.d##I##g##J##K = pd.d##I##_DIFFgamma##J##K[ii]
+
+#define BSSN_PENCIL_SET_DDGAMMA(I, J) \
+  bd.d##I##d##J##g11 = pd.d##I##d##J##_DIFFgamma11[ii]; \
+  bd.d##I##d##J##g12 = pd.d##I##d##J##_DIFFgamma12[ii]; \
+  bd.d##I##d##J##g13 = pd.d##I##d##J##_DIFFgamma13[ii]; \
+  bd.d##I##d##J##g22 = pd.d##I##d##J##_DIFFgamma22[ii]; \
+  bd.d##I##d##J##g23 = pd.d##I##d##J##_DIFFgamma23[ii]; \
+  bd.d##I##d##J##g33 = pd.d##I##d##J##_DIFFgamma33[ii]
+
+#define BSSN_PENCIL_SET_DI(I) \
+  bd.d##I##chi = pd.d##I##_DIFFchi[ii];      \
+  bd.d##I##a = pd.d##I##_DIFFalpha[ii];      \
+  bd.d##I##K = pd.d##I##_DIFFK[ii];          \
+  bd.d##I##Gamma1 = pd.d##I##_Gamma1[ii];    \
+  bd.d##I##Gamma2 = pd.d##I##_Gamma2[ii];    \
+  bd.d##I##Gamma3 = pd.d##I##_Gamma3[ii]
+
+#define BSSN_PENCIL_SET_DIDJ(I, J) \
+  bd.d##I##d##J##chi = pd.d##I##d##J##_DIFFchi[ii]; \
+  bd.d##I##d##J##a = pd.d##I##d##J##_DIFFalpha[ii]
+
+#define BSSN_PENCIL_SET_DTHETA(I) \
+  bd.d##I##theta = pd.d##I##_theta[ii]
+
+#define BSSN_PENCIL_SET_DBETA(I) \
+  bd.d##I##beta1 = pd.d##I##_beta1[ii]; \
+  bd.d##I##beta2 = pd.d##I##_beta2[ii]; \
+  bd.d##I##beta3 = pd.d##I##_beta3[ii]
+
+#define BSSN_PENCIL_SET_DIDJBETA(I, J) \
+  bd.d##I##d##J##beta1 = pd.d##I##d##J##_beta1[ii]; \
+  bd.d##I##d##J##beta2 = pd.d##I##d##J##_beta2[ii]; \
+  bd.d##I##d##J##beta3 = pd.d##I##d##J##_beta3[ii]
+
+#define BSSN_PENCIL_SET_ADV(field) bd.field##_adv = pd.adv_##field[ii]
+#define BSSN_PENCIL_SET_KO(field) bd.field##_KO = pd.KO_##field[ii]
+
+#endif
@@ -0,0 +1,161 @@
+#include "bssn.h"
+#include "../../cosmo_includes.h"
+
+using namespace SAMRAI;
+
+namespace cosmo
+{
+
+/**
+ * @brief cut box into tiles of at most tile_size cells in every direction,
+ *        tiles are appended to tiles and tagged with owner
+ */
+static void bssn_tile_box(
+  const hier::Box & box, idx_t tile_size, idx_t owner,
+  std::vector<hier::Box> & tiles, std::vector<idx_t> & owners)
+{
+  if(box.empty()) return;
+
+  for(int k = box.lower()[2]; k <= box.upper()[2]; k += tile_size)
+    for(int j = box.lower()[1]; j <= box.upper()[1]; j += tile_size)
+      for(int i = box.lower()[0]; i <= box.upper()[0]; i += tile_size)
+      {
+        hier::Box tile(box);
+        tile.lower()[0] = i;
+        tile.lower()[1] = j;
+        tile.lower()[2] = k;
+        tile.upper()[0] = std::min(i + (int)tile_size - 1, box.upper()[0]);
+        tile.upper()[1] = std::min(j + (int)tile_size - 1, box.upper()[1]);
+        tile.upper()[2] = std::min(k + (int)tile_size - 1, box.upper()[2]);
+        tiles.push_back(tile);
+        owners.push_back(owner);
+      }
+}
+
+/**
+ * @brief make one shallow copy of the BSSN object per patch of level, with
+ *        patch data and arrays of that patch initialized
+ * @details BSSN keeps the arrays of a single patch as members, copies let
+ *  tiles of different patches be evolved at the same time.
+ */
+void BSSN::initLevelViews(
+  const std::shared_ptr<hier::PatchLevel> & level,
+  std::vector<BSSN> & views)
+{
+  views.clear();
+  views.reserve(level->getLocalNumberOfPatches());
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    views.push_back(*this);
+    views.back().initPData(*pit);
+    views.back().initMDA(*pit);
+  }
+}
+
+/**
+ * @brief RK evolve interior of all patches of level, tile by tile
+ * @details Has to be called by a single thread of an enclosing parallel
+ *  region; every tile becomes an OpenMP task, so idle threads of the team
+ *  pick up tiles of any patch. Returns when all tiles are done.
+ *
+ * @param level
+ * @param dt time step
+ * @param deep_interior_only only evolve cells returned by getDeepInteriorBox
+ */
+void BSSN::RKEvolveLevelTasks(
+  const std::shared_ptr<hier::PatchLevel> & level, real_t dt,
+  bool deep_interior_only)
+{
+  std::vector<BSSN> views;
+  initLevelViews(level, views);
+
+  std::vector<const real_t *> dxs;
+  std::vector<hier::Box> tiles;
+  std::vector<idx_t> owners;
+
+  for( hier::PatchLevel::iterator pit(level->begin());
+       pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+
+    const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+      SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+        patch->getPatchGeometry()));
+
+    dxs.push_back(&(patch_geom->getDx())[0]);
+
+    bssn_tile_box(
+      deep_interior_only ? getDeepInteriorBox(patch) : patch->getBox(),
+      tile_size, dxs.size() - 1, tiles, owners);
+  }
+
+  for(idx_t t = 0; t < (idx_t)tiles.size(); t++)
+  {
+#pragma omp task firstprivate(t) shared(views, dxs, tiles, owners)
+    views[owners[t]].RKEvolveBox(tiles[t], dxs[owners[t]], dt);
+  }
+#pragma omp taskwait
+}
+
+/**
+ * @brief RK evolve interior of all patches of level with the tiled executor
+ */
+void BSSN::RKEvolveLevelTiled(
+  const std::shared_ptr<hier::PatchLevel> & level, real_t dt)
+{
+#pragma omp parallel
+  {
+#pragma omp single
+    RKEvolveLevelTasks(level, dt, false);
+  }
+}
+
+/**
+ * @brief finalize an RK step (stage n = 1..4 of RK4, or a low-storage RK
+ *        stage) on interior and ghost cells of all patches of level,
+ *        tiles of all patches are scheduled as OpenMP tasks
+ *
+ * @param level
+ * @param n RK4 stage, or low-storage RK stage when use_low_storage_rk is set
+ */
+void BSSN::KFinalizeLevelTiled(
+  const std::shared_ptr<hier::PatchLevel> & level, int n)
+{
+  if(rotate_rk_registers && n == 1)
+  {
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+      detachAFromP(*pit);
+  }
+
+  std::vector<BSSN> views;
+  initLevelViews(level, views);
+
+  std::vector<hier::Box> tiles;
+  std::vector<idx_t> owners;
+
+  for(idx_t p = 0; p < (idx_t)views.size(); p++)
+    bssn_tile_box(views[p].DIFFchi_a_pdata->getGhostBox(),
+                  tile_size, p, tiles, owners);
+
+#pragma omp parallel
+  {
+#pragma omp single
+    {
+      for(idx_t t = 0; t < (idx_t)tiles.size(); t++)
+      {
+#pragma omp task firstprivate(t) shared(views, tiles, owners)
+        {
+          if(use_low_storage_rk)
+            views[owners[t]].LSRKFinalizeBox(tiles[t], n);
+          else
+            views[owners[t]].KFinalizeBox(tiles[t], n);
+        }
+      }
+    }
+  }
+}
+
+} // namespace cosmo
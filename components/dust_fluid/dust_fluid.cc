@@ -1,6 +1,7 @@
 #include "dust_fluid.h"
 #include "../../cosmo_includes.h"
 #include "../../utils/math.h"
+#include "../statistic/hierarchy_reduction.h"
 
 
 using namespace SAMRAI;
@@ -563,96 +564,113 @@ void DustFluid::K4FinalizePatch(
   }
 }
 
-void DustFluid::printWConstraint(
-  BSSN *bssn,   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t weight_idx)
+/**
+ * @brief maximum of the Lorentz factor W computed from the metric and the
+ *        velocity, and L2 norm of its difference to E / D
+ */
+class WConstraintKernel : public ReductionKernel
 {
-  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
-    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
-      hierarchy->getGridGeometry()));
-  TBOX_ASSERT(grid_geometry_);
-  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
+ public:
+  WConstraintKernel(
+    DustFluid *dust_fluid_in, BSSN *bssn_in, idx_t weight_idx_in,
+    const real_t L_in[]):
+    dust_fluid(dust_fluid_in),
+    bssn(bssn_in),
+    weight_idx(weight_idx_in)
+  {
+    for(int d = 0; d < DIM; d++)
+      L[d] = L_in[d];
+  }
 
-  const double * domain_lower = &grid_geometry.getXLower()[0];
-  const double * domain_upper = &grid_geometry.getXUpper()[0];
+  void initPatch(const std::shared_ptr<hier::Patch> & patch, idx_t ln)
+  {
+    dust_fluid->initPData(patch);
+    dust_fluid->initMDA(patch);
 
-  double L[3];
-  for(int i = 0 ; i < DIM; i++)
-    L[i] = domain_upper[i] - domain_lower[i];
+    bssn->initPData(patch);
+    bssn->initMDA(patch);
 
+    const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom( 
+      SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+        patch->getPatchGeometry()));
 
-  real_t max_WV = -1, L2_WV = 0;
-  for(idx_t ln = 0; ln < hierarchy->getNumberOfLevels(); ln++)
-  {
-    const std::shared_ptr<hier::PatchLevel> level(
-      hierarchy->getPatchLevel(ln));
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
-    {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
-      initPData(patch);
-      initMDA(patch);
+    for(int d = 0; d < DIM; d++)
+      dx[d] = patch_geom->getDx()[d];
 
-      bssn->initPData(patch);
-      bssn->initMDA(patch);
+    std::shared_ptr<pdat::CellData<double> > weight(
+      SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+        patch->getPatchData(weight_idx)));
 
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom( 
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
+    weight_array =
+      pdat::ArrayDataAccess::access<DIM, double>(
+        weight->getArrayData());
+  }
 
-      const real_t * dx = &(patch_geom->getDx())[0];
-  
-      const hier::Box& box = patch->getBox();
+  void accumulate(idx_t i, idx_t j, idx_t k, double * sums, double * maxima)
+  {
+    if(weight_array(i,j,k) > 0)
+    {
+      BSSNData bd = {0};
+      DustFluidData dd = {0};
+      bssn->set_bd_values_for_dust_fluid(i, j, k, &bd, dx);
+      dust_fluid->getDustFluidData(i, j, k, &bd, &dd, dx);
+      double W = dd.E / dd.D;
+      double v1 = dd.S1 / dd.E, v2 = dd.S2 / dd.E, v3 = dd.S3 / dd.E;
+      double Wp = 1.0 / sqrt(1- pw2(bd.chi) * bd.gammai11 * v1 * v1 + pw2(bd.chi) * bd.gammai22 * v2 * v2 + pw2(bd.chi) * bd.gammai33 * v3 * v3
+                                 + 2.0 * pw2(bd.chi) * bd.gammai12 * v1 * v2 + 2.0 * pw2(bd.chi) * bd.gammai13 * v1 * v3 + 2.0 * pw2(bd.chi) * bd.gammai23 * v2 * v3);
+      maxima[0] = std::max(maxima[0], fabs(Wp));
+      sums[0] += pw2(Wp-W)  * weight_array(i,j,k) / (L[0] * L[1] * L[2]);
+    }
+  }
 
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
+  void finalize(const double * sums, const double * maxima)
+  {
+    real_t max_WV = std::max(maxima[0], -1.0), L2_WV = sqrt(sums[0]);
+    tbox::pout<<"Maximum W is "<<max_WV<<", L2 is "<<L2_WV<<"\n";
+  }
 
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
+ private:
+  DustFluid *dust_fluid;
+  BSSN *bssn;
+  idx_t weight_idx;
 
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
+  real_t L[DIM], dx[DIM];
+  arr_t weight_array;
+};
 
-      
-#pragma omp parallel for collapse(2) reduction(max:max_WV) reduction(+:L2_WV)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-            if(weight_array(i,j,k) > 0)
-            {
-              BSSNData bd = {0};
-              DustFluidData dd = {0};
-              bssn->set_bd_values_for_dust_fluid(i, j, k, &bd, dx);
-              getDustFluidData(i, j, k, &bd, &dd, dx);
-              double W = dd.E / dd.D;
-              double v1 = dd.S1 / dd.E, v2 = dd.S2 / dd.E, v3 = dd.S3 / dd.E;
-              double Wp = 1.0 / sqrt(1- pw2(bd.chi) * bd.gammai11 * v1 * v1 + pw2(bd.chi) * bd.gammai22 * v2 * v2 + pw2(bd.chi) * bd.gammai33 * v3 * v3
-                                         + 2.0 * pw2(bd.chi) * bd.gammai12 * v1 * v2 + 2.0 * pw2(bd.chi) * bd.gammai13 * v1 * v3 + 2.0 * pw2(bd.chi) * bd.gammai23 * v2 * v3);
-              max_WV = std::max(max_WV, fabs(Wp));
-              L2_WV += pw2(Wp-W)  * weight_array(i,j,k) / (L[0] * L[1] * L[2]);;
-            }
-          }
-        }
-      }
-    }
+/**
+ * @brief register the W constraint with a reduction, it is written to
+ *        pout when the reduction is swept
+ */
+void DustFluid::addWConstraintKernel(
+  HierarchyReduction & reduction, BSSN *bssn,
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t weight_idx)
+{
+  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
+    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
+      hierarchy->getGridGeometry()));
+  TBOX_ASSERT(grid_geometry_);
+  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
 
-  }
+  const double * domain_lower = &grid_geometry.getXLower()[0];
+  const double * domain_upper = &grid_geometry.getXUpper()[0];
 
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&max_WV, 1, MPI_MAX);
-    mpi.AllReduce(&L2_WV, 1, MPI_SUM);
+  double L[3];
+  for(int i = 0 ; i < DIM; i++)
+    L[i] = domain_upper[i] - domain_lower[i];
 
-  }
-  L2_WV = sqrt(L2_WV);
-  tbox::pout<<"Maximum W is "<<max_WV<<", L2 is "<<L2_WV<<"\n";
+  reduction.addKernel(
+    std::shared_ptr<ReductionKernel>(
+      new WConstraintKernel(this, bssn, weight_idx, L)),
+    1, 1);
+}
 
+void DustFluid::printWConstraint(
+  BSSN *bssn,   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t weight_idx)
+{
+  HierarchyReduction reduction;
+  addWConstraintKernel(reduction, bssn, hierarchy, weight_idx);
+  reduction.sweep(hierarchy);
 }
 
 void DustFluid::addDerivedFields(
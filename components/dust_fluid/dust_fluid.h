@@ -14,6 +14,8 @@
 namespace cosmo
 {
 
+class HierarchyReduction;
+
 /** Static matter class **/
 class DustFluid
 {
@@ -160,6 +162,10 @@ public:
   void printWConstraint(
     BSSN *bssn,   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t weight_idx);
 
+  void addWConstraintKernel(
+    HierarchyReduction & reduction, BSSN *bssn,
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t weight_idx);
+
 
   
   // if true, will not change T_{\mu\nu}
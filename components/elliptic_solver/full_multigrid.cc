@@ -318,50 +318,39 @@ void FASMultigrid::add_atom_to_eqn(atom atom_in, idx_t molecule_id, idx_t eqn_id
 real_t FASMultigrid::_evaluateEllipticEquationPt(idx_t eqn_id, idx_t depth_idx,
   idx_t i, idx_t j, idx_t k)
 {
-  real_t res = 0.0;
-   
-  for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
-  {
-    // value will end up being the value of a particular term in an equation
-    real_t val = eqns[eqn_id][mol_id].const_coef;
-    idx_t pos_idx = B_INDEX(i, j, k,
-       nx_h[depth_idx], ny_h[depth_idx], nz_h[depth_idx]);
+  idx_t pos_idx = B_INDEX(i, j, k,
+    nx_h[depth_idx], ny_h[depth_idx], nz_h[depth_idx]);
 
-    if(rho_h[eqn_id][mol_id][depth_idx].pts > 0) // constant
-      val *= rho_h[eqn_id][mol_id][depth_idx][pos_idx];
-    
-    
-    for(idx_t atom_id = 0; atom_id < eqns[eqn_id][mol_id].atom_n; atom_id++)
+  return compiled_eqns[eqn_id].evaluate(
+    [&](const atom & ad) -> real_t
     {
-      atom & ad = eqns[eqn_id][mol_id].atoms[atom_id];
-      
-      if(ad.type == 1) // polynomial type
-      {
-        fas_grid_t & vd =  u_h[ad.u_id][depth_idx];
-        fas_grid_t & vs =  u_shift_h[ad.u_id][depth_idx];
-        val *= pow(vd[pos_idx] + vs[pos_idx], ad.value);
-      }
+      fas_grid_t & vd = u_h[ad.u_id][depth_idx];
+      if(ad.type == 1) // polynomial type, base only
+        return vd[pos_idx] + u_shift_h[ad.u_id][depth_idx][pos_idx];
       else if(ad.type <= 4) // first derivative type
-      {
-        fas_grid_t & vd =  u_h[ad.u_id][depth_idx];
-        val *= derivative(i, j, k, vd.nx, vd.ny, vd.nz,
+        return derivative(i, j, k, vd.nx, vd.ny, vd.nz,
           der_type[ad.type][0], vd);
-      }
       else if(ad.type <= 10)
-      {
-        fas_grid_t & vd =  u_h[ad.u_id][depth_idx];
-        val *= double_derivative(i, j, k, vd.nx, vd.ny, vd.nz,
+        return double_derivative(i, j, k, vd.nx, vd.ny, vd.nz,
           der_type[ad.type][0], der_type[ad.type][1], vd);
-      }
-      else
-      {
-        fas_grid_t & vd =  u_h[ad.u_id][depth_idx];
-        val *= laplacian(i, j, k, vd.nx, vd.ny, vd.nz, vd);
-      }
-    }
-    res += val;
-  }
-  return res;
+      return laplacian(i, j, k, vd.nx, vd.ny, vd.nz, vd);
+    },
+    [&](idx_t mol_id) -> real_t
+    {
+      fas_grid_t & rho = rho_h[eqn_id][mol_id][depth_idx];
+      return (rho.pts > 0) ? rho[pos_idx] : 1.0;
+    });
+}
+
+/**
+ * @brief compile eqns into the flat representation used for
+ *  evaluating residuals, see compiled_eqn
+ */
+void FASMultigrid::_compileEquations()
+{
+  compiled_eqns.resize(u_n);
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    compiled_eqns[eqn_id].compile(eqns[eqn_id], molecule_n[eqn_id]);
 }
 
 /**
@@ -407,16 +396,16 @@ void FASMultigrid::_evaluateIterationForJacEquation(idx_t eqn_id,
         fas_grid_t & vs =  u_shift_h[ad.u_id][depth_idx];
         if(u_id == ad.u_id)
         {
-          mol_to_b = mol_to_b * pow(vd[pos_idx]+vs[pos_idx], ad.value)
-            + non_der_val * ad.value * pow(vd[pos_idx]+vs[pos_idx], ad.value-1.0);
-          non_der_val = non_der_val * pow(vd[pos_idx]+vs[pos_idx], ad.value);
-          mol_to_a *= pow(vd[pos_idx]+vs[pos_idx], ad.value);
+          mol_to_b = mol_to_b * fas_pow(vd[pos_idx]+vs[pos_idx], ad.value)
+            + non_der_val * ad.value * fas_pow(vd[pos_idx]+vs[pos_idx], ad.value-1.0);
+          non_der_val = non_der_val * fas_pow(vd[pos_idx]+vs[pos_idx], ad.value);
+          mol_to_a *= fas_pow(vd[pos_idx]+vs[pos_idx], ad.value);
         }
         else
         {
-          mol_to_b *= pow(vd[pos_idx]+vs[pos_idx], ad.value);
-          mol_to_a *= pow(vd[pos_idx]+vs[pos_idx], ad.value);
-          non_der_val *= pow(vd[pos_idx]+vs[pos_idx], ad.value);
+          mol_to_b *= fas_pow(vd[pos_idx]+vs[pos_idx], ad.value);
+          mol_to_a *= fas_pow(vd[pos_idx]+vs[pos_idx], ad.value);
+          non_der_val *= fas_pow(vd[pos_idx]+vs[pos_idx], ad.value);
         }
       }
       else if(ad.type <= 4) // first derivative type
@@ -526,15 +515,15 @@ real_t FASMultigrid::_evaluateDerEllipticEquation(idx_t eqn_id, idx_t depth_idx,
         fas_grid_t & jac_vd =  damping_v_h[u_id][depth_idx];
         if(u_id == ad.u_id)
         {
-          der_val = non_der_val * ad.value * pow(vd[pos_idx] + vs[pos_idx], ad.value-1.0) * jac_vd[pos_idx]
-            + der_val * pow(vd[pos_idx] + vs[pos_idx], ad.value);
+          der_val = non_der_val * ad.value * fas_pow(vd[pos_idx] + vs[pos_idx], ad.value-1.0) * jac_vd[pos_idx]
+            + der_val * fas_pow(vd[pos_idx] + vs[pos_idx], ad.value);
 
-          non_der_val = non_der_val * pow(vd[pos_idx] + vs[pos_idx], ad.value);
+          non_der_val = non_der_val * fas_pow(vd[pos_idx] + vs[pos_idx], ad.value);
         }
         else
         {
-          non_der_val *= pow(vd[pos_idx] + vs[pos_idx], ad.value);
-          der_val *= pow(vd[pos_idx] + vs[pos_idx], ad.value);
+          non_der_val *= fas_pow(vd[pos_idx] + vs[pos_idx], ad.value);
+          der_val *= fas_pow(vd[pos_idx] + vs[pos_idx], ad.value);
         }
       }
       else if(ad.type <= 4)// first derivative type
@@ -791,7 +780,7 @@ real_t FASMultigrid::_getMaxResidual(idx_t eqn_id, idx_t depth)
 
   real_t max_residual = 0.0;
 
-#pragma omp parallel for collapse(2) reduction(max : max_residual)
+#pragma omp parallel for collapse(2) private(i) reduction(max : max_residual)
   FAS_LOOP3_N(i,j,k,nx,ny,nz)
   {
     idx_t idx = B_INDEX(i, j, k, nx, ny, nz);
@@ -971,7 +960,7 @@ bool FASMultigrid::_getLambda( idx_t depth, real_t norm)
     for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
     {
       fas_grid_t & coarse_src = coarse_src_h[eqn_id][depth_idx];
-      #pragma omp parallel for default(shared) private(j,k) reduction(+:sum)
+      #pragma omp parallel for default(shared) private(i,j) reduction(+:sum)
       FAS_LOOP3_N(i,j,k,nx,ny,nz)
       {
         idx_t idx = B_INDEX(i, j, k, nx,ny,nz);
@@ -989,7 +978,7 @@ bool FASMultigrid::_getLambda( idx_t depth, real_t norm)
     for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
     {
       fas_grid_t & u = u_h[eqn_id][depth_idx];
-      #pragma omp parallel for default(shared) private(j,k)
+      #pragma omp parallel for default(shared) private(i,j)
       FAS_LOOP3_N(i,j,k,nx,ny,nz)
       {
         fas_grid_t & damping_v = damping_v_h[eqn_id][depth_idx];
@@ -1023,7 +1012,7 @@ bool FASMultigrid::_jacobianRelax( idx_t depth, real_t norm, real_t C, idx_t p)
   //initilizing value of damping_v
   for(idx_t eqn_id =0; eqn_id < u_n; eqn_id++)
   {
-    #pragma omp parallel for default(shared) private(j,k)
+    #pragma omp parallel for default(shared) private(i,j)
     FAS_LOOP3_N(i, j, k, nx, ny, nz)
     {
       damping_v_h[eqn_id][depth_idx][B_INDEX(i,j,k,nx, ny, nz)] = 0.0;
@@ -1042,7 +1031,7 @@ bool FASMultigrid::_jacobianRelax( idx_t depth, real_t norm, real_t C, idx_t p)
       fas_grid_t & damping_v = damping_v_h[eqn_id][depth_idx];
       fas_grid_t & jac_rhs = jac_rhs_h[eqn_id][depth_idx];
       
-      #pragma omp parallel for default(shared) private(j,k)
+      #pragma omp parallel for default(shared) private(i,j)
       FAS_LOOP3_N(i,j,k,nx,ny,nz)
       {
         idx_t idx = B_INDEX(i,j,k,nx,ny,nz);
@@ -1086,6 +1075,50 @@ bool FASMultigrid::_jacobianRelax( idx_t depth, real_t norm, real_t C, idx_t p)
   return true;
 }
 
+/**
+ * @brief one sweep of nonlinear multicolor Gauss-Seidel
+ * @details Points are colored by (i, j, k) modulo STENCIL_ORDER/2 + 1, so
+ *  that no two points of a color lie within reach of the stencils; all
+ *  points of one color are updated in parallel with a pointwise Newton
+ *  step u -= (F(u) - coarse_src) / (dF / du), ghosts are refreshed after
+ *  every color.
+ *
+ * @param depth depth to relax at
+ */
+void FASMultigrid::_multicolorGaussSeidelSweep(idx_t depth)
+{
+  idx_t depth_idx = _dIdx(depth);
+  idx_t nx = nx_h[depth_idx], ny = ny_h[depth_idx], nz = nz_h[depth_idx];
+  const idx_t stride = STENCIL_ORDER / 2 + 1;
+
+  for(idx_t ck = 0; ck < stride; ck++)
+  for(idx_t cj = 0; cj < stride; cj++)
+  for(idx_t ci = 0; ci < stride; ci++)
+  {
+    #pragma omp parallel for collapse(2)
+    for(idx_t k = ck; k < nz; k += stride)
+      for(idx_t j = cj; j < ny; j += stride)
+        for(idx_t i = ci; i < nx; i += stride)
+        {
+          idx_t idx = B_INDEX(i, j, k, nx, ny, nz);
+          for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+          {
+            real_t coef_a = 0, coef_b = 0;
+            // only the diagonal coef_b is needed here
+            _evaluateIterationForJacEquation(
+              eqn_id, depth_idx, coef_a, coef_b, i, j, k, eqn_id);
+            if(coef_b != 0)
+              u_h[eqn_id][depth_idx][idx] -=
+                (_evaluateEllipticEquationPt(eqn_id, depth_idx, i, j, k)
+                 - coarse_src_h[eqn_id][depth_idx][idx]) / coef_b;
+          }
+        }
+
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+      fillBoundary(u_h[eqn_id][depth_idx]);
+  }
+}
+
 /**
  * @brief relax u using the inexact Newton iterative method
  * @param depth
@@ -1144,6 +1177,10 @@ bool FASMultigrid::_relaxSolution_GaussSeidel( idx_t depth, idx_t max_iterations
         return 0;
       }
     }
+    else if(relax_scheme == multicolor_gauss_seidel)
+    {
+      _multicolorGaussSeidelSweep(depth);
+    }
 
   } // end iterations loop
 
@@ -1257,6 +1294,8 @@ void FASMultigrid::initializeShiftHeirarchy()
   
 bool FASMultigrid::VCycle()
 {
+  _compileEquations();
+
   if(!_relaxSolution_GaussSeidel(max_depth, max_relax_iters))
     return 0;
 
@@ -1302,6 +1341,8 @@ bool FASMultigrid::VCycle()
 
 void FASMultigrid::VCycles(idx_t num_cycles)
 {
+  _compileEquations();
+
   int cycle = 0;
   for(cycle = 0; cycle < num_cycles; ++cycle)
   {
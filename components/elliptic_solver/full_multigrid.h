@@ -7,6 +7,7 @@
 #include <iomanip>
 #include <cmath>
 #include <cstdio>
+#include <vector>
 #include "../../utils/Array.h"
 
 #include "multigrid_bd_handler.h"
@@ -15,10 +16,11 @@
 
 #define PI  (4.0*atan(1.0))
 
+// i is the fastest index of B_INDEX, keep it innermost
 #define FAS_LOOP3_N(i, j, k, nx, ny, nz)  \
-  for(i=0; i<nx; ++i)                     \
+  for(k=0; k<nz; ++k)                     \
     for(j=0; j<ny; ++j)                   \
-      for(k=0; k<nz; ++k)
+      for(i=0; i<nx; ++i)
 
 
 
@@ -73,6 +75,102 @@ class molecule
   }
 };
 
+/**
+ * @brief raise to a power, integer exponents are done by multiplication
+ */
+inline real_t fas_pow(real_t base, real_t exponent)
+{
+  int n = (int) exponent;
+  if(n != exponent || n > 16 || n < -16)
+    return std::pow(base, exponent);
+
+  real_t res = 1.0, b = (n < 0) ? 1.0 / base : base;
+  for(n = std::abs(n); n > 0; n >>= 1, b *= b)
+    if(n & 1) res *= b;
+  return res;
+}
+
+#define FAS_MAX_COMPILED_FACTORS 64
+
+/**
+ * @brief equation (set of molecules) compiled for pointwise evaluation
+ * @details
+ * Atoms appearing in several molecules of an equation (e.g. \Psi^-7 in
+ * the Hamiltonian constraint) are collected once into a list of distinct
+ * factors, so each of them is evaluated once per point; molecules then
+ * become products of factor values stored in flat arrays.
+ */
+class compiled_eqn
+{
+ public:
+  std::vector<atom> factors;       ///< distinct atoms of the equation
+  std::vector<idx_t> mol_start;    ///< factors of molecule m are mol_factors[mol_start[m] ... mol_start[m+1]-1]
+  std::vector<idx_t> mol_factors;  ///< factor ids of all molecules
+  std::vector<real_t> const_coef;  ///< constant coefficient of every molecule
+
+  void compile(const molecule * mols, idx_t mol_n)
+  {
+    factors.clear();
+    mol_factors.clear();
+    const_coef.resize(mol_n);
+    mol_start.resize(mol_n + 1);
+
+    for(idx_t mol_id = 0; mol_id < mol_n; mol_id++)
+    {
+      const_coef[mol_id] = mols[mol_id].const_coef;
+      mol_start[mol_id] = mol_factors.size();
+
+      for(idx_t atom_id = 0; atom_id < mols[mol_id].atom_n; atom_id++)
+      {
+        const atom & ad = mols[mol_id].atoms[atom_id];
+        idx_t f_id = 0;
+        for(; f_id < (idx_t)factors.size(); f_id++)
+          if(factors[f_id].type == ad.type && factors[f_id].u_id == ad.u_id
+             && (ad.type != 1 || factors[f_id].value == ad.value))
+            break;
+        if(f_id == (idx_t)factors.size())
+          factors.push_back(ad);
+        mol_factors.push_back(f_id);
+      }
+    }
+    mol_start[mol_n] = mol_factors.size();
+
+    if(factors.size() > FAS_MAX_COMPILED_FACTORS)
+      TBOX_ERROR("Too many distinct atoms in a multigrid equation!\n");
+  }
+
+  /**
+   * @brief evaluate the equation at a point
+   *
+   * @param factor_val returns the value of an atom, the base (u + u_shift)
+   *  for polynomial atoms
+   * @param rho_val returns the source term of a molecule (1 if none)
+   */
+  template<class FactorF, class RhoF>
+  inline real_t evaluate(FactorF factor_val, RhoF rho_val) const
+  {
+    real_t f_val[FAS_MAX_COMPILED_FACTORS];
+    const idx_t factor_n = factors.size();
+    for(idx_t f_id = 0; f_id < factor_n; f_id++)
+    {
+      const atom & ad = factors[f_id];
+      f_val[f_id] = (ad.type == 1) ?
+        fas_pow(factor_val(ad), ad.value) : factor_val(ad);
+    }
+
+    real_t res = 0.0;
+    const idx_t mol_n = const_coef.size();
+    for(idx_t mol_id = 0; mol_id < mol_n; mol_id++)
+    {
+      real_t val = const_coef[mol_id] * rho_val(mol_id);
+      for(idx_t n = mol_start[mol_id]; n < mol_start[mol_id + 1]; n++)
+        val *= f_val[mol_factors[n]];
+      res += val;
+    }
+    return res;
+  }
+};
+
 class FASMultigrid
 {
   private:
@@ -114,6 +212,10 @@ class FASMultigrid
   std::string boundary_type;
 
   multigridBdHandler * bd_handler;
+
+  std::vector<compiled_eqn> compiled_eqns;  ///< eqns compiled for residual evaluation
+
+  void _compileEquations();
     
   /**
    * @brief indexing scheme of a grid heirarchy
@@ -177,7 +279,8 @@ class FASMultigrid
   {
     inexact_newton,
     inexact_newton_constrained, // inexact Newton with volume constraint enforced
-    newton
+    newton,
+    multicolor_gauss_seidel // pointwise nonlinear Gauss-Seidel, colored for OpenMP
   };
 
   relax_t relax_scheme;
@@ -262,6 +365,8 @@ class FASMultigrid
 
   bool _singularityExists(idx_t eqn_id, idx_t depth);
 
+  void _multicolorGaussSeidelSweep(idx_t depth);
+
   bool _relaxSolution_GaussSeidel( idx_t depth, idx_t max_iterations);
 
   void _printStrip(fas_grid_t & out_h);
@@ -0,0 +1,1263 @@
+#include "samrai_multigrid.h"
+#include "../../utils/math.h"
+#include "SAMRAI/pdat/CellOverlap.h"
+#include "SAMRAI/hier/Transformation.h"
+
+using namespace SAMRAI;
+
+namespace cosmo
+{
+
+#define SAMRAI_FAS_LOOP3(i, j, k, lower, upper)   \
+  for(idx_t k = lower[2]; k <= upper[2]; k++)     \
+    for(idx_t j = lower[1]; j <= upper[1]; j++)   \
+      for(idx_t i = lower[0]; i <= upper[0]; i++)
+
+/**
+ * @brief Build the depth levels and register / allocate solver fields
+ * @details The finest depth is level ln of the hierarchy, which has to
+ *  cover the whole periodic domain and have boxes that can be coarsened
+ *  max_depth - 1 times by 2.
+ *
+ * @param hierarchy_in hierarchy the finest level belongs to
+ * @param ln level number of the finest depth
+ * @param u_n_in number of variables, equals to number of equations
+ * @param molecule_n_in number of molecules in each equation
+ * @param max_depth_in number of depths
+ * @param max_relax_iters_in number of relaxations at finest depth
+ * @param relaxation_tolerance_in relaxation jump out precision
+ * @param refine_op_type refine operator used for prolongation
+ * @param coarsen_op_type coarsen operator used for restriction
+ */
+SAMRAIFASMultigrid::SAMRAIFASMultigrid(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy_in, idx_t ln,
+  idx_t u_n_in, idx_t molecule_n_in [],
+  idx_t max_depth_in, idx_t max_relax_iters_in,
+  real_t relaxation_tolerance_in,
+  std::string refine_op_type,
+  std::string coarsen_op_type):
+  hierarchy(hierarchy_in),
+  dim(hierarchy_in->getDim())
+{
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  max_relax_iters = max_relax_iters_in;
+  max_depth = max_depth_in;
+  min_depth = 1;
+  max_depth_idx = _dIdx(max_depth);
+  min_depth_idx = _dIdx(min_depth);
+  total_depths = max_depth - min_depth + 1;
+  relaxation_tolerance = relaxation_tolerance_in;
+  u_n = u_n_in;
+
+  molecule_n = molecule_n_in;
+
+  eqns = new molecule *[u_n];
+
+  u_idx.resize(u_n);
+  tmp_idx.resize(u_n);
+  coarse_src_idx.resize(u_n);
+  jac_rhs_idx.resize(u_n);
+  damping_v_idx.resize(u_n);
+  u_shift_idx.resize(u_n);
+  rho_idx.resize(u_n);
+  has_rho.resize(u_n);
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+  {
+    eqns[eqn_id] = new molecule[molecule_n[eqn_id]];
+
+    std::string suffix = "_" + std::to_string(eqn_id);
+    u_idx[eqn_id] = _registerField("FAS_u" + suffix);
+    tmp_idx[eqn_id] = _registerField("FAS_tmp" + suffix);
+    coarse_src_idx[eqn_id] = _registerField("FAS_coarse_src" + suffix);
+    jac_rhs_idx[eqn_id] = _registerField("FAS_jac_rhs" + suffix);
+    damping_v_idx[eqn_id] = _registerField("FAS_damping_v" + suffix);
+    u_shift_idx[eqn_id] = _registerField("FAS_u_shift" + suffix);
+
+    rho_idx[eqn_id].resize(molecule_n[eqn_id]);
+    has_rho[eqn_id].resize(molecule_n[eqn_id], 0);
+    for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
+      rho_idx[eqn_id][mol_id] = _registerField(
+        "FAS_rho" + suffix + "_" + std::to_string(mol_id));
+  }
+
+  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry(
+    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
+      hierarchy->getGridGeometry()));
+  TBOX_ASSERT(grid_geometry);
+
+  // ghost cells are only ever filled from neighbouring patches
+  const hier::IntVector & periodic_shift =
+    grid_geometry->getPeriodicShift(hier::IntVector::getOne(dim));
+  for(int d = 0; d < DIM; d++)
+    if(periodic_shift[d] == 0)
+      TBOX_ERROR("SAMRAIFASMultigrid only supports periodic domains!\n");
+
+  std::shared_ptr<hier::Variable> u_var;
+  hier::VariableDatabase::getDatabase()->mapIndexToVariable(u_idx[0], u_var);
+
+  refine_op = grid_geometry->lookupRefineOperator(u_var, refine_op_type);
+  coarsen_op = grid_geometry->lookupCoarsenOperator(u_var, coarsen_op_type);
+  if(!refine_op || !coarsen_op)
+    TBOX_ERROR("SAMRAIFASMultigrid cannot find refine / coarsen operator "
+               << refine_op_type << " / " << coarsen_op_type << "\n");
+
+  levels.resize(total_depths);
+  levels[max_depth_idx] = hierarchy->getPatchLevel(ln);
+
+  const hier::IntVector & ratio = levels[max_depth_idx]->getRatioToLevelZero();
+  const hier::Box domain_box =
+    grid_geometry->getPhysicalDomain().getBoundingBox();
+
+  if(levels[max_depth_idx]->getGlobalNumberOfCells()
+     != domain_box.size() * ratio.getProduct())
+    TBOX_ERROR("SAMRAIFASMultigrid needs level " << ln
+               << " to cover the whole domain!\n");
+
+  // every patch needs to be coarsenable down to the coarsest depth
+  const idx_t factor = 1 << (max_depth - min_depth);
+  int bad_box = 0;
+  for(hier::PatchLevel::iterator pit(levels[max_depth_idx]->begin());
+      pit != levels[max_depth_idx]->end(); ++pit)
+  {
+    const hier::Box & box = (*pit)->getBox();
+    for(int d = 0; d < DIM; d++)
+      if(((box.lower()[d] % factor) + factor) % factor != 0
+         || ((box.upper()[d] + 1) % factor + factor) % factor != 0)
+        bad_box = 1;
+  }
+  mpi.AllReduce(&bad_box, 1, MPI_MAX);
+  if(bad_box)
+    TBOX_ERROR("Patch boxes on level " << ln << " can not be coarsened "
+               << max_depth - min_depth << " times!\n");
+
+  for(int d = 0; d < DIM; d++)
+    if(domain_box.numberCells()[d] * ratio[d] / factor < STENCIL_ORDER)
+      TBOX_ERROR("Coarsest level too small!");
+
+  for(idx_t depth = max_depth - 1; depth >= min_depth; --depth)
+  {
+    idx_t depth_idx = _dIdx(depth);
+    levels[depth_idx] = std::make_shared<hier::PatchLevel>(dim);
+    levels[depth_idx]->setCoarsenedPatchLevel(
+      levels[depth_idx + 1], hier::IntVector(dim, 2));
+  }
+
+  for(idx_t depth = max_depth; depth >= min_depth; --depth)
+  {
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    {
+      _allocateField(u_idx[eqn_id], depth);
+      _allocateField(tmp_idx[eqn_id], depth);
+      _allocateField(coarse_src_idx[eqn_id], depth);
+      _allocateField(jac_rhs_idx[eqn_id], depth);
+      _allocateField(damping_v_idx[eqn_id], depth);
+      _allocateField(u_shift_idx[eqn_id], depth);
+    }
+  }
+
+  // initializing x, y and z derivative
+  der_type[der1][0] = 1;
+  der_type[der2][0] = 2;
+  der_type[der3][0] = 3;
+
+  // initializing 9 kinds of double derivative
+  der_type[der11][0] = 1;
+  der_type[der11][1] = 1;
+
+  der_type[der22][0] = 2;
+  der_type[der22][1] = 2;
+
+  der_type[der33][0] = 3;
+  der_type[der33][1] = 3;
+
+  der_type[der12][0] = 1;
+  der_type[der12][1] = 2;
+
+  der_type[der13][0] = 1;
+  der_type[der13][1] = 3;
+
+  der_type[der23][0] = 2;
+  der_type[der23][1] = 3;
+
+  // initilizing coeficient of double derivative for different sencil orders
+  double_der_coef[2] = 2.0;
+  double_der_coef[4] = 2.5;
+  double_der_coef[6] = 49.0 / 18.0;
+  double_der_coef[8] = 205.0 / 72.0;
+}
+
+SAMRAIFASMultigrid::~SAMRAIFASMultigrid()
+{
+  for(idx_t depth = max_depth; depth >= min_depth; --depth)
+  {
+    idx_t depth_idx = _dIdx(depth);
+    const fas_level_t & level = levels[depth_idx];
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    {
+      level->deallocatePatchData(u_idx[eqn_id]);
+      level->deallocatePatchData(tmp_idx[eqn_id]);
+      level->deallocatePatchData(coarse_src_idx[eqn_id]);
+      level->deallocatePatchData(jac_rhs_idx[eqn_id]);
+      level->deallocatePatchData(damping_v_idx[eqn_id]);
+      level->deallocatePatchData(u_shift_idx[eqn_id]);
+      for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
+        if(level->checkAllocated(rho_idx[eqn_id][mol_id]))
+          level->deallocatePatchData(rho_idx[eqn_id][mol_id]);
+    }
+  }
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    delete [] eqns[eqn_id];
+  delete [] eqns;
+}
+
+/**
+ * @brief register (or look up) a cell centered solver field
+ *
+ * @param name variable name
+ * @return patch data index of the field in the FAS_MULTIGRID context
+ */
+idx_t SAMRAIFASMultigrid::_registerField(const std::string & name)
+{
+  hier::VariableDatabase* variable_db = hier::VariableDatabase::getDatabase();
+
+  std::shared_ptr<hier::Variable> var = variable_db->getVariable(name);
+  if(!var)
+    var = std::make_shared<pdat::CellVariable<real_t> >(dim, name, 1);
+
+  return variable_db->registerVariableAndContext(
+    var, variable_db->getContext("FAS_MULTIGRID"),
+    hier::IntVector(dim, STENCIL_ORDER));
+}
+
+arr_t SAMRAIFASMultigrid::_getArray(hier::Patch & patch, idx_t idx)
+{
+  std::shared_ptr<pdat::CellData<real_t> > pdata(
+    SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+      patch.getPatchData(idx)));
+  return pdat::ArrayDataAccess::access<DIM, real_t>(pdata->getArrayData());
+}
+
+/**
+ * @brief collect views of u, its shift, the Newton correction and
+ *  all source terms on a patch
+ */
+void SAMRAIFASMultigrid::_getPatchArrays(hier::Patch & patch, fas_patch_t & pa)
+{
+  pa.u.resize(u_n);
+  pa.u_shift.resize(u_n);
+  pa.damping_v.resize(u_n);
+  pa.rho.resize(u_n);
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+  {
+    pa.u[eqn_id] = _getArray(patch, u_idx[eqn_id]);
+    pa.u_shift[eqn_id] = _getArray(patch, u_shift_idx[eqn_id]);
+    pa.damping_v[eqn_id] = _getArray(patch, damping_v_idx[eqn_id]);
+
+    pa.rho[eqn_id].resize(molecule_n[eqn_id]);
+    for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
+      if(has_rho[eqn_id][mol_id])
+        pa.rho[eqn_id][mol_id] = _getArray(patch, rho_idx[eqn_id][mol_id]);
+  }
+
+  const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+    SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+      patch.getPatchGeometry()));
+
+  for(int d = 0; d < DIM; d++)
+    pa.dx[d] = patch_geom->getDx()[d];
+}
+
+/**
+ * @brief allocate a field at some depth and set it (ghosts included) to 0
+ */
+void SAMRAIFASMultigrid::_allocateField(idx_t idx, idx_t depth)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  if(!level->checkAllocated(idx))
+    level->allocatePatchData(idx);
+
+  for(hier::PatchLevel::iterator pit(level->begin());
+      pit != level->end(); ++pit)
+  {
+    std::shared_ptr<pdat::CellData<real_t> > pdata(
+      SAMRAI_SHARED_PTR_CAST<pdat::CellData<real_t>, hier::PatchData>(
+        (*pit)->getPatchData(idx)));
+    pdata->fillAll(0.0);
+  }
+}
+
+/**
+ * @brief fill ghost cells of a field from neighbouring (and periodic
+ *  image) patches, schedules are created on first use and cached
+ */
+void SAMRAIFASMultigrid::_fillGhosts(idx_t idx, idx_t depth)
+{
+  idx_t depth_idx = _dIdx(depth);
+  std::vector<std::shared_ptr<xfer::RefineSchedule> > & schedules =
+    ghost_schedules[idx];
+
+  if(schedules.empty())
+    schedules.resize(total_depths);
+
+  if(!schedules[depth_idx])
+  {
+    xfer::RefineAlgorithm refiner;
+    refiner.registerRefine(idx, idx, idx,
+                           std::shared_ptr<hier::RefineOperator>());
+    schedules[depth_idx] = refiner.createSchedule(levels[depth_idx], NULL);
+  }
+
+  schedules[depth_idx]->fillData(0.0);
+}
+
+void SAMRAIFASMultigrid::add_atom_to_eqn(atom atom_in, idx_t molecule_id, idx_t eqn_id)
+{
+  eqns[eqn_id][molecule_id].add_atom(atom_in);
+}
+
+/**
+ * @brief evaluating the value of equation at a point
+ * @param[in]  id of equation to calculate
+ * @param[in]  views of fields on the patch containing the point
+ * @param[in]  index of x direction
+ * @param[in]  index of y direction
+ * @param[in]  index of z direction
+ */
+real_t SAMRAIFASMultigrid::_evaluateEllipticEquationPt(idx_t eqn_id,
+  fas_patch_t & pa, idx_t i, idx_t j, idx_t k)
+{
+  return compiled_eqns[eqn_id].evaluate(
+    [&](const atom & ad) -> real_t
+    {
+      arr_t & vd = pa.u[ad.u_id];
+      if(ad.type == 1) // polynomial type, base only
+        return vd(i, j, k) + pa.u_shift[ad.u_id](i, j, k);
+      else if(ad.type <= 4) // first derivative type
+        return derivative(i, j, k, der_type[ad.type][0], vd, pa.dx);
+      else if(ad.type <= 10)
+        return double_derivative(i, j, k, der_type[ad.type][0],
+                                 der_type[ad.type][1], vd, pa.dx);
+      return laplacian(i, j, k, vd, pa.dx);
+    },
+    [&](idx_t mol_id) -> real_t
+    {
+      return has_rho[eqn_id][mol_id] ? pa.rho[eqn_id][mol_id](i, j, k) : 1.0;
+    });
+}
+
+/**
+ * @brief compile eqns into the flat representation used for
+ *  evaluating residuals, see compiled_eqn
+ */
+void SAMRAIFASMultigrid::_compileEquations()
+{
+  compiled_eqns.resize(u_n);
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    compiled_eqns[eqn_id].compile(eqns[eqn_id], molecule_n[eqn_id]);
+}
+
+/**
+ * @brief evaluate value of v * \partial F(u) / \partial u, storing coefficient a and b for interation
+ * @details see FASMultigrid::_evaluateIterationForJacEquation
+ */
+void SAMRAIFASMultigrid::_evaluateIterationForJacEquation(idx_t eqn_id,
+  fas_patch_t & pa, real_t &coef_a, real_t &coef_b,
+  idx_t i, idx_t j, idx_t k, idx_t u_id)
+{
+  const double * dx = pa.dx;
+  arr_t & jac_vd = pa.damping_v[u_id];
+
+  for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
+  {
+    real_t mol_to_a = 0.0, mol_to_b = 0.0;
+    real_t non_der_val = eqns[eqn_id][mol_id].const_coef;
+
+    if(has_rho[eqn_id][mol_id])
+      non_der_val *= pa.rho[eqn_id][mol_id](i, j, k);
+
+    for(idx_t atom_id = 0; atom_id < eqns[eqn_id][mol_id].atom_n; atom_id++)
+    {
+      atom & ad = eqns[eqn_id][mol_id].atoms[atom_id];
+      arr_t & vd = pa.u[ad.u_id];
+
+      if(ad.type == 1) // polynomial type
+      {
+        real_t v = vd(i, j, k) + pa.u_shift[ad.u_id](i, j, k);
+        if(u_id == ad.u_id)
+        {
+          mol_to_b = mol_to_b * fas_pow(v, ad.value)
+            + non_der_val * ad.value * fas_pow(v, ad.value - 1.0);
+          non_der_val = non_der_val * fas_pow(v, ad.value);
+          mol_to_a *= fas_pow(v, ad.value);
+        }
+        else
+        {
+          mol_to_b *= fas_pow(v, ad.value);
+          mol_to_a *= fas_pow(v, ad.value);
+          non_der_val *= fas_pow(v, ad.value);
+        }
+      }
+      else if(ad.type <= 4) // first derivative type
+      {
+        real_t der = derivative(i, j, k, der_type[ad.type][0], vd, dx);
+        if(u_id == ad.u_id)
+        {
+          mol_to_a = mol_to_a * der
+            + non_der_val * derivative(i, j, k, der_type[ad.type][0], jac_vd, dx);
+          mol_to_b = mol_to_b * der;
+          non_der_val = non_der_val * der;
+        }
+        else
+        {
+          non_der_val *= der;
+          mol_to_b *= der;
+          mol_to_a *= der;
+        }
+      }
+      else if(ad.type <= 10)
+      {
+        real_t der = double_derivative(i, j, k, der_type[ad.type][0],
+                                       der_type[ad.type][1], vd, dx);
+        if(u_id == ad.u_id)
+        {
+          // diagonal part of the stencil, only for non-mixed derivatives
+          real_t diag = (ad.type <= 7) * double_der_coef[STENCIL_ORDER]
+            / pw2(dx[(ad.type <= 7) ? (ad.type - 5) : 0]);
+          mol_to_a = mol_to_a * der
+            + non_der_val * (double_derivative(i, j, k, der_type[ad.type][0],
+                                               der_type[ad.type][1], jac_vd, dx)
+                             + diag * jac_vd(i, j, k));
+          mol_to_b = mol_to_b * der - non_der_val * diag;
+          non_der_val = non_der_val * der;
+        }
+        else
+        {
+          non_der_val *= der;
+          mol_to_a *= der;
+          mol_to_b *= der;
+        }
+      }
+      else
+      {
+        real_t lap_v = laplacian(i, j, k, vd, dx);
+        if(u_id == ad.u_id)
+        {
+          real_t diag = double_der_coef[STENCIL_ORDER]
+            * (1.0 / pw2(dx[0]) + 1.0 / pw2(dx[1]) + 1.0 / pw2(dx[2]));
+          mol_to_a = mol_to_a * lap_v
+            + non_der_val * (laplacian(i, j, k, jac_vd, dx) + diag * jac_vd(i, j, k));
+          mol_to_b = mol_to_b * lap_v - non_der_val * diag;
+          non_der_val = non_der_val * lap_v;
+        }
+        else
+        {
+          non_der_val *= lap_v;
+          mol_to_a *= lap_v;
+          mol_to_b *= lap_v;
+        }
+      }
+    }
+    coef_a += mol_to_a;
+    coef_b += mol_to_b;
+  }
+}
+
+/**
+ * @brief evaluate value of v * \partial F(u) / \partial u
+ * @details see FASMultigrid::_evaluateDerEllipticEquation
+ */
+real_t SAMRAIFASMultigrid::_evaluateDerEllipticEquation(idx_t eqn_id,
+  fas_patch_t & pa, idx_t i, idx_t j, idx_t k, idx_t u_id)
+{
+  const double * dx = pa.dx;
+  arr_t & jac_vd = pa.damping_v[u_id];
+  real_t res = 0.0;
+
+  for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
+  {
+    real_t non_der_val = eqns[eqn_id][mol_id].const_coef, der_val = 0.0;
+
+    if(has_rho[eqn_id][mol_id])
+      non_der_val *= pa.rho[eqn_id][mol_id](i, j, k);
+
+    for(idx_t atom_id = 0; atom_id < eqns[eqn_id][mol_id].atom_n; atom_id++)
+    {
+      atom & ad = eqns[eqn_id][mol_id].atoms[atom_id];
+      arr_t & vd = pa.u[ad.u_id];
+
+      if(ad.type == 1) // polynomial type
+      {
+        real_t v = vd(i, j, k) + pa.u_shift[ad.u_id](i, j, k);
+        if(u_id == ad.u_id)
+        {
+          der_val = non_der_val * ad.value * fas_pow(v, ad.value - 1.0) * jac_vd(i, j, k)
+            + der_val * fas_pow(v, ad.value);
+          non_der_val = non_der_val * fas_pow(v, ad.value);
+        }
+        else
+        {
+          non_der_val *= fas_pow(v, ad.value);
+          der_val *= fas_pow(v, ad.value);
+        }
+      }
+      else if(ad.type <= 4) // first derivative type
+      {
+        real_t der = derivative(i, j, k, der_type[ad.type][0], vd, dx);
+        if(u_id == ad.u_id)
+        {
+          der_val = non_der_val * derivative(i, j, k, der_type[ad.type][0], jac_vd, dx)
+            + der_val * der;
+          non_der_val = non_der_val * der;
+        }
+        else
+        {
+          non_der_val *= der;
+          der_val *= der;
+        }
+      }
+      else if(ad.type <= 10)
+      {
+        real_t der = double_derivative(i, j, k, der_type[ad.type][0],
+                                       der_type[ad.type][1], vd, dx);
+        if(u_id == ad.u_id)
+        {
+          der_val = non_der_val * double_derivative(i, j, k, der_type[ad.type][0],
+                                                    der_type[ad.type][1], jac_vd, dx)
+            + der_val * der;
+          non_der_val = non_der_val * der;
+        }
+        else
+        {
+          non_der_val *= der;
+          der_val *= der;
+        }
+      }
+      else
+      {
+        real_t lap_v = laplacian(i, j, k, vd, dx);
+        if(u_id == ad.u_id)
+        {
+          der_val = non_der_val * laplacian(i, j, k, jac_vd, dx)
+            + der_val * lap_v;
+          non_der_val = non_der_val * lap_v;
+        }
+        else
+        {
+          non_der_val *= lap_v;
+          der_val *= lap_v;
+        }
+      }
+    }
+    res += der_val;
+  }
+  return res;
+}
+
+/**
+ * @brief "restrict" a field at fine depth to the next coarser depth
+ * @details uses the coarsen operator patch by patch: the coarse patches
+ *  are the coarsened images of the fine ones and live on the same rank
+ *
+ * @param idx patch data index of field to restrict
+ * @param fine_depth "depth" of finer level
+ */
+void SAMRAIFASMultigrid::_restrictFine2coarse(idx_t idx, idx_t fine_depth)
+{
+  idx_t fine_idx = _dIdx(fine_depth);
+  idx_t coarse_idx = fine_idx - 1;
+  const hier::IntVector ratio(dim, 2);
+
+  for(hier::PatchLevel::iterator pit(levels[fine_idx]->begin());
+      pit != levels[fine_idx]->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & fine_patch = *pit;
+    std::shared_ptr<hier::Patch> coarse_patch(
+      levels[coarse_idx]->getPatch(fine_patch->getGlobalId()));
+
+    coarsen_op->coarsen(
+      *coarse_patch, *fine_patch, idx, idx, coarse_patch->getBox(), ratio);
+  }
+
+  _fillGhosts(idx, fine_depth - 1);
+}
+
+/**
+ * @brief interpolate a field at coarse depth to the next finer depth
+ * @details uses the refine operator patch by patch, coarse ghost cells
+ *  are always up to date so the operator stencil is covered
+ */
+void SAMRAIFASMultigrid::_interpolateCoarse2fine(idx_t idx, idx_t coarse_depth)
+{
+  idx_t fine_idx = _dIdx(coarse_depth + 1);
+  idx_t coarse_idx = _dIdx(coarse_depth);
+  const hier::IntVector ratio(dim, 2);
+
+  for(hier::PatchLevel::iterator pit(levels[fine_idx]->begin());
+      pit != levels[fine_idx]->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & fine_patch = *pit;
+    std::shared_ptr<hier::Patch> coarse_patch(
+      levels[coarse_idx]->getPatch(fine_patch->getGlobalId()));
+
+    pdat::CellOverlap overlap(
+      hier::BoxContainer(fine_patch->getBox()),
+      hier::Transformation(hier::IntVector::getZero(dim)));
+
+    refine_op->refine(*fine_patch, *coarse_patch, idx, idx, overlap, ratio);
+  }
+
+  _fillGhosts(idx, coarse_depth + 1);
+}
+
+/**
+ * @brief      Evaluate elliptic equation, stores in a field
+ *
+ * @param      result_idx  field to store result on
+ * @param      eqn_id      id of equation to deal with
+ * @param[in]  depth       depth to evaluate at
+ */
+void SAMRAIFASMultigrid::_evaluateEllipticEquation(idx_t result_idx, idx_t eqn_id, idx_t depth)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    hier::Patch & patch = **pit;
+    fas_patch_t pa;
+    _getPatchArrays(patch, pa);
+    arr_t result = _getArray(patch, result_idx);
+
+    const int * lower = &patch.getBox().lower()[0];
+    const int * upper = &patch.getBox().upper()[0];
+
+    #pragma omp parallel for collapse(2)
+    SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+    {
+      result(i, j, k) = _evaluateEllipticEquationPt(eqn_id, pa, i, j, k);
+    }
+  }
+  _fillGhosts(result_idx, depth);
+}
+
+/**
+ * @brief      Computes residual coarse_src - F(u)
+ * @param      residual_idx  field to store result on
+ * @param      eqn_id    id of equation to deal with
+ * @param[in]  depth     depth to evaluate at
+ */
+void SAMRAIFASMultigrid::_computeResidual(idx_t residual_idx, idx_t eqn_id, idx_t depth)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    hier::Patch & patch = **pit;
+    fas_patch_t pa;
+    _getPatchArrays(patch, pa);
+    arr_t residual = _getArray(patch, residual_idx);
+    arr_t coarse_src = _getArray(patch, coarse_src_idx[eqn_id]);
+
+    const int * lower = &patch.getBox().lower()[0];
+    const int * upper = &patch.getBox().upper()[0];
+
+    #pragma omp parallel for collapse(2)
+    SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+    {
+      residual(i, j, k) = coarse_src(i, j, k)
+        - _evaluateEllipticEquationPt(eqn_id, pa, i, j, k);
+    }
+  }
+  _fillGhosts(residual_idx, depth);
+}
+
+/**
+ * @brief      Computes max residual for a equation over all ranks
+ * @param      eqn_id id of equation we deal with
+ * @param[in]  depth  depth to compute residual at
+ * @return residual
+ */
+real_t SAMRAIFASMultigrid::_getMaxResidual(idx_t eqn_id, idx_t depth)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+  real_t max_residual = 0.0;
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    hier::Patch & patch = **pit;
+    fas_patch_t pa;
+    _getPatchArrays(patch, pa);
+    arr_t coarse_src = _getArray(patch, coarse_src_idx[eqn_id]);
+
+    const int * lower = &patch.getBox().lower()[0];
+    const int * upper = &patch.getBox().upper()[0];
+
+    #pragma omp parallel for collapse(2) reduction(max : max_residual)
+    SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+    {
+      real_t current_residual = std::fabs(coarse_src(i, j, k)
+        - _evaluateEllipticEquationPt(eqn_id, pa, i, j, k));
+
+      if(current_residual > max_residual)
+        max_residual = current_residual;
+    }
+  }
+
+  hierarchy->getMPI().AllReduce(&max_residual, 1, MPI_MAX);
+  return max_residual;
+}
+
+/**
+ * @brief get maximum residual among all equations
+ *
+ * @param depth to perform calculation
+ * @return residual
+ */
+real_t SAMRAIFASMultigrid::_getMaxResidualAllEqs(idx_t depth)
+{
+  real_t max_for_all = 0;
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    max_for_all = std::max(max_for_all, _getMaxResidual(eqn_id, depth));
+  return max_for_all;
+}
+
+/**
+ * @brief      Compute coarse_src and u on a coarser depth
+ * using tmp for some computations
+ * @param id of equation
+ * @param[in]  fine_depth  depth of level to coarsen
+ */
+void SAMRAIFASMultigrid::_computeCoarseRestrictions(idx_t eqn_id, idx_t fine_depth)
+{
+  _restrictFine2coarse(u_idx[eqn_id], fine_depth);
+
+  _computeResidual(tmp_idx[eqn_id], eqn_id, fine_depth);
+
+  _restrictFine2coarse(tmp_idx[eqn_id], fine_depth);
+
+  _evaluateEllipticEquation(coarse_src_idx[eqn_id], eqn_id, fine_depth - 1);
+
+  const fas_level_t & level = levels[_dIdx(fine_depth - 1)];
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    hier::Patch & patch = **pit;
+    arr_t coarse_src = _getArray(patch, coarse_src_idx[eqn_id]);
+    arr_t tmp = _getArray(patch, tmp_idx[eqn_id]);
+
+    const int * lower = &patch.getBox().lower()[0];
+    const int * upper = &patch.getBox().upper()[0];
+
+    #pragma omp parallel for collapse(2)
+    SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+    {
+      coarse_src(i, j, k) += tmp(i, j, k);
+    }
+  }
+  _fillGhosts(coarse_src_idx[eqn_id], fine_depth - 1);
+}
+
+/**
+ * @brief      Convert a field containing an approximate solution
+ *  to a field containing the solution error, err = true - appx.
+ *
+ * @param      appx_to_err_idx  field containing appx'n to convert
+ * @param      exact_soln_idx   field containing exact solution
+ * @param[in]  depth            depth to perform computation at
+ */
+void SAMRAIFASMultigrid::_changeApproximateSolutionToError(idx_t appx_to_err_idx,
+  idx_t exact_soln_idx, idx_t depth)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    hier::Patch & patch = **pit;
+    arr_t appx_to_err = _getArray(patch, appx_to_err_idx);
+    arr_t exact_soln = _getArray(patch, exact_soln_idx);
+
+    const int * lower = &patch.getBox().lower()[0];
+    const int * upper = &patch.getBox().upper()[0];
+
+    #pragma omp parallel for collapse(2)
+    SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+    {
+      appx_to_err(i, j, k) = exact_soln(i, j, k) - appx_to_err(i, j, k);
+    }
+  }
+  _fillGhosts(appx_to_err_idx, depth);
+}
+
+/**
+ * @brief Compute and add in correction to fine level from error
+ * on coarser level; replace error with appx. solution
+ *
+ * @param err2appx_idx field containing error
+ * @param appx_soln_idx field containing approximate solution
+ * @param fine_depth depth of fine level to correct
+ */
+void SAMRAIFASMultigrid::_correctFineFromCoarseErr_Err2Appx(idx_t err2appx_idx,
+  idx_t appx_soln_idx, idx_t fine_depth)
+{
+  _interpolateCoarse2fine(err2appx_idx, fine_depth - 1);
+
+  const fas_level_t & level = levels[_dIdx(fine_depth)];
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    hier::Patch & patch = **pit;
+    arr_t err2appx = _getArray(patch, err2appx_idx);
+    arr_t appx_soln = _getArray(patch, appx_soln_idx);
+
+    const int * lower = &patch.getBox().lower()[0];
+    const int * upper = &patch.getBox().upper()[0];
+
+    #pragma omp parallel for collapse(2)
+    SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+    {
+      // appx. solution in intermediate variable
+      real_t appx_val = appx_soln(i, j, k);
+      // correct approximate solution with error
+      appx_soln(i, j, k) += err2appx(i, j, k);
+      // store approximate solution in err2appx
+      err2appx(i, j, k) = appx_val;
+    }
+  }
+  _fillGhosts(appx_soln_idx, fine_depth);
+  _fillGhosts(err2appx_idx, fine_depth);
+}
+
+/**
+ * @brief Copy a field (ghosts included) to another one
+ *
+ * @param from_idx copy from this field
+ * @param to_idx to this field
+ * @param depth at this depth
+ */
+void SAMRAIFASMultigrid::_copyGrid(idx_t from_idx, idx_t to_idx, idx_t depth)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+  {
+    const std::shared_ptr<hier::Patch> & patch = *pit;
+    patch->getPatchData(to_idx)->copy(*patch->getPatchData(from_idx));
+  }
+}
+
+/**
+ * @brief u += coef * v for all variables at a depth
+ */
+void SAMRAIFASMultigrid::_addDampingV(idx_t depth, real_t coef)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+  {
+    for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+    {
+      hier::Patch & patch = **pit;
+      arr_t u = _getArray(patch, u_idx[eqn_id]);
+      arr_t damping_v = _getArray(patch, damping_v_idx[eqn_id]);
+
+      const int * lower = &patch.getBox().lower()[0];
+      const int * upper = &patch.getBox().upper()[0];
+
+      #pragma omp parallel for collapse(2)
+      SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+      {
+        u(i, j, k) += coef * damping_v(i, j, k);
+      }
+    }
+    _fillGhosts(u_idx[eqn_id], depth);
+  }
+}
+
+/**
+ * @brief iterative method to find a \lambda between 1 and zero,
+ *        returning the largest value that satisfies
+ *        norm less than the norm of F(u)
+ * @param depth
+ * @param norm
+ */
+bool SAMRAIFASMultigrid::_getLambda(idx_t depth, real_t norm)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+
+  _addDampingV(depth, 1.0);
+
+  for(idx_t s = 0; s < 100; s++)
+  {
+    real_t sum = 0.0;
+
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    {
+      for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+      {
+        hier::Patch & patch = **pit;
+        fas_patch_t pa;
+        _getPatchArrays(patch, pa);
+        arr_t coarse_src = _getArray(patch, coarse_src_idx[eqn_id]);
+
+        const int * lower = &patch.getBox().lower()[0];
+        const int * upper = &patch.getBox().upper()[0];
+
+        #pragma omp parallel for collapse(2) reduction(+:sum)
+        SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+        {
+          real_t temp = _evaluateEllipticEquationPt(eqn_id, pa, i, j, k)
+            - coarse_src(i, j, k);
+          sum += temp * temp;
+        }
+      }
+    }
+    hierarchy->getMPI().AllReduce(&sum, 1, MPI_SUM);
+
+    if(sum <= norm)  // when | F(u + \lambda v) | < | F(u) | stop
+      return 1;
+
+    _addDampingV(depth, -0.01);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief perform Jacobian relaxation until a desired precision is reached
+ * @param depth
+ * @param norm of F(u)
+ * @param parameter can control the converge speed
+ * @param parameter can control the converge speed
+ */
+bool SAMRAIFASMultigrid::_jacobianRelax(idx_t depth, real_t norm, real_t C, idx_t p)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+  idx_t cnt = 0;
+
+  real_t norm_r = 1e100, norm_pre;
+
+  //initilizing value of damping_v
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    _allocateField(damping_v_idx[eqn_id], depth);
+
+  while(norm_r >= std::min(pow(norm, (real_t)(p+1)) * C, norm))
+  {
+    //relax until the convergent condition got satisfy
+    norm_r = 0.0;
+    norm_pre = 0.0;
+
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    {
+      for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+      {
+        hier::Patch & patch = **pit;
+        fas_patch_t pa;
+        _getPatchArrays(patch, pa);
+        arr_t & damping_v = pa.damping_v[eqn_id];
+        arr_t jac_rhs = _getArray(patch, jac_rhs_idx[eqn_id]);
+
+        const int * lower = &patch.getBox().lower()[0];
+        const int * upper = &patch.getBox().upper()[0];
+
+        #pragma omp parallel for collapse(2)
+        SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+        {
+          real_t coef_a = 0, coef_b = 0, temp = 0;
+          _evaluateIterationForJacEquation(eqn_id, pa, coef_a, coef_b, i, j, k, eqn_id);
+          for(idx_t u_id = 0; u_id < u_n; u_id++)
+          {
+            if(u_id != eqn_id)
+              temp += _evaluateDerEllipticEquation(eqn_id, pa, i, j, k, u_id);
+          }
+          damping_v(i, j, k) = (coef_a - jac_rhs(i, j, k) + temp) / (-coef_b);
+        }
+      }
+      _fillGhosts(damping_v_idx[eqn_id], depth);
+    }
+
+    for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+    {
+      hier::Patch & patch = **pit;
+      fas_patch_t pa;
+      _getPatchArrays(patch, pa);
+      std::vector<arr_t> jac_rhs(u_n);
+      for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+        jac_rhs[eqn_id] = _getArray(patch, jac_rhs_idx[eqn_id]);
+
+      const int * lower = &patch.getBox().lower()[0];
+      const int * upper = &patch.getBox().upper()[0];
+
+      #pragma omp parallel for collapse(2) reduction(+:norm_r)
+      SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+      {
+        for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+        {
+          real_t temp = 0;
+          for(idx_t u_id = 0; u_id < u_n; u_id++)
+            temp += _evaluateDerEllipticEquation(eqn_id, pa, i, j, k, u_id);
+          temp -= jac_rhs[eqn_id](i, j, k);
+          norm_r += temp * temp;
+        }
+      }
+    }
+    hierarchy->getMPI().AllReduce(&norm_r, 1, MPI_SUM);
+
+    cnt++;
+    if(cnt > 5000 && norm_r > norm_pre)
+    {
+      //cannot solve Jacobian equation to precision needed
+      tbox::pout << "Unable to achieve a precise enough solution within "
+                 << cnt << " iterations.\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief relax u using the inexact Newton iterative method
+ * @param depth
+ * @param max interation number
+ */
+bool SAMRAIFASMultigrid::_relaxSolution_GaussSeidel(idx_t depth, idx_t max_iterations)
+{
+  const fas_level_t & level = levels[_dIdx(depth)];
+  idx_t depth_idx = _dIdx(depth);
+  real_t norm;
+
+  for(idx_t s = 0; s < max_iterations; ++s)
+  {
+    // set tolenrance precision, which should be smaller when grids become more coarse
+    if(_getMaxResidualAllEqs(depth) < (relaxation_tolerance / pw2(1<<(max_depth_idx - depth_idx))))
+      break;
+
+    norm = 0.0;
+
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    {
+      for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+      {
+        hier::Patch & patch = **pit;
+        fas_patch_t pa;
+        _getPatchArrays(patch, pa);
+        arr_t jac_rhs = _getArray(patch, jac_rhs_idx[eqn_id]);
+        arr_t coarse_src = _getArray(patch, coarse_src_idx[eqn_id]);
+
+        const int * lower = &patch.getBox().lower()[0];
+        const int * upper = &patch.getBox().upper()[0];
+
+        #pragma omp parallel for collapse(2) reduction(+:norm)
+        SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+        {
+          real_t temp = _evaluateEllipticEquationPt(eqn_id, pa, i, j, k)
+            - coarse_src(i, j, k);
+
+          norm += temp * temp;
+
+          //evalue jac_source at right hand side of Jacobian linear equation
+          jac_rhs(i, j, k) = -temp;
+        }
+      }
+    }
+    hierarchy->getMPI().AllReduce(&norm, 1, MPI_SUM);
+
+    if(_jacobianRelax(depth, norm, 1, 0) == false)
+      return 0;
+
+    // get damping parameter lambda
+    if(_getLambda(depth, norm) == false)
+    {
+      tbox::pout<<"Can't find suitable damping factor!!!\n";
+      return 0;
+    }
+  } // end iterations loop
+
+  return 1;
+}
+
+/**
+ * @brief      Restrict all source terms to coarser depths
+ * @details    source terms may have been allocated on some ranks only
+ *  (through getPolySrcArray), so agree on them first
+ */
+void SAMRAIFASMultigrid::initializeRhoHeirarchy()
+{
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+  {
+    mpi.AllReduce(&has_rho[eqn_id][0], molecule_n[eqn_id], MPI_MAX);
+
+    for(idx_t mol_id = 0; mol_id < molecule_n[eqn_id]; mol_id++)
+    {
+      if(!has_rho[eqn_id][mol_id])
+        continue;
+
+      if(!levels[max_depth_idx]->checkAllocated(rho_idx[eqn_id][mol_id]))
+        _allocateField(rho_idx[eqn_id][mol_id], max_depth);
+
+      for(idx_t depth = max_depth; depth > min_depth; --depth)
+      {
+        _allocateField(rho_idx[eqn_id][mol_id], depth - 1);
+        _restrictFine2coarse(rho_idx[eqn_id][mol_id], depth);
+      }
+    }
+  }
+}
+
+/**
+ * @brief      Restrict all shift functions to coarser depths
+ */
+void SAMRAIFASMultigrid::initializeShiftHeirarchy()
+{
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    for(idx_t depth = max_depth; depth > min_depth; --depth)
+      _restrictFine2coarse(u_shift_idx[eqn_id], depth);
+}
+
+/**
+ * @brief      Solution of a variable on a patch of the finest depth,
+ *  to set the initial guess or read out the result
+ */
+arr_t SAMRAIFASMultigrid::getSolutionArray(hier::Patch & patch, idx_t u_id)
+{
+  return _getArray(patch, u_idx[u_id]);
+}
+
+/**
+ * @brief      Shift function of a variable on a patch of the finest depth
+ */
+arr_t SAMRAIFASMultigrid::getShiftArray(hier::Patch & patch, idx_t u_id)
+{
+  return _getArray(patch, u_shift_idx[u_id]);
+}
+
+/**
+ * @brief      Source term of a molecule on a patch of the finest depth,
+ *  allocated on first access
+ */
+arr_t SAMRAIFASMultigrid::getPolySrcArray(hier::Patch & patch, idx_t eqn_id, idx_t mol_id)
+{
+  if(!has_rho[eqn_id][mol_id])
+  {
+    _allocateField(rho_idx[eqn_id][mol_id], max_depth);
+    has_rho[eqn_id][mol_id] = 1;
+  }
+  return _getArray(patch, rho_idx[eqn_id][mol_id]);
+}
+
+bool SAMRAIFASMultigrid::VCycle()
+{
+  _compileEquations();
+
+  if(!_relaxSolution_GaussSeidel(max_depth, max_relax_iters))
+    return 0;
+
+  tbox::pout << "  Initial max. residual on fine grid is: "
+             << _getMaxResidualAllEqs(max_depth) << ".\n" << std::flush;
+
+  idx_t depth, coarse_depth;
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+  {
+    for(depth = max_depth; min_depth < depth; --depth)
+      _computeCoarseRestrictions(eqn_id, depth);
+    _copyGrid(u_idx[eqn_id], tmp_idx[eqn_id], min_depth);
+  }
+
+  for(coarse_depth = min_depth; coarse_depth < max_depth; coarse_depth++)
+  {
+    if(!_relaxSolution_GaussSeidel(coarse_depth, max_relax_iters * (max_depth - coarse_depth) * 2))
+      return 0;
+
+    tbox::pout << "    Working on upward stroke at depth " << coarse_depth
+               << "; residual after solving is: "
+               << _getMaxResidualAllEqs(coarse_depth) << ".\n" << std::flush;
+
+    // tmp should hold appx. soln; convert to error
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+      _changeApproximateSolutionToError(tmp_idx[eqn_id], u_idx[eqn_id], coarse_depth);
+
+    // tmp should hold error
+    for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+      _correctFineFromCoarseErr_Err2Appx(tmp_idx[eqn_id], u_idx[eqn_id], coarse_depth+1);
+
+    // tmp now holds appx. soln on finer level;
+    // u now holds corrected solution on finer level
+  }
+
+  if(!_relaxSolution_GaussSeidel(max_depth, max_relax_iters))
+    return 0;
+  tbox::pout << "  Final max. residual on fine grid is: "
+             << _getMaxResidualAllEqs(max_depth) << ".\n" << std::flush;
+  return 1;
+}
+
+/**
+ * @brief      Run V-cycles on the solution set through getSolutionArray,
+ *  ghost cells of the solution are filled afterwards
+ */
+void SAMRAIFASMultigrid::VCycles(idx_t num_cycles)
+{
+  _compileEquations();
+
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+    _fillGhosts(u_idx[eqn_id], max_depth);
+
+  int cycle = 0;
+  for(cycle = 0; cycle < num_cycles; ++cycle)
+  {
+    if(!VCycle())
+    {
+      tbox::pout << "Jumping out of the Vcycles!\n";
+      break;
+    }
+  }
+
+  if(cycle == num_cycles)
+    _relaxSolution_GaussSeidel(max_depth, 10);
+  tbox::pout << "  Final solution residual is: "
+             << _getMaxResidualAllEqs(max_depth) << "\n" << std::flush;
+
+  const fas_level_t & level = levels[max_depth_idx];
+
+  for(idx_t eqn_id = 0; eqn_id < u_n; eqn_id++)
+  {
+    real_t u_sum = 0, u_min = INF, u_max = -INF, n_pts = 0;
+    for(hier::PatchLevel::iterator pit(level->begin()); pit != level->end(); ++pit)
+    {
+      hier::Patch & patch = **pit;
+      arr_t u = _getArray(patch, u_idx[eqn_id]);
+
+      const int * lower = &patch.getBox().lower()[0];
+      const int * upper = &patch.getBox().upper()[0];
+
+      #pragma omp parallel for collapse(2) reduction(+:u_sum, n_pts) reduction(min:u_min) reduction(max:u_max)
+      SAMRAI_FAS_LOOP3(i, j, k, lower, upper)
+      {
+        u_sum += u(i, j, k);
+        u_min = std::min(u_min, u(i, j, k));
+        u_max = std::max(u_max, u(i, j, k));
+        n_pts += 1;
+      }
+    }
+    mpi.AllReduce(&u_sum, 1, MPI_SUM);
+    mpi.AllReduce(&n_pts, 1, MPI_SUM);
+    mpi.AllReduce(&u_min, 1, MPI_MIN);
+    mpi.AllReduce(&u_max, 1, MPI_MAX);
+
+    tbox::pout << " Solution for variable " << eqn_id
+               << " has average / min / max value: " << std::setprecision(9)
+               << u_sum / n_pts << " / " << u_min << " / " << u_max
+               << ".\n" << std::flush;
+  }
+}
+
+} // namespace cosmo
@@ -0,0 +1,194 @@
+#ifndef SAMRAI_FAS_MULTIGRID_H
+#define SAMRAI_FAS_MULTIGRID_H
+
+#include "../../cosmo_includes.h"
+#include "SAMRAI/hier/PatchHierarchy.h"
+#include "SAMRAI/hier/PatchLevel.h"
+#include "SAMRAI/hier/VariableDatabase.h"
+#include "SAMRAI/hier/RefineOperator.h"
+#include "SAMRAI/hier/CoarsenOperator.h"
+#include "SAMRAI/xfer/RefineAlgorithm.h"
+#include "SAMRAI/xfer/RefineSchedule.h"
+
+#include "full_multigrid.h"
+
+#include <map>
+
+using namespace SAMRAI;
+
+namespace cosmo
+{
+
+/**
+ * @brief FAS multigrid solver working on distributed SAMRAI patch data
+ * @details
+ * Solves the same kind of systems (molecules built from atoms) with the
+ * same inexact Newton relaxation as FASMultigrid, but without replicating
+ * the grid on every rank. The finest depth is a level of the hierarchy
+ * covering the whole (periodic) domain; every coarser depth is a PatchLevel
+ * obtained from it by PatchLevel::setCoarsenedPatchLevel, so each rank only
+ * stores the coarsened images of the patches it owns. Ghost cells are filled
+ * with level RefineSchedules and transfers between depths are done patch by
+ * patch with the refine / coarsen operators registered to the grid geometry.
+ */
+class SAMRAIFASMultigrid
+{
+ private:
+
+  typedef std::shared_ptr<hier::PatchLevel> fas_level_t;
+
+  /**
+   * @brief views of all solver fields on a single patch
+   */
+  struct fas_patch_t
+  {
+    std::vector<arr_t> u, u_shift, damping_v;
+    std::vector<std::vector<arr_t> > rho;
+    double dx[DIM];
+  };
+
+  std::shared_ptr<hier::PatchHierarchy> hierarchy;
+  const tbox::Dimension dim;
+
+  idx_t u_n;          ///< number of variables ( = number of equations)
+
+  idx_t * molecule_n; ///< number of molecules for each equation
+
+  real_t relaxation_tolerance;  ///< desired precision when performing relaxation
+
+  idx_t max_depth, max_depth_idx;
+  idx_t min_depth, min_depth_idx;
+  idx_t total_depths, max_relax_iters;
+
+  idx_t der_type[12 /* number of items in enum atom_type */][2 /* derivative directions(s) */];      ///< vectors that stores devivative directions
+
+  real_t double_der_coef[9];  ///< coefficients of f(x,y,z) in double derivative stencils
+
+  std::vector<fas_level_t> levels;  ///< one level per depth, the finest one belongs to the hierarchy
+
+  // patch data indices of solver fields, one per variable / equation
+  std::vector<idx_t> u_idx;           ///< field seeking a solution for
+  std::vector<idx_t> tmp_idx;         ///< reusable field for storing intermediate calculations
+  std::vector<idx_t> coarse_src_idx;  ///< multigrid source term
+  std::vector<idx_t> jac_rhs_idx;     ///< - F(u) which is rhs of Jacob Linear function
+  std::vector<idx_t> damping_v_idx;   ///< Newton correction v, used to calculate F(u + \lambda v)
+  std::vector<idx_t> u_shift_idx;     ///< the shift function of u, only change vars in poly to (u+u_shift)
+  std::vector<std::vector<idx_t> > rho_idx;  ///< source terms of every molecule
+  std::vector<std::vector<int> > has_rho;    ///< whether a molecule has a source term
+
+  std::vector<compiled_eqn> compiled_eqns;  ///< eqns compiled for residual evaluation
+
+  std::shared_ptr<hier::RefineOperator> refine_op;
+  std::shared_ptr<hier::CoarsenOperator> coarsen_op;
+
+  /// ghost filling schedules indexed by patch data index and depth index
+  std::map<idx_t, std::vector<std::shared_ptr<xfer::RefineSchedule> > >
+  ghost_schedules;
+
+  /**
+   * @brief indexing scheme of a level heirarchy
+   * @return index of level at a particular depth
+   */
+  inline idx_t _dIdx(idx_t depth)
+  {
+    return depth - min_depth;
+  }
+
+  idx_t _registerField(const std::string & name);
+
+  arr_t _getArray(hier::Patch & patch, idx_t idx);
+
+  void _getPatchArrays(hier::Patch & patch, fas_patch_t & pa);
+
+  void _allocateField(idx_t idx, idx_t depth);
+
+  void _fillGhosts(idx_t idx, idx_t depth);
+
+  void _compileEquations();
+
+  real_t _evaluateEllipticEquationPt(idx_t eqn_id, fas_patch_t & pa,
+    idx_t i, idx_t j, idx_t k);
+
+  void _evaluateIterationForJacEquation(idx_t eqn_id, fas_patch_t & pa,
+    real_t &coef_a, real_t &coef_b, idx_t i, idx_t j, idx_t k, idx_t u_id);
+
+  real_t _evaluateDerEllipticEquation(idx_t eqn_id, fas_patch_t & pa,
+    idx_t i, idx_t j, idx_t k, idx_t u_id);
+
+  void _restrictFine2coarse(idx_t idx, idx_t fine_depth);
+
+  void _interpolateCoarse2fine(idx_t idx, idx_t coarse_depth);
+
+  void _evaluateEllipticEquation(idx_t result_idx, idx_t eqn_id, idx_t depth);
+
+  void _computeResidual(idx_t residual_idx, idx_t eqn_id, idx_t depth);
+
+  real_t _getMaxResidual(idx_t eqn_id, idx_t depth);
+
+  real_t _getMaxResidualAllEqs(idx_t depth);
+
+  void _computeCoarseRestrictions(idx_t eqn_id, idx_t fine_depth);
+
+  void _changeApproximateSolutionToError(idx_t appx_to_err_idx,
+    idx_t exact_soln_idx, idx_t depth);
+
+  void _correctFineFromCoarseErr_Err2Appx(idx_t err2appx_idx,
+    idx_t appx_soln_idx, idx_t fine_depth);
+
+  void _copyGrid(idx_t from_idx, idx_t to_idx, idx_t depth);
+
+  void _addDampingV(idx_t depth, real_t coef);
+
+  bool _getLambda(idx_t depth, real_t norm);
+
+  bool _jacobianRelax(idx_t depth, real_t norm, real_t C, idx_t p);
+
+  bool _relaxSolution_GaussSeidel(idx_t depth, idx_t max_iterations);
+
+ public:
+
+  enum atom_type
+  {
+    poly = FASMultigrid::poly,
+    der1 = FASMultigrid::der1,
+    der2 = FASMultigrid::der2,
+    der3 = FASMultigrid::der3,
+    der11 = FASMultigrid::der11,
+    der22 = FASMultigrid::der22,
+    der33 = FASMultigrid::der33,
+    der12 = FASMultigrid::der12,
+    der13 = FASMultigrid::der13,
+    der23 = FASMultigrid::der23,
+    lap = FASMultigrid::lap
+  };
+
+  molecule ** eqns; ///< All terms in all equations
+
+  SAMRAIFASMultigrid(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy_in, idx_t ln,
+    idx_t u_n_in, idx_t molecule_n_in [],
+    idx_t max_depth_in, idx_t max_relax_iters_in,
+    real_t relaxation_tolerance_in,
+    std::string refine_op_type = "LINEAR_REFINE",
+    std::string coarsen_op_type = "CONSERVATIVE_COARSEN");
+  ~SAMRAIFASMultigrid();
+
+  void add_atom_to_eqn(atom atom_in, idx_t molecule_id, idx_t eqn_id);
+
+  bool VCycle();
+
+  void VCycles(idx_t num_cycles);
+
+  arr_t getSolutionArray(hier::Patch & patch, idx_t u_id);
+
+  arr_t getShiftArray(hier::Patch & patch, idx_t u_id);
+
+  arr_t getPolySrcArray(hier::Patch & patch, idx_t eqn_id, idx_t mol_id);
+
+  void initializeRhoHeirarchy();
+
+  void initializeShiftHeirarchy();
+};
+
+} // namespace cosmo
+#endif
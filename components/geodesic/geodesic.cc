@@ -22,6 +22,11 @@ Geodesic::Geodesic(
   ghost_width(cosmo_geodesic_db->getIntegerWithDefault("ghost_width", 2)),
   p0(cosmo_geodesic_db->getDoubleWithDefault("p0", 1)),
   save_metric(cosmo_geodesic_db->getBoolWithDefault("save_metric", false)),
+  cache_metric_coefs(
+    cosmo_geodesic_db->getBoolWithDefault("cache_metric_coefficients", false)),
+  precompute_ray_geometry(
+    cosmo_geodesic_db->getBoolWithDefault("precompute_ray_geometry", false)),
+  batched_rk(cosmo_geodesic_db->getBoolWithDefault("batched_rk", false)),
   pc(new pdat::IndexVariable<ParticleContainer, pdat::CellGeometry>(
       dim, "particle"))
 {
@@ -58,6 +63,14 @@ Geodesic::Geodesic(
   pc_d_buffer_idx = variable_db->registerVariableAndContext(
     pc, context_down_stream_buffer, hier::IntVector(dim, ghost_width));
 
+  // interpolation stencils of particles in the ghost cells reach two
+  // cells further
+  ray_geometry_var = std::shared_ptr<pdat::CellVariable<double> >(
+    new pdat::CellVariable<double>(
+      dim, "ray_geometry", GEODESIC_RAY_GEOMETRY_DEPTH));
+  ray_geometry_idx = variable_db->registerVariableAndContext(
+    ray_geometry_var, context_scratch, hier::IntVector(dim, ghost_width + 2));
+
 
   std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
     SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
@@ -154,7 +167,7 @@ void Geodesic::compute_tricubic_coeffs(double *a, double *f)
 }
 
 double Geodesic::evaluate_interpolation(
-  double * a, double x, double y, double z)
+  const double * a, double x, double y, double z)
 {
 #define P2(x) x*x
 #define P3(x) x*x*x
@@ -227,17 +240,14 @@ void Geodesic::initAll(
       
       pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator iter(*pc_pdata, true);
       pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator iterend(*pc_pdata, false);
-      std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> it_vec;
-      for(;iter != iterend; iter++) it_vec.push_back(iter);
-
-      for(int ii = 0; ii < it_vec.size(); ii++)
+      for(; iter != iterend; iter++)
       {
-        ParticleContainer & id = *it_vec[ii];
+        ParticleContainer & id = *iter;
 
         double shift[3] = {0};
 
-        for(std::list<RKParticle>::iterator it=id.p_list.begin();
-            it != id.p_list.end(); it++)
+        for(ParticleContainer::iterator it=id.begin();
+            it != id.end(); it++)
         {
           if((*it).ip[0] < num_p_after * 3 && (*it).ip[0] >= num_p_before * 3)
           {
@@ -330,8 +340,8 @@ void Geodesic::initAll(
 
         double shift[3] = {0};
 
-        for(std::list<RKParticle>::iterator it=id.p_list.begin();
-            it != id.p_list.end(); it++)
+        for(ParticleContainer::iterator it=id.begin();
+            it != id.end(); it++)
         {
           if((*it).ip[0] < num_p_after * 3 && (*it).ip[0] >= num_p_before * 3)
           {
@@ -421,6 +431,8 @@ void Geodesic::allocParticles(
   level->allocatePatchData(pc_idx);
   level->allocatePatchData(pc_s_idx);
   level->allocatePatchData(pc_d_buffer_idx);
+  if(precompute_ray_geometry)
+    level->allocatePatchData(ray_geometry_idx);
 }
 
 void Geodesic::insertPatchParticles(
@@ -443,16 +455,12 @@ void Geodesic::insertPatchParticles(
   pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator iter(*src_pdata, true);
   pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator iterend(*src_pdata, false);
 
-  std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> it_vec;
-  for(;iter != iterend; iter++) it_vec.push_back(iter);
-
-  //#pragma omp parallel for
-  for(int ii = 0; ii < it_vec.size(); ii++)
+  for(; iter != iterend; iter++)
   {
 
     // get pointer to this particle at Index
-    ParticleContainer & src_p = *it_vec[ii];
-    hier::Index ic (it_vec[ii].getIndex());
+    ParticleContainer & src_p = *iter;
+    hier::Index ic (iter.getIndex());
     ParticleContainer *dst_p = dst_pdata->getItem(ic);
 
     if(dst_p == NULL)
@@ -462,7 +470,7 @@ void Geodesic::insertPatchParticles(
       dst_p = dst_pdata->getItem(ic);
       delete p;
     }
-    dst_p->p_list.insert(dst_p->p_list.end(), src_p.p_list.begin(), src_p.p_list.end());
+    dst_p->append(src_p);
     
   }
 
@@ -572,26 +580,31 @@ void Geodesic::preAdvance(
   // note these particles are REAL particles living in ghost cells
   // so the filling should be from real container to real container
  {  
-   std::shared_ptr<hier::RefineOperator> refine_op
-     = grid_geometry.
-     lookupRefineOperator(pc, "PARTICLE_REFINE");
+   if(ghost_fill_schedules.size() <= ln)
+     ghost_fill_schedules.resize(ln + 1);
+
+   if(!ghost_fill_schedules[ln])
+   {
+     std::shared_ptr<hier::RefineOperator> refine_op
+       = grid_geometry.
+       lookupRefineOperator(pc, "PARTICLE_REFINE");
   
 
-   xfer::RefineAlgorithm refiner;
+     xfer::RefineAlgorithm refiner;
   
-   refiner.registerRefine(pc_idx,
-                          pc_idx,                        
-                          pc_idx,                        
-                          refine_op);
+     refiner.registerRefine(pc_idx,
+                            pc_idx,                        
+                            pc_idx,                        
+                            refine_op);
 
-   std::shared_ptr<xfer::RefineSchedule> refine_schedule;
-  
-   refine_schedule =
-     refiner.createSchedule(
-       level,
-       NULL);
+     ghost_fill_schedules[ln] =
+       refiner.createSchedule(
+         level,
+         NULL);
+   }
 
-   refine_schedule->fillData(0.0);
+   // only exchanges with the ranks owning neighbouring patches
+   ghost_fill_schedules[ln]->fillData(0.0);
 
  }
 }
@@ -640,106 +653,141 @@ void Geodesic::RKEvolvePatch(
   std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> it_vec;
   for(;iter != iterend; iter++) it_vec.push_back(iter);
 
-#pragma omp parallel for
-  for(int ii = 0; ii < it_vec.size(); ii++)
-  {
+  // the _a fields are fixed during this call, so the coefficients of a
+  // cell can be shared by all particles in it
+  MetricCoefCache coef_cache;
+  MetricCoefCache * coef_cache_p = cache_metric_coefs ? &coef_cache : NULL;
 
-    //    hier::Index idx(*ic);
-    ParticleContainer & id = *it_vec[ii];
+  RayGeometry ray_geometry;
+  RayGeometry * ray_geometry_p = NULL;
+  if(precompute_ray_geometry)
+  {
+    fillRayGeometry(patch, bssn, dx, it_vec, effective_ghost_box,
+                    ghost_box_phys_lower, ghost_box_phys_upper, &ray_geometry);
+    ray_geometry_p = &ray_geometry;
+  }
 
+#pragma omp parallel
+  {
+    RKBatch batch;
 
-    for(std::list<RKParticle>::iterator it=id.p_list.begin();
-        it != id.p_list.end(); it++)
+#pragma omp for
+    for(int ii = 0; ii < it_vec.size(); ii++)
     {
-      GeodesicData gd = {0};
-      double shift[3] = {0};
+
+      //    hier::Index idx(*ic);
+      ParticleContainer & id = *it_vec[ii];
+
+
+      for(ParticleContainer::iterator it=id.begin();
+          it != id.end(); it++)
+      {
+        GeodesicData gd = {0};
+        double shift[3] = {0};
     
       
-      for(int i = 0 ; i < 3; i ++)
-      {
-        if(ghost_box_phys_lower[i] > ((*it).x_a[i])) 
-          shift[i] = ceil( (double)(ghost_box_phys_lower[i] - (*it).x_a[i]) / round(L[i]));
-        if(ghost_box_phys_upper[i] < ((*it).x_a[i])) 
-          shift[i] = -ceil( (double)(-ghost_box_phys_upper[i] + (*it).x_a[i]) / round(L[i]));
+        for(int i = 0 ; i < 3; i ++)
+        {
+          if(ghost_box_phys_lower[i] > ((*it).x_a[i])) 
+            shift[i] = ceil( (double)(ghost_box_phys_lower[i] - (*it).x_a[i]) / round(L[i]));
+          if(ghost_box_phys_upper[i] < ((*it).x_a[i])) 
+            shift[i] = -ceil( (double)(-ghost_box_phys_upper[i] + (*it).x_a[i]) / round(L[i]));
 
-      }
-      int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] );
-      int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] );
-      int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] );
+        }
+        int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] );
+        int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] );
+        int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] );
 
-      // if particle is outside the ghost box anytime
-      // during the RK advance, do not advance it
-      hier::Index temp_idx(i0, j0, k0);
+        // if particle is outside the ghost box anytime
+        // during the RK advance, do not advance it
+        hier::Index temp_idx(i0, j0, k0);
       
-      if(!effective_ghost_box.contains(temp_idx))
-      {
-        for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
-          (*it).x_c[i] = 0;
-        continue;
-      }
+        if(!effective_ghost_box.contains(temp_idx))
+        {
+          for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+            (*it).x_c[i] = 0;
+          continue;
+        }
       
-      for(int i = 0; i < 8; i++)
-        for(int j = 0; j < 8; j++)
-          for(int k = 0; k < 8; k++)
-          {
-            int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] -0.5);
-            int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] -0.5);
-            int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] -0.5);
+        for(int i = 0; i < 8; i++)
+          for(int j = 0; j < 8; j++)
+            for(int k = 0; k < 8; k++)
+            {
+              int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] -0.5);
+              int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] -0.5);
+              int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] -0.5);
 
-            hier::Index temp_idx(i0-3+i, j0-3+j, k0-3+k);
+              hier::Index temp_idx(i0-3+i, j0-3+j, k0-3+k);
             
-            if(!fields_ghost_box.contains(temp_idx))
-              TBOX_ERROR("Particle at "<<hier::Index(i0, j0, k0)
-                         <<"is not contained in the ghostbox "<<fields_ghost_box<<"\n");
-          }
-      set_gd_values(patch, (*it).x_a, &gd, bssn, dx, shift);
-      RKEvolveParticle((*it), gd, dt);
-      if(PARTICLE_REAL_PROPERTIES > 0)
-      {
-        (*it).rp[0] = gd.p0;
-        if(save_metric && PARTICLE_REAL_PROPERTIES > 6)
+              if(!fields_ghost_box.contains(temp_idx))
+                TBOX_ERROR("Particle at "<<hier::Index(i0, j0, k0)
+                           <<"is not contained in the ghostbox "<<fields_ghost_box<<"\n");
+            }
+        if(batched_rk)
         {
-          (*it).rp[1] = gd.m11;
-          (*it).rp[2] = gd.m12;
-          (*it).rp[3] = gd.m13;
-          (*it).rp[4] = gd.m22;
-          (*it).rp[5] = gd.m23;
-          (*it).rp[6] = gd.m33;
+          DustFluidData dd = {0};
+          interpolate_gd_values(patch, (*it).x_a, &gd, bssn, dx, shift,
+                                coef_cache_p, ray_geometry_p);
+          if(PARTICLE_REAL_PROPERTIES > 7)
+            set_gd_values_for_dust_fluid(patch, (*it).x_a, &gd, &dd, dustFluidSim, dx, shift);
+          batch.add(&id, it.index(), gd, dd);
+          if(batch.full())
+            RKEvolveBatch(&batch, dt, true);
+          continue;
         }
-        // outputing dust fluid info
-        if(PARTICLE_REAL_PROPERTIES > 7)
+        set_gd_values(patch, (*it).x_a, &gd, bssn, dx, shift,
+                      coef_cache_p, ray_geometry_p);
+        RKEvolveParticle((*it), gd, dt);
+        if(PARTICLE_REAL_PROPERTIES > 0)
         {
-          DustFluidData dd = {0};
-          set_gd_values_for_dust_fluid(patch, (*it).x_a, &gd, &dd, dustFluidSim, dx, shift);
-                      double v1 = dd.S1 / dd.E, v2 = dd.S2 / dd.E, v3 = dd.S3 / dd.E;
-            double W = dd.E / dd.D;
-            double vi1 = gd.mi11 * v1 + gd.mi12 * v2 + gd.mi13 * v3;
-            double vi2 = gd.mi12 * v1 + gd.mi22 * v2 + gd.mi23 * v3;
-            double vi3 = gd.mi13 * v1 + gd.mi23 * v2 + gd.mi33 * v3;
+          (*it).rp[0] = gd.p0;
+          if(save_metric && PARTICLE_REAL_PROPERTIES > 6)
+          {
+            (*it).rp[1] = gd.m11;
+            (*it).rp[2] = gd.m12;
+            (*it).rp[3] = gd.m13;
+            (*it).rp[4] = gd.m22;
+            (*it).rp[5] = gd.m23;
+            (*it).rp[6] = gd.m33;
+          }
+          // outputing dust fluid info
+          if(PARTICLE_REAL_PROPERTIES > 7)
+          {
+            DustFluidData dd = {0};
+            set_gd_values_for_dust_fluid(patch, (*it).x_a, &gd, &dd, dustFluidSim, dx, shift);
+                        double v1 = dd.S1 / dd.E, v2 = dd.S2 / dd.E, v3 = dd.S3 / dd.E;
+              double W = dd.E / dd.D;
+              double vi1 = gd.mi11 * v1 + gd.mi12 * v2 + gd.mi13 * v3;
+              double vi2 = gd.mi12 * v1 + gd.mi22 * v2 + gd.mi23 * v3;
+              double vi3 = gd.mi13 * v1 + gd.mi23 * v2 + gd.mi33 * v3;
             
 
-            // u^0
-            (*it).rp[7] = W / gd.alpha;
-            // u^i
-            (*it).rp[8] = (vi1 - gd.beta1 / gd.alpha) * W;
-            (*it).rp[9] = (vi2 - gd.beta2 / gd.alpha) * W;
-            (*it).rp[10] =(vi3 - gd.beta3 / gd.alpha) * W;
-            // u_i
-            (*it).rp[11] = v1 * W;
-            (*it).rp[12] = v2 * W;
-            (*it).rp[13] = v3 * W;
-
-            // storing p_0
-            (*it).rp[14] = -gd.p0 * pw2(gd.alpha) + gd.beta1 * gd.q1 + gd.beta2 * gd.q2 + gd.beta3 * gd.q3;
-        }
-        if(PARTICLE_REAL_PROPERTIES > 15)
-        {
-          (*it).rp[15] = gd.K;
-        }
+              // u^0
+              (*it).rp[7] = W / gd.alpha;
+              // u^i
+              (*it).rp[8] = (vi1 - gd.beta1 / gd.alpha) * W;
+              (*it).rp[9] = (vi2 - gd.beta2 / gd.alpha) * W;
+              (*it).rp[10] =(vi3 - gd.beta3 / gd.alpha) * W;
+              // u_i
+              (*it).rp[11] = v1 * W;
+              (*it).rp[12] = v2 * W;
+              (*it).rp[13] = v3 * W;
 
+              // storing p_0
+              (*it).rp[14] = -gd.p0 * pw2(gd.alpha) + gd.beta1 * gd.q1 + gd.beta2 * gd.q2 + gd.beta3 * gd.q3;
+          }
+          if(PARTICLE_REAL_PROPERTIES > 15)
+          {
+            (*it).rp[15] = gd.K;
+          }
+
+        }
       }
-    }
     
+    }
+
+    if(batch.n > 0)
+      RKEvolveBatch(&batch, dt, true);
   }
 
 }
@@ -784,80 +832,113 @@ void Geodesic::RKEvolvePatch(
   std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> it_vec;
   for(;iter != iterend; iter++) it_vec.push_back(iter);
 
-#pragma omp parallel for
-  for(int ii = 0; ii < it_vec.size(); ii++)
+  // the _a fields are fixed during this call, so the coefficients of a
+  // cell can be shared by all particles in it
+  MetricCoefCache coef_cache;
+  MetricCoefCache * coef_cache_p = cache_metric_coefs ? &coef_cache : NULL;
+
+  RayGeometry ray_geometry;
+  RayGeometry * ray_geometry_p = NULL;
+  if(precompute_ray_geometry)
   {
-    //    hier::Index idx(*ic);
-    ParticleContainer & id = *it_vec[ii];
+    fillRayGeometry(patch, bssn, dx, it_vec, effective_ghost_box,
+                    ghost_box_phys_lower, ghost_box_phys_upper, &ray_geometry);
+    ray_geometry_p = &ray_geometry;
+  }
 
+#pragma omp parallel
+  {
+    RKBatch batch;
 
-    for(std::list<RKParticle>::iterator it=id.p_list.begin();
-        it != id.p_list.end(); it++)
+#pragma omp for
+    for(int ii = 0; ii < it_vec.size(); ii++)
     {
-      GeodesicData gd = {0};
-      double shift[3] = {0};
+      //    hier::Index idx(*ic);
+      ParticleContainer & id = *it_vec[ii];
+
+
+      for(ParticleContainer::iterator it=id.begin();
+          it != id.end(); it++)
+      {
+        GeodesicData gd = {0};
+        double shift[3] = {0};
     
       
-      for(int i = 0 ; i < 3; i ++)
-      {
-        if(ghost_box_phys_lower[i] > ((*it).x_a[i])) 
-          shift[i] = ceil( (double)(ghost_box_phys_lower[i] - (*it).x_a[i]) / round(L[i]));
-        if(ghost_box_phys_upper[i] < ((*it).x_a[i])) 
-          shift[i] = -ceil( (double)(-ghost_box_phys_upper[i] + (*it).x_a[i]) / round(L[i]));
+        for(int i = 0 ; i < 3; i ++)
+        {
+          if(ghost_box_phys_lower[i] > ((*it).x_a[i])) 
+            shift[i] = ceil( (double)(ghost_box_phys_lower[i] - (*it).x_a[i]) / round(L[i]));
+          if(ghost_box_phys_upper[i] < ((*it).x_a[i])) 
+            shift[i] = -ceil( (double)(-ghost_box_phys_upper[i] + (*it).x_a[i]) / round(L[i]));
 
-      }
-      int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] );
-      int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] );
-      int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] );
+        }
+        int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] );
+        int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] );
+        int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] );
 
-      // if particle is outside the ghost box anytime
-      // during the RK advance, do not advance it
-      hier::Index temp_idx(i0, j0, k0);
+        // if particle is outside the ghost box anytime
+        // during the RK advance, do not advance it
+        hier::Index temp_idx(i0, j0, k0);
       
-      if(!effective_ghost_box.contains(temp_idx))
-      {
-        for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
-          (*it).x_c[i] = 0;
-        continue;
-      }
+        if(!effective_ghost_box.contains(temp_idx))
+        {
+          for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+            (*it).x_c[i] = 0;
+          continue;
+        }
       
-      for(int i = 0; i < 8; i++)
-        for(int j = 0; j < 8; j++)
-          for(int k = 0; k < 8; k++)
-          {
-            int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] -0.5);
-            int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] -0.5);
-            int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] -0.5);
+        for(int i = 0; i < 8; i++)
+          for(int j = 0; j < 8; j++)
+            for(int k = 0; k < 8; k++)
+            {
+              int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] -0.5);
+              int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] -0.5);
+              int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] -0.5);
 
-            hier::Index temp_idx(i0-3+i, j0-3+j, k0-3+k);
+              hier::Index temp_idx(i0-3+i, j0-3+j, k0-3+k);
             
-            if(!fields_ghost_box.contains(temp_idx))
-              TBOX_ERROR("Particle at "<<hier::Index(i0, j0, k0)
-                         <<"is not contained in the ghostbox "<<fields_ghost_box<<"\n");
-          }
-      set_gd_values(patch, (*it).x_a, &gd, bssn, dx, shift);
-      RKEvolveParticle((*it), gd, dt);
-      if(PARTICLE_REAL_PROPERTIES > 0)
-      {
-        (*it).rp[0] = gd.p0;
-        if(save_metric && PARTICLE_REAL_PROPERTIES > 6)
+              if(!fields_ghost_box.contains(temp_idx))
+                TBOX_ERROR("Particle at "<<hier::Index(i0, j0, k0)
+                           <<"is not contained in the ghostbox "<<fields_ghost_box<<"\n");
+            }
+        if(batched_rk)
+        {
+          DustFluidData dd = {0};
+          interpolate_gd_values(patch, (*it).x_a, &gd, bssn, dx, shift,
+                                coef_cache_p, ray_geometry_p);
+          batch.add(&id, it.index(), gd, dd);
+          if(batch.full())
+            RKEvolveBatch(&batch, dt, false);
+          continue;
+        }
+        set_gd_values(patch, (*it).x_a, &gd, bssn, dx, shift,
+                      coef_cache_p, ray_geometry_p);
+        RKEvolveParticle((*it), gd, dt);
+        if(PARTICLE_REAL_PROPERTIES > 0)
         {
-          (*it).rp[1] = gd.m11;
-          (*it).rp[2] = gd.m12;
-          (*it).rp[3] = gd.m13;
-          (*it).rp[4] = gd.m22;
-          (*it).rp[5] = gd.m23;
-          (*it).rp[6] = gd.m33;
+          (*it).rp[0] = gd.p0;
+          if(save_metric && PARTICLE_REAL_PROPERTIES > 6)
+          {
+            (*it).rp[1] = gd.m11;
+            (*it).rp[2] = gd.m12;
+            (*it).rp[3] = gd.m13;
+            (*it).rp[4] = gd.m22;
+            (*it).rp[5] = gd.m23;
+            (*it).rp[6] = gd.m33;
+          }
         }
       }
-    }
     
+    }
+
+    if(batch.n > 0)
+      RKEvolveBatch(&batch, dt, false);
   }
 
 }
 
 void Geodesic::RKEvolveParticle(
-  RKParticle &p, GeodesicData &gd, double dt)
+  const ParticleRef & p, GeodesicData &gd, double dt)
 {
   p.x_c[0] = dt *
     (-gd.beta1 +
@@ -893,6 +974,192 @@ void Geodesic::RKEvolveParticle(
 #endif
 }
 
+#define GEODESIC_BATCH_LOAD(field) gd.field[n] = gd_in.field
+
+void Geodesic::RKBatch::add(
+  ParticleContainer * pc, int p,
+  const GeodesicData &gd_in, const DustFluidData &dd_in)
+{
+  pcs[n] = pc;
+  ps[n] = p;
+
+  GEODESIC_APPLY_TO_BATCH_FIELDS(GEODESIC_BATCH_LOAD);
+
+  D[n] = dd_in.D;
+  E[n] = dd_in.E;
+  S1[n] = dd_in.S1;
+  S2[n] = dd_in.S2;
+  S3[n] = dd_in.S3;
+
+  n++;
+}
+
+#undef GEODESIC_BATCH_LOAD
+
+#define GEODESIC_BATCH_CAL_DM(K,I,J)                                    \
+  b.d##K##m##I##J[l] = -2.0 * b.d##K##chi[l] * b.m##I##J[l] / pw3(b.chi[l]) \
+    + b.d##K##m##I##J[l] / pw2(b.chi[l])
+
+#define GEODESIC_BATCH_DP(K)                                            \
+  x_c[2+K][l] = dt * (                                                  \
+    -b.p0[l] * b.alpha[l] * b.d##K##alpha[l]                            \
+    + (b.q1[l] * b.d##K##beta1[l] + b.q2[l] * b.d##K##beta2[l]          \
+       + b.q3[l] * b.d##K##beta3[l])                                    \
+    + (b.qi1[l] * b.qi1[l] * b.d##K##m11[l]                             \
+       + b.qi2[l] * b.qi2[l] * b.d##K##m22[l]                           \
+       + b.qi3[l] * b.qi3[l] * b.d##K##m33[l]                           \
+       + 2.0*b.qi1[l] * b.qi2[l] * b.d##K##m12[l]                       \
+       + 2.0*b.qi1[l] * b.qi3[l] * b.d##K##m13[l]                       \
+       + 2.0*b.qi2[l] * b.qi3[l] * b.d##K##m23[l])/2.0/b.p0[l])
+
+/**
+ * @brief advance the particles of a batch, the physical metric, its
+ *        inverse, p0, the right hand side and the dust fluid frame are
+ *        evaluated across lanes (same expressions as set_gd_values and
+ *        RKEvolveParticle), then scattered back and the batch is emptied
+ *
+ * @param batch
+ * @param dt
+ * @param with_dust_fluid also store the dust fluid four-velocity, p_0 and K
+ */
+void Geodesic::RKEvolveBatch(
+  RKBatch *batch, double dt, bool with_dust_fluid)
+{
+  GeodesicBatch & b = batch->gd;
+  const int n = batch->n;
+
+  double x_c[PARTICLE_NUMBER_OF_STATES][GEODESIC_BATCH_WIDTH];
+  double u0[GEODESIC_BATCH_WIDTH], u1[GEODESIC_BATCH_WIDTH],
+    u2[GEODESIC_BATCH_WIDTH], u3[GEODESIC_BATCH_WIDTH];
+  double v1W[GEODESIC_BATCH_WIDTH], v2W[GEODESIC_BATCH_WIDTH],
+    v3W[GEODESIC_BATCH_WIDTH], p_0[GEODESIC_BATCH_WIDTH];
+
+#pragma omp simd
+  for(int l = 0; l < n; l++)
+  {
+    // calculating derivative to the 3-metric, not conformal one
+    COSMO_APPLY_TO_IJK_PERMS(GEODESIC_BATCH_CAL_DM);
+
+    b.m11[l] = b.m11[l] / pw2(b.chi[l]);
+    b.m12[l] = b.m12[l] / pw2(b.chi[l]);
+    b.m13[l] = b.m13[l] / pw2(b.chi[l]);
+    b.m22[l] = b.m22[l] / pw2(b.chi[l]);
+    b.m23[l] = b.m23[l] / pw2(b.chi[l]);
+    b.m33[l] = b.m33[l] / pw2(b.chi[l]);
+
+    real_t det = b.m11[l] * b.m22[l] * b.m33[l] + b.m12[l] * b.m23[l] * b.m13[l]
+      + b.m12[l] * b.m23[l] * b.m13[l] - b.m13[l] * b.m22[l] * b.m13[l]
+      - b.m12[l] * b.m12[l] * b.m33[l] - b.m23[l] * b.m23[l] * b.m11[l];
+
+    b.mi11[l] = (b.m22[l] * b.m33[l] - pw2(b.m23[l])) / det;
+    b.mi22[l] = (b.m11[l] * b.m33[l] - pw2(b.m13[l])) / det;
+    b.mi33[l] = (b.m11[l] * b.m22[l] - pw2(b.m12[l])) / det;
+    b.mi12[l] = (b.m13[l]*b.m23[l] - b.m12[l]*(b.m33[l])) / det;
+    b.mi13[l] = (b.m12[l]*b.m23[l] - b.m13[l]*(b.m22[l])) / det;
+    b.mi23[l] = (b.m12[l]*b.m13[l] - b.m23[l]*(b.m11[l])) / det;
+
+    b.qi1[l] = b.q1[l] * b.mi11[l] + b.q2[l] * b.mi12[l] + b.q3[l] * b.mi13[l];
+    b.qi2[l] = b.q1[l] * b.mi12[l] + b.q2[l] * b.mi22[l] + b.q3[l] * b.mi23[l];
+    b.qi3[l] = b.q1[l] * b.mi13[l] + b.q2[l] * b.mi23[l] + b.q3[l] * b.mi33[l];
+
+    b.p0[l] = sqrt(
+      + b.q1[l] * b.q1[l] * b.mi11[l] + 2.0*b.q1[l] * b.q2[l] * b.mi12[l]
+      + b.q2[l] * b.q2[l] * b.mi22[l] + 2.0*b.q1[l] * b.q3[l] * b.mi13[l]
+      + b.q3[l] * b.q3[l] * b.mi33[l] + 2.0*b.q2[l] * b.q3[l] * b.mi23[l])
+      / b.alpha[l];
+  }
+
+#pragma omp simd
+  for(int l = 0; l < n; l++)
+  {
+    x_c[0][l] = dt *
+      (-b.beta1[l] +
+       (b.mi11[l] * b.q1[l] + b.mi12[l] * b.q2[l] + b.mi13[l] * b.q3[l]) / b.p0[l]);
+    x_c[1][l] = dt *
+      (-b.beta2[l] +
+       (b.mi12[l] * b.q1[l] + b.mi22[l] * b.q2[l] + b.mi23[l] * b.q3[l]) / b.p0[l]);
+    x_c[2][l] = dt *
+      (-b.beta3[l] +
+       (b.mi13[l] * b.q1[l] + b.mi23[l] * b.q2[l] + b.mi33[l] * b.q3[l]) / b.p0[l]);
+
+    GEODESIC_BATCH_DP(1);
+    GEODESIC_BATCH_DP(2);
+    GEODESIC_BATCH_DP(3);
+
+#if EVOLVE_LAMBDA
+    x_c[6][l] = dt / b.p0[l];
+#endif
+  }
+
+  if(with_dust_fluid)
+  {
+#pragma omp simd
+    for(int l = 0; l < n; l++)
+    {
+      double v1 = batch->S1[l] / batch->E[l], v2 = batch->S2[l] / batch->E[l],
+        v3 = batch->S3[l] / batch->E[l];
+      double W = batch->E[l] / batch->D[l];
+      double vi1 = b.mi11[l] * v1 + b.mi12[l] * v2 + b.mi13[l] * v3;
+      double vi2 = b.mi12[l] * v1 + b.mi22[l] * v2 + b.mi23[l] * v3;
+      double vi3 = b.mi13[l] * v1 + b.mi23[l] * v2 + b.mi33[l] * v3;
+
+      // u^0
+      u0[l] = W / b.alpha[l];
+      // u^i
+      u1[l] = (vi1 - b.beta1[l] / b.alpha[l]) * W;
+      u2[l] = (vi2 - b.beta2[l] / b.alpha[l]) * W;
+      u3[l] = (vi3 - b.beta3[l] / b.alpha[l]) * W;
+      // u_i
+      v1W[l] = v1 * W;
+      v2W[l] = v2 * W;
+      v3W[l] = v3 * W;
+
+      p_0[l] = -b.p0[l] * pw2(b.alpha[l]) + b.beta1[l] * b.q1[l]
+        + b.beta2[l] * b.q2[l] + b.beta3[l] * b.q3[l];
+    }
+  }
+
+  for(int l = 0; l < n; l++)
+  {
+    ParticleRef p = (*batch->pcs[l])[batch->ps[l]];
+
+    for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+      p.x_c[i] = x_c[i][l];
+
+    if(PARTICLE_REAL_PROPERTIES > 0)
+    {
+      p.rp[0] = b.p0[l];
+      if(save_metric && PARTICLE_REAL_PROPERTIES > 6)
+      {
+        p.rp[1] = b.m11[l];
+        p.rp[2] = b.m12[l];
+        p.rp[3] = b.m13[l];
+        p.rp[4] = b.m22[l];
+        p.rp[5] = b.m23[l];
+        p.rp[6] = b.m33[l];
+      }
+      if(with_dust_fluid && PARTICLE_REAL_PROPERTIES > 7)
+      {
+        p.rp[7] = u0[l];
+        p.rp[8] = u1[l];
+        p.rp[9] = u2[l];
+        p.rp[10] = u3[l];
+        p.rp[11] = v1W[l];
+        p.rp[12] = v2W[l];
+        p.rp[13] = v3W[l];
+        p.rp[14] = p_0[l];
+      }
+      if(with_dust_fluid && PARTICLE_REAL_PROPERTIES > 15)
+        p.rp[15] = b.K[l];
+    }
+  }
+
+  batch->n = 0;
+}
+
+#undef GEODESIC_BATCH_CAL_DM
+#undef GEODESIC_BATCH_DP
+
 void Geodesic::registerRKRefiner(
   xfer::RefineAlgorithm& refiner,
   std::shared_ptr<hier::RefineOperator> &particle_refine_op)
@@ -906,7 +1173,7 @@ void Geodesic::registerRKRefiner(
 
 void Geodesic::set_gd_values_for_dust_fluid(
   const std::shared_ptr<hier::Patch> & patch, 
-  double p_info[], GeodesicData *gd, DustFluidData *dd, DustFluid *dustFluid, const real_t dx[], double shift[])
+  const ParticleField<double> & p_info, GeodesicData *gd, DustFluidData *dd, DustFluid *dustFluid, const real_t dx[], double shift[])
 {
   
   int i0 = floor((gd->x - domain_lower[0] ) / dx[0] - 0.5);
@@ -953,66 +1220,268 @@ void Geodesic::set_gd_values_for_dust_fluid(
   dd->S3 = evaluate_interpolation(a_S3, xd, yd, zd);
 }
 
-// set values needed by evolution equation for null geodesic
-// since the corresponding particle has been living in certain
-// patch, do not need global interpolation any more
-void Geodesic::set_gd_values(
-  const std::shared_ptr<hier::Patch> & patch, 
-  double p_info[], GeodesicData *gd, BSSN *bssn, const real_t dx[], double shift[])
+void Geodesic::RayGeometry::attach(
+  const std::shared_ptr<pdat::CellData<double> > & pdata)
 {
-  gd->x = p_info[0], gd->y = p_info[1], gd->z = p_info[2];
-  gd->q1 = p_info[3], gd->q2 = p_info[4], gd->q3 = p_info[5];
-#if EVOLVE_LAMBDA
-  gd->lambda = p_info[6];
-#endif
-  gd->x += (double)shift[0] * L[0];
-  gd->y += (double)shift[1] * L[1];
-  gd->z += (double)shift[2] * L[2];
-  
-  int i0 = floor((gd->x - domain_lower[0] ) / dx[0] - 0.5);
-  int j0 = floor((gd->y - domain_lower[1] ) / dx[1] - 0.5);
-  int k0 = floor((gd->z - domain_lower[2] ) / dx[2] - 0.5);
+  const hier::Box & ghost_box = pdata->getGhostBox();
 
-  
-  
-  real_t x0 = domain_lower[0] + (double)i0 * dx[0] + dx[0]/2.0;
-  real_t y0 = domain_lower[1] + (double)j0 * dx[1] + dx[1]/2.0;
-  real_t z0 = domain_lower[2] + (double)k0 * dx[2] + dx[2]/2.0;
+  for(int c = 0; c < GEODESIC_RAY_GEOMETRY_DEPTH; c++)
+    v[c] = pdata->getPointer(c);
 
-  double xd = (gd->x - x0) / dx[0];
-  double yd = (gd->y - y0) / dx[1];
-  double zd = (gd->z - z0) / dx[2];
+  for(int d = 0; d < 3; d++)
+  {
+    lower[d] = ghost_box.lower()[d];
+    n[d] = ghost_box.upper()[d] - ghost_box.lower()[d] + 1;
+  }
+}
 
-  GEODESIC_DEFINE_CRSPLINES_CHI;
-  GEODESIC_DEFINE_CRSPLINES_DCHI(1);
-  GEODESIC_DEFINE_CRSPLINES_DCHI(2);
-  GEODESIC_DEFINE_CRSPLINES_DCHI(3);
+bool Geodesic::RayGeometry::contains(int i, int j, int k) const
+{
+  return i >= lower[0] && i < lower[0] + n[0]
+    && j >= lower[1] && j < lower[1] + n[1]
+    && k >= lower[2] && k < lower[2] + n[2];
+}
 
-  GEODESIC_DEFINE_CRSPLINES_BETA(1);
-  GEODESIC_DEFINE_CRSPLINES_BETA(2);
-  GEODESIC_DEFINE_CRSPLINES_BETA(3);
+idx_t Geodesic::RayGeometry::offset(int i, int j, int k) const
+{
+  return (i - lower[0]) + (idx_t)n[0] * ((j - lower[1])
+                                         + (idx_t)n[1] * (k - lower[2]));
+}
 
-  GEODESIC_DEFINE_CRSPLINES_DBETA(1,1);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(1,2);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(1,3);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(2,1);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(2,2);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(2,3);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(3,1);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(3,2);
-  GEODESIC_DEFINE_CRSPLINES_DBETA(3,3);
+#define GEODESIC_RAY_GEOMETRY_STORE(field) v[c++][idx] = bd.field
+#define GEODESIC_RAY_GEOMETRY_STORE_M(I,J)      \
+  GEODESIC_RAY_GEOMETRY_STORE(gamma##I##J)
+#define GEODESIC_RAY_GEOMETRY_STORE_DM(K,I,J)   \
+  GEODESIC_RAY_GEOMETRY_STORE(d##K##g##I##J)
+
+#define GEODESIC_RAY_GEOMETRY_LOAD(field) bd->field = v[c++][idx]
+#define GEODESIC_RAY_GEOMETRY_LOAD_M(I,J)       \
+  GEODESIC_RAY_GEOMETRY_LOAD(gamma##I##J)
+#define GEODESIC_RAY_GEOMETRY_LOAD_DM(K,I,J)    \
+  GEODESIC_RAY_GEOMETRY_LOAD(d##K##g##I##J)
+
+/**
+ * @brief store the quantities the interpolation reads from a BSSNData
+ *        filled by set_bd_values_for_ray_tracing, load restores them in
+ *        the same order
+ */
+void Geodesic::RayGeometry::store(int i, int j, int k, const BSSNData &bd)
+{
+  const idx_t idx = offset(i, j, k);
+  int c = 0;
+
+  GEODESIC_RAY_GEOMETRY_STORE(chi);
+  GEODESIC_RAY_GEOMETRY_STORE(d1chi);
+  GEODESIC_RAY_GEOMETRY_STORE(d2chi);
+  GEODESIC_RAY_GEOMETRY_STORE(d3chi);
+
+  GEODESIC_RAY_GEOMETRY_STORE(beta1);
+  GEODESIC_RAY_GEOMETRY_STORE(beta2);
+  GEODESIC_RAY_GEOMETRY_STORE(beta3);
+
+  GEODESIC_RAY_GEOMETRY_STORE(d1beta1);
+  GEODESIC_RAY_GEOMETRY_STORE(d1beta2);
+  GEODESIC_RAY_GEOMETRY_STORE(d1beta3);
+  GEODESIC_RAY_GEOMETRY_STORE(d2beta1);
+  GEODESIC_RAY_GEOMETRY_STORE(d2beta2);
+  GEODESIC_RAY_GEOMETRY_STORE(d2beta3);
+  GEODESIC_RAY_GEOMETRY_STORE(d3beta1);
+  GEODESIC_RAY_GEOMETRY_STORE(d3beta2);
+  GEODESIC_RAY_GEOMETRY_STORE(d3beta3);
+
+  GEODESIC_RAY_GEOMETRY_STORE(DIFFalpha);
+  GEODESIC_RAY_GEOMETRY_STORE(d1a);
+  GEODESIC_RAY_GEOMETRY_STORE(d2a);
+  GEODESIC_RAY_GEOMETRY_STORE(d3a);
+
+  COSMO_APPLY_TO_IJ_PERMS(GEODESIC_RAY_GEOMETRY_STORE_M);
+  COSMO_APPLY_TO_IJK_PERMS(GEODESIC_RAY_GEOMETRY_STORE_DM);
+
+  GEODESIC_RAY_GEOMETRY_STORE(K);
+}
 
-  GEODESIC_DEFINE_CRSPLINES_ALPHA;
+void Geodesic::RayGeometry::load(int i, int j, int k, BSSNData *bd) const
+{
+  const idx_t idx = offset(i, j, k);
+  int c = 0;
+
+  GEODESIC_RAY_GEOMETRY_LOAD(chi);
+  GEODESIC_RAY_GEOMETRY_LOAD(d1chi);
+  GEODESIC_RAY_GEOMETRY_LOAD(d2chi);
+  GEODESIC_RAY_GEOMETRY_LOAD(d3chi);
+
+  GEODESIC_RAY_GEOMETRY_LOAD(beta1);
+  GEODESIC_RAY_GEOMETRY_LOAD(beta2);
+  GEODESIC_RAY_GEOMETRY_LOAD(beta3);
+
+  GEODESIC_RAY_GEOMETRY_LOAD(d1beta1);
+  GEODESIC_RAY_GEOMETRY_LOAD(d1beta2);
+  GEODESIC_RAY_GEOMETRY_LOAD(d1beta3);
+  GEODESIC_RAY_GEOMETRY_LOAD(d2beta1);
+  GEODESIC_RAY_GEOMETRY_LOAD(d2beta2);
+  GEODESIC_RAY_GEOMETRY_LOAD(d2beta3);
+  GEODESIC_RAY_GEOMETRY_LOAD(d3beta1);
+  GEODESIC_RAY_GEOMETRY_LOAD(d3beta2);
+  GEODESIC_RAY_GEOMETRY_LOAD(d3beta3);
+
+  GEODESIC_RAY_GEOMETRY_LOAD(DIFFalpha);
+  GEODESIC_RAY_GEOMETRY_LOAD(d1a);
+  GEODESIC_RAY_GEOMETRY_LOAD(d2a);
+  GEODESIC_RAY_GEOMETRY_LOAD(d3a);
+
+  COSMO_APPLY_TO_IJ_PERMS(GEODESIC_RAY_GEOMETRY_LOAD_M);
+  COSMO_APPLY_TO_IJK_PERMS(GEODESIC_RAY_GEOMETRY_LOAD_DM);
+
+  GEODESIC_RAY_GEOMETRY_LOAD(K);
+}
 
-  GEODESIC_DEFINE_CRSPLINES_DALPHA(1);
-  GEODESIC_DEFINE_CRSPLINES_DALPHA(2);
-  GEODESIC_DEFINE_CRSPLINES_DALPHA(3);
+#undef GEODESIC_RAY_GEOMETRY_STORE
+#undef GEODESIC_RAY_GEOMETRY_STORE_M
+#undef GEODESIC_RAY_GEOMETRY_STORE_DM
+#undef GEODESIC_RAY_GEOMETRY_LOAD
+#undef GEODESIC_RAY_GEOMETRY_LOAD_M
+#undef GEODESIC_RAY_GEOMETRY_LOAD_DM
+
+/**
+ * @brief compute the derived metric quantities once on every cell that is
+ *        part of the interpolation stencil of a particle advanced in this
+ *        RK stage, so interpolation only reads them
+ *
+ * @param patch
+ * @param bssn
+ * @param dx
+ * @param it_vec particle containers of the patch
+ * @param effective_ghost_box particles outside it are not advanced
+ * @param ghost_box_phys_lower
+ * @param ghost_box_phys_upper
+ * @param ray_geometry attached to the filled patch data
+ */
+void Geodesic::fillRayGeometry(
+  const std::shared_ptr<hier::Patch> & patch, BSSN *bssn, const real_t dx[],
+  const std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> & it_vec,
+  const hier::Box & effective_ghost_box,
+  const double ghost_box_phys_lower[], const double ghost_box_phys_upper[],
+  RayGeometry *ray_geometry)
+{
+  std::shared_ptr<pdat::CellData<double> > ray_geometry_pdata(
+    SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+      patch->getPatchData(ray_geometry_idx)));
 
-  COSMO_APPLY_TO_IJ_PERMS(GEODESIC_DEFINE_CRSPLINES_M);
-  COSMO_APPLY_TO_IJK_PERMS(GEODESIC_DEFINE_CRSPLINES_DM);
+  ray_geometry->attach(ray_geometry_pdata);
+
+  const hier::Box & rg_box = ray_geometry_pdata->getGhostBox();
+  int rg_lower[3], n[3];
+  for(int d = 0; d < 3; d++)
+  {
+    rg_lower[d] = rg_box.lower()[d];
+    n[d] = rg_box.upper()[d] - rg_box.lower()[d] + 1;
+  }
+
+  // derivatives need two more cells of the fields on each side
+  hier::Box fields_box = bssn->DIFFchi_a_pdata->getGhostBox();
+  fields_box.grow(hier::IntVector(dim, -2));
+
+  std::vector<char> needed((idx_t)n[0] * n[1] * n[2], 0);
+
+  for(int ii = 0; ii < it_vec.size(); ii++)
+  {
+    ParticleContainer & id = *it_vec[ii];
+
+    for(ParticleContainer::iterator it=id.begin();
+        it != id.end(); it++)
+    {
+      double shift[3] = {0};
+
+      for(int i = 0 ; i < 3; i ++)
+      {
+        if(ghost_box_phys_lower[i] > ((*it).x_a[i])) 
+          shift[i] = ceil( (double)(ghost_box_phys_lower[i] - (*it).x_a[i]) / round(L[i]));
+        if(ghost_box_phys_upper[i] < ((*it).x_a[i])) 
+          shift[i] = -ceil( (double)(-ghost_box_phys_upper[i] + (*it).x_a[i]) / round(L[i]));
+      }
+
+      hier::Index cell_idx(
+        floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] ),
+        floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] ),
+        floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] ));
+
+      if(!effective_ghost_box.contains(cell_idx))
+        continue;
+
+      int i0 = floor(((*it).x_a[0] + shift[0] * L[0] - domain_lower[0] ) / dx[0] -0.5);
+      int j0 = floor(((*it).x_a[1] + shift[1] * L[1] - domain_lower[1] ) / dx[1] -0.5);
+      int k0 = floor(((*it).x_a[2] + shift[2] * L[2] - domain_lower[2] ) / dx[2] -0.5);
+
+      for(int i = i0 - 1; i <= i0 + 2; i++)
+        for(int j = j0 - 1; j <= j0 + 2; j++)
+          for(int k = k0 - 1; k <= k0 + 2; k++)
+          {
+            if(!ray_geometry->contains(i, j, k)
+               || !fields_box.contains(hier::Index(i, j, k)))
+              continue;
+            needed[(i - rg_lower[0]) + (idx_t)n[0] * ((j - rg_lower[1])
+                                          + (idx_t)n[1] * (k - rg_lower[2]))] = 1;
+          }
+    }
+  }
+
+#pragma omp parallel for collapse(2) schedule(dynamic)
+  for(int k = 0; k < n[2]; k++)
+    for(int j = 0; j < n[1]; j++)
+    {
+      BSSNData bd = {0};
+      for(int i = 0; i < n[0]; i++)
+      {
+        if(!needed[i + (idx_t)n[0] * (j + (idx_t)n[1] * k)])
+          continue;
+#if USE_COSMOTRACE
+        bssn->set_bd_values_for_ray_tracing(
+          rg_lower[0] + i, rg_lower[1] + j, rg_lower[2] + k, &bd, dx, false);
+#endif
+        ray_geometry->store(
+          rg_lower[0] + i, rg_lower[1] + j, rg_lower[2] + k, bd);
+      }
+    }
+}
+
+/**
+ * @brief compute the coefficients on the stencil starting one cell below
+ *        (i0, j0, k0) from the _a fields
+ */
+void Geodesic::MetricCoefs::compute(
+  BSSN *bssn, const RayGeometry *ray_geometry,
+  int i0, int j0, int k0, const real_t dx[])
+{
+  GEODESIC_DEFINE_VALUES_CHI;
+  GEODESIC_DEFINE_VALUES_DCHI(1);
+  GEODESIC_DEFINE_VALUES_DCHI(2);
+  GEODESIC_DEFINE_VALUES_DCHI(3);
+
+  GEODESIC_DEFINE_VALUES_BETA(1);
+  GEODESIC_DEFINE_VALUES_BETA(2);
+  GEODESIC_DEFINE_VALUES_BETA(3);
+
+  GEODESIC_DEFINE_VALUES_DBETA(1,1);
+  GEODESIC_DEFINE_VALUES_DBETA(1,2);
+  GEODESIC_DEFINE_VALUES_DBETA(1,3);
+  GEODESIC_DEFINE_VALUES_DBETA(2,1);
+  GEODESIC_DEFINE_VALUES_DBETA(2,2);
+  GEODESIC_DEFINE_VALUES_DBETA(2,3);
+  GEODESIC_DEFINE_VALUES_DBETA(3,1);
+  GEODESIC_DEFINE_VALUES_DBETA(3,2);
+  GEODESIC_DEFINE_VALUES_DBETA(3,3);
+
+  GEODESIC_DEFINE_VALUES_ALPHA;
+
+  GEODESIC_DEFINE_VALUES_DALPHA(1);
+  GEODESIC_DEFINE_VALUES_DALPHA(2);
+  GEODESIC_DEFINE_VALUES_DALPHA(3);
+
+  COSMO_APPLY_TO_IJ_PERMS(GEODESIC_DEFINE_VALUES_M);
+  COSMO_APPLY_TO_IJK_PERMS(GEODESIC_DEFINE_VALUES_DM);
 
 #if PARTICLE_REAL_PROPERTIES > 15
-    GEODESIC_DEFINE_CRSPLINES_K;
+    GEODESIC_DEFINE_VALUES_K;
 #endif
 
   BSSNData bd = {0};
@@ -1021,8 +1490,12 @@ void Geodesic::set_gd_values(
     for(int j = 0; j < 4; j++)
       for(int k = 0; k < 4; k++)
       {
+        if(ray_geometry != NULL
+           && ray_geometry->contains(i0-1+i, j0-1+j, k0-1+k))
+          ray_geometry->load(i0-1+i, j0-1+j, k0-1+k, &bd);
 #if USE_COSMOTRACE
-       bssn->set_bd_values_for_ray_tracing(i0-1+i, j0-1+j, k0-1+k, &bd, dx);
+        else
+          bssn->set_bd_values_for_ray_tracing(i0-1+i, j0-1+j, k0-1+k, &bd, dx);
 #endif
         GEODESIC_CRSPLINES_SET_F_CHI;
         GEODESIC_CRSPLINES_SET_F_DCHI(1);
@@ -1086,9 +1559,15 @@ void Geodesic::set_gd_values(
 #if PARTICLE_REAL_PROPERTIES > 15
   GEODESIC_CRSPLINES_CAL_COEF_K;
 #endif
+}
 
-  
-  
+/**
+ * @brief interpolate the metric quantities at relative position
+ *        (xd, yd, zd) inside the cell into gd
+ */
+void Geodesic::MetricCoefs::evaluate(
+  GeodesicData *gd, double xd, double yd, double zd) const
+{
   GEODESIC_CRSPLINES_EVAL_CHI;
   GEODESIC_CRSPLINES_EVAL_DCHI(1);
   GEODESIC_CRSPLINES_EVAL_DCHI(2);
@@ -1120,7 +1599,43 @@ void Geodesic::set_gd_values(
 #if PARTICLE_REAL_PROPERTIES > 15
   GEODESIC_CRSPLINES_EVAL_K;
 #endif
+}
+
+/**
+ * @brief coefficients for the stencil of cell (i0, j0, k0), computed by
+ *        the first thread asking for them
+ */
+const Geodesic::MetricCoefs & Geodesic::MetricCoefCache::get(
+  BSSN *bssn, const RayGeometry *ray_geometry,
+  int i0, int j0, int k0, const real_t dx[])
+{
+  entry_t * entry;
 
+#pragma omp critical(geodesic_metric_coef_cache)
+  {
+    std::unique_ptr<entry_t> & e = entries[std::make_tuple(i0, j0, k0)];
+    if(!e)
+      e.reset(new entry_t);
+    entry = e.get();
+  }
+
+  std::call_once(entry->built, [&](){
+      entry->coefs.compute(bssn, ray_geometry, i0, j0, k0, dx);
+    });
+
+  return entry->coefs;
+}
+
+// set values needed by evolution equation for null geodesic
+// since the corresponding particle has been living in certain
+// patch, do not need global interpolation any more
+void Geodesic::set_gd_values(
+  const std::shared_ptr<hier::Patch> & patch, 
+  const ParticleField<double> & p_info, GeodesicData *gd, BSSN *bssn, const real_t dx[], double shift[],
+  MetricCoefCache *coef_cache, const RayGeometry *ray_geometry)
+{
+  interpolate_gd_values(patch, p_info, gd, bssn, dx, shift,
+                        coef_cache, ray_geometry);
   
   // calculating derivative to the 3-metric, not conformal one
   COSMO_APPLY_TO_IJK_PERMS(GEODESIC_CRSPLINES_CAL_DM);
@@ -1154,6 +1669,49 @@ void Geodesic::set_gd_values(
 
 }
 
+/**
+ * @brief fill the position and momentum of a particle and the metric
+ *        quantities interpolated at it, the conversion to the physical
+ *        metric is left to the caller
+ */
+void Geodesic::interpolate_gd_values(
+  const std::shared_ptr<hier::Patch> & patch, 
+  const ParticleField<double> & p_info, GeodesicData *gd, BSSN *bssn, const real_t dx[], double shift[],
+  MetricCoefCache *coef_cache, const RayGeometry *ray_geometry)
+{
+  gd->x = p_info[0], gd->y = p_info[1], gd->z = p_info[2];
+  gd->q1 = p_info[3], gd->q2 = p_info[4], gd->q3 = p_info[5];
+#if EVOLVE_LAMBDA
+  gd->lambda = p_info[6];
+#endif
+  gd->x += (double)shift[0] * L[0];
+  gd->y += (double)shift[1] * L[1];
+  gd->z += (double)shift[2] * L[2];
+  
+  int i0 = floor((gd->x - domain_lower[0] ) / dx[0] - 0.5);
+  int j0 = floor((gd->y - domain_lower[1] ) / dx[1] - 0.5);
+  int k0 = floor((gd->z - domain_lower[2] ) / dx[2] - 0.5);
+
+  
+  
+  real_t x0 = domain_lower[0] + (double)i0 * dx[0] + dx[0]/2.0;
+  real_t y0 = domain_lower[1] + (double)j0 * dx[1] + dx[1]/2.0;
+  real_t z0 = domain_lower[2] + (double)k0 * dx[2] + dx[2]/2.0;
+
+  double xd = (gd->x - x0) / dx[0];
+  double yd = (gd->y - y0) / dx[1];
+  double zd = (gd->z - z0) / dx[2];
+
+  if(coef_cache != NULL)
+    coef_cache->get(bssn, ray_geometry, i0, j0, k0, dx).evaluate(gd, xd, yd, zd);
+  else
+  {
+    MetricCoefs coefs;
+    coefs.compute(bssn, ray_geometry, i0, j0, k0, dx);
+    coefs.evaluate(gd, xd, yd, zd);
+  }
+}
+
 void Geodesic::K1FinalizePatch(
   const std::shared_ptr<hier::Patch> & patch)
 {
@@ -1179,8 +1737,8 @@ void Geodesic::K1FinalizePatch(
   {
     ParticleContainer & id = *it_vec[ii];
 
-    for(std::list<RKParticle>::iterator it=id.p_list.begin();
-        it != id.p_list.end(); it++)
+    for(ParticleContainer::iterator it=id.begin();
+        it != id.end(); it++)
     {
       for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
       {
@@ -1225,8 +1783,8 @@ void Geodesic::K2FinalizePatch(
   {
     ParticleContainer & id = *it_vec[ii];
 
-    for(std::list<RKParticle>::iterator it=id.p_list.begin();
-        it != id.p_list.end(); it++)
+    for(ParticleContainer::iterator it=id.begin();
+        it != id.end(); it++)
     {
       for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
       {
@@ -1269,8 +1827,8 @@ void Geodesic::K3FinalizePatch(
   {
     ParticleContainer & id = *it_vec[ii];
 
-    for(std::list<RKParticle>::iterator it=id.p_list.begin();
-        it != id.p_list.end(); it++)
+    for(ParticleContainer::iterator it=id.begin();
+        it != id.end(); it++)
     {
       for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
       {
@@ -1316,8 +1874,8 @@ void Geodesic::K4FinalizePatch(
 
     ParticleContainer &id = *it_vec[ii];
 
-    for(std::list<RKParticle>::iterator it=id.p_list.begin();
-        it != id.p_list.end(); it++)
+    for(ParticleContainer::iterator it=id.begin();
+        it != id.end(); it++)
     {
       for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
       {
@@ -1452,7 +2010,7 @@ void Geodesic::regridPostProcessing(
              dst_p = pc_pdata->getItem(*i);
              delete p;
            }
-           dst_p->p_list.insert(dst_p->p_list.end(), src_p->p_list.begin(), src_p->p_list.end());
+           dst_p->append(*src_p);
 
          }
       }
@@ -1464,6 +2022,17 @@ void Geodesic::regridPostProcessing(
 
 }
 
+/**
+ * @brief drop the cached particle transfer schedules, has to be called
+ *        whenever the patch levels change
+ */
+void Geodesic::resetTransferSchedules()
+{
+  ghost_fill_schedules.clear();
+  upstream_schedules.clear();
+  downstream_schedules.clear();
+}
+
 // particle redistribution, see the notes for more detail
 void Geodesic::particleRedistribution(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
@@ -1472,7 +2041,6 @@ void Geodesic::particleRedistribution(
   //  if(step == 54) clearParticles(hierarchy, ln, pc_d_buffer_idx);
 
   cur_step = step;
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
   std::shared_ptr<hier::PatchLevel> level(
     hierarchy->getPatchLevel(ln));
   // put all particles to correct cell after advancing it
@@ -1501,23 +2069,19 @@ void Geodesic::particleRedistribution(
     // pdat::CellIterator icend(pdat::CellGeometry::end(ghost_box));
     // for (pdat::CellIterator ic(pdat::CellGeometry::begin(ghost_box));
     //      ic != icend; ++ic)
-    std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> it_vec;
-    for(;iter != iterend; iter++) it_vec.push_back(iter);
-
     // !!!!!!!!!!!!!!!!!!VERY IMPORTANT HERE!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     // Can I parallel this?
     // Answer might be NO!
-    //#pragma omp parallel for
-    for(int ii = 0; ii < it_vec.size(); ii++)
+    for(; iter != iterend; iter++)
     {
-      hier::Index old_idx(it_vec[ii].getIndex());
+      hier::Index old_idx(iter.getIndex());
 
-      ParticleContainer & id = *it_vec[ii];
+      ParticleContainer & id = *iter;
 
 
       // go through all particles
-      for(std::list<RKParticle>::iterator it=id.p_list.begin();
-          it != id.p_list.end();)
+      for(ParticleContainer::iterator it=id.begin();
+          it != id.end();)
       {
 
         double shift[3] = {0};
@@ -1580,7 +2144,7 @@ void Geodesic::particleRedistribution(
         }
                 
         // erase and advance
-        it = id.p_list.erase(it);
+        it = id.erase(it);
         
       }
 
@@ -1596,8 +2160,6 @@ void Geodesic::particleRedistribution(
     std::shared_ptr<hier::PatchLevel> level(
       hierarchy->getPatchLevel(ln));
 
-    xfer::RefineAlgorithm refiner;
-
     std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
       SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
         hierarchy->getGridGeometry()));
@@ -1606,35 +2168,42 @@ void Geodesic::particleRedistribution(
 
     geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
 
+    if(upstream_schedules.size() <= ln)
+    {
+      upstream_schedules.resize(ln + 1);
+      downstream_schedules.resize(ln + 1);
+    }
 
-    std::shared_ptr<hier::RefineOperator> refine_op
-      = grid_geometry.
-      lookupRefineOperator(pc, "PARTICLE_REFINE");
-
-   
-    refiner.registerRefine(pc_s_idx,
-                           pc_idx,                        
-                           pc_s_idx,                        
-                           refine_op);
-
-    std::shared_ptr<xfer::RefineSchedule> refine_schedule;
-
-    std::shared_ptr<hier::PatchLevel> finer_level(
-      hierarchy->getPatchLevel(ln + 1));
+    if(!upstream_schedules[ln])
+    {
+      xfer::RefineAlgorithm refiner;
 
-    // fill only real cells of finer level
-    refine_schedule =
-      refiner.createSchedule(
-        std::shared_ptr<xfer::PatchLevelFillPattern>(
-          new xfer::PatchLevelInteriorFillPattern()),
-        finer_level,
-        NULL,
-        ln,
-        hierarchy,
-        NULL);
+      std::shared_ptr<hier::RefineOperator> refine_op
+        = grid_geometry.
+        lookupRefineOperator(pc, "PARTICLE_REFINE");
 
+   
+      refiner.registerRefine(pc_s_idx,
+                             pc_idx,                        
+                             pc_s_idx,                        
+                             refine_op);
+
+      std::shared_ptr<hier::PatchLevel> finer_level(
+        hierarchy->getPatchLevel(ln + 1));
+
+      // fill only real cells of finer level
+      upstream_schedules[ln] =
+        refiner.createSchedule(
+          std::shared_ptr<xfer::PatchLevelFillPattern>(
+            new xfer::PatchLevelInteriorFillPattern()),
+          finer_level,
+          NULL,
+          ln,
+          hierarchy,
+          NULL);
+    }
 
-    refine_schedule->fillData(0.0);
+    upstream_schedules[ln]->fillData(0.0);
 
     /*********************************************/
   
@@ -1665,20 +2234,23 @@ void Geodesic::particleRedistribution(
 
     
     //coarsen the data from downstream buffer from the upper level
-    xfer::CoarsenAlgorithm coarsener(dim);
+    if(!downstream_schedules[ln])
+    {
+      xfer::CoarsenAlgorithm coarsener(dim);
 
-    std::shared_ptr<hier::CoarsenOperator> coarsen_op = grid_geometry.
-      lookupCoarsenOperator(pc, "PARTICLE_COARSEN");
+      std::shared_ptr<hier::CoarsenOperator> coarsen_op = grid_geometry.
+        lookupCoarsenOperator(pc, "PARTICLE_COARSEN");
 
-    coarsener.registerCoarsen(pc_s_idx,                  
-                              pc_d_buffer_idx,                   
-                              coarsen_op,
-                              hier::IntVector(dim, 1));
+      coarsener.registerCoarsen(pc_s_idx,                  
+                                pc_d_buffer_idx,                   
+                                coarsen_op,
+                                hier::IntVector(dim, 1));
 
-    std::shared_ptr<xfer::CoarsenSchedule> coarsen_schedules =
-      coarsener.createSchedule(level, hierarchy->getPatchLevel(ln+1));
+      downstream_schedules[ln] =
+        coarsener.createSchedule(level, hierarchy->getPatchLevel(ln+1));
+    }
 
-    coarsen_schedules->coarsenData();
+    downstream_schedules[ln]->coarsenData();
 
     insertLevelParticles(hierarchy, ln, pc_s_idx, pc_idx);
 
@@ -1691,8 +2263,6 @@ void Geodesic::particleRedistribution(
   // updating downstream buffer
   if(ln > 0 && do_update_buffer)
   {
-
-        int p_in_buffer_num = 0;
     std::shared_ptr<hier::PatchLevel> level(
       hierarchy->getPatchLevel(ln));
 
@@ -1707,99 +2277,44 @@ void Geodesic::particleRedistribution(
     {
       std::shared_ptr<hier::Patch> patch(*ip);
 
-
-      
       std::shared_ptr<hier::PatchGeometry> geom (patch->getPatchGeometry());
 
-
       initPData(patch);
 
-      // enumerating boudary boxes with different co-dimension as coarse-fine boundaries
-      
-      const std::vector<hier::BoundaryBox> & codim1_boxes =
-        cfb.getBoundaries(patch->getGlobalId(), 1, patch->getBox().getBlockId());
-
-      const int n_codim1_boxes = static_cast<int>(codim1_boxes.size());
-
-      for(int l = 0 ; l < n_codim1_boxes; l++)
+      // ghost regions along coarse-fine boundary boxes of all co-dimensions
+      std::vector<hier::Box> boundary_fill_boxes;
+      for(int codim = 1; codim <= 3; codim++)
       {
-        hier::Box boundary_fill_box =
-          geom->getBoundaryFillBox(
-            codim1_boxes[l], patch->getBox(), hier::IntVector(dim, ghost_width));
+        const std::vector<hier::BoundaryBox> & boundary_boxes =
+          cfb.getBoundaries(patch->getGlobalId(), codim, patch->getBox().getBlockId());
 
-        pdat::CellIterator icend(pdat::CellGeometry::end(boundary_fill_box));
-        for (pdat::CellIterator ic(pdat::CellGeometry::begin(boundary_fill_box));
-             ic != icend; ++ic)
-        {
-          ParticleContainer *pc = pc_pdata->getItem(*ic);
-          if(pc != NULL){
-            pc_d_buffer_pdata->replaceAddItem(*ic, *pc);
-
-          }
-        }
+        for(int l = 0 ; l < static_cast<int>(boundary_boxes.size()); l++)
+          boundary_fill_boxes.push_back(
+            geom->getBoundaryFillBox(
+              boundary_boxes[l], patch->getBox(), hier::IntVector(dim, ghost_width)));
       }
 
-      const std::vector<hier::BoundaryBox> & codim2_boxes =
-        cfb.getBoundaries(patch->getGlobalId(), 2, patch->getBox().getBlockId());
-
+      if(boundary_fill_boxes.empty())
+        continue;
 
-      const int n_codim2_boxes = static_cast<int>(codim2_boxes.size());
+      // only visit occupied cells instead of every boundary cell
+      pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator iter(*pc_pdata, true);
+      pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator iterend(*pc_pdata, false);
 
-      for(int l = 0 ; l < n_codim2_boxes; l++)
+      for(;iter != iterend; iter++)
       {
-        hier::Box boundary_fill_box =
-          geom->getBoundaryFillBox(
-            codim2_boxes[l], patch->getBox(), hier::IntVector(dim, ghost_width));
+        const hier::Index & idx = iter.getIndex();
 
-
-        pdat::CellIterator icend(pdat::CellGeometry::end(boundary_fill_box));
-        for (pdat::CellIterator ic(pdat::CellGeometry::begin(boundary_fill_box));
-             ic != icend; ++ic)
+        for(int l = 0; l < static_cast<int>(boundary_fill_boxes.size()); l++)
         {
-          ParticleContainer *pc = pc_pdata->getItem(*ic);
-          if(pc != NULL)
+          if(boundary_fill_boxes[l].contains(idx))
           {
-
-            pc_d_buffer_pdata->replaceAddItem(*ic, *pc);
+            pc_d_buffer_pdata->replaceAddItem(idx, *iter);
+            break;
           }
         }
-        
-        
       }
-
-      const std::vector<hier::BoundaryBox> & codim3_boxes =
-        cfb.getBoundaries(patch->getGlobalId(), 3, patch->getBox().getBlockId());
-
-
-      const int n_codim3_boxes = static_cast<int>(codim3_boxes.size());
-
-      for(int l = 0 ; l < n_codim3_boxes; l++)
-      {
-        hier::Box boundary_fill_box =
-          geom->getBoundaryFillBox(
-            codim3_boxes[l], patch->getBox(), hier::IntVector(dim, ghost_width));
-
-        pdat::CellIterator icend(pdat::CellGeometry::end(boundary_fill_box));
-        for (pdat::CellIterator ic(pdat::CellGeometry::begin(boundary_fill_box));
-             ic != icend; ++ic)
-        {
-          ParticleContainer *pc = pc_pdata->getItem(*ic);
-
-          if(pc != NULL){
-            pc_d_buffer_pdata->replaceAddItem(*ic, *pc);
-          }
-        }
-
-                
-      }
-      p_in_buffer_num += pc_d_buffer_pdata->getNumberOfItems();
-
     }
-
-    if(mpi.getSize() > 1)
-      mpi.AllReduce(&p_in_buffer_num, 1, MPI_SUM);
-
-
   }
 
 }
@@ -1848,10 +2363,10 @@ void Geodesic::printAll(
       for(; iter != iterend; iter++){
         ParticleContainer & p = *iter;
         {
-          tbox::pout<<"\nThere are "<<p.p_list.size()<<" particles at cell "
+          tbox::pout<<"\nThere are "<<p.size()<<" particles at cell "
                    <<iter.getIndex()<<". Node "<<mpi.getRank()<<", box "<<patch->getBox()
                    <<". Their location and velocity are \n";
-          cnt += p.p_list.size();
+          cnt += p.size();
           p.print();
         }
       }
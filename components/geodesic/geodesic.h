@@ -26,6 +26,10 @@
 #include "SAMRAI/pdat/IndexVariable.h"
 #include "SAMRAI/pdat/IndexData.h"
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 using namespace SAMRAI;
 
 
@@ -64,6 +68,60 @@ namespace cosmo
 #define GEODESIC_DEFINE_CRSPLINES_DM(K,I,J) \
   double a_d##K##m##I##J[64], f_d##K##m##I##J[64];
 
+#define GEODESIC_DEFINE_COEFS_CHI \
+  double a_chi[64]
+
+#define GEODESIC_DEFINE_COEFS_DCHI(I)       \
+  double a_d##I##chi[64]
+  
+#define GEODESIC_DEFINE_COEFS_BETA(I) \
+  double a_beta##I[64]
+
+#define GEODESIC_DEFINE_COEFS_DBETA(I,J) \
+  double a_d##I##beta##J[64]
+  
+#define GEODESIC_DEFINE_COEFS_ALPHA \
+  double a_alpha[64]
+
+#define GEODESIC_DEFINE_COEFS_DALPHA(I) \
+  double a_d##I##alpha[64]
+
+#define GEODESIC_DEFINE_COEFS_M(I,J) \
+  double a_m##I##J[64]
+
+#define GEODESIC_DEFINE_COEFS_DM(K,I,J) \
+  double a_d##K##m##I##J[64]
+
+#define GEODESIC_DEFINE_COEFS_K \
+  double a_K[64]
+
+#define GEODESIC_DEFINE_VALUES_CHI \
+  double f_chi[64]
+
+#define GEODESIC_DEFINE_VALUES_DCHI(I)       \
+  double f_d##I##chi[64]
+  
+#define GEODESIC_DEFINE_VALUES_BETA(I) \
+  double f_beta##I[64]
+
+#define GEODESIC_DEFINE_VALUES_DBETA(I,J) \
+  double f_d##I##beta##J[64]
+  
+#define GEODESIC_DEFINE_VALUES_ALPHA \
+  double f_alpha[64]
+
+#define GEODESIC_DEFINE_VALUES_DALPHA(I) \
+  double f_d##I##alpha[64]
+
+#define GEODESIC_DEFINE_VALUES_M(I,J) \
+  double f_m##I##J[64]
+
+#define GEODESIC_DEFINE_VALUES_DM(K,I,J) \
+  double f_d##K##m##I##J[64]
+
+#define GEODESIC_DEFINE_VALUES_K \
+  double f_K[64]
+
 #define GEODESIC_DEFINE_CRSPLINES_DF_D \
   double a_D[64], f_D[64];
 
@@ -168,9 +226,127 @@ namespace cosmo
 
 
   
+// derived metric quantities stored per cell for ray tracing: chi, d_i chi,
+// beta^i, d_i beta^j, alpha, d_i alpha, gamma_ij, d_k gamma_ij and K
+#define GEODESIC_RAY_GEOMETRY_DEPTH 45
+
 class Geodesic
 {
  public:
+  /**
+   * @brief access to the patch data holding the derived metric quantities
+   *        of the current patch, one depth component per quantity
+   */
+  class RayGeometry
+  {
+   public:
+    void attach(const std::shared_ptr<pdat::CellData<double> > & pdata);
+
+    bool contains(int i, int j, int k) const;
+
+    void store(int i, int j, int k, const BSSNData &bd);
+
+    void load(int i, int j, int k, BSSNData *bd) const;
+
+   private:
+    idx_t offset(int i, int j, int k) const;
+
+    double * v[GEODESIC_RAY_GEOMETRY_DEPTH];
+    int lower[3], n[3];
+  };
+
+  /**
+   * @brief tricubic interpolation coefficients of the metric quantities
+   *        on the 4^3 stencil around one cell
+   */
+  struct MetricCoefs
+  {
+    GEODESIC_DEFINE_COEFS_CHI;
+    GEODESIC_DEFINE_COEFS_DCHI(1);
+    GEODESIC_DEFINE_COEFS_DCHI(2);
+    GEODESIC_DEFINE_COEFS_DCHI(3);
+
+    GEODESIC_DEFINE_COEFS_BETA(1);
+    GEODESIC_DEFINE_COEFS_BETA(2);
+    GEODESIC_DEFINE_COEFS_BETA(3);
+
+    GEODESIC_DEFINE_COEFS_DBETA(1,1);
+    GEODESIC_DEFINE_COEFS_DBETA(1,2);
+    GEODESIC_DEFINE_COEFS_DBETA(1,3);
+    GEODESIC_DEFINE_COEFS_DBETA(2,1);
+    GEODESIC_DEFINE_COEFS_DBETA(2,2);
+    GEODESIC_DEFINE_COEFS_DBETA(2,3);
+    GEODESIC_DEFINE_COEFS_DBETA(3,1);
+    GEODESIC_DEFINE_COEFS_DBETA(3,2);
+    GEODESIC_DEFINE_COEFS_DBETA(3,3);
+
+    GEODESIC_DEFINE_COEFS_ALPHA;
+
+    GEODESIC_DEFINE_COEFS_DALPHA(1);
+    GEODESIC_DEFINE_COEFS_DALPHA(2);
+    GEODESIC_DEFINE_COEFS_DALPHA(3);
+
+    COSMO_APPLY_TO_IJ_PERMS(GEODESIC_DEFINE_COEFS_M);
+    COSMO_APPLY_TO_IJK_PERMS(GEODESIC_DEFINE_COEFS_DM);
+
+#if PARTICLE_REAL_PROPERTIES > 15
+    GEODESIC_DEFINE_COEFS_K;
+#endif
+
+    void compute(
+      BSSN *bssn, const RayGeometry *ray_geometry,
+      int i0, int j0, int k0, const real_t dx[]);
+
+    void evaluate(
+      GeodesicData *gd, double xd, double yd, double zd) const;
+  };
+
+  /**
+   * @brief metric coefficients of the cells of one patch, built on first
+   *        use and shared by all particles in a cell; only valid while the
+   *        _a fields do not change, i.e. within one RK stage
+   */
+  class MetricCoefCache
+  {
+   public:
+    const MetricCoefs & get(
+      BSSN *bssn, const RayGeometry *ray_geometry,
+      int i0, int j0, int k0, const real_t dx[]);
+
+   private:
+    struct entry_t
+    {
+      std::once_flag built;
+      MetricCoefs coefs;
+    };
+
+    std::map<std::tuple<int, int, int>, std::unique_ptr<entry_t> > entries;
+  };
+
+  /**
+   * @brief particles of one thread whose interpolated geometry has been
+   *        gathered, advanced together once all lanes are filled
+   */
+  class RKBatch
+  {
+   public:
+    RKBatch(): n(0) {}
+
+    void add(ParticleContainer * pc, int p,
+             const GeodesicData &gd_in, const DustFluidData &dd_in);
+
+    bool full() const { return n == GEODESIC_BATCH_WIDTH; }
+
+    int n;
+    ParticleContainer * pcs[GEODESIC_BATCH_WIDTH];
+    int ps[GEODESIC_BATCH_WIDTH];
+
+    GeodesicBatch gd;
+    real_t D[GEODESIC_BATCH_WIDTH], E[GEODESIC_BATCH_WIDTH],
+      S1[GEODESIC_BATCH_WIDTH], S2[GEODESIC_BATCH_WIDTH],
+      S3[GEODESIC_BATCH_WIDTH];
+  };
+
   Geodesic(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
     const tbox::Dimension& dim_in,
@@ -214,7 +390,10 @@ class Geodesic
 
   
   void RKEvolveParticle(
-    RKParticle &p, GeodesicData &gd, double dt);
+    const ParticleRef & p, GeodesicData &gd, double dt);
+
+  void RKEvolveBatch(
+    RKBatch *batch, double dt, bool with_dust_fluid);
 
   
   void K1FinalizePatch(
@@ -231,11 +410,24 @@ class Geodesic
 
   void set_gd_values(
   const std::shared_ptr<hier::Patch> & patch, 
-  double p_info[], GeodesicData *gd, BSSN *bssn, const real_t dx[], double shift[]);
+  const ParticleField<double> & p_info, GeodesicData *gd, BSSN *bssn, const real_t dx[], double shift[],
+  MetricCoefCache *coef_cache = NULL, const RayGeometry *ray_geometry = NULL);
+
+  void interpolate_gd_values(
+  const std::shared_ptr<hier::Patch> & patch, 
+  const ParticleField<double> & p_info, GeodesicData *gd, BSSN *bssn, const real_t dx[], double shift[],
+  MetricCoefCache *coef_cache, const RayGeometry *ray_geometry);
+
+  void fillRayGeometry(
+    const std::shared_ptr<hier::Patch> & patch, BSSN *bssn, const real_t dx[],
+    const std::vector<pdat::IndexData<ParticleContainer, pdat::CellGeometry>::iterator> & it_vec,
+    const hier::Box & effective_ghost_box,
+    const double ghost_box_phys_lower[], const double ghost_box_phys_upper[],
+    RayGeometry *ray_geometry);
 
   void set_gd_values_for_dust_fluid(
     const std::shared_ptr<hier::Patch> & patch, 
-    double p_info[], GeodesicData *gd, DustFluidData *dd, DustFluid *dustFluidSim, const real_t dx[], double shift[]);
+    const ParticleField<double> & p_info, GeodesicData *gd, DustFluidData *dd, DustFluid *dustFluidSim, const real_t dx[], double shift[]);
 
   
   void clearParticlesCoveredbyFinerLevel(
@@ -286,10 +478,10 @@ class Geodesic
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN *bssn, DustFluid *dustFluid);
 
   
-  void compute_tricubic_coeffs(double *a, double *f);
+  static void compute_tricubic_coeffs(double *a, double *f);
 
-  double evaluate_interpolation(
-    double * a, double x, double y, double z);
+  static double evaluate_interpolation(
+    const double * a, double x, double y, double z);
 
   void allocParticles(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy, int ln);
@@ -305,6 +497,8 @@ class Geodesic
   void regridPostProcessing(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
 
+  void resetTransferSchedules();
+
 
 
 
@@ -318,7 +512,9 @@ class Geodesic
   std::shared_ptr<pdat::IndexVariable<ParticleContainer,
     pdat::CellGeometry> > pc;
 
-  int pc_idx, pc_s_idx, pc_d_buffer_idx, weight_idx;
+  std::shared_ptr<pdat::CellVariable<double> > ray_geometry_var;
+
+  int pc_idx, pc_s_idx, pc_d_buffer_idx, weight_idx, ray_geometry_idx;
   int ghost_width;
 
   std::shared_ptr<pdat::IndexData<ParticleContainer,
@@ -328,10 +524,25 @@ class Geodesic
   std::shared_ptr<pdat::IndexData<ParticleContainer,
                                   pdat::CellGeometry> > pc_d_buffer_pdata;
 
+  // particle transfer schedules per level, created on first use and
+  // dropped whenever the hierarchy changes
+  std::vector<std::shared_ptr<xfer::RefineSchedule> >
+    ghost_fill_schedules, upstream_schedules;
+  std::vector<std::shared_ptr<xfer::CoarsenSchedule> >
+    downstream_schedules;
+
   double domain_lower[3], domain_upper[3], L[3];
   
   double p0;
   bool save_metric;
+  // share interpolation coefficients between particles in the same cell
+  bool cache_metric_coefs;
+  // interpolate derived metric quantities stored once per RK stage
+  // instead of recomputing derivatives for every particle
+  bool precompute_ray_geometry;
+  // gather the interpolated geometry of GEODESIC_BATCH_WIDTH particles
+  // and evaluate their right hand sides together across lanes
+  bool batched_rk;
   int cur_step, num_p;
 };
 }
@@ -30,6 +30,44 @@ typedef struct {
 
 }GeodesicData;
 
+// number of geodesics whose right hand sides are evaluated together
+#ifndef GEODESIC_BATCH_WIDTH
+#define GEODESIC_BATCH_WIDTH 8
+#endif
+
+#define GEODESIC_APPLY_TO_BATCH_FIELDS(function)                        \
+  function(m11); function(m12); function(m13);                          \
+  function(m22); function(m23); function(m33);                          \
+  function(mi11); function(mi12); function(mi13);                       \
+  function(mi22); function(mi23); function(mi33);                       \
+  function(q1); function(q2); function(q3);                             \
+  function(qi1); function(qi2); function(qi3);                          \
+  function(chi); function(d1chi); function(d2chi); function(d3chi);     \
+  function(K);                                                          \
+  function(beta1); function(beta2); function(beta3);                    \
+  function(d1beta1); function(d1beta2); function(d1beta3);              \
+  function(d2beta1); function(d2beta2); function(d2beta3);              \
+  function(d3beta1); function(d3beta2); function(d3beta3);              \
+  function(alpha); function(d1alpha); function(d2alpha); function(d3alpha); \
+  function(d1m11); function(d1m12); function(d1m13);                    \
+  function(d1m22); function(d1m23); function(d1m33);                    \
+  function(d2m11); function(d2m12); function(d2m13);                    \
+  function(d2m22); function(d2m23); function(d2m33);                    \
+  function(d3m11); function(d3m12); function(d3m13);                    \
+  function(d3m22); function(d3m23); function(d3m33);                    \
+  function(p0)
+
+#define GEODESIC_DEFINE_BATCH_FIELD(field) \
+  real_t field[GEODESIC_BATCH_WIDTH]
+
+/**
+ * @brief GeodesicData of GEODESIC_BATCH_WIDTH geodesics, one lane per
+ *        geodesic in every field
+ */
+typedef struct {
+  GEODESIC_APPLY_TO_BATCH_FIELDS(GEODESIC_DEFINE_BATCH_FIELD);
+}GeodesicBatch;
+
  
 }
 #endif
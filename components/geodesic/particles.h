@@ -18,6 +18,8 @@
 
 #include "boost/shared_ptr.hpp"
 #include <list>
+#include <vector>
+#include <algorithm>
 
 #include "SAMRAI/hier/Index.h"
 #include "SAMRAI/hier/IntVector.h"
@@ -99,31 +101,237 @@ class RKParticle
   }
 };
 
+/**
+ * @brief component i of a particle quantity kept structure-of-arrays,
+ *        consecutive components are stride elements apart
+ */
+template<class T>
+class ParticleField
+{
+ public:
+  ParticleField(T * base_in, size_t stride_in):
+    base(base_in),
+    stride(stride_in)
+  {
+  }
+
+  T & operator[](int i) const
+  {
+    return base[i * stride];
+  }
+
+ private:
+  T * base;
+  size_t stride;
+};
+
+/**
+ * @brief one particle of a ParticleContainer, accessed like an RKParticle;
+ *        only valid until particles are added to or erased from the
+ *        container
+ */
+class ParticleRef
+{
+ public:
+  ParticleRef(double * reals, int * ints, size_t stride):
+    x_p(reals, stride),
+    x_a(reals + PARTICLE_NUMBER_OF_STATES * stride, stride),
+    x_c(reals + 2 * PARTICLE_NUMBER_OF_STATES * stride, stride),
+    x_f(reals + 3 * PARTICLE_NUMBER_OF_STATES * stride, stride),
+    rp(reals + 4 * PARTICLE_NUMBER_OF_STATES * stride, stride),
+    ip(ints, stride)
+  {
+  }
+
+  ParticleField<double> x_p, x_a, x_c, x_f, rp;
+  ParticleField<int> ip;
+};
+
+/**
+ * @brief particles living in one cell, stored structure-of-arrays:
+ *        every state component and property is a contiguous array over
+ *        the particles of the cell
+ */
 class ParticleContainer
 {
 
 public:
+  class iterator
+  {
+   public:
+    iterator(ParticleContainer * pc_in, int p_in):
+      pc(pc_in),
+      p(p_in)
+    {
+    }
+
+    ParticleRef operator*() const
+    {
+      return (*pc)[p];
+    }
+
+    iterator & operator++()
+    {
+      p++;
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      iterator old(*this);
+      p++;
+      return old;
+    }
+
+    bool operator==(const iterator & other) const
+    {
+      return pc == other.pc && p == other.p;
+    }
+
+    bool operator!=(const iterator & other) const
+    {
+      return !(*this == other);
+    }
+
+    int index() const
+    {
+      return p;
+    }
+
+   private:
+    ParticleContainer * pc;
+    int p;
+  };
+
  ParticleContainer():
-  idx(-9999,-9999,-9999)
+  idx(-9999,-9999,-9999),
+  n_p(0),
+  capacity(0)
    {
    }
 
    ~ParticleContainer()
    {
-     p_list.clear();
    }
 
 
    // initializing empty ParticleContainer 
  ParticleContainer(const hier::Index idx_in):
-     idx(idx_in)
+     idx(idx_in),
+     n_p(0),
+     capacity(0)
    {
      
    }
 
-   void addParticle(RKParticle & p)
+   int size() const
+   {
+     return n_p;
+   }
+
+   iterator begin()
+   {
+     return iterator(this, 0);
+   }
+
+   iterator end()
+   {
+     return iterator(this, n_p);
+   }
+
+   ParticleRef operator[](int p)
+   {
+     return ParticleRef(&reals[p], &ints[p], capacity);
+   }
+
+   /**
+    * @brief make room for exactly n particles, used when the final number
+    *        of particles is known
+    */
+   void reserve(int n)
+   {
+     if(n > capacity)
+       setCapacity(n);
+   }
+
+   // release the room not used by the particles
+   void shrinkToFit()
+   {
+     if(capacity > n_p)
+       setCapacity(n_p);
+   }
+
+   void addParticle(const RKParticle & p)
+   {
+     grow();
+     ParticleRef dst = (*this)[n_p++];
+     for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+     {
+       dst.x_p[i] = p.x_p[i];
+       dst.x_a[i] = p.x_a[i];
+       dst.x_c[i] = p.x_c[i];
+       dst.x_f[i] = p.x_f[i];
+     }
+     for(int i = 0; i < PARTICLE_REAL_PROPERTIES; i++)
+       dst.rp[i] = p.rp[i];
+     for(int i = 0; i < PARTICLE_INT_PROPERTIES; i++)
+       dst.ip[i] = p.ip[i];
+   }
+
+   // p has to belong to another container
+   void addParticle(const ParticleRef & p)
+   {
+     grow();
+     ParticleRef dst = (*this)[n_p++];
+     for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+     {
+       dst.x_p[i] = p.x_p[i];
+       dst.x_a[i] = p.x_a[i];
+       dst.x_c[i] = p.x_c[i];
+       dst.x_f[i] = p.x_f[i];
+     }
+     for(int i = 0; i < PARTICLE_REAL_PROPERTIES; i++)
+       dst.rp[i] = p.rp[i];
+     for(int i = 0; i < PARTICLE_INT_PROPERTIES; i++)
+       dst.ip[i] = p.ip[i];
+   }
+
+   // append all particles of src, component by component
+   void append(const ParticleContainer & src)
+   {
+     reserve(n_p + src.n_p);
+     for(int c = 0; c < REAL_NUMBERS_IN_A_PARTICLE; c++)
+       std::copy(src.reals.begin() + (size_t)c * src.capacity,
+                 src.reals.begin() + (size_t)c * src.capacity + src.n_p,
+                 reals.begin() + (size_t)c * capacity + n_p);
+     for(int c = 0; c < INT_NUMBERS_IN_A_PARTICLE; c++)
+       std::copy(src.ints.begin() + (size_t)c * src.capacity,
+                 src.ints.begin() + (size_t)c * src.capacity + src.n_p,
+                 ints.begin() + (size_t)c * capacity + n_p);
+     n_p += src.n_p;
+   }
+
+   /**
+    * @brief remove the particle at it by moving the last particle into its
+    *        place, it then points to the next particle not yet visited
+    */
+   iterator erase(iterator it)
+   {
+     int p = it.index();
+     n_p--;
+     if(p != n_p)
+     {
+       for(int c = 0; c < REAL_NUMBERS_IN_A_PARTICLE; c++)
+         reals[(size_t)c * capacity + p] = reals[(size_t)c * capacity + n_p];
+       for(int c = 0; c < INT_NUMBERS_IN_A_PARTICLE; c++)
+         ints[(size_t)c * capacity + p] = ints[(size_t)c * capacity + n_p];
+     }
+     return it;
+   }
+
+   void clear()
    {
-     p_list.push_back(p);
+     n_p = 0;
    }
    
    void copySourceItem(
@@ -133,14 +341,27 @@ public:
    {
       NULL_USE(idx);
       NULL_USE(src_offset);
-      idx = src_item.idx;
-      p_list = src_item.p_list;
+      *this = src_item;
+   }
+
+   // copies hold exactly the particles of p
+   ParticleContainer(const ParticleContainer & p):
+     idx(p.idx),
+     n_p(0),
+     capacity(0)
+   {
+     append(p);
    }
 
    ParticleContainer & operator = (const ParticleContainer & p)
      {
+       if(this == &p) return *this;
        idx = p.idx;
-       p_list = p.p_list;
+       reals.clear();
+       ints.clear();
+       n_p = 0;
+       capacity = 0;
+       append(p);
        return *this;
      }
 
@@ -157,10 +378,10 @@ public:
      // for each particle, 6 double variables needed to store
      // their states.
      byte_size += tbox::MessageStream::getSizeof<double>(REAL_NUMBERS_IN_A_PARTICLE)
-       * p_list.size();
+       * n_p;
 
      byte_size += tbox::MessageStream::getSizeof<int>(INT_NUMBERS_IN_A_PARTICLE)
-       * p_list.size();
+       * n_p;
 
      // also adding size for 3d indices
      byte_size += tbox::MessageStream::getSizeof<int>(3);
@@ -171,52 +392,33 @@ public:
 
 /* Pack data into tbox::MessageStream by using stream.pack() function, 
  * see SAMRAI's reference for more detail about tbox::MessageStream.
- *
- *
+ * The states x_a, the real and the int properties are packed array by
+ * array.
  */
    void packStream(
       tbox::MessageStream& stream)
    {
-     //     const SAMRAI_MPI& mpi(SAMRAI_MPI::getSAMRAIWorld());
-     /* if (mpi.getRank() == 0) { */
-     /*   TBOX_ERROR("Statistic::packStream error...\n" */
-     /*              << "    Processor zero should not pack stat data" << std::endl); */
-     /* } */
-
      stream.pack(&idx[0], 3);
      
-     int p_num = p_list.size();
+     int p_num = n_p;
      stream.pack(&p_num, 1);
-     
-     double temp[PARTICLE_NUMBER_OF_STATES+PARTICLE_INT_PROPERTIES+PARTICLE_REAL_PROPERTIES];
 
-     for (std::list<RKParticle>::iterator it=p_list.begin(); it != p_list.end(); ++it)
-     {
-       for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
-         temp[i] = (*it).x_a[i];
+     if(p_num == 0) return;
 
-       for(int i = 0; i < PARTICLE_REAL_PROPERTIES; i++)
-         temp[PARTICLE_NUMBER_OF_STATES+i] = (*it).rp[i];
+     for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+       stream.pack(&(*this)[0].x_a[i], p_num);
 
-       
-       for(int i = 0; i < PARTICLE_INT_PROPERTIES; i++)
-         temp[PARTICLE_NUMBER_OF_STATES+PARTICLE_REAL_PROPERTIES+i] = (*it).ip[i];
+     for(int i = 0; i < PARTICLE_REAL_PROPERTIES; i++)
+       stream.pack(&(*this)[0].rp[i], p_num);
 
-       
-       stream.pack(&temp[0], PARTICLE_NUMBER_OF_STATES+PARTICLE_INT_PROPERTIES+PARTICLE_REAL_PROPERTIES);
-     }
+     for(int i = 0; i < PARTICLE_INT_PROPERTIES; i++)
+       stream.pack(&(*this)[0].ip[i], p_num);
    }
 
    void unpackStream(
       tbox::MessageStream& stream,
       const hier::IntVector offset)
    {
-     //     const SAMRAI_MPI& mpi(SAMRAI_MPI::getSAMRAIWorld());
-     /* if (mpi.getRank() != 0) { */
-     /*   TBOX_ERROR("Statistic::unpackStream error...\n" */
-     /*              << "    Only processor zero should unpack stat data" << std::endl); */
-     /* } */
-
      stream.unpack(&idx[0], 3);
      
      int incoming_p_num;
@@ -224,29 +426,24 @@ public:
 
      stream>>incoming_p_num;
 
-     
-     for(int i = 0; i < incoming_p_num; i++)
-     {
-       double temp_p_info[PARTICLE_NUMBER_OF_STATES+PARTICLE_INT_PROPERTIES+PARTICLE_REAL_PROPERTIES];
+     if(incoming_p_num == 0) return;
 
-       RKParticle temp_p;
+     reserve(n_p + incoming_p_num);
+     ParticleRef first = (*this)[n_p];
 
-       //getting level info
-       //       stream>>temp_p_lv_info;
+     for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i++)
+     {
+       stream.unpack(&first.x_a[i], incoming_p_num);
+       std::copy(&first.x_a[i], &first.x_a[i] + incoming_p_num, &first.x_p[i]);
+     }
 
-       // getting location and velocity info
-       stream.unpack(&temp_p_info[0], PARTICLE_NUMBER_OF_STATES+PARTICLE_INT_PROPERTIES+PARTICLE_REAL_PROPERTIES);
+     for(int i = 0; i < PARTICLE_REAL_PROPERTIES; i++)
+       stream.unpack(&first.rp[i], incoming_p_num);
 
-       // copying data to a temp particle object
-       for(int i = 0; i < PARTICLE_NUMBER_OF_STATES; i ++)
-         temp_p.x_a[i] = temp_p.x_p[i] = temp_p_info[i];
-       for(int i = 0; i < PARTICLE_REAL_PROPERTIES; i ++)
-         temp_p.rp[i] = temp_p_info[PARTICLE_NUMBER_OF_STATES+i];
-       for(int i = 0; i < PARTICLE_INT_PROPERTIES; i ++)
-         temp_p.ip[i] = temp_p_info[PARTICLE_NUMBER_OF_STATES+PARTICLE_REAL_PROPERTIES+i];
-       // adding this temp particle to the list
-       p_list.push_back(temp_p);
-     }
+     for(int i = 0; i < PARTICLE_INT_PROPERTIES; i++)
+       stream.unpack(&first.ip[i], incoming_p_num);
+
+     n_p += incoming_p_num;
    }
 
    void putToRestart(
@@ -263,8 +460,7 @@ public:
    // print info in this list
    void print()
    {
-     //     int p_num = p_list.size();
-     for (std::list<RKParticle>::iterator it=p_list.begin(); it != p_list.end(); ++it)
+     for (iterator it=begin(); it != end(); ++it)
      {
        
        tbox::pout<<"("<<(*it).x_a[0]<<", "<<(*it).x_a[1]<<", "<<(*it).x_a[2]<<")  ";
@@ -285,16 +481,41 @@ public:
      tbox::pout<<" ";
    }
 
-   /* ParticleContainer& operator=(const ParticleContainer& other) // copy assignment */
-   /*   { */
-   /*     //       tbox::pout<<idx<<" "<<p_list.size()<<" "<<other.p_list.size()<<"\n"; */
-   /*     idx = other.idx; */
-   /*     p_list = other.p_list; */
-   /*     //       p_list.insert(p_list.end(),other.p_list.begin(), other.p_list.end()); */
-   /*   } */
-   
-   hier::Index idx;   
-   std::list<RKParticle> p_list;
+   hier::Index idx;
+
+ private:
+   // room for one more particle, growing by half of the capacity so a
+   // cell filled particle by particle wastes at most a third of its room
+   void grow()
+   {
+     if(n_p == capacity)
+       setCapacity(capacity + capacity / 2 + 1);
+   }
+
+   // move the arrays of every component to the new stride
+   void setCapacity(int new_capacity)
+   {
+     std::vector<double> new_reals((size_t)new_capacity * REAL_NUMBERS_IN_A_PARTICLE);
+     std::vector<int> new_ints((size_t)new_capacity * INT_NUMBERS_IN_A_PARTICLE);
+
+     for(int c = 0; c < REAL_NUMBERS_IN_A_PARTICLE; c++)
+       std::copy(reals.begin() + (size_t)c * capacity,
+                 reals.begin() + (size_t)c * capacity + n_p,
+                 new_reals.begin() + (size_t)c * new_capacity);
+     for(int c = 0; c < INT_NUMBERS_IN_A_PARTICLE; c++)
+       std::copy(ints.begin() + (size_t)c * capacity,
+                 ints.begin() + (size_t)c * capacity + n_p,
+                 new_ints.begin() + (size_t)c * new_capacity);
+
+     reals.swap(new_reals);
+     ints.swap(new_ints);
+     capacity = new_capacity;
+   }
+
+   // component c of particle p is at c * capacity + p
+   std::vector<double> reals;
+   std::vector<int> ints;
+   int n_p, capacity;
 };
 
 #endif
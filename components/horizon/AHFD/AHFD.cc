@@ -3035,9 +3035,6 @@ printf("AHFinderDirect:: proc %d: initializing interpolator outputs to 999.999\n
 #endif
 
 
-          hierarchy->getMPI().Barrier();
-
-
  // all coordinate information is stored in interp_coords
  status = CCTK_InterpGridArrays(N_GRID_DIMS,
         		       gi.operator_handle, gi.param_table_handle,
@@ -5670,14 +5667,12 @@ int Horizon::CCTK_InterpGridArrays(
 {
   const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
   int ln_num = hierarchy->getNumberOfLevels(), ln;
-  const int N_interp_points_bak = N_interp_points;
-
-  int is_dummy = 0;
-
-  CCTK_REAL dummy_x_mask = 0, dummy_y_mask = 0, dummy_z_mask = 0;
 
   int rank = 0;
 
+  // quantities per point, stored in output_arrays[4] ... output_arrays[33]
+  const int N_GEOM_INTERP_VALS = 30;
+
   #if USE_HERMITE_GEOM_INTERP
   // initialing interpolator
   
@@ -5733,481 +5728,407 @@ int Horizon::CCTK_InterpGridArrays(
    
   #endif
 
-  for(rank = 0 ; rank < state.N_procs; rank++)
-  {
-    // initialization on every node
-    N_interp_points = N_interp_points_bak;
-    is_dummy = 0;
-
-    //**********************************************************************
-    // initialing is_dummy
-    if(N_interp_points == 0)
-      is_dummy = 1;
-    
-    // every nodes' is_dummy variable will be the same
-    // as the variable on "rank" node after Bcast
-    mpi.Bcast(&is_dummy, 1, MPI_INT, rank);
+  //**********************************************************************
+  // gather the points of all ranks at once
+  std::vector<int> n_points(state.N_procs, 0), point_offsets(state.N_procs + 1, 0);
+  mpi.Allgather(&N_interp_points, 1, MPI_INT, &n_points[0], 1, MPI_INT);
 
-    if(!is_dummy)//the current node is not dummy
-    {
-      mpi.Bcast(&N_interp_points, 1, MPI_INT, rank);
-      for(int n = 0; n < N_interp_points; n++)
-      {
-        int cur_mpi_rank = -1, cur_mpi_level = -1; 
+  for(rank = 0; rank < state.N_procs; rank++)
+    point_offsets[rank + 1] = point_offsets[rank] + n_points[rank];
 
-        CCTK_REAL x = 0, y = 0, z = 0;
-        if(state.my_proc == rank)
-        {
-          x = ((const CCTK_REAL *)interp_coords[0])[n];
-          y = ((const CCTK_REAL *)interp_coords[1])[n];
-          z = ((const CCTK_REAL *)interp_coords[2])[n];
-        }
+  const int N_total_points = point_offsets[state.N_procs];
 
-        // every (x,y,z) on nodes is the same after this call
-        mpi.Bcast(&x, 1, MPI_DOUBLE, rank);
-        mpi.Bcast(&y, 1, MPI_DOUBLE, rank);
-        mpi.Bcast(&z, 1, MPI_DOUBLE, rank);
+  if(N_total_points == 0)
+    return 1;
 
-        fp dg11, dg22, dg33, dg12, dg13, dg23,
-          d1dg11, d1dg22, d1dg33, d1dg12, d1dg13, d1dg23,
-          d2dg11, d2dg22, d2dg33, d2dg12, d2dg13, d2dg23,
-          d3dg11, d3dg22, d3dg33, d3dg12, d3dg13, d3dg23,
-          dK11, dK22, dK33, dK12, dK13, dK23;
-        
-        fp & g11 = (state.my_proc != rank)?dg11:(( fp *)output_arrays[4])[n];
-        fp & d1g11 = (state.my_proc != rank)?d1dg11:(( fp *)output_arrays[5])[n];
-        fp & d2g11 = (state.my_proc != rank)?d2dg11:(( fp *)output_arrays[6])[n];
-        fp & d3g11 = (state.my_proc != rank)?d3dg11:(( fp *)output_arrays[7])[n];
-        fp & g12 = (state.my_proc != rank)?dg12:(( fp *)output_arrays[8])[n];
-        fp & d1g12 = (state.my_proc != rank)?d1dg12:(( fp *)output_arrays[9])[n];
-        fp & d2g12 = (state.my_proc != rank)?d2dg12:(( fp *)output_arrays[10])[n];
-        fp & d3g12 = (state.my_proc != rank)?d3dg12:(( fp *)output_arrays[11])[n];
-        fp & g13 = (state.my_proc != rank)?dg13:(( fp *)output_arrays[12])[n];
-        fp & d1g13 = (state.my_proc != rank)?d1dg13:(( fp *)output_arrays[13])[n];
-        fp & d2g13 = (state.my_proc != rank)?d2dg13:(( fp *)output_arrays[14])[n];
-        fp & d3g13 = (state.my_proc != rank)?d3dg13:(( fp *)output_arrays[15])[n];
-        fp & g22 = (state.my_proc != rank)?dg22:(( fp *)output_arrays[16])[n];
-        fp & d1g22 = (state.my_proc != rank)?d1dg22:(( fp *)output_arrays[17])[n];
-        fp & d2g22 = (state.my_proc != rank)?d2dg22:(( fp *)output_arrays[18])[n];
-        fp & d3g22 = (state.my_proc != rank)?d3dg22:(( fp *)output_arrays[19])[n];
-        fp & g23 = (state.my_proc != rank)?dg23:(( fp *)output_arrays[20])[n];
-        fp & d1g23 = (state.my_proc != rank)?d1dg23:(( fp *)output_arrays[21])[n];
-        fp & d2g23 = (state.my_proc != rank)?d2dg23:(( fp *)output_arrays[22])[n];
-        fp & d3g23 = (state.my_proc != rank)?d3dg23:(( fp *)output_arrays[23])[n];
-        fp & g33 = (state.my_proc != rank)?dg33:(( fp *)output_arrays[24])[n];
-        fp & d1g33 = (state.my_proc != rank)?d1dg33:(( fp *)output_arrays[25])[n];
-        fp & d2g33 = (state.my_proc != rank)?d2dg33:(( fp *)output_arrays[26])[n];
-        fp & d3g33 = (state.my_proc != rank)?d3dg33:(( fp *)output_arrays[27])[n];
-        fp & K11 = (state.my_proc != rank)?dK11:(( fp *)output_arrays[28])[n];
-        fp & K12 = (state.my_proc != rank)?dK12:(( fp *)output_arrays[29])[n];
-        fp & K13 = (state.my_proc != rank)?dK13:(( fp *)output_arrays[30])[n];
-        fp & K22 = (state.my_proc != rank)?dK22:(( fp *)output_arrays[31])[n];
-        fp & K23 = (state.my_proc != rank)?dK23:(( fp *)output_arrays[32])[n];
-        fp & K33 = (state.my_proc != rank)?dK33:(( fp *)output_arrays[33])[n];
-
-        g11 = 0;
-        d1g11 = 0;
-        d2g11 = 0;
-        d3g11 = 0;
-        g12 = 0;
-        d1g12 = 0;
-        d2g12 = 0;
-        d3g12 = 0;
-        g13 = 0;
-        d1g13 = 0;
-        d2g13 = 0;
-        d3g13 = 0;
-        g22 = 0;
-        d1g22 = 0;
-        d2g22 = 0;
-        d3g22 = 0;
-        g23 = 0;
-        d1g23 = 0;
-        d2g23 = 0;
-        d3g23 = 0;
-        g33 = 0;
-        d1g33 = 0;
-        d2g33 = 0;
-        d3g33 = 0;
-        K11 = 0;
-        K12 = 0;
-        K13 = 0;
-        K22 = 0;
-        K23 = 0;
-        K33 = 0;
-
-        for (ln = ln_num - 1; ln >= 0; ln--)
-        {
-          std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
-          hier::PatchLevel::iterator p(level->begin());
-          for (;p != level->end(); ++p)
-          {
-            const std::shared_ptr<hier::Patch>& patch = *p;
-            const hier::Box& box = patch->getBox();
+  std::vector<CCTK_REAL> local_coords(3 * N_interp_points);
+  std::vector<CCTK_REAL> all_coords(3 * N_total_points);
+  std::vector<int> coord_counts(state.N_procs), coord_displs(state.N_procs);
 
-            const int * lower = &box.lower()[0];
-            const int * upper = &box.upper()[0];
-      
-            std::shared_ptr<geom::CartesianPatchGeometry> patch_geometry(
-              SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-                patch->getPatchGeometry()));
+  for(int n = 0; n < N_interp_points; n++)
+  {
+    local_coords[3 * n] = ((const CCTK_REAL *)interp_coords[0])[n];
+    local_coords[3 * n + 1] = ((const CCTK_REAL *)interp_coords[1])[n];
+    local_coords[3 * n + 2] = ((const CCTK_REAL *)interp_coords[2])[n];
+  }
 
+  for(rank = 0; rank < state.N_procs; rank++)
+  {
+    coord_counts[rank] = 3 * n_points[rank];
+    coord_displs[rank] = 3 * point_offsets[rank];
+  }
 
-            const real_t * dx = &(patch_geometry->getDx())[0];
+  mpi.Allgatherv(local_coords.data(), 3 * N_interp_points, MPI_DOUBLE,
+                 all_coords.data(), &coord_counts[0], &coord_displs[0], MPI_DOUBLE);
 
-            int i0 = floor((x  - domain_lower[0] ) / dx[0] - 0.5);
-            int j0 = floor((y  - domain_lower[1] ) / dx[1] - 0.5);
-            int k0 = floor((z  - domain_lower[2] ) / dx[2] - 0.5);
+  //**********************************************************************
+  // interpolate every point covered by a local patch, finest level first;
+  // owner_key = level * N_procs + rank is maximal on the rank owning the
+  // point on the finest level that covers it
+  std::vector<int> owner_key(N_total_points, -1);
+  std::vector<fp> all_vals(N_GEOM_INTERP_VALS * N_total_points, 0);
 
-            if( i0 >= lower[0] && i0 <= upper[0]
-                && j0 >= lower[1] && j0 <= upper[1]
-                && k0 >= lower[2] && k0 <= upper[2])
-            {
-              cur_mpi_rank = state.my_proc;
-              cur_mpi_level = ln;
-              bssn->initPData(patch);
-              
-#if USE_HERMITE_GEOM_INTERP
-              //***************************
-              // doing Hermite interpolation
-              double * g11_in = bssn->DIFFgamma11_a_pdata->getPointer();
-              double * g22_in = bssn->DIFFgamma22_a_pdata->getPointer();
-              double * g33_in = bssn->DIFFgamma33_a_pdata->getPointer();
-              double * g12_in = bssn->DIFFgamma12_a_pdata->getPointer();
-              double * g13_in = bssn->DIFFgamma13_a_pdata->getPointer();
-              double * g23_in = bssn->DIFFgamma23_a_pdata->getPointer();
-
-              double * A11_in = bssn->A11_a_pdata->getPointer();
-              double * A22_in = bssn->A22_a_pdata->getPointer();
-              double * A33_in = bssn->A33_a_pdata->getPointer();
-              double * A12_in = bssn->A12_a_pdata->getPointer();
-              double * A13_in = bssn->A13_a_pdata->getPointer();
-              double * A23_in = bssn->A23_a_pdata->getPointer();
-
-              double * K_in = bssn->DIFFK_a_pdata->getPointer();
-
-              double * chi_in = bssn->DIFFchi_a_pdata->getPointer();
-
-              
-              const void * local_interp_coords[DIM];
-
-              double local_x = x, local_y = y, local_z = z;
-              local_interp_coords[0] = (const void *) &local_x;
-              local_interp_coords[1] = (const void *) &local_y;
-              local_interp_coords[2] = (const void *) &local_z;
-              
-              const int input_array_dims[DIM] =
-                {upper[0] - lower[0] + 1 + 2 * GHOST_WIDTH,
-                 upper[1] - lower[1] + 1 + 2 * GHOST_WIDTH,
-                 upper[2] - lower[2] + 1 + 2 * GHOST_WIDTH};
-
-              const void * input_arrays[14];
-
-              input_arrays[0] = (const void *) g11_in;  
-              input_arrays[1] = (const void *) g12_in;  
-              input_arrays[2] = (const void *) g13_in;  
-              input_arrays[3] = (const void *) g22_in;  
-              input_arrays[4] = (const void *) g23_in;  
-              input_arrays[5] = (const void *) g33_in;  
-
-              input_arrays[6] = (const void *) A11_in;  
-              input_arrays[7] = (const void *) A12_in;  
-              input_arrays[8] = (const void *) A13_in;  
-              input_arrays[9] = (const void *) A22_in;  
-              input_arrays[10] = (const void *) A23_in;  
-              input_arrays[11] = (const void *) A33_in;  
-
-              input_arrays[12] = (const void *) K_in;
-              input_arrays[13] = (const void *) chi_in;
-
-              double K = 0, chi=0, d1chi=0, d2chi=0, d3chi = 0;
-
-              void * output_arrays[35];
-              output_arrays[0] = (void *) &g11;
-              output_arrays[1] = (void *) &d1g11;
-              output_arrays[2] = (void *) &d2g11;
-              output_arrays[3] = (void *) &d3g11;
-
-              output_arrays[4] = (void *) &g12;
-              output_arrays[5] = (void *) &d1g12;
-              output_arrays[6] = (void *) &d2g12;
-              output_arrays[7] = (void *) &d3g12;
-
-              output_arrays[8] = (void *) &g13;
-              output_arrays[9] = (void *) &d1g13;
-              output_arrays[10] = (void *) &d2g13;
-              output_arrays[11] = (void *) &d3g13;
-
-              output_arrays[12] = (void *) &g22;
-              output_arrays[13] = (void *) &d1g22;
-              output_arrays[14] = (void *) &d2g22;
-              output_arrays[15] = (void *) &d3g22;
-
-              output_arrays[16] = (void *) &g23;
-              output_arrays[17] = (void *) &d1g23;
-              output_arrays[18] = (void *) &d2g23;
-              output_arrays[19] = (void *) &d3g23;
-
-              output_arrays[20] = (void *) &g33;
-              output_arrays[21] = (void *) &d1g33;
-              output_arrays[22] = (void *) &d2g33;
-              output_arrays[23] = (void *) &d3g33;
-
-              output_arrays[24] = (void *) &K11;
-              output_arrays[25] = (void *) &K12;
-              output_arrays[26] = (void *) &K13;
-              output_arrays[27] = (void *) &K22;
-              output_arrays[28] = (void *) &K23;
-              output_arrays[29] = (void *) &K33;
-
-              output_arrays[30] = (void *) &K;
-
-              output_arrays[31] = (void *) &chi;
-              output_arrays[32] = (void *) &d1chi;
-              output_arrays[33] = (void *) &d2chi;
-              output_arrays[34] = (void *) &d3chi;
-
-              // const int input_array_strides[DIM] =
-              //   {1, input_array_dims[0], input_array_dims[0] * input_array_dims[1]};
-              // const int input_array_min_subscripts[DIM] =
-              //   {lower[0] - GHOST_WIDTH, lower[1] - GHOST_WIDTH, lower[2] - GHOST_WIDTH};
-
-              // const int input_array_max_subscripts[DIM] =
-              //   {upper[0] + GHOST_WIDTH, upper[1] + GHOST_WIDTH, upper[2] + GHOST_WIDTH};
-
-              // int offset = (lower[0] - GHOST_WIDTH) +
-              //   input_array_strides[1]* (lower[1] - GHOST_WIDTH)
-              //   + input_array_strides[2] * (lower[2] - GHOST_WIDTH);
-
-
-              // shift the point coordinate to match the index
-              local_x-= (lower[0] - GHOST_WIDTH ) * dx[0];
-              local_y-= (lower[1] - GHOST_WIDTH ) * dx[1];
-              local_z-= (lower[2] - GHOST_WIDTH ) * dx[2];
-              
-              // const CCTK_INT input_array_offsets[14] =
-              //   {-offset, -offset, -offset, -offset, -offset,
-              //    -offset, -offset, -offset, -offset, -offset,
-              //    -offset, -offset, -offset, -offset };
-
-              // if (Util_TableSetIntArray(param_table_handle,  
-              //                           DIM, input_array_strides,  
-              //                           "input_array_strides") < 0)
-              //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
-
-              // if (Util_TableSetIntArray(param_table_handle,  
-              //                           DIM, input_array_min_subscripts,  
-              //                           "input_array_min_subscripts") < 0)
-              //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
-
-              // if (Util_TableSetIntArray(param_table_handle,  
-              //                           DIM, input_array_max_subscripts,  
-              //                           "input_array_max_subscripts") < 0)
-              //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
-
-              // if (Util_TableSetIntArray(param_table_handle,  
-              //                           14, input_array_offsets,  
-              //                           "input_array_offsets") < 0)
-              //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
-
-              const double origin[DIM] = {dx[0]/2,dx[1]/2,dx[2]/2};
-              const double delta[DIM] = {dx[0], dx[1], dx[2]} ;
-
-
-              if (AEILocalInterp_U_Hermite(DIM,  
-                                          param_table_handle,  
-                                          origin, delta,  
-                                          1,  
-                                          CCTK_VARIABLE_REAL,  
-                                          local_interp_coords,  
-                                          14,  
-                                          input_array_dims,  
-                                          input_array_type_codes,  
-                                          input_arrays,  
-                                          35,  
-                                          output_array_type_codes,  
-                                          output_arrays) < 0)
-                                   error_exit(-1, "error return from interpolator!");
-
-
-              // calculate K from A and gamma
-
-              *(double *)output_arrays[31] += 1; // chi = DIFFchi + 1.0
-              *(double *)output_arrays[0] += 1; // g11 = DIFFgamma11 + 1.0
-              *(double *)output_arrays[12] += 1; // g11 = DIFFgamma11 + 1.0
-              *(double *)output_arrays[20] += 1; // g11 = DIFFgamma11 + 1.0
-              
-              for(int i = 24; i <= 29; i++ ) // restoring K_ij
-              {
-                *(double *)output_arrays[i] = 1.0 / pw2(*(double *)output_arrays[31]) *
-                  (*(double *)output_arrays[i] + (*(double *)output_arrays[4 * (i - 24)]) * (*(double *)output_arrays[30]) / 3.0);
-              }
-              
-              for(int i = 0; i<=20; i+=4)
-              {
-                *(double *)output_arrays[i + 1] = 1.0 / pw2(*(double *)output_arrays[31]) *
-                  (-2.0 * (*(double *)output_arrays[32]) * (*(double *)output_arrays[i]) / (*(double *)output_arrays[31])
-                   + (*(double *)output_arrays[i+1]));
-                *(double *)output_arrays[i + 2] = 1.0 / pw2(*(double *)output_arrays[31]) *
-                  (-2.0 * (*(double *)output_arrays[33]) * (*(double *)output_arrays[i]) / (*(double *)output_arrays[31])
-                   + (*(double *)output_arrays[i+2]));
-                *(double *)output_arrays[i + 3] = 1.0 / pw2(*(double *)output_arrays[31]) *
-                  (-2.0 * (*(double *)output_arrays[34]) * (*(double *)output_arrays[i]) / (*(double *)output_arrays[31])
-                   + (*(double *)output_arrays[i+3]));
-
-                *(double *)output_arrays[i] = 1.0 / pw2(*(double *)output_arrays[31]) * (*(double *)output_arrays[i]);
-
-              }
-#else
-              // doing tri-linear interpolation
-              bssn->initMDA(patch);
+  for(int n = 0; n < N_total_points; n++)
+  {
+    const CCTK_REAL x = all_coords[3 * n];
+    const CCTK_REAL y = all_coords[3 * n + 1];
+    const CCTK_REAL z = all_coords[3 * n + 2];
+
+    // same ordering as output_arrays[4] ... output_arrays[33]
+    fp * vals = &all_vals[N_GEOM_INTERP_VALS * n];
+    fp & g11 = vals[0];
+    fp & d1g11 = vals[1];
+    fp & d2g11 = vals[2];
+    fp & d3g11 = vals[3];
+    fp & g12 = vals[4];
+    fp & d1g12 = vals[5];
+    fp & d2g12 = vals[6];
+    fp & d3g12 = vals[7];
+    fp & g13 = vals[8];
+    fp & d1g13 = vals[9];
+    fp & d2g13 = vals[10];
+    fp & d3g13 = vals[11];
+    fp & g22 = vals[12];
+    fp & d1g22 = vals[13];
+    fp & d2g22 = vals[14];
+    fp & d3g22 = vals[15];
+    fp & g23 = vals[16];
+    fp & d1g23 = vals[17];
+    fp & d2g23 = vals[18];
+    fp & d3g23 = vals[19];
+    fp & g33 = vals[20];
+    fp & d1g33 = vals[21];
+    fp & d2g33 = vals[22];
+    fp & d3g33 = vals[23];
+    fp & K11 = vals[24];
+    fp & K12 = vals[25];
+    fp & K13 = vals[26];
+    fp & K22 = vals[27];
+    fp & K23 = vals[28];
+    fp & K33 = vals[29];
+
+    for (ln = ln_num - 1; ln >= 0; ln--)
+    {
+      std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+      hier::PatchLevel::iterator p(level->begin());
+      for (;p != level->end(); ++p)
+      {
+        const std::shared_ptr<hier::Patch>& patch = *p;
+        const hier::Box& box = patch->getBox();
 
-              BSSNData bd = {0};
-              
-              for(int k = k0; k <= k0 + 1; k++)
-              {
-                double z0 = domain_lower[2] + (double)k * dx[2] + dx[2]/2.0 ;
-                COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_MJ);
-                COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_KJ);
-                COSMO_APPLY_TO_IJK_PERMS(AHFD_DEFINE_TEMP_DMJ);
-                for(int j = j0; j <= j0 + 1; j++)
-                {
-                  double y0 = domain_lower[1] + (double)j * dx[1] + dx[1]/2.0 ;
-
-                  COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_MI);
-                  COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_KI);
-                  COSMO_APPLY_TO_IJK_PERMS(AHFD_DEFINE_TEMP_DMI);
-                  for(int i = i0; i <= i0 + 1; i++)
-                  {
-                    double x0 = domain_lower[0] + (double)i * dx[0] + dx[0]/2.0 ;
-                    bssn->set_bd_values(i, j, k, &bd, dx);
-                    COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_M_1);
-                    COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_K_1);
-                    COSMO_APPLY_TO_IJK_PERMS(AHFD_INTERPOLATE_DM_1);
-                  }
-                  COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_M_2);
-                  COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_K_2);
-                  COSMO_APPLY_TO_IJK_PERMS(AHFD_INTERPOLATE_DM_2);
-                }
-                COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_M_3);
-                COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_K_3);
-                COSMO_APPLY_TO_IJK_PERMS(AHFD_INTERPOLATE_DM_3);
+        const int * lower = &box.lower()[0];
+        const int * upper = &box.upper()[0];
+  
+        std::shared_ptr<geom::CartesianPatchGeometry> patch_geometry(
+          SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+            patch->getPatchGeometry()));
 
-              }
-#endif
 
-              break; 
-            }
+        const real_t * dx = &(patch_geometry->getDx())[0];
 
-          } // patch loop
-          if(p != level->end())
-            break;
-        } // level loop
+        int i0 = floor((x  - domain_lower[0] ) / dx[0] - 0.5);
+        int j0 = floor((y  - domain_lower[1] ) / dx[1] - 0.5);
+        int k0 = floor((z  - domain_lower[2] ) / dx[2] - 0.5);
 
-        if(state.N_procs > 1)
+        if( i0 >= lower[0] && i0 <= upper[0]
+            && j0 >= lower[1] && j0 <= upper[1]
+            && k0 >= lower[2] && k0 <= upper[2])
         {
-          mpi.AllReduce(&cur_mpi_level, 1, MPI_MAX);
+          owner_key[n] = ln * state.N_procs + state.my_proc;
+          bssn->initPData(patch);
+          
+#if USE_HERMITE_GEOM_INTERP
+          //***************************
+          // doing Hermite interpolation
+          double * g11_in = bssn->DIFFgamma11_a_pdata->getPointer();
+          double * g22_in = bssn->DIFFgamma22_a_pdata->getPointer();
+          double * g33_in = bssn->DIFFgamma33_a_pdata->getPointer();
+          double * g12_in = bssn->DIFFgamma12_a_pdata->getPointer();
+          double * g13_in = bssn->DIFFgamma13_a_pdata->getPointer();
+          double * g23_in = bssn->DIFFgamma23_a_pdata->getPointer();
+
+          double * A11_in = bssn->A11_a_pdata->getPointer();
+          double * A22_in = bssn->A22_a_pdata->getPointer();
+          double * A33_in = bssn->A33_a_pdata->getPointer();
+          double * A12_in = bssn->A12_a_pdata->getPointer();
+          double * A13_in = bssn->A13_a_pdata->getPointer();
+          double * A23_in = bssn->A23_a_pdata->getPointer();
+
+          double * K_in = bssn->DIFFK_a_pdata->getPointer();
+
+          double * chi_in = bssn->DIFFchi_a_pdata->getPointer();
+
+          
+          const void * local_interp_coords[DIM];
 
-          if(ln != cur_mpi_level)
-            cur_mpi_rank = -1;
+          double local_x = x, local_y = y, local_z = z;
+          local_interp_coords[0] = (const void *) &local_x;
+          local_interp_coords[1] = (const void *) &local_y;
+          local_interp_coords[2] = (const void *) &local_z;
           
-          mpi.AllReduce(&cur_mpi_rank, 1, MPI_MAX);
-          if(cur_mpi_rank == -1)
+          const int input_array_dims[DIM] =
+            {upper[0] - lower[0] + 1 + 2 * GHOST_WIDTH,
+             upper[1] - lower[1] + 1 + 2 * GHOST_WIDTH,
+             upper[2] - lower[2] + 1 + 2 * GHOST_WIDTH};
+
+          const void * input_arrays[14];
+
+          input_arrays[0] = (const void *) g11_in;  
+          input_arrays[1] = (const void *) g12_in;  
+          input_arrays[2] = (const void *) g13_in;  
+          input_arrays[3] = (const void *) g22_in;  
+          input_arrays[4] = (const void *) g23_in;  
+          input_arrays[5] = (const void *) g33_in;  
+
+          input_arrays[6] = (const void *) A11_in;  
+          input_arrays[7] = (const void *) A12_in;  
+          input_arrays[8] = (const void *) A13_in;  
+          input_arrays[9] = (const void *) A22_in;  
+          input_arrays[10] = (const void *) A23_in;  
+          input_arrays[11] = (const void *) A33_in;  
+
+          input_arrays[12] = (const void *) K_in;
+          input_arrays[13] = (const void *) chi_in;
+
+          double K = 0, chi=0, d1chi=0, d2chi=0, d3chi = 0;
+
+          void * output_arrays[35];
+          output_arrays[0] = (void *) &g11;
+          output_arrays[1] = (void *) &d1g11;
+          output_arrays[2] = (void *) &d2g11;
+          output_arrays[3] = (void *) &d3g11;
+
+          output_arrays[4] = (void *) &g12;
+          output_arrays[5] = (void *) &d1g12;
+          output_arrays[6] = (void *) &d2g12;
+          output_arrays[7] = (void *) &d3g12;
+
+          output_arrays[8] = (void *) &g13;
+          output_arrays[9] = (void *) &d1g13;
+          output_arrays[10] = (void *) &d2g13;
+          output_arrays[11] = (void *) &d3g13;
+
+          output_arrays[12] = (void *) &g22;
+          output_arrays[13] = (void *) &d1g22;
+          output_arrays[14] = (void *) &d2g22;
+          output_arrays[15] = (void *) &d3g22;
+
+          output_arrays[16] = (void *) &g23;
+          output_arrays[17] = (void *) &d1g23;
+          output_arrays[18] = (void *) &d2g23;
+          output_arrays[19] = (void *) &d3g23;
+
+          output_arrays[20] = (void *) &g33;
+          output_arrays[21] = (void *) &d1g33;
+          output_arrays[22] = (void *) &d2g33;
+          output_arrays[23] = (void *) &d3g33;
+
+          output_arrays[24] = (void *) &K11;
+          output_arrays[25] = (void *) &K12;
+          output_arrays[26] = (void *) &K13;
+          output_arrays[27] = (void *) &K22;
+          output_arrays[28] = (void *) &K23;
+          output_arrays[29] = (void *) &K33;
+
+          output_arrays[30] = (void *) &K;
+
+          output_arrays[31] = (void *) &chi;
+          output_arrays[32] = (void *) &d1chi;
+          output_arrays[33] = (void *) &d2chi;
+          output_arrays[34] = (void *) &d3chi;
+
+          // const int input_array_strides[DIM] =
+          //   {1, input_array_dims[0], input_array_dims[0] * input_array_dims[1]};
+          // const int input_array_min_subscripts[DIM] =
+          //   {lower[0] - GHOST_WIDTH, lower[1] - GHOST_WIDTH, lower[2] - GHOST_WIDTH};
+
+          // const int input_array_max_subscripts[DIM] =
+          //   {upper[0] + GHOST_WIDTH, upper[1] + GHOST_WIDTH, upper[2] + GHOST_WIDTH};
+
+          // int offset = (lower[0] - GHOST_WIDTH) +
+          //   input_array_strides[1]* (lower[1] - GHOST_WIDTH)
+          //   + input_array_strides[2] * (lower[2] - GHOST_WIDTH);
+
+
+          // shift the point coordinate to match the index
+          local_x-= (lower[0] - GHOST_WIDTH ) * dx[0];
+          local_y-= (lower[1] - GHOST_WIDTH ) * dx[1];
+          local_z-= (lower[2] - GHOST_WIDTH ) * dx[2];
+          
+          // const CCTK_INT input_array_offsets[14] =
+          //   {-offset, -offset, -offset, -offset, -offset,
+          //    -offset, -offset, -offset, -offset, -offset,
+          //    -offset, -offset, -offset, -offset };
+
+          // if (Util_TableSetIntArray(param_table_handle,  
+          //                           DIM, input_array_strides,  
+          //                           "input_array_strides") < 0)
+          //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
+
+          // if (Util_TableSetIntArray(param_table_handle,  
+          //                           DIM, input_array_min_subscripts,  
+          //                           "input_array_min_subscripts") < 0)
+          //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
+
+          // if (Util_TableSetIntArray(param_table_handle,  
+          //                           DIM, input_array_max_subscripts,  
+          //                           "input_array_max_subscripts") < 0)
+          //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
+
+          // if (Util_TableSetIntArray(param_table_handle,  
+          //                           14, input_array_offsets,  
+          //                           "input_array_offsets") < 0)
+          //   CCTK_WARN(-1, "can’t set operand_indices array in parameter table!");
+
+          const double origin[DIM] = {dx[0]/2,dx[1]/2,dx[2]/2};
+          const double delta[DIM] = {dx[0], dx[1], dx[2]} ;
+
+
+          if (AEILocalInterp_U_Hermite(DIM,  
+                                      param_table_handle,  
+                                      origin, delta,  
+                                      1,  
+                                      CCTK_VARIABLE_REAL,  
+                                      local_interp_coords,  
+                                      14,  
+                                      input_array_dims,  
+                                      input_array_type_codes,  
+                                      input_arrays,  
+                                      35,  
+                                      output_array_type_codes,  
+                                      output_arrays) < 0)
+                               error_exit(-1, "error return from interpolator!");
+
+
+          // calculate K from A and gamma
+
+          *(double *)output_arrays[31] += 1; // chi = DIFFchi + 1.0
+          *(double *)output_arrays[0] += 1; // g11 = DIFFgamma11 + 1.0
+          *(double *)output_arrays[12] += 1; // g11 = DIFFgamma11 + 1.0
+          *(double *)output_arrays[20] += 1; // g11 = DIFFgamma11 + 1.0
+          
+          for(int i = 24; i <= 29; i++ ) // restoring K_ij
           {
-            tbox::pout<<"Warning, cannot find patch that covers the point ("
-                      <<x<<","<<y<<","<<z<<")\n";
-            return -1;
+            *(double *)output_arrays[i] = 1.0 / pw2(*(double *)output_arrays[31]) *
+              (*(double *)output_arrays[i] + (*(double *)output_arrays[4 * (i - 24)]) * (*(double *)output_arrays[30]) / 3.0);
           }
           
-          //          std::cout<<"working on level: "<<cur_mpi_level<<"\n";
-          if(cur_mpi_rank != rank)
+          for(int i = 0; i<=20; i+=4)
           {
-            if(state.my_proc == cur_mpi_rank)
-            {
-              mpi.Send(&g11, 1, MPI_DOUBLE, rank, 1);
+            *(double *)output_arrays[i + 1] = 1.0 / pw2(*(double *)output_arrays[31]) *
+              (-2.0 * (*(double *)output_arrays[32]) * (*(double *)output_arrays[i]) / (*(double *)output_arrays[31])
+               + (*(double *)output_arrays[i+1]));
+            *(double *)output_arrays[i + 2] = 1.0 / pw2(*(double *)output_arrays[31]) *
+              (-2.0 * (*(double *)output_arrays[33]) * (*(double *)output_arrays[i]) / (*(double *)output_arrays[31])
+               + (*(double *)output_arrays[i+2]));
+            *(double *)output_arrays[i + 3] = 1.0 / pw2(*(double *)output_arrays[31]) *
+              (-2.0 * (*(double *)output_arrays[34]) * (*(double *)output_arrays[i]) / (*(double *)output_arrays[31])
+               + (*(double *)output_arrays[i+3]));
+
+            *(double *)output_arrays[i] = 1.0 / pw2(*(double *)output_arrays[31]) * (*(double *)output_arrays[i]);
 
-              mpi.Send(&g12, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&g13, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&g22, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&g23, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&g33, 1, MPI_DOUBLE, rank, 1);
-            
-              mpi.Send(&K11, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&K12, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&K13, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&K22, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&K23, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&K33, 1, MPI_DOUBLE, rank, 1);
-            
-              mpi.Send(&d1g11, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d1g12, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d1g13, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d1g22, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d1g23, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d1g33, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d2g11, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d2g12, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d2g13, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d2g22, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d2g23, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d2g33, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d3g11, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d3g12, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d3g13, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d3g22, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d3g23, 1, MPI_DOUBLE, rank, 1);
-              mpi.Send(&d3g33, 1, MPI_DOUBLE, rank, 1);
-            }
-            else if(state.my_proc == rank)
-            {
-              mpi.Recv(&g11, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
+          }
+#else
+          // doing tri-linear interpolation
+          bssn->initMDA(patch);
 
-              mpi.Recv(&g12, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&g13, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&g22, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&g23, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&g33, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-            
-              mpi.Recv(&K11, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&K12, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&K13, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&K22, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&K23, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&K33, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-            
-              mpi.Recv(&d1g11, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d1g12, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d1g13, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d1g22, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d1g23, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d1g33, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d2g11, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d2g12, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d2g13, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d2g22, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d2g23, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d2g33, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d3g11, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d3g12, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d3g13, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d3g22, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d3g23, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
-              mpi.Recv(&d3g33, 1, MPI_DOUBLE, cur_mpi_rank, 1, MPI_STATUS_IGNORE);
+          BSSNData bd = {0};
+          
+          for(int k = k0; k <= k0 + 1; k++)
+          {
+            double z0 = domain_lower[2] + (double)k * dx[2] + dx[2]/2.0 ;
+            COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_MJ);
+            COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_KJ);
+            COSMO_APPLY_TO_IJK_PERMS(AHFD_DEFINE_TEMP_DMJ);
+            for(int j = j0; j <= j0 + 1; j++)
+            {
+              double y0 = domain_lower[1] + (double)j * dx[1] + dx[1]/2.0 ;
 
+              COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_MI);
+              COSMO_APPLY_TO_IJ_PERMS(AHFD_DEFINE_TEMP_KI);
+              COSMO_APPLY_TO_IJK_PERMS(AHFD_DEFINE_TEMP_DMI);
+              for(int i = i0; i <= i0 + 1; i++)
+              {
+                double x0 = domain_lower[0] + (double)i * dx[0] + dx[0]/2.0 ;
+                bssn->set_bd_values(i, j, k, &bd, dx);
+                COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_M_1);
+                COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_K_1);
+                COSMO_APPLY_TO_IJK_PERMS(AHFD_INTERPOLATE_DM_1);
+              }
+              COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_M_2);
+              COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_K_2);
+              COSMO_APPLY_TO_IJK_PERMS(AHFD_INTERPOLATE_DM_2);
             }
-          }
+            COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_M_3);
+            COSMO_APPLY_TO_IJ_PERMS(AHFD_INTERPOLATE_K_3);
+            COSMO_APPLY_TO_IJK_PERMS(AHFD_INTERPOLATE_DM_3);
 
-          
+          }
+#endif
 
+          break; 
         }
-      }
+
+      } // patch loop
+      if(p != level->end())
+        break;
+    } // level loop
+  }
+
+  //**********************************************************************
+  // a single reduction decides the owners of all points
+  mpi.AllReduce(&owner_key[0], N_total_points, MPI_MAX);
+
+  for(int n = 0; n < N_total_points; n++)
+  {
+    if(owner_key[n] < 0)
+    {
+      tbox::pout<<"Warning, cannot find patch that covers the point ("
+                <<all_coords[3 * n]<<","<<all_coords[3 * n + 1]<<","
+                <<all_coords[3 * n + 2]<<")\n";
+      return -1;
     }
-    
-    mpi.Barrier();
-           
+  }
+
+  //**********************************************************************
+  // return the values of owned points to the requesting ranks in one
+  // all-to-all; both sides walk the points in the same order
+  std::vector<fp> send_buf;
+  std::vector<int> send_counts(state.N_procs, 0), send_displs(state.N_procs, 0);
+  std::vector<int> recv_counts(state.N_procs, 0), recv_displs(state.N_procs, 0);
 
+  for(rank = 0; rank < state.N_procs; rank++)
+  {
+    send_displs[rank] = send_buf.size();
+    for(int n = point_offsets[rank]; n < point_offsets[rank + 1]; n++)
+      if(owner_key[n] % state.N_procs == state.my_proc)
+        send_buf.insert(send_buf.end(),
+                        all_vals.begin() + N_GEOM_INTERP_VALS * n,
+                        all_vals.begin() + N_GEOM_INTERP_VALS * (n + 1));
+    send_counts[rank] = send_buf.size() - send_displs[rank];
+  }
+
+  for(int n = point_offsets[state.my_proc]; n < point_offsets[state.my_proc + 1]; n++)
+    recv_counts[owner_key[n] % state.N_procs] += N_GEOM_INTERP_VALS;
+
+  for(rank = 1; rank < state.N_procs; rank++)
+    recv_displs[rank] = recv_displs[rank - 1] + recv_counts[rank - 1];
+
+  std::vector<fp> recv_buf(N_GEOM_INTERP_VALS * N_interp_points);
+
+  MPI_Alltoallv(send_buf.data(), &send_counts[0], &send_displs[0], MPI_DOUBLE,
+                recv_buf.data(), &recv_counts[0], &recv_displs[0], MPI_DOUBLE,
+                mpi.getCommunicator());
+
+  for(int n = 0; n < N_interp_points; n++)
+  {
+    const int owner = owner_key[point_offsets[state.my_proc] + n] % state.N_procs;
+    const fp * vals = &recv_buf[recv_displs[owner]];
+    recv_displs[owner] += N_GEOM_INTERP_VALS;
+
+    for(int v = 0; v < N_GEOM_INTERP_VALS; v++)
+      ((fp *)output_arrays[4 + v])[n] = vals[v];
   }
-  
 
   return 1;
 }
@@ -22,6 +22,7 @@ HorizonStatistics::HorizonStatistics(
   w_idx(w_idx_in),
   invalid_id( hier::LocalId::getInvalidId(), tbox::SAMRAI_MPI::getInvalidRank()),
   non_zero_angular_momentum(cosmo_horizon_db->getBoolWithDefault("non_zero_angular_momentum", true)),
+  batch_killing_transport(cosmo_horizon_db->getBoolWithDefault("batch_killing_transport", false)),
   horizon(horizon_in)
 {
   std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
@@ -189,12 +190,6 @@ void HorizonStatistics::set_G_values(
   real_t x = r * cos(phi) * sin(theta);
   real_t y = r * sin(phi) * sin(theta);
   real_t z = r * cos(theta);
-        
-
-  real_t st = sin(theta);
-  real_t ct = cos(theta);
-  real_t sp = sin(phi);
-  real_t cp = cos(phi);
 
   for (ln = ln_num - 1; ln >= 0; ln--)
   {
@@ -233,8 +228,6 @@ void HorizonStatistics::set_G_values(
         
         bssn->initPData(patch);
         bssn->initMDA(patch);
-        
-        BSSNData bd = {0};
 
         real_t x0 = domain_lower[0] + (double)i0 * dx[0] + dx[0]/2.0 - coord_origin[0];
         real_t y0 = domain_lower[1] + (double)j0 * dx[1] + dx[1]/2.0 - coord_origin[1];
@@ -244,163 +237,9 @@ void HorizonStatistics::set_G_values(
         double yd = (y - y0) / dx[1];
         double zd = (z - z0) / dx[2];
 
-        
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_DEFINE_CRSPLINES_G);
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_DEFINE_CRSPLINES_M);
-        HORIZON_DEFINE_CRSPLINES_DCHI(1);
-        HORIZON_DEFINE_CRSPLINES_DCHI(2);
-        HORIZON_DEFINE_CRSPLINES_DCHI(3);
-        double a_R[64], f_R[64];
-        double a_chi[64], f_chi[64];
-
-        double d1chi, d2chi, d3chi;
-        
-        for(int i = 0; i < 4; i++)
-          for(int j = 0; j < 4; j++)
-            for(int k = 0; k < 4; k++)
-            {
-              bssn->set_bd_values(i0-1+i, j0-1+j, k0-1+k, &bd, dx);
-              COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_SET_F_G);
-              COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_SET_F_M);
-              HORIZON_CRSPLINES_SET_F_DCHI(1);
-              HORIZON_CRSPLINES_SET_F_DCHI(2);
-              HORIZON_CRSPLINES_SET_F_DCHI(3);
-              f_R[i*16 + j*4 + k] = bd.ricci;
-              f_chi[i*16 + j*4 + k] = bd.chi;
-            }
-
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_CAL_COEF_G);
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_COEF_M);
-        HORIZON_CRSPLINES_CAL_COEF_DCHI(1);
-        HORIZON_CRSPLINES_CAL_COEF_DCHI(2);
-        HORIZON_CRSPLINES_CAL_COEF_DCHI(3);
-        compute_tricubic_coeffs(a_R, f_R);
-        compute_tricubic_coeffs(a_chi, f_chi);
-        
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_EVAL_G);
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_EVAL_M);
-        HORIZON_CRSPLINES_EVAL_DCHI(1);
-        HORIZON_CRSPLINES_EVAL_DCHI(2);
-        HORIZON_CRSPLINES_EVAL_DCHI(3);
-        kd->R = evaluate_interpolation(a_R, xd, yd, zd);
-        kd->chi = evaluate_interpolation(a_chi, xd, yd, zd);
-
-        // order is important here!!!!!
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_M);
-
-        real_t det = kd->m11 * kd->m22 * kd->m33 + kd->m12 * kd->m23 * kd->m13
-          + kd->m12 * kd->m23 * kd->m13 - kd->m13 * kd->m22 * kd->m13
-          - kd->m12 * kd->m12 * kd->m33 - kd->m23 * kd->m23 * kd->m11;
-  
-        kd->mi11 = (kd->m22 * kd->m33 - pw2(kd->m23)) / det;
-        kd->mi22 = (kd->m11 * kd->m33 - pw2(kd->m13)) / det;
-        kd->mi33 = (kd->m11 * kd->m22 - pw2(kd->m12)) / det;
-        kd->mi12 = (kd->m13*kd->m23 - kd->m12*(kd->m33)) / det;
-        kd->mi13 = (kd->m12*kd->m23 - kd->m13*(kd->m22)) / det;
-        kd->mi23 = (kd->m12*kd->m13 - kd->m23*(kd->m11)) / det;
-        
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_CAL_G);
-
-          
-        G111[theta_i][phi_i] = ((pw2(x) + pw2(y))*z*(5*(pw2(x) + pw2(y)) - 
-                                                     pw2(z))*cos(2*theta) + 
-                                (pw2(x) + pw2(y))*(-(z*(3*(pw2(x) + pw2(y)) + 
-                                                        pw2(z))) + 4*(cp*x + sp*y)*(pw2(x) + pw2(y) - 
-                                                                                    pw2(z))*sin(2*theta)) + 
-                                2*pw2(ct)*z*(3*(pw2(x) + pw2(y)) + pw2(z))*((x - 
-                                                                             y)*(x + y)*cos(2*phi) + 2*x*y*sin(2*phi)) + 
-                                pw2(r)*(pw2(x) + 
-                                        pw2(y))*(4*pw2(cp)*pw2(ct)*x*z*kd->Gc111 + x*z*kd->Gc122 
-                                                 + x*z*cos(2*theta)*kd->Gc122 + 2*x*z*kd->Gc133 - 
-                                                 2*x*z*cos(2*theta)*kd->Gc133 + y*z*kd->Gc211 + 
-                                                 y*z*cos(2*theta)*kd->Gc211 + y*z*kd->Gc222 + 
-                                                 y*z*cos(2*theta)*kd->Gc222 + 2*y*z*kd->Gc233 - 
-                                                 2*y*z*cos(2*theta)*kd->Gc233 - pw2(x)*kd->Gc311 - 
-                                                 pw2(y)*kd->Gc311 - pw2(x)*cos(2*theta)*kd->Gc311 - 
-                                                 pw2(y)*cos(2*theta)*kd->Gc311 + 
-                                                 4*pw2(ct)*sin(2*phi)*(x*z*kd->Gc112 + y*z*kd->Gc212 - (pw2(x) 
-                                                                                                        + pw2(y))*kd->Gc312) + 
-                                                 4*cp*sin(2*theta)*(-(z*(x*kd->Gc113 + y*kd->Gc213)) + 
-                                                                    (pw2(x) + pw2(y))*kd->Gc313) - pw2(x)*kd->Gc322 - 
-                                                 pw2(y)*kd->Gc322 - pw2(x)*cos(2*theta)*kd->Gc322 - 
-                                                 pw2(y)*cos(2*theta)*kd->Gc322 - 
-                                                 2*pw2(ct)*cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + 
-                                                                       y*z*kd->Gc222 + pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - 
-                                                                       (pw2(x) + pw2(y))*kd->Gc322) + 
-                                                 4*sp*sin(2*theta)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
-                                                                    (pw2(x) + pw2(y))*kd->Gc323) - 4*pw2(st)*(pw2(x) + 
-                                                                                                              pw2(y))*kd->Gc333))/
-          (4.*pow(pw2(r),2.5)*pow((pw2(x) + 
-                                   pw2(y))/pw2(r),1.5));
- 
-        G122[theta_i][phi_i] = (pw2(st)*(z*((pw2(x) + pw2(y))*(pw2(x) + pw2(y) - 
-                                                               pw2(z)) - (3*(pw2(x) + pw2(y)) + pw2(z))*((x - y)*(x 
-                                                                                                                  + y)*cos(2*phi) + 2*x*y*sin(2*phi))) + 
-                                         pw2(r)*(pw2(x) + 
-                                                 pw2(y))*(2*pw2(sp)*x*z*kd->Gc111 + x*z*kd->Gc122 + 
-                                                          y*z*kd->Gc211 + y*z*kd->Gc222 - pw2(x)*kd->Gc311 - 
-                                                          pw2(y)*kd->Gc311 + 
-                                                          2*sin(2*phi)*(-(z*(x*kd->Gc112 + y*kd->Gc212)) + 
-                                                                        (pw2(x) + pw2(y))*kd->Gc312) - pw2(x)*kd->Gc322 - 
-                                                          pw2(y)*kd->Gc322 + 
-                                                          cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + y*z*kd->Gc222 + 
-                                                                      pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - (pw2(x) + 
-                                                                                                             pw2(y))*kd->Gc322))))/
-          (2.*pow(pw2(r),2.5)*pow((pw2(x) + 
-                                   pw2(y))/pw2(r),1.5));
-  
-
-        G112[theta_i][phi_i] = (2*(-(sp*x) + cp*y)*(pw2(x) + pw2(y))*(pw2(x) + 
-                                                                      pw2(y) - pw2(z)) + 2*(sp*x - cp*y)*(pw2(x) + 
-                                                                                                          pw2(y))*(pw2(x) + pw2(y) - pw2(z))*cos(2*theta) + 
-                                z*(3*(pw2(x) + pw2(y)) + 
-                                   pw2(z))*sin(2*theta)*(2*x*y*cos(2*phi) + (-pw2(x) + 
-                                                                             pw2(y))*sin(2*phi)) + 
-                                pw2(r)*(pw2(x) + 
-                                        pw2(y))*(2*cos(2*phi)*sin(2*theta)*(x*z*kd->Gc112 + y*z*kd->Gc212 
-                                                                            - (pw2(x) + pw2(y))*kd->Gc312) + 
-                                                 4*sp*pw2(st)*(x*z*kd->Gc113 + y*z*kd->Gc213 - (pw2(x) 
-                                                                                                + pw2(y))*kd->Gc313) + 
-                                                 sin(2*theta)*sin(2*phi)*(-(x*z*kd->Gc111) + x*z*kd->Gc122 - 
-                                                                          y*z*kd->Gc211 + y*z*kd->Gc222 + pw2(x)*kd->Gc311 + 
-                                                                          pw2(y)*kd->Gc311 - (pw2(x) + pw2(y))*kd->Gc322) + 
-                                                 4*cp*pw2(st)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
-                                                               (pw2(x) + 
-                                                                pw2(y))*kd->Gc323)))/(4.*pow(pw2(r),2.5)*pow((pw2(x) 
-                                                                                                              + pw2(y))/pw2(r),1.5));
-
-
-        G211[theta_i][phi_i] = (pw2(r)*(4*pw2(ct)*(-2*x*y*cos(2*phi) + (x - y)*(x + 
-                                                                                y)*sin(2*phi)) + (pw2(x) + pw2(y))*
-                                        (-4*pw2(cp)*pw2(ct)*y*kd->Gc111 - y*kd->Gc122 - 
-                                         y*cos(2*theta)*kd->Gc122 - 2*y*kd->Gc133 + 2*y*cos(2*theta)*kd->Gc133 
-                                         + x*kd->Gc211 + x*cos(2*theta)*kd->Gc211 + 
-                                         4*pw2(ct)*sin(2*phi)*(-(y*kd->Gc112) + x*kd->Gc212) + 
-                                         4*cp*sin(2*theta)*(y*kd->Gc113 - x*kd->Gc213) + 
-                                         2*pw2(ct)*cos(2*phi)*(y*kd->Gc122 + x*(kd->Gc211 - kd->Gc222)) + 
-                                         x*kd->Gc222 + 
-                                         x*cos(2*theta)*kd->Gc222 + 4*sp*sin(2*theta)*(y*kd->Gc123 - 
-                                                                                       x*kd->Gc223) + 2*x*kd->Gc233 - 
-                                         2*x*cos(2*theta)*kd->Gc233)))/(4.*pow(pw2(x) + pw2(y),2));
-
-
-        G212[theta_i][phi_i] = (pw2(r)*(2*sin(2*theta)*((x - y)*(x + y)*cos(2*phi) + 
-                                                        2*x*y*sin(2*phi)) + (pw2(x) + pw2(y))*
-                                        (2*cos(2*phi)*sin(2*theta)*(-(y*kd->Gc112) + x*kd->Gc212) + 
-                                         4*sp*pw2(st)*(-(y*kd->Gc113) + x*kd->Gc213) + 
-                                         sin(2*theta)*sin(2*phi)*(y*kd->Gc111 - y*kd->Gc122 + x*(-kd->Gc211 + 
-                                                                                                 kd->Gc222)) + 
-                                         4*cp*pw2(st)*(y*kd->Gc123 - 
-                                                       x*kd->Gc223))))/(4.*pow(pw2(x) + pw2(y),2));
-  
+        interpolate_kd_values(bssn, dx, i0, j0, k0, xd, yd, zd, kd);
 
-        G222[theta_i][phi_i] = (pw2(r)*pw2(st)*(4*x*y*cos(2*phi) + 2*(-pw2(x) + 
-                                                                      pw2(y))*sin(2*phi) - 
-                                                (pw2(x) + pw2(y))*(2*pw2(sp)*y*kd->Gc111 - 
-                                                                   2*y*sin(2*phi)*kd->Gc112 + y*kd->Gc122 + y*cos(2*phi)*kd->Gc122 - 
-                                                                   x*kd->Gc211 + x*cos(2*phi)*kd->Gc211 + 2*x*sin(2*phi)*kd->Gc212 - 
-                                                                   2*pw2(cp)*x*kd->Gc222)))/(2.*pow(pw2(x) + 
-                                                                                                    pw2(y),2));
+        set_G_values_local(theta, phi, theta_i, phi_i, r, kd);
 
         break;
       }
@@ -463,6 +302,219 @@ void HorizonStatistics::set_kd_values(
   real_t y = r * sin(phi) * sin(theta);
   real_t z = r * cos(theta);
         
+  for (ln = ln_num - 1; ln >= 0; ln--)
+  {
+    std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+    hier::PatchLevel::iterator p(level->begin());
+    for (;p != level->end(); ++p)
+    {
+      const std::shared_ptr<hier::Patch>& patch = *p;
+      const hier::Box& box = patch->getBox();
+
+      const int * lower = &box.lower()[0];
+      const int * upper = &box.upper()[0];
+      
+      std::shared_ptr<geom::CartesianPatchGeometry> patch_geometry(
+        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+          patch->getPatchGeometry()));
+
+
+      const real_t * dx = &(patch_geometry->getDx())[0];
+      int i0 = floor((x + coord_origin[0] - domain_lower[0] ) / dx[0] - 0.5);
+      int j0 = floor((y + coord_origin[1] - domain_lower[1] ) / dx[1] - 0.5);
+      int k0 = floor((z + coord_origin[2] - domain_lower[2] ) / dx[2] - 0.5);
+
+      
+      if( i0 >= lower[0] && i0 <= upper[0]
+          && j0 >= lower[1] && j0 <= upper[1]
+          && k0 >= lower[2] && k0 <= upper[2])
+      {
+        cur_mpi_rank = mpi.getRank();
+
+        cur_mpi_level = ln;
+        
+
+        bssn->initPData(patch);
+        bssn->initMDA(patch);
+
+        real_t x0 = domain_lower[0] + (double)i0 * dx[0] + dx[0]/2.0 - coord_origin[0];
+        real_t y0 = domain_lower[1] + (double)j0 * dx[1] + dx[1]/2.0 - coord_origin[1];
+        real_t z0 = domain_lower[2] + (double)k0 * dx[2] + dx[2]/2.0 - coord_origin[2];
+
+        double xd = (x - x0) / dx[0];
+        double yd = (y - y0) / dx[1];
+        double zd = (z - z0) / dx[2];
+
+        interpolate_kd_values(bssn, dx, i0, j0, k0, xd, yd, zd, kd);
+
+        set_kd_values_local(theta, phi, theta_i, phi_i, r, kd);
+
+        break;
+      }
+    }
+    if(p != level->end())
+      break;
+
+  }
+
+  mpi.Barrier();
+
+  if (mpi.getSize() > 1)
+  {
+    mpi.AllReduce(&cur_mpi_level, 1, MPI_MAX);
+  }
+  mpi.Barrier();
+
+  if(mpi.getSize() > 1 && ln != cur_mpi_level)
+  {
+    cur_mpi_rank = -1;
+  }
+
+  
+  mpi.Barrier();
+
+  if (mpi.getSize() > 1)
+  {
+    mpi.AllReduce(&cur_mpi_rank, 1, MPI_MAX);
+  }
+  mpi.Barrier();
+  
+  if(cur_mpi_rank == -1)
+    TBOX_ERROR("Cannot find proper patch in set bd values\n");
+
+}
+
+/**
+ * @brief set G111 ... G222 at (theta_i, phi_i) from the metric data already
+ *        interpolated to the point
+ * @details kd needs Gc and m, no communication is done here
+ */
+void HorizonStatistics::set_G_values_local(
+  double theta, double phi, int theta_i, int phi_i, double r, KillingData *kd)
+{
+  real_t x = r * cos(phi) * sin(theta);
+  real_t y = r * sin(phi) * sin(theta);
+  real_t z = r * cos(theta);
+
+  real_t st = sin(theta);
+  real_t ct = cos(theta);
+  real_t sp = sin(phi);
+  real_t cp = cos(phi);
+
+  G111[theta_i][phi_i] = ((pw2(x) + pw2(y))*z*(5*(pw2(x) + pw2(y)) - 
+                                               pw2(z))*cos(2*theta) + 
+                          (pw2(x) + pw2(y))*(-(z*(3*(pw2(x) + pw2(y)) + 
+                                                  pw2(z))) + 4*(cp*x + sp*y)*(pw2(x) + pw2(y) - 
+                                                                              pw2(z))*sin(2*theta)) + 
+                          2*pw2(ct)*z*(3*(pw2(x) + pw2(y)) + pw2(z))*((x - 
+                                                                       y)*(x + y)*cos(2*phi) + 2*x*y*sin(2*phi)) + 
+                          pw2(r)*(pw2(x) + 
+                                  pw2(y))*(4*pw2(cp)*pw2(ct)*x*z*kd->Gc111 + x*z*kd->Gc122 
+                                           + x*z*cos(2*theta)*kd->Gc122 + 2*x*z*kd->Gc133 - 
+                                           2*x*z*cos(2*theta)*kd->Gc133 + y*z*kd->Gc211 + 
+                                           y*z*cos(2*theta)*kd->Gc211 + y*z*kd->Gc222 + 
+                                           y*z*cos(2*theta)*kd->Gc222 + 2*y*z*kd->Gc233 - 
+                                           2*y*z*cos(2*theta)*kd->Gc233 - pw2(x)*kd->Gc311 - 
+                                           pw2(y)*kd->Gc311 - pw2(x)*cos(2*theta)*kd->Gc311 - 
+                                           pw2(y)*cos(2*theta)*kd->Gc311 + 
+                                           4*pw2(ct)*sin(2*phi)*(x*z*kd->Gc112 + y*z*kd->Gc212 - (pw2(x) 
+                                                                                                  + pw2(y))*kd->Gc312) + 
+                                           4*cp*sin(2*theta)*(-(z*(x*kd->Gc113 + y*kd->Gc213)) + 
+                                                              (pw2(x) + pw2(y))*kd->Gc313) - pw2(x)*kd->Gc322 - 
+                                           pw2(y)*kd->Gc322 - pw2(x)*cos(2*theta)*kd->Gc322 - 
+                                           pw2(y)*cos(2*theta)*kd->Gc322 - 
+                                           2*pw2(ct)*cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + 
+                                                                 y*z*kd->Gc222 + pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - 
+                                                                 (pw2(x) + pw2(y))*kd->Gc322) + 
+                                           4*sp*sin(2*theta)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
+                                                              (pw2(x) + pw2(y))*kd->Gc323) - 4*pw2(st)*(pw2(x) + 
+                                                                                                        pw2(y))*kd->Gc333))/
+    (4.*pow(pw2(r),2.5)*pow((pw2(x) + 
+                             pw2(y))/pw2(r),1.5));
+
+  G122[theta_i][phi_i] = (pw2(st)*(z*((pw2(x) + pw2(y))*(pw2(x) + pw2(y) - 
+                                                         pw2(z)) - (3*(pw2(x) + pw2(y)) + pw2(z))*((x - y)*(x 
+                                                                                                            + y)*cos(2*phi) + 2*x*y*sin(2*phi))) + 
+                                   pw2(r)*(pw2(x) + 
+                                           pw2(y))*(2*pw2(sp)*x*z*kd->Gc111 + x*z*kd->Gc122 + 
+                                                    y*z*kd->Gc211 + y*z*kd->Gc222 - pw2(x)*kd->Gc311 - 
+                                                    pw2(y)*kd->Gc311 + 
+                                                    2*sin(2*phi)*(-(z*(x*kd->Gc112 + y*kd->Gc212)) + 
+                                                                  (pw2(x) + pw2(y))*kd->Gc312) - pw2(x)*kd->Gc322 - 
+                                                    pw2(y)*kd->Gc322 + 
+                                                    cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + y*z*kd->Gc222 + 
+                                                                pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - (pw2(x) + 
+                                                                                                       pw2(y))*kd->Gc322))))/
+    (2.*pow(pw2(r),2.5)*pow((pw2(x) + 
+                             pw2(y))/pw2(r),1.5));
+
+
+  G112[theta_i][phi_i] = (2*(-(sp*x) + cp*y)*(pw2(x) + pw2(y))*(pw2(x) + 
+                                                                pw2(y) - pw2(z)) + 2*(sp*x - cp*y)*(pw2(x) + 
+                                                                                                    pw2(y))*(pw2(x) + pw2(y) - pw2(z))*cos(2*theta) + 
+                          z*(3*(pw2(x) + pw2(y)) + 
+                             pw2(z))*sin(2*theta)*(2*x*y*cos(2*phi) + (-pw2(x) + 
+                                                                       pw2(y))*sin(2*phi)) + 
+                          pw2(r)*(pw2(x) + 
+                                  pw2(y))*(2*cos(2*phi)*sin(2*theta)*(x*z*kd->Gc112 + y*z*kd->Gc212 
+                                                                      - (pw2(x) + pw2(y))*kd->Gc312) + 
+                                           4*sp*pw2(st)*(x*z*kd->Gc113 + y*z*kd->Gc213 - (pw2(x) 
+                                                                                          + pw2(y))*kd->Gc313) + 
+                                           sin(2*theta)*sin(2*phi)*(-(x*z*kd->Gc111) + x*z*kd->Gc122 - 
+                                                                    y*z*kd->Gc211 + y*z*kd->Gc222 + pw2(x)*kd->Gc311 + 
+                                                                    pw2(y)*kd->Gc311 - (pw2(x) + pw2(y))*kd->Gc322) + 
+                                           4*cp*pw2(st)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
+                                                         (pw2(x) + 
+                                                          pw2(y))*kd->Gc323)))/(4.*pow(pw2(r),2.5)*pow((pw2(x) 
+                                                                                                        + pw2(y))/pw2(r),1.5));
+
+
+  G211[theta_i][phi_i] = (pw2(r)*(4*pw2(ct)*(-2*x*y*cos(2*phi) + (x - y)*(x + 
+                                                                          y)*sin(2*phi)) + (pw2(x) + pw2(y))*
+                                  (-4*pw2(cp)*pw2(ct)*y*kd->Gc111 - y*kd->Gc122 - 
+                                   y*cos(2*theta)*kd->Gc122 - 2*y*kd->Gc133 + 2*y*cos(2*theta)*kd->Gc133 
+                                   + x*kd->Gc211 + x*cos(2*theta)*kd->Gc211 + 
+                                   4*pw2(ct)*sin(2*phi)*(-(y*kd->Gc112) + x*kd->Gc212) + 
+                                   4*cp*sin(2*theta)*(y*kd->Gc113 - x*kd->Gc213) + 
+                                   2*pw2(ct)*cos(2*phi)*(y*kd->Gc122 + x*(kd->Gc211 - kd->Gc222)) + 
+                                   x*kd->Gc222 + 
+                                   x*cos(2*theta)*kd->Gc222 + 4*sp*sin(2*theta)*(y*kd->Gc123 - 
+                                                                                 x*kd->Gc223) + 2*x*kd->Gc233 - 
+                                   2*x*cos(2*theta)*kd->Gc233)))/(4.*pow(pw2(x) + pw2(y),2));
+
+
+  G212[theta_i][phi_i] = (pw2(r)*(2*sin(2*theta)*((x - y)*(x + y)*cos(2*phi) + 
+                                                  2*x*y*sin(2*phi)) + (pw2(x) + pw2(y))*
+                                  (2*cos(2*phi)*sin(2*theta)*(-(y*kd->Gc112) + x*kd->Gc212) + 
+                                   4*sp*pw2(st)*(-(y*kd->Gc113) + x*kd->Gc213) + 
+                                   sin(2*theta)*sin(2*phi)*(y*kd->Gc111 - y*kd->Gc122 + x*(-kd->Gc211 + 
+                                                                                           kd->Gc222)) + 
+                                   4*cp*pw2(st)*(y*kd->Gc123 - 
+                                                 x*kd->Gc223))))/(4.*pow(pw2(x) + pw2(y),2));
+
+
+  G222[theta_i][phi_i] = (pw2(r)*pw2(st)*(4*x*y*cos(2*phi) + 2*(-pw2(x) + 
+                                                                pw2(y))*sin(2*phi) - 
+                                          (pw2(x) + pw2(y))*(2*pw2(sp)*y*kd->Gc111 - 
+                                                             2*y*sin(2*phi)*kd->Gc112 + y*kd->Gc122 + y*cos(2*phi)*kd->Gc122 - 
+                                                             x*kd->Gc211 + x*cos(2*phi)*kd->Gc211 + 2*x*sin(2*phi)*kd->Gc212 - 
+                                                             2*pw2(cp)*x*kd->Gc222)))/(2.*pow(pw2(x) + 
+                                                                                              pw2(y),2));
+}
+
+/**
+ * @brief set the surface metric, its Christoffel symbols and Ricci scalar
+ *        from the metric data already interpolated to the point
+ * @details kd needs Gc, m and mi; the G111 ... G222 arrays and ah_radius
+ * have to be set. No communication is done here
+ */
+void HorizonStatistics::set_kd_values_local(
+  double theta, double phi, int theta_i, int phi_i, double r, KillingData *kd)
+{
+  real_t x = r * cos(phi) * sin(theta);
+  real_t y = r * sin(phi) * sin(theta);
+  real_t z = r * cos(theta);
+
   real_t st = sin(theta);
   real_t ct = cos(theta);
   real_t sp = sin(phi);
@@ -499,316 +551,477 @@ void HorizonStatistics::set_kd_values(
   Phi[1] = (l[1] * (l[0]*d2h - l[1] * d1h) + l[0]) / sqrt(1 - l[2] * l[2]);
 
   Phi[2] = l[2] * (l[0] * d2h - l[1] * d1h)  / sqrt(1 - l[2] * l[2]);
+
+  kd->q11 = pw2(r) * (
+    kd->m11 * Theta[0] * Theta[0] + 2.0 * kd->m12 * Theta[0] * Theta[1]
+    + 2.0 * kd->m13 * Theta[0] * Theta[2] + kd->m22 * Theta[1] * Theta[1]
+    + 2.0 * kd->m23 * Theta[1] * Theta[2] + kd->m33 * Theta[2] * Theta[2]);
+
+  kd->q12 = 2.0 * st * pw2(r) * (
+    kd->m11 * Theta[0] * Phi[0] + kd->m12 * Theta[0] * Phi[1]
+    + kd->m12 * Theta[1] * Phi[0] + kd->m13 * Theta[0] * Phi[2]
+    + kd->m13 * Theta[2] * Phi[0] + kd->m22 * Theta[1] * Phi[1]
+    + kd->m23 * Theta[1] * Phi[2] + kd->m23 * Theta[2] * Phi[1]
+    +  kd->m33 * Theta[2] * Phi[2]);
+
+  kd->q22 = pw2(r * st) * (
+    kd->m11 * Phi[0] * Phi[0] + 2.0 * kd->m12 * Phi[0] * Phi[1]
+    + 2.0 * kd->m13 * Phi[0] * Phi[2] + kd->m22 * Phi[1] * Phi[1]
+    + 2.0 * kd->m23 * Phi[1] * Phi[2] + kd->m33 * Phi[2] * Phi[2]);
   
-  for (ln = ln_num - 1; ln >= 0; ln--)
+  // kd->q11 = pw2(r)*(ct*(pw2(cp)*ct*kd->m11
+  //                       + ct*sin(2*phi)*kd->m12
+  //                       + ct*pw2(sp)*kd->m22
+  //                       - 2*st*(cp*kd->m13 + sp*kd->m23)) + pw2(st)*kd->m33);
+
+
+  // kd->q12 = pw2(r)*st*(ct*cos(2*phi)*kd->m12
+  //                      + sp*st*kd->m13
+  //                      + cp*ct*sp*(-kd->m11 + kd->m22) - cp*st*kd->m23);
+
+  // kd->q22 = pw2(r)*pw2(st)*(pw2(sp)*kd->m11 + cp*(-2*sp*kd->m12 + cp*kd->m22));
+
+  // std::cout<<ct*cos(2*phi)*kd->m12<<" "<<
+  //   sp*st*kd->m13<<" "<<cp*ct*sp*(-kd->m11 + kd->m22)<<" "
+  //          <<- cp*st*kd->m23<<"\n";
+  //        std::cout<<fabs(kd->q11 - q11) / q11<<" "<<q12<<" "<<kd->q12
+  //       <<" "<<fabs(kd->q22 - q22) / q22<<"\n";
+  
+  kd->Gs111 = ((pw2(x) + pw2(y))*z*(5*(pw2(x) + pw2(y)) - 
+                                    pw2(z))*cos(2*theta) + 
+               (pw2(x) + pw2(y))*(-(z*(3*(pw2(x) + pw2(y)) + 
+                                       pw2(z))) + 4*(cp*x + sp*y)*(pw2(x) + pw2(y) - 
+                                                                   pw2(z))*sin(2*theta)) + 
+               2*pw2(ct)*z*(3*(pw2(x) + pw2(y)) + pw2(z))*((x - 
+                                                            y)*(x + y)*cos(2*phi) + 2*x*y*sin(2*phi)) + 
+               pw2(r)*(pw2(x) + 
+                       pw2(y))*(4*pw2(cp)*pw2(ct)*x*z*kd->Gc111 + x*z*kd->Gc122 
+                                + x*z*cos(2*theta)*kd->Gc122 + 2*x*z*kd->Gc133 - 
+                                2*x*z*cos(2*theta)*kd->Gc133 + y*z*kd->Gc211 + 
+                                y*z*cos(2*theta)*kd->Gc211 + y*z*kd->Gc222 + 
+                                y*z*cos(2*theta)*kd->Gc222 + 2*y*z*kd->Gc233 - 
+                                2*y*z*cos(2*theta)*kd->Gc233 - pw2(x)*kd->Gc311 - 
+                                pw2(y)*kd->Gc311 - pw2(x)*cos(2*theta)*kd->Gc311 - 
+                                pw2(y)*cos(2*theta)*kd->Gc311 + 
+                                4*pw2(ct)*sin(2*phi)*(x*z*kd->Gc112 + y*z*kd->Gc212 - (pw2(x) 
+                                                                                       + pw2(y))*kd->Gc312) + 
+                                4*cp*sin(2*theta)*(-(z*(x*kd->Gc113 + y*kd->Gc213)) + 
+                                                   (pw2(x) + pw2(y))*kd->Gc313) - pw2(x)*kd->Gc322 - 
+                                pw2(y)*kd->Gc322 - pw2(x)*cos(2*theta)*kd->Gc322 - 
+                                pw2(y)*cos(2*theta)*kd->Gc322 - 
+                                2*pw2(ct)*cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + 
+                                                      y*z*kd->Gc222 + pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - 
+                                                      (pw2(x) + pw2(y))*kd->Gc322) + 
+                                4*sp*sin(2*theta)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
+                                                   (pw2(x) + pw2(y))*kd->Gc323) - 4*pw2(st)*(pw2(x) + 
+                                                                                             pw2(y))*kd->Gc333))/
+    (4.*pow(pw2(r),2.5)*pow((pw2(x) + 
+                             pw2(y))/pw2(r),1.5));
+
+  kd->Gs122 = (pw2(st)*(z*((pw2(x) + pw2(y))*(pw2(x) + pw2(y) - 
+                                              pw2(z)) - (3*(pw2(x) + pw2(y)) + pw2(z))*((x - y)*(x 
+                                                                                                 + y)*cos(2*phi) + 2*x*y*sin(2*phi))) + 
+                        pw2(r)*(pw2(x) + 
+                                pw2(y))*(2*pw2(sp)*x*z*kd->Gc111 + x*z*kd->Gc122 + 
+                                         y*z*kd->Gc211 + y*z*kd->Gc222 - pw2(x)*kd->Gc311 - 
+                                         pw2(y)*kd->Gc311 + 
+                                         2*sin(2*phi)*(-(z*(x*kd->Gc112 + y*kd->Gc212)) + 
+                                                       (pw2(x) + pw2(y))*kd->Gc312) - pw2(x)*kd->Gc322 - 
+                                         pw2(y)*kd->Gc322 + 
+                                         cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + y*z*kd->Gc222 + 
+                                                     pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - (pw2(x) + 
+                                                                                            pw2(y))*kd->Gc322))))/
+    (2.*pow(pw2(r),2.5)*pow((pw2(x) + 
+                             pw2(y))/pw2(r),1.5));
+
+
+  kd->Gs112 = (2*(-(sp*x) + cp*y)*(pw2(x) + pw2(y))*(pw2(x) + 
+                                                     pw2(y) - pw2(z)) + 2*(sp*x - cp*y)*(pw2(x) + 
+                                                                                         pw2(y))*(pw2(x) + pw2(y) - pw2(z))*cos(2*theta) + 
+               z*(3*(pw2(x) + pw2(y)) + 
+                  pw2(z))*sin(2*theta)*(2*x*y*cos(2*phi) + (-pw2(x) + 
+                                                            pw2(y))*sin(2*phi)) + 
+               pw2(r)*(pw2(x) + 
+                       pw2(y))*(2*cos(2*phi)*sin(2*theta)*(x*z*kd->Gc112 + y*z*kd->Gc212 
+                                                           - (pw2(x) + pw2(y))*kd->Gc312) + 
+                                4*sp*pw2(st)*(x*z*kd->Gc113 + y*z*kd->Gc213 - (pw2(x) 
+                                                                               + pw2(y))*kd->Gc313) + 
+                                sin(2*theta)*sin(2*phi)*(-(x*z*kd->Gc111) + x*z*kd->Gc122 - 
+                                                         y*z*kd->Gc211 + y*z*kd->Gc222 + pw2(x)*kd->Gc311 + 
+                                                         pw2(y)*kd->Gc311 - (pw2(x) + pw2(y))*kd->Gc322) + 
+                                4*cp*pw2(st)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
+                                              (pw2(x) + 
+                                               pw2(y))*kd->Gc323)))/(4.*pow(pw2(r),2.5)*pow((pw2(x) 
+                                                                                             + pw2(y))/pw2(r),1.5));
+
+
+  kd->Gs211 = (pw2(r)*(4*pw2(ct)*(-2*x*y*cos(2*phi) + (x - y)*(x + 
+                                                               y)*sin(2*phi)) + (pw2(x) + pw2(y))*
+                       (-4*pw2(cp)*pw2(ct)*y*kd->Gc111 - y*kd->Gc122 - 
+                        y*cos(2*theta)*kd->Gc122 - 2*y*kd->Gc133 + 2*y*cos(2*theta)*kd->Gc133 
+                        + x*kd->Gc211 + x*cos(2*theta)*kd->Gc211 + 
+                        4*pw2(ct)*sin(2*phi)*(-(y*kd->Gc112) + x*kd->Gc212) + 
+                        4*cp*sin(2*theta)*(y*kd->Gc113 - x*kd->Gc213) + 
+                        2*pw2(ct)*cos(2*phi)*(y*kd->Gc122 + x*(kd->Gc211 - kd->Gc222)) + 
+                        x*kd->Gc222 + 
+                        x*cos(2*theta)*kd->Gc222 + 4*sp*sin(2*theta)*(y*kd->Gc123 - 
+                                                                      x*kd->Gc223) + 2*x*kd->Gc233 - 
+                        2*x*cos(2*theta)*kd->Gc233)))/(4.*pow(pw2(x) + pw2(y),2));
+
+
+  kd->Gs212 = (pw2(r)*(2*sin(2*theta)*((x - y)*(x + y)*cos(2*phi) + 
+                                       2*x*y*sin(2*phi)) + (pw2(x) + pw2(y))*
+                       (2*cos(2*phi)*sin(2*theta)*(-(y*kd->Gc112) + x*kd->Gc212) + 
+                        4*sp*pw2(st)*(-(y*kd->Gc113) + x*kd->Gc213) + 
+                        sin(2*theta)*sin(2*phi)*(y*kd->Gc111 - y*kd->Gc122 + x*(-kd->Gc211 + 
+                                                                                kd->Gc222)) + 
+                        4*cp*pw2(st)*(y*kd->Gc123 - 
+                                      x*kd->Gc223))))/(4.*pow(pw2(x) + pw2(y),2));
+
+
+  kd->Gs222 = (pw2(r)*pw2(st)*(4*x*y*cos(2*phi) + 2*(-pw2(x) + 
+                                                     pw2(y))*sin(2*phi) - 
+                               (pw2(x) + pw2(y))*(2*pw2(sp)*y*kd->Gc111 - 
+                                                  2*y*sin(2*phi)*kd->Gc112 + y*kd->Gc122 + y*cos(2*phi)*kd->Gc122 - 
+                                                  x*kd->Gc211 + x*cos(2*phi)*kd->Gc211 + 2*x*sin(2*phi)*kd->Gc212 - 
+                                                  2*pw2(cp)*x*kd->Gc222)))/(2.*pow(pw2(x) + 
+                                                                                   pw2(y),2));
+
+  real_t det = kd->q11 * kd->q22 - kd->q12 * kd->q12;
+
+
+  kd->qi11 = kd->q22 / det;
+  kd->qi12 = -kd->q12 / det;
+  kd->qi22 =  kd->q11 / det;
+
+
+  kd->R11 = HORIZON_CALCULATE_D1G(1,1,1)
+    + HORIZON_CALCULATE_D2G(2,1,1)
+    - HORIZON_CALCULATE_D1G(1,1,1)
+    - HORIZON_CALCULATE_D1G(2,2,1)
+    + (kd->Gs111 * kd->Gs111 + kd->Gs221 * kd->Gs111
+       + kd->Gs112 * kd->Gs211 + kd->Gs222 * kd->Gs211)
+    - (kd->Gs111 * kd->Gs111 + kd->Gs112 * kd->Gs211
+       + kd->Gs211 * kd->Gs121 + kd->Gs212 * kd->Gs221);
+
+  kd->R12 = HORIZON_CALCULATE_D1G(1,1,2)
+    + HORIZON_CALCULATE_D2G(2,1,2)
+    - HORIZON_CALCULATE_D2G(1,1,1)
+    - HORIZON_CALCULATE_D2G(2,2,1)
+    + (kd->Gs111 * kd->Gs112 + kd->Gs221 * kd->Gs112
+       + kd->Gs112 * kd->Gs212 + kd->Gs222 * kd->Gs212)
+    - (kd->Gs121 * kd->Gs121 + kd->Gs122 * kd->Gs211
+       + kd->Gs221 * kd->Gs121 + kd->Gs222 * kd->Gs221);
+
+  kd->R22 = HORIZON_CALCULATE_D1G(1,2,2)
+    + HORIZON_CALCULATE_D2G(2,2,2)
+    - HORIZON_CALCULATE_D2G(1,1,2)
+    - HORIZON_CALCULATE_D2G(2,2,2)
+    + (kd->Gs111 * kd->Gs122 + kd->Gs221 * kd->Gs122
+       + kd->Gs112 * kd->Gs222 + kd->Gs222 * kd->Gs222)
+    - (kd->Gs121 * kd->Gs122 + kd->Gs122 * kd->Gs212
+       + kd->Gs221 * kd->Gs122 + kd->Gs222 * kd->Gs222);
+
+  kd->R = kd->qi11 * kd->R11 + kd->qi12 * kd->R12 * 2.0
+    + kd->qi22 * kd->R22;
+}
+
+/**
+ * @brief interpolate the metric data at a point with tricubic splines
+ * @details sets Gc, m, mi, K_ij, K, chi and R (3D Ricci scalar) of kd
+ * from the patch BSSN is initialized with; thread safe
+ *
+ * @param bssn
+ * @param dx grid spacing of the patch
+ * @param i0 index of the cell below the point
+ * @param j0
+ * @param k0
+ * @param xd offset of the point from cell (i0, j0, k0) in units of dx
+ * @param yd
+ * @param zd
+ * @param kd data to fill
+ */
+void HorizonStatistics::interpolate_kd_values(
+  BSSN * bssn, const real_t dx[], int i0, int j0, int k0,
+  double xd, double yd, double zd, KillingData *kd)
+{
+  BSSNData bd = {0};
+
+  COSMO_APPLY_TO_IJK_PERMS(HORIZON_DEFINE_CRSPLINES_G);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_DEFINE_CRSPLINES_M);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_DEFINE_CRSPLINES_K);
+  HORIZON_DEFINE_CRSPLINES_DCHI(1);
+  HORIZON_DEFINE_CRSPLINES_DCHI(2);
+  HORIZON_DEFINE_CRSPLINES_DCHI(3);
+  double a_R[64], f_R[64];
+  double a_chi[64], f_chi[64];
+  double a_K[64], f_K[64];
+
+  double d1chi, d2chi, d3chi;
+
+  for(int i = 0; i < 4; i++)
+    for(int j = 0; j < 4; j++)
+      for(int k = 0; k < 4; k++)
+      {
+        bssn->set_bd_values(i0-1+i, j0-1+j, k0-1+k, &bd, dx);
+        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_SET_F_G);
+        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_SET_F_M);
+        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_SET_F_K);
+        HORIZON_CRSPLINES_SET_F_DCHI(1);
+        HORIZON_CRSPLINES_SET_F_DCHI(2);
+        HORIZON_CRSPLINES_SET_F_DCHI(3);
+        f_R[i*16 + j*4 + k] = bd.ricci;
+        f_chi[i*16 + j*4 + k] = bd.chi;
+        f_K[i*16 + j*4 + k] = bd.K;
+      }
+
+  COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_CAL_COEF_G);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_COEF_M);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_COEF_K);
+  HORIZON_CRSPLINES_CAL_COEF_DCHI(1);
+  HORIZON_CRSPLINES_CAL_COEF_DCHI(2);
+  HORIZON_CRSPLINES_CAL_COEF_DCHI(3);
+  compute_tricubic_coeffs(a_R, f_R);
+  compute_tricubic_coeffs(a_chi, f_chi);
+  compute_tricubic_coeffs(a_K, f_K);
+
+  COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_EVAL_G);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_EVAL_M);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_EVAL_K);
+  HORIZON_CRSPLINES_EVAL_DCHI(1);
+  HORIZON_CRSPLINES_EVAL_DCHI(2);
+  HORIZON_CRSPLINES_EVAL_DCHI(3);
+  kd->R = evaluate_interpolation(a_R, xd, yd, zd);
+  kd->chi = evaluate_interpolation(a_chi, xd, yd, zd);
+  kd->K = evaluate_interpolation(a_K, xd, yd, zd);
+
+  // order is important here!!!!!
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_K);
+  COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_M);
+
+  real_t det = kd->m11 * kd->m22 * kd->m33 + kd->m12 * kd->m23 * kd->m13
+    + kd->m12 * kd->m23 * kd->m13 - kd->m13 * kd->m22 * kd->m13
+    - kd->m12 * kd->m12 * kd->m33 - kd->m23 * kd->m23 * kd->m11;
+
+  kd->mi11 = (kd->m22 * kd->m33 - pw2(kd->m23)) / det;
+  kd->mi22 = (kd->m11 * kd->m33 - pw2(kd->m13)) / det;
+  kd->mi33 = (kd->m11 * kd->m22 - pw2(kd->m12)) / det;
+  kd->mi12 = (kd->m13*kd->m23 - kd->m12*(kd->m33)) / det;
+  kd->mi13 = (kd->m12*kd->m23 - kd->m13*(kd->m22)) / det;
+  kd->mi23 = (kd->m12*kd->m13 - kd->m23*(kd->m11)) / det;
+
+  COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_CAL_G);
+}
+
+/**
+ * @brief interpolate the metric data to a set of surface points at once
+ * @details every rank interpolates the points covered by its own patches,
+ * finest level first; one reduction picks the owner of every point (the
+ * finest level wins) and a second one hands the owners' values to all ranks
+ *
+ * @param hierarchy
+ * @param bssn
+ * @param coords (x, y, z) of the points relative to coord_origin
+ * @param kds interpolated data, one entry per point
+ */
+void HorizonStatistics::interpolate_surface_values(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn,
+  const std::vector<real_t> & coords, std::vector<KillingData> & kds)
+{
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+  const int n_points = coords.size() / 3;
+  const int n_reals = sizeof(KillingData) / sizeof(real_t);
+
+  KillingData kd_zero = {0};
+  kds.assign(n_points, kd_zero);
+
+  // level * size + rank of the patch a point is interpolated on
+  std::vector<int> owner_key(n_points, -1);
+
+  for (int ln = hierarchy->getNumberOfLevels() - 1; ln >= 0; ln--)
   {
     std::shared_ptr<hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
-    hier::PatchLevel::iterator p(level->begin());
-    for (;p != level->end(); ++p)
+    for (hier::PatchLevel::iterator p(level->begin()); p != level->end(); ++p)
     {
       const std::shared_ptr<hier::Patch>& patch = *p;
       const hier::Box& box = patch->getBox();
 
       const int * lower = &box.lower()[0];
       const int * upper = &box.upper()[0];
-      
+
       std::shared_ptr<geom::CartesianPatchGeometry> patch_geometry(
         SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
           patch->getPatchGeometry()));
 
-
       const real_t * dx = &(patch_geometry->getDx())[0];
-      int i0 = floor((x + coord_origin[0] - domain_lower[0] ) / dx[0] - 0.5);
-      int j0 = floor((y + coord_origin[1] - domain_lower[1] ) / dx[1] - 0.5);
-      int k0 = floor((z + coord_origin[2] - domain_lower[2] ) / dx[2] - 0.5);
 
-      
-      if( i0 >= lower[0] && i0 <= upper[0]
-          && j0 >= lower[1] && j0 <= upper[1]
-          && k0 >= lower[2] && k0 <= upper[2])
+      std::vector<int> patch_points;
+      for(int n = 0; n < n_points; n++)
       {
-        cur_mpi_rank = mpi.getRank();
+        if(owner_key[n] >= 0)
+          continue;
+
+        int i0 = floor((coords[3*n] + coord_origin[0] - domain_lower[0] ) / dx[0] - 0.5);
+        int j0 = floor((coords[3*n+1] + coord_origin[1] - domain_lower[1] ) / dx[1] - 0.5);
+        int k0 = floor((coords[3*n+2] + coord_origin[2] - domain_lower[2] ) / dx[2] - 0.5);
+
+        if( i0 >= lower[0] && i0 <= upper[0]
+            && j0 >= lower[1] && j0 <= upper[1]
+            && k0 >= lower[2] && k0 <= upper[2])
+        {
+          owner_key[n] = ln * mpi.getSize() + mpi.getRank();
+          patch_points.push_back(n);
+        }
+      }
 
-        cur_mpi_level = ln;
-        
+      if(patch_points.empty())
+        continue;
+
+      bssn->initPData(patch);
+      bssn->initMDA(patch);
+
+#pragma omp parallel for
+      for(int pi = 0; pi < (int)patch_points.size(); pi++)
+      {
+        const int n = patch_points[pi];
+        const real_t x = coords[3*n], y = coords[3*n+1], z = coords[3*n+2];
+
+        int i0 = floor((x + coord_origin[0] - domain_lower[0] ) / dx[0] - 0.5);
+        int j0 = floor((y + coord_origin[1] - domain_lower[1] ) / dx[1] - 0.5);
+        int k0 = floor((z + coord_origin[2] - domain_lower[2] ) / dx[2] - 0.5);
 
-        bssn->initPData(patch);
-        bssn->initMDA(patch);
-        
-        BSSNData bd = {0};
-        
-        
         real_t x0 = domain_lower[0] + (double)i0 * dx[0] + dx[0]/2.0 - coord_origin[0];
         real_t y0 = domain_lower[1] + (double)j0 * dx[1] + dx[1]/2.0 - coord_origin[1];
         real_t z0 = domain_lower[2] + (double)k0 * dx[2] + dx[2]/2.0 - coord_origin[2];
 
-        double xd = (x - x0) / dx[0];
-        double yd = (y - y0) / dx[1];
-        double zd = (z - z0) / dx[2];
-
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_DEFINE_CRSPLINES_G);
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_DEFINE_CRSPLINES_M);
-        HORIZON_DEFINE_CRSPLINES_DCHI(1);
-        HORIZON_DEFINE_CRSPLINES_DCHI(2);
-        HORIZON_DEFINE_CRSPLINES_DCHI(3);
-        double a_R[64], f_R[64];
-        double a_chi[64], f_chi[64];
-
-        double d1chi, d2chi, d3chi;
-        
-        for(int i = 0; i < 4; i++)
-          for(int j = 0; j < 4; j++)
-            for(int k = 0; k < 4; k++)
-            {
-              bssn->set_bd_values(i0-1+i, j0-1+j, k0-1+k, &bd, dx);
-              COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_SET_F_G);
-              COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_SET_F_M);
-              HORIZON_CRSPLINES_SET_F_DCHI(1);
-              HORIZON_CRSPLINES_SET_F_DCHI(2);
-              HORIZON_CRSPLINES_SET_F_DCHI(3);
-              f_R[i*16 + j*4 + k] = bd.ricci;
-              f_chi[i*16 + j*4 + k] = bd.chi;
-            }
+        interpolate_kd_values(bssn, dx, i0, j0, k0,
+                              (x - x0) / dx[0], (y - y0) / dx[1], (z - z0) / dx[2],
+                              &kds[n]);
+      }
+    }
+  }
 
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_CAL_COEF_G);
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_COEF_M);
-        HORIZON_CRSPLINES_CAL_COEF_DCHI(1);
-        HORIZON_CRSPLINES_CAL_COEF_DCHI(2);
-        HORIZON_CRSPLINES_CAL_COEF_DCHI(3);
-        compute_tricubic_coeffs(a_R, f_R);
-        compute_tricubic_coeffs(a_chi, f_chi);
-        
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_EVAL_G);
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_EVAL_M);
-        HORIZON_CRSPLINES_EVAL_DCHI(1);
-        HORIZON_CRSPLINES_EVAL_DCHI(2);
-        HORIZON_CRSPLINES_EVAL_DCHI(3);
-        kd->R = evaluate_interpolation(a_R, xd, yd, zd);
-        kd->chi = evaluate_interpolation(a_chi, xd, yd, zd);
+  if (mpi.getSize() > 1)
+  {
+    mpi.AllReduce(&owner_key[0], n_points, MPI_MAX);
 
-        
-        COSMO_APPLY_TO_IJ_PERMS(HORIZON_CRSPLINES_CAL_M);
+    for(int n = 0; n < n_points; n++)
+      if(owner_key[n] % mpi.getSize() != mpi.getRank())
+        kds[n] = kd_zero;
 
-        real_t det = kd->m11 * kd->m22 * kd->m33 + kd->m12 * kd->m23 * kd->m13
-          + kd->m12 * kd->m23 * kd->m13 - kd->m13 * kd->m22 * kd->m13
-          - kd->m12 * kd->m12 * kd->m33 - kd->m23 * kd->m23 * kd->m11;
-  
-        kd->mi11 = (kd->m22 * kd->m33 - pw2(kd->m23)) / det;
-        kd->mi22 = (kd->m11 * kd->m33 - pw2(kd->m13)) / det;
-        kd->mi33 = (kd->m11 * kd->m22 - pw2(kd->m12)) / det;
-        kd->mi12 = (kd->m13*kd->m23 - kd->m12*(kd->m33)) / det;
-        kd->mi13 = (kd->m12*kd->m23 - kd->m13*(kd->m22)) / det;
-        kd->mi23 = (kd->m12*kd->m13 - kd->m23*(kd->m11)) / det;
-        
-        COSMO_APPLY_TO_IJK_PERMS(HORIZON_CRSPLINES_CAL_G);
-        
-        
-        kd->q11 = pw2(r) * (
-          kd->m11 * Theta[0] * Theta[0] + 2.0 * kd->m12 * Theta[0] * Theta[1]
-          + 2.0 * kd->m13 * Theta[0] * Theta[2] + kd->m22 * Theta[1] * Theta[1]
-          + 2.0 * kd->m23 * Theta[1] * Theta[2] + kd->m33 * Theta[2] * Theta[2]);
-
-        kd->q12 = 2.0 * st * pw2(r) * (
-          kd->m11 * Theta[0] * Phi[0] + kd->m12 * Theta[0] * Phi[1]
-          + kd->m12 * Theta[1] * Phi[0] + kd->m13 * Theta[0] * Phi[2]
-          + kd->m13 * Theta[2] * Phi[0] + kd->m22 * Theta[1] * Phi[1]
-          + kd->m23 * Theta[1] * Phi[2] + kd->m23 * Theta[2] * Phi[1]
-          +  kd->m33 * Theta[2] * Phi[2]);
-
-        kd->q22 = pw2(r * st) * (
-          kd->m11 * Phi[0] * Phi[0] + 2.0 * kd->m12 * Phi[0] * Phi[1]
-          + 2.0 * kd->m13 * Phi[0] * Phi[2] + kd->m22 * Phi[1] * Phi[1]
-          + 2.0 * kd->m23 * Phi[1] * Phi[2] + kd->m33 * Phi[2] * Phi[2]);
-        
-        // kd->q11 = pw2(r)*(ct*(pw2(cp)*ct*kd->m11
-        //                       + ct*sin(2*phi)*kd->m12
-        //                       + ct*pw2(sp)*kd->m22
-        //                       - 2*st*(cp*kd->m13 + sp*kd->m23)) + pw2(st)*kd->m33);
+    mpi.AllReduce((real_t *)&kds[0], n_points * n_reals, MPI_SUM);
+  }
 
-  
-        // kd->q12 = pw2(r)*st*(ct*cos(2*phi)*kd->m12
-        //                      + sp*st*kd->m13
-        //                      + cp*ct*sp*(-kd->m11 + kd->m22) - cp*st*kd->m23);
+  for(int n = 0; n < n_points; n++)
+    if(owner_key[n] < 0)
+      TBOX_ERROR("Cannot find patch cover the point ("
+                 <<coords[3*n]<<","<<coords[3*n+1]<<","<<coords[3*n+2]<<")\n");
+}
 
-        // kd->q22 = pw2(r)*pw2(st)*(pw2(sp)*kd->m11 + cp*(-2*sp*kd->m12 + cp*kd->m22));
+/**
+ * @brief set everything the Killing transport needs on the surface with
+ *        two batched interpolations
+ * @details fills ah_radius and G111 ... G222 on the (2 n_theta, 2 n_phi)
+ * grid used by initG, then kd_table and kd_radius at the half-step
+ * points the transport, area and angular momentum are evaluated at
+ */
+void HorizonStatistics::set_surface_values(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn)
+{
+  std::vector<real_t> thetas, phis, radii, coords;
+  std::vector<KillingData> kds;
 
-        // std::cout<<ct*cos(2*phi)*kd->m12<<" "<<
-        //   sp*st*kd->m13<<" "<<cp*ct*sp*(-kd->m11 + kd->m22)<<" "
-        //          <<- cp*st*kd->m23<<"\n";
-        //        std::cout<<fabs(kd->q11 - q11) / q11<<" "<<q12<<" "<<kd->q12
-        //       <<" "<<fabs(kd->q22 - q22) / q22<<"\n";
-        
-        kd->Gs111 = ((pw2(x) + pw2(y))*z*(5*(pw2(x) + pw2(y)) - 
-                                          pw2(z))*cos(2*theta) + 
-                     (pw2(x) + pw2(y))*(-(z*(3*(pw2(x) + pw2(y)) + 
-                                             pw2(z))) + 4*(cp*x + sp*y)*(pw2(x) + pw2(y) - 
-                                                                         pw2(z))*sin(2*theta)) + 
-                     2*pw2(ct)*z*(3*(pw2(x) + pw2(y)) + pw2(z))*((x - 
-                                                                  y)*(x + y)*cos(2*phi) + 2*x*y*sin(2*phi)) + 
-                     pw2(r)*(pw2(x) + 
-                             pw2(y))*(4*pw2(cp)*pw2(ct)*x*z*kd->Gc111 + x*z*kd->Gc122 
-                                      + x*z*cos(2*theta)*kd->Gc122 + 2*x*z*kd->Gc133 - 
-                                      2*x*z*cos(2*theta)*kd->Gc133 + y*z*kd->Gc211 + 
-                                      y*z*cos(2*theta)*kd->Gc211 + y*z*kd->Gc222 + 
-                                      y*z*cos(2*theta)*kd->Gc222 + 2*y*z*kd->Gc233 - 
-                                      2*y*z*cos(2*theta)*kd->Gc233 - pw2(x)*kd->Gc311 - 
-                                      pw2(y)*kd->Gc311 - pw2(x)*cos(2*theta)*kd->Gc311 - 
-                                      pw2(y)*cos(2*theta)*kd->Gc311 + 
-                                      4*pw2(ct)*sin(2*phi)*(x*z*kd->Gc112 + y*z*kd->Gc212 - (pw2(x) 
-                                                                                             + pw2(y))*kd->Gc312) + 
-                                      4*cp*sin(2*theta)*(-(z*(x*kd->Gc113 + y*kd->Gc213)) + 
-                                                         (pw2(x) + pw2(y))*kd->Gc313) - pw2(x)*kd->Gc322 - 
-                                      pw2(y)*kd->Gc322 - pw2(x)*cos(2*theta)*kd->Gc322 - 
-                                      pw2(y)*cos(2*theta)*kd->Gc322 - 
-                                      2*pw2(ct)*cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + 
-                                                            y*z*kd->Gc222 + pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - 
-                                                            (pw2(x) + pw2(y))*kd->Gc322) + 
-                                      4*sp*sin(2*theta)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
-                                                         (pw2(x) + pw2(y))*kd->Gc323) - 4*pw2(st)*(pw2(x) + 
-                                                                                                   pw2(y))*kd->Gc333))/
-          (4.*pow(pw2(r),2.5)*pow((pw2(x) + 
-                                   pw2(y))/pw2(r),1.5));
- 
-        kd->Gs122 = (pw2(st)*(z*((pw2(x) + pw2(y))*(pw2(x) + pw2(y) - 
-                                                    pw2(z)) - (3*(pw2(x) + pw2(y)) + pw2(z))*((x - y)*(x 
-                                                                                                       + y)*cos(2*phi) + 2*x*y*sin(2*phi))) + 
-                              pw2(r)*(pw2(x) + 
-                                      pw2(y))*(2*pw2(sp)*x*z*kd->Gc111 + x*z*kd->Gc122 + 
-                                               y*z*kd->Gc211 + y*z*kd->Gc222 - pw2(x)*kd->Gc311 - 
-                                               pw2(y)*kd->Gc311 + 
-                                               2*sin(2*phi)*(-(z*(x*kd->Gc112 + y*kd->Gc212)) + 
-                                                             (pw2(x) + pw2(y))*kd->Gc312) - pw2(x)*kd->Gc322 - 
-                                               pw2(y)*kd->Gc322 + 
-                                               cos(2*phi)*(x*z*kd->Gc122 - y*z*kd->Gc211 + y*z*kd->Gc222 + 
-                                                           pw2(x)*kd->Gc311 + pw2(y)*kd->Gc311 - (pw2(x) + 
-                                                                                                  pw2(y))*kd->Gc322))))/
-          (2.*pow(pw2(r),2.5)*pow((pw2(x) + 
-                                   pw2(y))/pw2(r),1.5));
-  
+  // points of initG
+  for(int theta_i = 0; theta_i < 2 * n_theta; theta_i++)
+    for(int phi_i = 0; phi_i < 2 * n_phi; phi_i++)
+    {
+      thetas.push_back(PI * ((double) theta_i + 0.5) / (double)n_theta / 2.0);
+      phis.push_back(2.0 * PI * ((double) phi_i + 0.5) / (double)n_phi / 2.0);
+    }
 
-        kd->Gs112 = (2*(-(sp*x) + cp*y)*(pw2(x) + pw2(y))*(pw2(x) + 
-                                                           pw2(y) - pw2(z)) + 2*(sp*x - cp*y)*(pw2(x) + 
-                                                                                               pw2(y))*(pw2(x) + pw2(y) - pw2(z))*cos(2*theta) + 
-                     z*(3*(pw2(x) + pw2(y)) + 
-                        pw2(z))*sin(2*theta)*(2*x*y*cos(2*phi) + (-pw2(x) + 
-                                                                  pw2(y))*sin(2*phi)) + 
-                     pw2(r)*(pw2(x) + 
-                             pw2(y))*(2*cos(2*phi)*sin(2*theta)*(x*z*kd->Gc112 + y*z*kd->Gc212 
-                                                                 - (pw2(x) + pw2(y))*kd->Gc312) + 
-                                      4*sp*pw2(st)*(x*z*kd->Gc113 + y*z*kd->Gc213 - (pw2(x) 
-                                                                                     + pw2(y))*kd->Gc313) + 
-                                      sin(2*theta)*sin(2*phi)*(-(x*z*kd->Gc111) + x*z*kd->Gc122 - 
-                                                               y*z*kd->Gc211 + y*z*kd->Gc222 + pw2(x)*kd->Gc311 + 
-                                                               pw2(y)*kd->Gc311 - (pw2(x) + pw2(y))*kd->Gc322) + 
-                                      4*cp*pw2(st)*(-(z*(x*kd->Gc123 + y*kd->Gc223)) + 
-                                                    (pw2(x) + 
-                                                     pw2(y))*kd->Gc323)))/(4.*pow(pw2(r),2.5)*pow((pw2(x) 
-                                                                                                   + pw2(y))/pw2(r),1.5));
-
-
-        kd->Gs211 = (pw2(r)*(4*pw2(ct)*(-2*x*y*cos(2*phi) + (x - y)*(x + 
-                                                                     y)*sin(2*phi)) + (pw2(x) + pw2(y))*
-                             (-4*pw2(cp)*pw2(ct)*y*kd->Gc111 - y*kd->Gc122 - 
-                              y*cos(2*theta)*kd->Gc122 - 2*y*kd->Gc133 + 2*y*cos(2*theta)*kd->Gc133 
-                              + x*kd->Gc211 + x*cos(2*theta)*kd->Gc211 + 
-                              4*pw2(ct)*sin(2*phi)*(-(y*kd->Gc112) + x*kd->Gc212) + 
-                              4*cp*sin(2*theta)*(y*kd->Gc113 - x*kd->Gc213) + 
-                              2*pw2(ct)*cos(2*phi)*(y*kd->Gc122 + x*(kd->Gc211 - kd->Gc222)) + 
-                              x*kd->Gc222 + 
-                              x*cos(2*theta)*kd->Gc222 + 4*sp*sin(2*theta)*(y*kd->Gc123 - 
-                                                                            x*kd->Gc223) + 2*x*kd->Gc233 - 
-                              2*x*cos(2*theta)*kd->Gc233)))/(4.*pow(pw2(x) + pw2(y),2));
-
-
-        kd->Gs212 = (pw2(r)*(2*sin(2*theta)*((x - y)*(x + y)*cos(2*phi) + 
-                                             2*x*y*sin(2*phi)) + (pw2(x) + pw2(y))*
-                             (2*cos(2*phi)*sin(2*theta)*(-(y*kd->Gc112) + x*kd->Gc212) + 
-                              4*sp*pw2(st)*(-(y*kd->Gc113) + x*kd->Gc213) + 
-                              sin(2*theta)*sin(2*phi)*(y*kd->Gc111 - y*kd->Gc122 + x*(-kd->Gc211 + 
-                                                                                      kd->Gc222)) + 
-                              4*cp*pw2(st)*(y*kd->Gc123 - 
-                                            x*kd->Gc223))))/(4.*pow(pw2(x) + pw2(y),2));
-  
+  getRadii(thetas, phis, radii, coords);
+  interpolate_surface_values(hierarchy, bssn, coords, kds);
 
-        kd->Gs222 = (pw2(r)*pw2(st)*(4*x*y*cos(2*phi) + 2*(-pw2(x) + 
-                                                           pw2(y))*sin(2*phi) - 
-                                     (pw2(x) + pw2(y))*(2*pw2(sp)*y*kd->Gc111 - 
-                                                        2*y*sin(2*phi)*kd->Gc112 + y*kd->Gc122 + y*cos(2*phi)*kd->Gc122 - 
-                                                        x*kd->Gc211 + x*cos(2*phi)*kd->Gc211 + 2*x*sin(2*phi)*kd->Gc212 - 
-                                                        2*pw2(cp)*x*kd->Gc222)))/(2.*pow(pw2(x) + 
-                                                                                         pw2(y),2));
-  
-        det = kd->q11 * kd->q22 - kd->q12 * kd->q12;
+#pragma omp parallel for collapse(2)
+  for(int theta_i = 0; theta_i < 2 * n_theta; theta_i++)
+    for(int phi_i = 0; phi_i < 2 * n_phi; phi_i++)
+    {
+      const int n = theta_i * 2 * n_phi + phi_i;
+      ah_radius[theta_i][phi_i] = radii[n];
+      set_G_values_local(thetas[n], phis[n], theta_i, phi_i, radii[n], &kds[n]);
+    }
 
+  // half-step points, theta = PI * (theta_i / 2 + 0.5) / n_theta
+  // and phi = 2 PI * (phi_i / 2 + 0.5) / n_phi
+  thetas.clear();
+  phis.clear();
+  for(int theta_i = 0; theta_i < 2 * n_theta - 1; theta_i++)
+    for(int phi_i = 0; phi_i < 2 * n_phi; phi_i++)
+    {
+      thetas.push_back(PI * ((double) theta_i / 2.0 + 0.5) / (double)n_theta);
+      phis.push_back(2.0 * PI * ((double) phi_i / 2.0 + 0.5) / (double)n_phi);
+    }
 
-        kd->qi11 = kd->q22 / det;
-        kd->qi12 = -kd->q12 / det;
-        kd->qi22 =  kd->q11 / det;
+  getRadii(thetas, phis, kd_radius, coords);
+  interpolate_surface_values(hierarchy, bssn, coords, kd_table);
 
+#pragma omp parallel for collapse(2)
+  for(int theta_i = 0; theta_i < 2 * n_theta - 1; theta_i++)
+    for(int phi_i = 0; phi_i < 2 * n_phi; phi_i++)
+    {
+      const int n = theta_i * 2 * n_phi + phi_i;
+      const real_t r = kd_radius[n];
+      KillingData *kd = &kd_table[n];
 
-        kd->R11 = HORIZON_CALCULATE_D1G(1,1,1)
-          + HORIZON_CALCULATE_D2G(2,1,1)
-          - HORIZON_CALCULATE_D1G(1,1,1)
-          - HORIZON_CALCULATE_D1G(2,2,1)
-          + (kd->Gs111 * kd->Gs111 + kd->Gs221 * kd->Gs111
-             + kd->Gs112 * kd->Gs211 + kd->Gs222 * kd->Gs211)
-          - (kd->Gs111 * kd->Gs111 + kd->Gs112 * kd->Gs211
-             + kd->Gs211 * kd->Gs121 + kd->Gs212 * kd->Gs221);
-  
-        kd->R12 = HORIZON_CALCULATE_D1G(1,1,2)
-          + HORIZON_CALCULATE_D2G(2,1,2)
-          - HORIZON_CALCULATE_D2G(1,1,1)
-          - HORIZON_CALCULATE_D2G(2,2,1)
-          + (kd->Gs111 * kd->Gs112 + kd->Gs221 * kd->Gs112
-             + kd->Gs112 * kd->Gs212 + kd->Gs222 * kd->Gs212)
-          - (kd->Gs121 * kd->Gs121 + kd->Gs122 * kd->Gs211
-             + kd->Gs221 * kd->Gs121 + kd->Gs222 * kd->Gs221);
-
-        kd->R22 = HORIZON_CALCULATE_D1G(1,2,2)
-          + HORIZON_CALCULATE_D2G(2,2,2)
-          - HORIZON_CALCULATE_D2G(1,1,2)
-          - HORIZON_CALCULATE_D2G(2,2,2)
-          + (kd->Gs111 * kd->Gs122 + kd->Gs221 * kd->Gs122
-             + kd->Gs112 * kd->Gs222 + kd->Gs222 * kd->Gs222)
-          - (kd->Gs121 * kd->Gs122 + kd->Gs122 * kd->Gs212
-             + kd->Gs221 * kd->Gs122 + kd->Gs222 * kd->Gs222);
-
-        kd->R = kd->qi11 * kd->R11 + kd->qi12 * kd->R12 * 2.0
-          + kd->qi22 * kd->R22;
+      set_kd_values_local(thetas[n], phis[n], theta_i, phi_i, r, kd);
 
-        break;
-      }
+      kd->d1F = dF(theta_i, phi_i, 1, coords[3*n], coords[3*n+1], coords[3*n+2], r);
+      kd->d2F = dF(theta_i, phi_i, 2, coords[3*n], coords[3*n+1], coords[3*n+2], r);
+      kd->d3F = dF(theta_i, phi_i, 3, coords[3*n], coords[3*n+1], coords[3*n+2], r);
     }
-    if(p != level->end())
-      break;
-
-  }
+}
 
-  mpi.Barrier();
+/**
+ * @brief data set by set_surface_values at half-step point (theta_i, phi_i)
+ */
+KillingData * HorizonStatistics::surface_kd(int theta_i, int phi_i)
+{
+  return &kd_table[theta_i * 2 * n_phi + phi_i % (2 * n_phi)];
+}
 
-  if (mpi.getSize() > 1)
-  {
-    mpi.AllReduce(&cur_mpi_level, 1, MPI_MAX);
-  }
-  mpi.Barrier();
+/**
+ * @brief horizon radii in a set of directions with a single finder call
+ *
+ * @param thetas
+ * @param phis
+ * @param radii radius in each direction
+ * @param coords (x, y, z) on the horizon relative to coord_origin
+ */
+void HorizonStatistics::getRadii(
+  const std::vector<real_t> & thetas, const std::vector<real_t> & phis,
+  std::vector<real_t> & radii, std::vector<real_t> & coords)
+{
+  const int n_points = thetas.size();
+  std::vector<real_t> x(n_points), y(n_points), z(n_points);
 
-  if(mpi.getSize() > 1 && ln != cur_mpi_level)
+  for(int n = 0; n < n_points; n++)
   {
-    cur_mpi_rank = -1;
+    x[n] = cos(phis[n]) * sin(thetas[n]) + origin[0];
+    y[n] = sin(phis[n]) * sin(thetas[n]) + origin[1];
+    z[n] = cos(thetas[n]) + origin[2];
   }
 
-  
-  mpi.Barrier();
+  radii.resize(n_points);
+  horizon->AHFinderDirect_radius_in_direction(
+    horizon_id, n_points, &x[0], &y[0], &z[0], &radii[0]);
 
-  if (mpi.getSize() > 1)
+  coords.resize(3 * n_points);
+  for(int n = 0; n < n_points; n++)
   {
-    mpi.AllReduce(&cur_mpi_rank, 1, MPI_MAX);
+    coords[3*n] = radii[n] * cos(phis[n]) * sin(thetas[n]);
+    coords[3*n+1] = radii[n] * sin(phis[n]) * sin(thetas[n]);
+    coords[3*n+2] = radii[n] * cos(thetas[n]);
   }
-  mpi.Barrier();
-  
-  if(cur_mpi_rank == -1)
-    TBOX_ERROR("Cannot find proper patch in set bd values\n");
-
 }
 
 real_t HorizonStatistics::ev_k_theta_dphi(KillingData *kd, int theta_i, int phi_i)
@@ -863,6 +1076,12 @@ void HorizonStatistics::transportKillingTheta(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
   idx_t phi_i, double k_theta_0, double k_phi_0, double k_L_0, BSSN * bssn)
 {
+  if(batch_killing_transport)
+  {
+    transportKillingThetaLocal(phi_i, k_theta_0, k_phi_0, k_L_0);
+    return;
+  }
+
   // transporting killing vector (or test vector from 0 to 2 \pi)
   double phi = 2.0 * PI * ((double) phi_i +0.5) / (double)n_phi;
   double dtheta = PI / (double) n_theta;
@@ -1053,7 +1272,7 @@ void HorizonStatistics::transportKillingTheta(
     //    r = ah_radius[theta_i*2-1][phi_i*2];
     r = getRadius(theta, phi);
     mpi.Barrier();
-    set_kd_values(hierarchy, theta, phi, (theta_i*2 +1)%(2*n_theta), phi_i*2, r, &kd, bssn);
+    set_kd_values(hierarchy, theta, phi, theta_i*2 - 1, phi_i*2, r, &kd, bssn);
 
     real_t k2_theta = ev_k_theta_dtheta(&kd, theta_i, phi_i);
     real_t k2_phi = ev_k_phi_dtheta(&kd, theta_i, phi_i);
@@ -1099,7 +1318,7 @@ void HorizonStatistics::transportKillingTheta(
     //    r = ah_radius[theta_i*2-2][phi_i*2];
     r= getRadius(theta, phi);
     mpi.Barrier();
-    set_kd_values(hierarchy, theta, phi, (theta_i*2 +2)%(2*n_theta), phi_i*2, r, &kd, bssn);
+    set_kd_values(hierarchy, theta, phi, theta_i*2 - 2, phi_i*2, r, &kd, bssn);
 
 
     
@@ -1144,6 +1363,12 @@ void HorizonStatistics::transportKillingPhi(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
   idx_t theta_i, idx_t phi_f, double k_theta_0, double k_phi_0, double k_L_0, BSSN * bssn)
 {
+  if(batch_killing_transport)
+  {
+    transportKillingPhiLocal(theta_i, phi_f, k_theta_0, k_phi_0, k_L_0);
+    return;
+  }
+
   // transporting killing vector (or test vector from 0 to 2 \pi)
   double theta = PI * ((double) theta_i +0.5) / (double)n_theta;
   double dphi = 2.0 * PI / (double) n_phi;
@@ -1280,6 +1505,129 @@ void HorizonStatistics::transportKillingPhi(
   }
 }
 
+/**
+ * @brief right hand side of the Killing transport equations along theta
+ *        or phi with the current k_theta, k_phi and k_L at (theta_i, phi_i)
+ */
+void HorizonStatistics::ev_k_rhs(
+  KillingData *kd, int theta_i, int phi_i, bool along_theta, real_t res[])
+{
+  if(along_theta)
+  {
+    res[0] = ev_k_theta_dtheta(kd, theta_i, phi_i);
+    res[1] = ev_k_phi_dtheta(kd, theta_i, phi_i);
+    res[2] = ev_k_L_dtheta(kd, theta_i, phi_i);
+  }
+  else
+  {
+    res[0] = ev_k_theta_dphi(kd, theta_i, phi_i);
+    res[1] = ev_k_phi_dphi(kd, theta_i, phi_i);
+    res[2] = ev_k_L_dphi(kd, theta_i, phi_i);
+  }
+}
+
+/**
+ * @brief RK4 step of the Killing transport from (theta_i, phi_i) to
+ *        (theta_f, phi_f), no communication
+ *
+ * @param h step in theta or phi
+ * @param along_theta
+ * @param kd_0 surface data at the start of the step
+ * @param kd_h surface data half way
+ * @param kd_1 surface data at the end of the step
+ */
+void HorizonStatistics::transportKillingStepLocal(
+  int theta_i, int phi_i, int theta_f, int phi_f, double h, bool along_theta,
+  KillingData *kd_0, KillingData *kd_h, KillingData *kd_1)
+{
+  real_t k_theta_0 = k_theta[theta_i][phi_i];
+  real_t k_phi_0 = k_phi[theta_i][phi_i];
+  real_t k_L_0 = k_L[theta_i][phi_i];
+
+  real_t k1[3], k2[3], k3[3], k4[3];
+
+  ev_k_rhs(kd_0, theta_i, phi_i, along_theta, k1);
+
+  k_theta[theta_i][phi_i] = k_theta_0 + h * k1[0] / 2.0;
+  k_phi[theta_i][phi_i] = k_phi_0 + h * k1[1] / 2.0;
+  k_L[theta_i][phi_i] = k_L_0 + h * k1[2] / 2.0;
+
+  ev_k_rhs(kd_h, theta_i, phi_i, along_theta, k2);
+
+  k_theta[theta_i][phi_i] = k_theta_0 + h * k2[0] / 2.0;
+  k_phi[theta_i][phi_i] = k_phi_0 + h * k2[1] / 2.0;
+  k_L[theta_i][phi_i] = k_L_0 + h * k2[2] / 2.0;
+
+  ev_k_rhs(kd_h, theta_i, phi_i, along_theta, k3);
+
+  k_theta[theta_i][phi_i] = k_theta_0 + h * k3[0];
+  k_phi[theta_i][phi_i] = k_phi_0 + h * k3[1];
+  k_L[theta_i][phi_i] = k_L_0 + h * k3[2];
+
+  ev_k_rhs(kd_1, theta_i, phi_i, along_theta, k4);
+
+  k_theta[theta_f][phi_f] = k_theta_0 + h / 6.0 *
+    (k1[0] + 2.0 * k2[0] + 2.0 * k3[0] + k4[0]);
+  k_phi[theta_f][phi_f] = k_phi_0 + h / 6.0 *
+    (k1[1] + 2.0 * k2[1] + 2.0 * k3[1] + k4[1]);
+  k_L[theta_f][phi_f] = k_L_0 + h / 6.0 *
+    (k1[2] + 2.0 * k2[2] + 2.0 * k3[2] + k4[2]);
+
+  // restore the initial result
+  k_theta[theta_i][phi_i] = k_theta_0;
+  k_phi[theta_i][phi_i] = k_phi_0;
+  k_L[theta_i][phi_i] = k_L_0;
+}
+
+/**
+ * @brief transportKillingTheta with the data of set_surface_values;
+ *        only touches column phi_i, so lines can run concurrently
+ */
+void HorizonStatistics::transportKillingThetaLocal(
+  idx_t phi_i, double k_theta_0, double k_phi_0, double k_L_0)
+{
+  double dtheta = PI / (double) n_theta;
+
+  // always starts from n_theta / 2
+  k_theta[n_theta/2][phi_i] = k_theta_0;
+  k_phi[n_theta/2][phi_i] = k_phi_0;
+  k_L[n_theta/2][phi_i] = k_L_0;
+
+  // transporting theta_i to theta_i + 1
+  for(int theta_i = n_theta/2; theta_i < n_theta - 1; theta_i++)
+    transportKillingStepLocal(
+      theta_i, phi_i, theta_i + 1, phi_i, dtheta, true,
+      surface_kd(theta_i*2, phi_i*2), surface_kd(theta_i*2 + 1, phi_i*2),
+      surface_kd(theta_i*2 + 2, phi_i*2));
+
+  // transporting theta_i to theta_i - 1
+  for(int theta_i = n_theta/2; theta_i > 0; theta_i--)
+    transportKillingStepLocal(
+      theta_i, phi_i, theta_i - 1, phi_i, -dtheta, true,
+      surface_kd(theta_i*2, phi_i*2), surface_kd(theta_i*2 - 1, phi_i*2),
+      surface_kd(theta_i*2 - 2, phi_i*2));
+}
+
+/**
+ * @brief transportKillingPhi with the data of set_surface_values
+ */
+void HorizonStatistics::transportKillingPhiLocal(
+  idx_t theta_i, idx_t phi_f, double k_theta_0, double k_phi_0, double k_L_0)
+{
+  double dphi = 2.0 * PI / (double) n_phi;
+
+  k_theta[theta_i][0] = k_theta_0;
+  k_phi[theta_i][0] = k_phi_0;
+  k_L[theta_i][0] = k_L_0;
+
+  // transporting phi_i to phi_f
+  for(int phi_i = 0; phi_i < phi_f; phi_i++)
+    transportKillingStepLocal(
+      theta_i, phi_i, theta_i, (phi_i+1)%n_phi, dphi, false,
+      surface_kd(theta_i*2, phi_i*2), surface_kd(theta_i*2, phi_i*2 + 1),
+      surface_kd(theta_i*2, phi_i*2 + 2));
+}
+
 void HorizonStatistics::initG(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn)
 {
@@ -1826,6 +2174,27 @@ real_t HorizonStatistics::angularMomentum(
   real_t dtheta = PI / (double)n_theta;
   real_t dphi = 2.0 * PI / (double)n_phi;
   real_t res = 0;
+
+  if(batch_killing_transport)
+  {
+#pragma omp parallel for collapse(2) reduction(+:res)
+    for(int theta_i = 0; theta_i < n_theta; theta_i++)
+    {
+      for(int phi_i = 0; phi_i < n_phi; phi_i++)
+      {
+        double theta = PI * ((double) theta_i +0.5) / (double)n_theta;
+        double phi = 2.0 * PI * ((double) phi_i +0.5) / (double)n_phi;
+
+        KillingData *kd = surface_kd(theta_i*2, phi_i*2);
+
+        res += angularMomentumDensity(
+          theta, phi, kd_radius[theta_i * 4 * n_phi + phi_i * 2],
+          theta_i, phi_i, kd, kd) * dtheta * dphi;
+      }
+    }
+    return res / 8.0 / PI;
+  }
+
   for(int theta_i = 0; theta_i < n_theta; theta_i++)
   {
     for(int phi_i = 0; phi_i < n_phi; phi_i++)
@@ -1834,51 +2203,20 @@ real_t HorizonStatistics::angularMomentum(
       double theta = PI * ((double) theta_i +0.5) / (double)n_theta;
       double phi = 2.0 * PI * ((double) phi_i +0.5) / (double)n_phi;
 
-      real_t st = sin(theta);
-      real_t ct = cos(theta);
-      real_t sp = sin(phi);
-      real_t cp = cos(phi);
-      
       real_t r = getRadius(theta, phi);
       
-      KillingData kd = {0};
+      KillingData norm_kd = {0};
 
       set_norm_values(hierarchy, theta, phi, theta_i, phi_i,
-                      getRadius(theta, phi), &kd, bssn);
-      
-
-      real_t k1 = r * (k_theta[theta_i][phi_i] * ct * cp
-                                                   - k_phi[theta_i][phi_i] * sp * st);
-      real_t k2 = r * (k_theta[theta_i][phi_i] * ct * sp
-                                                   + k_phi[theta_i][phi_i] * cp * st);
-      real_t k3 = - r * k_theta[theta_i][phi_i] * st;
-
-      
-      real_t s1 = (kd.mi11 * kd.d1F + kd.mi12 * kd.d2F + kd.mi13 * kd.d3F)
-        / (sqrt((kd.mi11 * kd.d1F * kd.d1F + kd.mi22 * kd.d2F * kd.d2F + kd.mi33 * kd.d3F *kd.d3F
-                 + 2.0 * (kd.mi12 * kd.d1F * kd.d2F + kd.mi13 * kd.d1F * kd.d3F + kd.mi23 * kd.d2F * kd.d3F))));
-      real_t s2 = (kd.mi21 * kd.d1F + kd.mi22 * kd.d2F + kd.mi23 * kd.d3F)
-        / (sqrt((kd.mi11 * kd.d1F * kd.d1F + kd.mi22 * kd.d2F * kd.d2F + kd.mi33 * kd.d3F *kd.d3F
-                 + 2.0 * (kd.mi12 * kd.d1F * kd.d2F + kd.mi13 * kd.d1F * kd.d3F + kd.mi23 * kd.d2F * kd.d3F))));
-      real_t s3 = (kd.mi31 * kd.d1F + kd.mi32 * kd.d2F + kd.mi33 * kd.d3F)
-        / (sqrt((kd.mi11 * kd.d1F * kd.d1F + kd.mi22 * kd.d2F * kd.d2F + kd.mi33 * kd.d3F *kd.d3F
-                 + 2.0 * (kd.mi12 * kd.d1F * kd.d2F + kd.mi13 * kd.d1F * kd.d3F + kd.mi23 * kd.d2F * kd.d3F))));
+                      getRadius(theta, phi), &norm_kd, bssn);
 
-      
-      real_t K11 = kd.K11, K12 = kd.K12, K13 = kd.K13;
-      real_t K22 = kd.K22, K23 = kd.K23, K33 = kd.K33;
-
-      
-      kd = {0};
+      KillingData kd = {0};
 
       set_kd_values(hierarchy, theta, phi, theta_i*2, phi_i*2,
                     r, &kd, bssn);
 
-      double det = kd.q11 * kd.q22 - kd.q12 * kd.q12;
-
-      res += (k1 * s1 * K11 + k2 * s2 * K22 + k3 * s3 * K33
-        + k1 * s2 * K12 + k1 * s3 * K13 + k2 * s3 * K23
-              + k2 * s1 * K12 + k3 * s1 * K13 + k3 * s2 * K23) * sqrt(det) * dtheta * dphi;
+      res += angularMomentumDensity(
+        theta, phi, r, theta_i, phi_i, &norm_kd, &kd) * dtheta * dphi;
 
       
       mpi.Barrier();
@@ -1892,10 +2230,73 @@ real_t HorizonStatistics::angularMomentum(
   return res / 8.0 / PI;
 }
 
+/**
+ * @brief integrand of the angular momentum at (theta_i, phi_i)
+ *
+ * @param norm_kd data with mi, dF and K_ij set
+ * @param kd data with the surface metric q set
+ */
+real_t HorizonStatistics::angularMomentumDensity(
+  double theta, double phi, double r, int theta_i, int phi_i,
+  KillingData *norm_kd, KillingData *kd)
+{
+  real_t st = sin(theta);
+  real_t ct = cos(theta);
+  real_t sp = sin(phi);
+  real_t cp = cos(phi);
+
+  const KillingData & nd = *norm_kd;
+
+  real_t k1 = r * (k_theta[theta_i][phi_i] * ct * cp
+                   - k_phi[theta_i][phi_i] * sp * st);
+  real_t k2 = r * (k_theta[theta_i][phi_i] * ct * sp
+                   + k_phi[theta_i][phi_i] * cp * st);
+  real_t k3 = - r * k_theta[theta_i][phi_i] * st;
+
+  real_t s1 = (nd.mi11 * nd.d1F + nd.mi12 * nd.d2F + nd.mi13 * nd.d3F)
+    / (sqrt((nd.mi11 * nd.d1F * nd.d1F + nd.mi22 * nd.d2F * nd.d2F + nd.mi33 * nd.d3F *nd.d3F
+             + 2.0 * (nd.mi12 * nd.d1F * nd.d2F + nd.mi13 * nd.d1F * nd.d3F + nd.mi23 * nd.d2F * nd.d3F))));
+  real_t s2 = (nd.mi21 * nd.d1F + nd.mi22 * nd.d2F + nd.mi23 * nd.d3F)
+    / (sqrt((nd.mi11 * nd.d1F * nd.d1F + nd.mi22 * nd.d2F * nd.d2F + nd.mi33 * nd.d3F *nd.d3F
+             + 2.0 * (nd.mi12 * nd.d1F * nd.d2F + nd.mi13 * nd.d1F * nd.d3F + nd.mi23 * nd.d2F * nd.d3F))));
+  real_t s3 = (nd.mi31 * nd.d1F + nd.mi32 * nd.d2F + nd.mi33 * nd.d3F)
+    / (sqrt((nd.mi11 * nd.d1F * nd.d1F + nd.mi22 * nd.d2F * nd.d2F + nd.mi33 * nd.d3F *nd.d3F
+             + 2.0 * (nd.mi12 * nd.d1F * nd.d2F + nd.mi13 * nd.d1F * nd.d3F + nd.mi23 * nd.d2F * nd.d3F))));
+
+  real_t K11 = nd.K11, K12 = nd.K12, K13 = nd.K13;
+  real_t K22 = nd.K22, K23 = nd.K23, K33 = nd.K33;
+
+  double det = kd->q11 * kd->q22 - kd->q12 * kd->q12;
+
+  return (k1 * s1 * K11 + k2 * s2 * K22 + k3 * s3 * K33
+          + k1 * s2 * K12 + k1 * s3 * K13 + k2 * s3 * K23
+          + k2 * s1 * K12 + k3 * s1 * K13 + k3 * s2 * K23) * sqrt(det);
+}
+
 void HorizonStatistics::convertToVector(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn)
 {
   const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+
+  if(batch_killing_transport)
+  {
+#pragma omp parallel for collapse(2)
+    for(int theta_i = 0; theta_i < n_theta; theta_i++)
+    {
+      for(int phi_i = 0; phi_i < n_phi; phi_i++)
+      {
+        double k_theta0 = k_theta[theta_i][phi_i];
+        double k_phi0 = k_phi[theta_i][phi_i];
+
+        KillingData *kd = surface_kd(theta_i*2, phi_i*2);
+
+        k_theta[theta_i][phi_i] = kd->qi11 * k_theta0 + kd->qi12 * k_phi0;
+        k_phi[theta_i][phi_i] = kd->qi12 * k_theta0 + kd->qi22 * k_phi0;
+      }
+    }
+    return;
+  }
+
   for(int theta_i = 0; theta_i < n_theta; theta_i++)
   {
     for(int phi_i = 0; phi_i < n_phi; phi_i++)
@@ -1933,6 +2334,22 @@ real_t HorizonStatistics::area(
   real_t dtheta = PI / (double)n_theta;
   real_t dphi = 2.0 * PI / (double)n_phi;
   real_t res = 0;
+
+  if(batch_killing_transport)
+  {
+#pragma omp parallel for collapse(2) reduction(+:res)
+    for(int theta_i = 0; theta_i < n_theta; theta_i++)
+    {
+      for(int phi_i = 0; phi_i < n_phi; phi_i++)
+      {
+        KillingData *kd = surface_kd(theta_i*2, phi_i*2);
+
+        res += sqrt(kd->q11 * kd->q22 - kd->q12 * kd->q12) * dtheta * dphi;
+      }
+    }
+    return res;
+  }
+
   for(int theta_i = 0; theta_i < n_theta; theta_i++)
   {
     for(int phi_i = 0; phi_i < n_phi; phi_i++)
@@ -1977,7 +2394,10 @@ void HorizonStatistics::findKilling(
 
   initGridding(hierarchy);
 
-  initG(hierarchy, bssn);
+  if(batch_killing_transport)
+    set_surface_values(hierarchy, bssn);
+  else
+    initG(hierarchy, bssn);
 
   double angular_m = 0;
 
@@ -1990,6 +2410,8 @@ void HorizonStatistics::findKilling(
   
     transportKillingPhi(hierarchy, n_theta/2, n_phi - 1, x[0], x[1], x[2], bssn);
 
+    // lines are independent once the surface data is local
+#pragma omp parallel for if(batch_killing_transport)
     for(int i = 0; i < n_phi; i++)
     {
       transportKillingTheta(
@@ -348,8 +348,39 @@ public:
   void set_norm_values(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
     double theta, double phi, int theta_i, int phi_i, double r, KillingData *kd, BSSN * bssn);
+
+  void set_G_values_local(
+    double theta, double phi, int theta_i, int phi_i, double r, KillingData *kd);
+  void set_kd_values_local(
+    double theta, double phi, int theta_i, int phi_i, double r, KillingData *kd);
+  void interpolate_kd_values(
+    BSSN * bssn, const real_t dx[], int i0, int j0, int k0,
+    double xd, double yd, double zd, KillingData *kd);
+
+  void interpolate_surface_values(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn,
+    const std::vector<real_t> & coords, std::vector<KillingData> & kds);
+  void set_surface_values(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn);
+  KillingData * surface_kd(int theta_i, int phi_i);
+  void getRadii(
+    const std::vector<real_t> & thetas, const std::vector<real_t> & phis,
+    std::vector<real_t> & radii, std::vector<real_t> & coords);
+
+  void ev_k_rhs(
+    KillingData *kd, int theta_i, int phi_i, bool along_theta, real_t res[]);
+  void transportKillingStepLocal(
+    int theta_i, int phi_i, int theta_f, int phi_f, double h, bool along_theta,
+    KillingData *kd_0, KillingData *kd_h, KillingData *kd_1);
+  void transportKillingThetaLocal(
+    idx_t phi_i, double k_theta_0, double k_phi_0, double k_L_0);
+  void transportKillingPhiLocal(
+    idx_t theta_i, idx_t phi_f, double k_theta_0, double k_phi_0, double k_L_0);
   real_t angularMomentum(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn);
+  real_t angularMomentumDensity(
+    double theta, double phi, double r, int theta_i, int phi_i,
+    KillingData *norm_kd, KillingData *kd);
   real_t area(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy, BSSN * bssn);
 
@@ -403,6 +434,13 @@ public:
   std::vector<std::vector<double>> G111, G112, G122, G211, G212, G222, ah_radius;
 
   bool non_zero_angular_momentum;
+
+  // gather the surface data in batched collectives and transport
+  // the Killing vector locally
+  bool batch_killing_transport;
+  // surface data on the half-step points, see set_surface_values
+  std::vector<KillingData> kd_table;
+  std::vector<real_t> kd_radius;
   AHFinderDirect::Horizon *horizon;  
   int horizon_id;
 };
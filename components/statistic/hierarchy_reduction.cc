@@ -0,0 +1,156 @@
+#include "../../cosmo_includes.h"
+#include "hierarchy_reduction.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief combine two packed reduction buffers into inout, the first
+ *        entry holds the number of sums, the maxima follow the sums
+ */
+static void combine_reduction_buffers(
+  const double * in, double * inout, idx_t n_values)
+{
+  const idx_t n_sums = static_cast<idx_t>(in[0]);
+
+  for(idx_t v = 1; v <= n_sums; v++)
+    inout[v] += in[v];
+  for(idx_t v = n_sums + 1; v < n_values; v++)
+    inout[v] = std::max(inout[v], in[v]);
+}
+
+/**
+ * @brief MPI operator on whole packed buffers (one element of a contiguous
+ *        type), so sums and maxima go through a single MPI_Allreduce
+ */
+static void reduction_buffer_op(
+  void * in, void * inout, int * len, MPI_Datatype * type)
+{
+  int type_size;
+  MPI_Type_size(*type, &type_size);
+  const idx_t n_values = type_size / sizeof(double);
+
+  for(int e = 0; e < *len; e++)
+    combine_reduction_buffers(
+      static_cast<double *>(in) + e * n_values,
+      static_cast<double *>(inout) + e * n_values, n_values);
+}
+
+HierarchyReduction::HierarchyReduction():
+  n_sums(0),
+  n_maxima(0)
+{
+}
+
+/**
+ * @brief register a kernel, kernels are applied to every cell in the
+ *        order they were added
+ *
+ * @param kernel
+ * @param n_sums_in number of sums the kernel accumulates
+ * @param n_maxima_in number of maxima the kernel accumulates
+ */
+void HierarchyReduction::addKernel(
+  const std::shared_ptr<ReductionKernel> & kernel,
+  idx_t n_sums_in, idx_t n_maxima_in)
+{
+  registered_kernel_t rk;
+  rk.kernel = kernel;
+  rk.sum_offset = n_sums;
+  rk.max_offset = n_maxima;
+  kernels.push_back(rk);
+
+  n_sums += n_sums_in;
+  n_maxima += n_maxima_in;
+}
+
+/**
+ * @brief accumulate all kernels over the hierarchy and hand them the
+ *        global results, has to be called by all ranks
+ *
+ * @param hierarchy
+ */
+void HierarchyReduction::sweep(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy)
+{
+  if(kernels.empty()) return;
+
+  const idx_t n_kernels = kernels.size();
+  const idx_t n_values = 1 + n_sums + n_maxima;
+
+  std::vector<double> identity(n_values);
+  identity[0] = n_sums;
+  std::fill(identity.begin() + 1, identity.begin() + 1 + n_sums, 0.0);
+  std::fill(identity.begin() + 1 + n_sums, identity.end(),
+            -std::numeric_limits<double>::max());
+
+  std::vector<double> values(identity);
+
+  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
+  {
+    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+
+      for(idx_t kn = 0; kn < n_kernels; kn++)
+        kernels[kn].kernel->initPatch(patch, ln);
+
+      const hier::Box& box = patch->getBox();
+
+      const int * lower = &box.lower()[0];
+      const int * upper = &box.upper()[0];
+
+#pragma omp parallel
+      {
+        std::vector<double> local(identity);
+        double * sums = local.data() + 1;
+        double * maxima = local.data() + 1 + n_sums;
+
+#pragma omp for collapse(2) schedule(static)
+        for(int k = lower[2]; k <= upper[2]; k++)
+        {
+          for(int j = lower[1]; j <= upper[1]; j++)
+          {
+            for(int i = lower[0]; i <= upper[0]; i++)
+            {
+              for(idx_t kn = 0; kn < n_kernels; kn++)
+                kernels[kn].kernel->accumulate(
+                  i, j, k,
+                  sums + kernels[kn].sum_offset,
+                  maxima + kernels[kn].max_offset);
+            }
+          }
+        }
+
+#pragma omp critical
+        combine_reduction_buffers(local.data(), values.data(), n_values);
+      }
+    }
+  }
+
+  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
+  if (mpi.getSize() > 1) {
+    MPI_Datatype buffer_type;
+    MPI_Op buffer_op;
+    MPI_Type_contiguous(n_values, MPI_DOUBLE, &buffer_type);
+    MPI_Type_commit(&buffer_type);
+    MPI_Op_create(&reduction_buffer_op, 1, &buffer_op);
+
+    MPI_Allreduce(MPI_IN_PLACE, values.data(), 1, buffer_type, buffer_op,
+                  mpi.getCommunicator());
+
+    MPI_Op_free(&buffer_op);
+    MPI_Type_free(&buffer_type);
+  }
+
+  for(idx_t kn = 0; kn < n_kernels; kn++)
+    kernels[kn].kernel->finalize(
+      values.data() + 1 + kernels[kn].sum_offset,
+      values.data() + 1 + n_sums + kernels[kn].max_offset);
+}
+
+}
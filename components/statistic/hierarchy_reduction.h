@@ -0,0 +1,68 @@
+#ifndef COSMO_HIERARCHY_REDUCTION_H
+#define COSMO_HIERARCHY_REDUCTION_H
+
+#include "../../cosmo_includes.h"
+
+using namespace SAMRAI;
+
+namespace cosmo{
+
+/**
+ * @brief quantity (or set of quantities) accumulated cell by cell over the
+ *        hierarchy by a HierarchyReduction
+ */
+class ReductionKernel
+{
+ public:
+  virtual ~ReductionKernel() {}
+
+  /**
+   * @brief set up cell access for a patch, called before its cells are
+   *        swept and outside of parallel regions
+   */
+  virtual void initPatch(
+    const std::shared_ptr<hier::Patch> & patch, idx_t ln) = 0;
+
+  /**
+   * @brief add cell (i, j, k) of the current patch to the sums and maxima
+   *        of the calling thread, called concurrently for different cells
+   */
+  virtual void accumulate(
+    idx_t i, idx_t j, idx_t k, double * sums, double * maxima) = 0;
+
+  /**
+   * @brief receive the sums and maxima reduced over all cells and ranks
+   */
+  virtual void finalize(const double * sums, const double * maxima) = 0;
+};
+
+/**
+ * @brief sweeps the hierarchy once for all registered kernels, with
+ *        thread-local accumulation and one packed MPI_Allreduce
+ */
+class HierarchyReduction
+{
+ public:
+  HierarchyReduction();
+
+  void addKernel(
+    const std::shared_ptr<ReductionKernel> & kernel,
+    idx_t n_sums, idx_t n_maxima);
+
+  bool empty() const { return kernels.empty(); }
+
+  void sweep(const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
+
+ private:
+  struct registered_kernel_t
+  {
+    std::shared_ptr<ReductionKernel> kernel;
+    idx_t sum_offset, max_offset;
+  };
+
+  std::vector<registered_kernel_t> kernels;
+  idx_t n_sums, n_maxima;
+};
+
+}
+#endif
@@ -37,729 +37,486 @@ CosmoStatistic::CosmoStatistic(
   
 }
 
-real_t CosmoStatistic::calculate_conformal_avg(
-  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
-  BSSN *bssn,
-  idx_t weight_idx,
-  idx_t field_idx,
-  //calculating conformal avg only on boundary
-  bool only_on_bd,
-  double min_radius)
+
+/**
+ * @brief physical size of the simulation domain
+ */
+static void get_domain_size(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy, real_t L[])
 {
   std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
     SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
       hierarchy->getGridGeometry()));
   TBOX_ASSERT(grid_geometry_);
   geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
-  const double * dx = &grid_geometry.getDx()[0];
 
-  real_t L[3];
   const double * domain_lower = &grid_geometry.getXLower()[0];
   const double * domain_upper = &grid_geometry.getXUpper()[0];
 
-  for(int i = 0 ; i < 3; i++)
+  for(int i = 0 ; i < DIM; i++)
     L[i] = domain_upper[i] - domain_lower[i];
+}
 
-  int output_num = static_cast<idx_t>(conformal_avg_list.size());
-  double conformal_avg = 0;
+static arr_t get_cell_array(
+  const std::shared_ptr<hier::Patch> & patch, idx_t idx)
+{
+  std::shared_ptr<pdat::CellData<double> > cell_data(
+    SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+      patch->getPatchData(idx)));
 
-  arr_t * arrays = new arr_t[output_num];
+  return pdat::ArrayDataAccess::access<DIM, double>(
+    cell_data->getArrayData());
+}
 
-  double tot_vol = 0;
+/**
+ * @brief conformal volume average of fields outside min_radius, or their
+ *        average along the 12 domain edges weighted by proper length
+ */
+class ConformalAvgKernel : public ReductionKernel
+{
+ public:
+  ConformalAvgKernel(
+    BSSN *bssn_in,
+    idx_t weight_idx_in,
+    const std::vector<idx_t> & field_idx_in,
+    const real_t L_in[],
+    bool only_on_bd_in,
+    real_t min_radius_in,
+    std::ostream * lstream_in,
+    const std::vector<std::string> * names_in):
+    bssn(bssn_in),
+    weight_idx(weight_idx_in),
+    field_idx(field_idx_in),
+    only_on_bd(only_on_bd_in),
+    min_radius(min_radius_in),
+    lstream(lstream_in),
+    names(names_in),
+    arrays(field_idx_in.size()),
+    tot_vol(0),
+    avg(field_idx_in.size(), 0)
+  {
+    for(int d = 0; d < DIM; d++)
+      L[d] = L_in[d];
+  }
 
-  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
+  void initPatch(const std::shared_ptr<hier::Patch> & patch, idx_t ln)
   {
-    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+    const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+      SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+        patch->getPatchGeometry()));
 
-    
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
+    for(int d = 0; d < DIM; d++)
     {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
+      dx[d] = patch_geom->getDx()[d];
+      n_cells[d] = round(L[d] / dx[d]);
+    }
 
-      const hier::Box& box = patch->getBox();
+    bssn->initPData(patch);
+    bssn->initMDA(patch);
 
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
+    weight_array = get_cell_array(patch, weight_idx);
+    DIFFchi = bssn->DIFFchi_a;
+    gamma[0] = bssn->DIFFgamma11_a;
+    gamma[1] = bssn->DIFFgamma22_a;
+    gamma[2] = bssn->DIFFgamma33_a;
 
-      bssn->initPData(patch);
+    for(idx_t f = 0; f < (idx_t)field_idx.size(); f++)
+      arrays[f] = get_cell_array(patch, field_idx[f]);
+  }
 
-      bssn->initMDA(patch);
+  void accumulate(idx_t i, idx_t j, idx_t k, double * sums, double * maxima)
+  {
+    double w = 0;
 
+    if(only_on_bd)
+    {
+      const idx_t idx[3] = {i, j, k};
+      // edges along direction d
+      for(int d = 0; d < 3; d++)
+      {
+        const int a = (d + 1) % 3, b = (d + 2) % 3;
+        if((idx[a] == 0 || idx[a] == n_cells[a] - 1)
+           && (idx[b] == 0 || idx[b] == n_cells[b] - 1))
+          w += dx[d] * (gamma[d](i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
+      }
+    }
+    else
+    {
+      double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
+      double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
+      double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
+      double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
 
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
+      if(weight_array(i,j,k) > 0 && r > min_radius)
+        w = weight_array(i, j, k) / pw3(DIFFchi(i, j, k) + 1.0);
+    }
 
-      arr_t DIFFchi_array = bssn->DIFFchi_a;
+    sums[0] += w;
+    for(idx_t f = 0; f < (idx_t)arrays.size(); f++)
+      sums[1 + f] += w * arrays[f](i, j, k);
+  }
 
-      arr_t gamma11 = bssn->DIFFgamma11_a;
-      arr_t gamma12 = bssn->DIFFgamma12_a;
-      arr_t gamma13 = bssn->DIFFgamma13_a;
-      arr_t gamma22 = bssn->DIFFgamma22_a;
-      arr_t gamma23 = bssn->DIFFgamma23_a;
-      arr_t gamma33 = bssn->DIFFgamma33_a;
+  void finalize(const double * sums, const double * maxima)
+  {
+    tot_vol = sums[0];
+    for(idx_t f = 0; f < (idx_t)avg.size(); f++)
+      avg[f] = sums[1 + f] / tot_vol;
 
-      
-      std::shared_ptr<pdat::CellData<double> > var_cell_data(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(field_idx)));
+    if(lstream == NULL) return;
 
-      arr_t array = pdat::ArrayDataAccess::access<DIM, double>(
-        var_cell_data->getArrayData());
-      
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
-      
-      const double *dx = &patch_geom->getDx()[0];
+    (*lstream)<<"Total vol is " << tot_vol<<"\n";
 
-      
-#pragma omp parallel for collapse(2) reduction(+:tot_vol, conformal_avg)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-            if(only_on_bd)
-            {
-              if(i == 0 && j == 0)
-              {
-                tot_vol +=  dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(i == 0 && j == (round(L[1]/dx[1])) - 1)
-              {
-                tot_vol += dx[2] * (gamma33(i, j, k) + 1.0)  / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(j == 0 && i == round(L[0]/dx[0]) - 1)
-              {
-                tot_vol += dx[2] * (gamma33(i, j, k) + 1.0)  / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-
-              }
-              else if(i == round(L[0]/dx[0]) - 1 && j == (round(L[1]/dx[1])) - 1)
-              {
-                tot_vol += dx[2] * (gamma33(i, j, k) + 1.0)  / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              if(i == 0 && k == 0)
-              {
-                tot_vol +=  dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(i == 0 && k == (round(L[2]/dx[2])) - 1)
-              {
-                tot_vol += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(k == 0 && i == round(L[0]/dx[0]) - 1)
-              {
-                tot_vol += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(i == round(L[0]/dx[0]) - 1 && k == (round(L[2]/dx[2])) - 1)
-              {
-                tot_vol += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-                            
-              if(k == 0 && j == 0)
-              {
-                tot_vol +=  dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(j == 0 && k == (round(L[2]/dx[2])) - 1)
-              {
-                tot_vol += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-              else if(k == 0 && j == (round(L[1]/dx[1])) - 1)
-              {
-                tot_vol += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-
-              }
-              else if(j == (round(L[1]/dx[1])) - 1 && k == (round(L[2]/dx[2])) - 1)
-              {
-                tot_vol += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0);
-                conformal_avg += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi_array(i, j, k) + 1.0)
-                  * array(i, j, k);
-              }
-
-              continue;
-            }
-            double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
-            double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
-            double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
-            double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
-
-            if(weight_array(i,j,k) > 0 && r > min_radius)
-            {
-              tot_vol += weight_array(i, j, k) * 1.0 / pw3(DIFFchi_array(i, j, k) + 1.0);
-              conformal_avg +=
-                1.0 / pw3(DIFFchi_array(i, j, k) + 1.0) * array(i, j, k)
-                * weight_array(i, j, k);
-            }
-          }
-        }
-      }
+    for(idx_t f = 0; f < (idx_t)avg.size(); f++)
+    {
+      (*lstream)<<"Conformal Avg for "<<(*names)[f]
+                <<" is "
+                <<std::setprecision(12)<<avg[f]<<"\n";
     }
   }
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&tot_vol, 1, MPI_SUM);
-    mpi.AllReduce(&conformal_avg, 1, MPI_SUM);
-  }
-
-  return conformal_avg / tot_vol;
-  
-}
 
-void CosmoStatistic::output_expansion_info(
-    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
-    BSSN *bssn,
-    idx_t weight_idx,
-    idx_t step_num,
-    real_t time,
-    real_t min_radius)
+  idx_t numSums() const { return 1 + field_idx.size(); }
+
+  const std::vector<real_t> & getAvg() const { return avg; }
+
+ private:
+  BSSN *bssn;
+  idx_t weight_idx;
+  std::vector<idx_t> field_idx;
+  bool only_on_bd;
+  real_t min_radius;
+  std::ostream * lstream;
+  const std::vector<std::string> * names;
+
+  real_t L[DIM], dx[DIM];
+  idx_t n_cells[DIM];
+  arr_t weight_array, DIFFchi, gamma[3];
+  std::vector<arr_t> arrays;
+
+  real_t tot_vol;
+  std::vector<real_t> avg;
+};
+
+/**
+ * @brief areas of the 6 domain faces and lengths of its 12 edges, with
+ *        face / edge averages of K^2, AijAij, Ricci (and tau) on them and
+ *        the volume average of K^2, all outside min_radius
+ */
+class ExpansionInfoKernel : public ReductionKernel
 {
-  if( expansion_info_interval == 0 || step_num % expansion_info_interval != 0)
-    return;
-  
-  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
-    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
-      hierarchy->getGridGeometry()));
-  TBOX_ASSERT(grid_geometry_);
-  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
-  const double * dx = &grid_geometry.getDx()[0];
-
-  const double * domain_lower = &grid_geometry.getXLower()[0];
-  const double * domain_upper = &grid_geometry.getXUpper()[0];
-
-  int coarsest_boxes[3];
-
-  double L[DIM];
-  for(int i = 0 ; i < DIM; i++)
-    L[i] = domain_upper[i] - domain_lower[i];
+ public:
+  // weights on faces / edges: 1 (area / length), K^2, AijAij, Ricci, tau
+#if USE_PROPER_TIME
+  static const idx_t n_quantities = 5;
+#else
+  static const idx_t n_quantities = 4;
+#endif
+  // sums are tot_vol, Ksq_vol, 6 faces per quantity, 12 edges per quantity
+  static const idx_t face_offset = 2;
+  static const idx_t edge_offset = face_offset + 6 * n_quantities;
+  static const idx_t n_sums = edge_offset + 12 * n_quantities;
+
+  ExpansionInfoKernel(
+    BSSN *bssn_in,
+    idx_t weight_idx_in,
+    const real_t L_in[],
+    real_t min_radius_in,
+    std::ostream * lstream_in):
+    bssn(bssn_in),
+    weight_idx(weight_idx_in),
+    min_radius(min_radius_in),
+    lstream(lstream_in)
+  {
+    for(int d = 0; d < DIM; d++)
+      L[d] = L_in[d];
+  }
 
-  
-  for(int i = 0; i < 3; i++)
-    coarsest_boxes[i] = round((domain_upper[i] - domain_lower[i]) / dx[i] );
-  
-  double tot_vol = 0;
-  double face_area[6] = {0}; //(0, y, z), (L, y, z), (x, 0, z), (x, L, z), (x, y, 0), (x, y, L)
-  double K_face[6] = {0};
-
-  double Ksq_vol = 0;
-  //(0, 0, z), (0, L, z), (L, 0, z), (L, L, z)
-  //(0, y, 0), (0, y, L), (L, 0, z), (L, y, L)
-  //(x, 0, 0), (x, 0, L), (x, L, 0), (x, L, L)
-  double edge_length[12] = {0};
-  double K_edge[12] = {0};
-
-  #if USE_PROPER_TIME
-  double tau_face[6] = {0};
-  double tau_edge[12] = {0};
-  #endif
-
-  double AijAij_face[6] = {0};
-  double AijAij_edge[12] = {0};
-
-  double ricci_face[6] = {0};
-  double ricci_edge[12] = {0};
-  
-  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
+  void initPatch(const std::shared_ptr<hier::Patch> & patch, idx_t ln)
   {
-    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+    const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+      SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+        patch->getPatchGeometry()));
 
-    
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
+    for(int d = 0; d < DIM; d++)
     {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
+      dx[d] = patch_geom->getDx()[d];
+      n_cells[d] = round(L[d] / dx[d]);
+    }
 
-      const hier::Box& box = patch->getBox();
+    bssn->initPData(patch);
+    bssn->initMDA(patch);
+
+    weight_array = get_cell_array(patch, weight_idx);
+    DIFFchi = bssn->DIFFchi_a;
+    K = bssn->DIFFK_a;
+    gamma[0][0] = bssn->DIFFgamma11_a;
+    gamma[0][1] = gamma[1][0] = bssn->DIFFgamma12_a;
+    gamma[0][2] = gamma[2][0] = bssn->DIFFgamma13_a;
+    gamma[1][1] = bssn->DIFFgamma22_a;
+    gamma[1][2] = gamma[2][1] = bssn->DIFFgamma23_a;
+    gamma[2][2] = bssn->DIFFgamma33_a;
+    AijAij = bssn->AijAij_a;
+    ricci = bssn->ricci_a;
+#if USE_PROPER_TIME
+    tau = bssn->tau_a;
+#endif
+  }
 
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
+  void accumulate(idx_t i, idx_t j, idx_t k, double * sums, double * maxima)
+  {
+    double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
+    double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
+    double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
+    double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
 
-      bssn->initPData(patch);
+    if(weight_array(i,j,k) <= 0 || r <= min_radius)
+      return;
 
-      bssn->initMDA(patch);
+    const double chi = DIFFchi(i, j, k) + 1.0;
 
+    sums[0] += weight_array(i, j, k) * 1.0 / pw3(chi);
+    sums[1] += weight_array(i, j, k) * 1.0 / pw3(chi) * pw2(K(i , j, k));
 
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
+    const double q[n_quantities] = {
+      1.0, pw2(K(i, j, k)), AijAij(i, j, k), ricci(i, j, k)
+#if USE_PROPER_TIME
+      , tau(i, j, k)
+#endif
+    };
 
-      arr_t DIFFchi = bssn->DIFFchi_a;
-      arr_t K = bssn->DIFFK_a;
-      arr_t gamma11 = bssn->DIFFgamma11_a;
-      arr_t gamma12 = bssn->DIFFgamma12_a;
-      arr_t gamma13 = bssn->DIFFgamma13_a;
-      arr_t gamma22 = bssn->DIFFgamma22_a;
-      arr_t gamma23 = bssn->DIFFgamma23_a;
-      arr_t gamma33 = bssn->DIFFgamma33_a;
-      arr_t AijAij = bssn->AijAij_a;
-      arr_t ricci = bssn->ricci_a;
-      #if USE_PROPER_TIME
-      arr_t tau = bssn->tau_a;
-      #endif
+    const idx_t idx[3] = {i, j, k};
 
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
-      
-      const double *dx = &patch_geom->getDx()[0];
+    // faces (0, y, z), (L, y, z), (x, 0, z), (x, L, z), (x, y, 0), (x, y, L)
+    for(int d = 0; d < 3; d++)
+    {
+      const int a = (d == 0) ? 1 : 0, b = (d == 2) ? 1 : 2;
+      idx_t f;
+      if(idx[d] == 0)
+        f = 2 * d;
+      else if(idx[d] == n_cells[d] - 1)
+        f = 2 * d + 1;
+      else
+        continue;
+
+      double sq_det2 = ((gamma[a][a](i, j, k) + 1.0) * (gamma[b][b](i, j, k) + 1.0)
+                        - pw2(gamma[a][b](i, j, k))) / pw2(chi);
+      for(idx_t n = 0; n < n_quantities; n++)
+        sums[face_offset + 6 * n + f] += dx[a] * dx[b] * sq_det2 * q[n];
+    }
 
+    // edges (0, 0, z), (0, L, z), (L, 0, z), (L, L, z),
+    // (0, y, 0), (0, y, L), (L, y, 0), (L, y, L),
+    // (x, 0, 0), (x, 0, L), (x, L, 0), (x, L, L)
+    for(int d = 2; d >= 0; d--)
+    {
+      const int a = (d == 0) ? 1 : 0, b = (d == 2) ? 1 : 2;
+      if((idx[a] != 0 && idx[a] != n_cells[a] - 1)
+         || (idx[b] != 0 && idx[b] != n_cells[b] - 1))
+        continue;
 
-      //#pragma omp parallel for collapse(2) reduction(+:tot_vol)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-            double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
-            double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
-            double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
-            double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
-
-            if(weight_array(i,j,k) > 0 && r > min_radius)
-            {
-              tot_vol += weight_array(i, j, k) * 1.0 / pw3(DIFFchi(i, j, k) + 1.0);
-
-              Ksq_vol += weight_array(i, j, k) * 1.0 / pw3(DIFFchi(i, j, k) + 1.0) * pw2(K(i , j, k)); 
-              
-              if(i == 0)
-              {
-                double sq_det2 = ((gamma22(i, j, k) + 1.0) * (gamma33(i, j, k) + 1.0)
-                                  - pw2(gamma23(i, j, k))) / pw2(DIFFchi(i, j, k) + 1.0);
-                face_area[0] += dx[1] * dx[2] * sq_det2;
-                K_face[0] += dx[1] * dx[2] * sq_det2 * pw2(K(i, j, k));
-                #if USE_PROPER_TIME
-                tau_face[0] += dx[1] * dx[2] * sq_det2 * tau(i, j, k);
-                #endif
-                AijAij_face[0] += dx[1] * dx[2] * sq_det2 * AijAij(i, j, k);
-                ricci_face[0] += dx[1] * dx[2] * sq_det2 * ricci(i, j, k);
-              }
-              else if(i == (coarsest_boxes[0] << ln) - 1)
-              {
-                double sq_det2 = ( (gamma22(i, j, k) + 1.0)* (gamma33(i, j, k)  + 1.0)
-                                   - pw2(gamma23(i, j, k))) / pw2(DIFFchi(i, j, k) + 1.0);
-                face_area[1] += dx[1] * dx[2] * sq_det2;
-                K_face[1] += dx[1] * dx[2] * sq_det2 * pw2(K(i, j, k));
-                #if USE_PROPER_TIME
-                tau_face[1] += dx[1] * dx[2] * sq_det2 * tau(i, j, k);
-                #endif
-                AijAij_face[1] += dx[1] * dx[2] * sq_det2 * AijAij(i, j, k);
-                ricci_face[1] += dx[1] * dx[2] * sq_det2 * ricci(i, j, k);
-              }
-              if(j == 0)
-              {
-                double sq_det2 = ( (gamma11(i, j, k) + 1.0)* (gamma33(i, j, k) + 1.0)
-                                   - pw2(gamma13(i, j, k))) / pw2(DIFFchi(i, j, k) + 1.0);
-                face_area[2] += dx[0] * dx[2] * sq_det2;
-                K_face[2] += dx[0] * dx[2] * sq_det2 * pw2(K(i, j, k));
-                #if USE_PROPER_TIME
-                tau_face[2] += dx[0] * dx[2] * sq_det2 * tau(i, j, k);
-                #endif
-                AijAij_face[2] += dx[0] * dx[2] * sq_det2 * AijAij(i, j, k);
-                ricci_face[2] += dx[0] * dx[2] * sq_det2 * ricci(i, j, k);
-              }
-              else if(j == (coarsest_boxes[1] << ln) - 1)
-              {
-                double sq_det2 = ((gamma11(i, j, k) + 1.0) * (gamma33(i, j, k) + 1.0)
-                                  - pw2(gamma13(i, j, k))) / pw2(DIFFchi(i, j, k) + 1.0);
-                face_area[3] += dx[0] * dx[2] * sq_det2;
-                K_face[3] += dx[0] * dx[2] * sq_det2 * pw2(K(i, j, k));
-                #if USE_PROPER_TIME
-                tau_face[3] += dx[0] * dx[2] * sq_det2 * tau(i, j, k);
-                #endif
-                AijAij_face[3] += dx[0] * dx[2] * sq_det2 * AijAij(i, j, k);
-                ricci_face[3] += dx[0] * dx[2] * sq_det2 * ricci(i, j, k);
-              }
-              if(k == 0)
-              {
-                double sq_det2 = ((gamma11(i, j, k) + 1.0) * (gamma22(i, j, k) + 1.0)
-                                  - pw2(gamma12(i, j, k))) / pw2(DIFFchi(i, j, k) + 1.0);
-                face_area[4] += dx[0] * dx[1] * sq_det2;
-                K_face[4] += dx[1] * dx[0] * sq_det2 * pw2(K(i, j, k));
-                #if USE_PROPER_TIME
-                tau_face[4] += dx[1] * dx[0] * sq_det2 * tau(i, j, k);
-                #endif
-                AijAij_face[4] += dx[1] * dx[0] * sq_det2 * AijAij(i, j, k);
-                ricci_face[4] += dx[1] * dx[0] * sq_det2 * ricci(i, j, k);
-              }
-              else if(k == (coarsest_boxes[2] << ln) - 1)
-              {
-                double sq_det2 = ((gamma11(i, j, k) + 1.0) * (gamma22(i, j, k) + 1.0)
-                                  - pw2(gamma12(i, j, k))) / pw2(DIFFchi(i, j, k) + 1.0);
-                face_area[5] += dx[0] * dx[1] * sq_det2;
-                K_face[5] += dx[1] * dx[0] * sq_det2 * pw2(K(i, j, k));
-                #if USE_PROPER_TIME
-                tau_face[5] += dx[1] * dx[0] * sq_det2 * tau(i, j, k);
-                #endif
-                AijAij_face[5] += dx[1] * dx[0] * sq_det2 * AijAij(i, j, k);
-                ricci_face[5] += dx[1] * dx[0] * sq_det2 * ricci(i, j, k);
-              }
-
-              if(i == 0 && j == 0)
-              {
-                edge_length[0] +=  dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[0] += pw2(K(i, j, k)) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[0] += tau(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[0] += AijAij(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[0] += ricci(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(i == 0 && j == (coarsest_boxes[1] << ln) - 1)
-              {
-                edge_length[1] += dx[2] * (gamma33(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                K_edge[1] += pw2(K(i, j, k)) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[1] += tau(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #endif
-                AijAij_edge[1] += AijAij(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[1] += ricci(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(j == 0 && i == (coarsest_boxes[0] << ln) - 1)
-              {
-                edge_length[2] += dx[2] * (gamma33(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                K_edge[2] += pw2(K(i, j, k)) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[2] += tau(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #endif
-                AijAij_edge[2] += AijAij(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[2] += ricci(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(i == (coarsest_boxes[0] << ln) - 1 && j == (coarsest_boxes[1] << ln) - 1)
-              {
-                edge_length[3] += dx[2] * (gamma33(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                K_edge[3] += pw2(K(i, j, k)) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[3] += tau(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                #endif
-                AijAij_edge[3] += AijAij(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[3] += ricci(i, j, k) * dx[2] * (gamma33(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-              }
-
-              if(i == 0 && k == 0)
-              {
-                edge_length[4] +=  dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                K_edge[4] += pw2(K(i, j, k)) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[4] += tau(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[4] += AijAij(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[4] += ricci(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(i == 0 && k == (coarsest_boxes[2] << ln) - 1)
-              {
-                edge_length[5] += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[5] += pw2(K(i, j, k)) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[5] += tau(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[5] += AijAij(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[5] += ricci(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(k == 0 && i == (coarsest_boxes[0] << ln) - 1)
-              {
-                edge_length[6] += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[6] += pw2(K(i, j, k)) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[6] += tau(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[6] += AijAij(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[6] += ricci(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(i == (coarsest_boxes[0] << ln) - 1 && k == (coarsest_boxes[2] << ln) - 1)
-              {
-                edge_length[7] += dx[1] * (gamma22(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[7] += pw2(K(i, j, k)) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[7] += tau(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[7] += AijAij(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[7] += ricci(i, j, k) * dx[1] * (gamma22(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-                            
-              if(k == 0 && j == 0)
-              {
-                edge_length[8] +=  dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[8] += pw2(K(i, j, k)) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[8] += tau(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[8] += AijAij(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[8] += ricci(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(j == 0 && k == (coarsest_boxes[2] << ln) - 1)
-              {
-                edge_length[9] += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[9] += pw2(K(i, j, k)) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[9] += tau(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[9] += AijAij(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[9] += ricci(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(k == 0 && j == (coarsest_boxes[1] << ln) - 1)
-              {
-                edge_length[10] += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[10] += pw2(K(i, j, k)) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[10] += tau(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[10] += AijAij(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[10] += ricci(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              else if(j == (coarsest_boxes[1] << ln) - 1 && k == (coarsest_boxes[2] << ln) - 1)
-              {
-                edge_length[11] += dx[0] * (gamma11(i, j, k) + 1.0) / (DIFFchi(i, j, k) + 1.0);
-                K_edge[11] += pw2(K(i, j, k)) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                #if USE_PROPER_TIME
-                tau_edge[11] += tau(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);                
-                #endif
-                AijAij_edge[11] += AijAij(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-                ricci_edge[11] += ricci(i, j, k) * dx[0] * (gamma11(i, j, k) + 1.0)  / (DIFFchi(i, j, k) + 1.0);
-              }
-              
-            }
-          }
-        }
-      }
+      const idx_t e = 4 * (2 - d) + 2 * (idx[a] != 0) + (idx[b] != 0);
+
+      double length = dx[d] * (gamma[d][d](i, j, k) + 1.0) / chi;
+      for(idx_t n = 0; n < n_quantities; n++)
+        sums[edge_offset + 12 * n + e] += length * q[n];
     }
   }
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&tot_vol, 1, MPI_SUM);
-    mpi.AllReduce(&face_area[0], 6, MPI_SUM);
-    mpi.AllReduce(&edge_length[0], 12, MPI_SUM);
-    mpi.AllReduce(&K_face[0], 6, MPI_SUM);
-    mpi.AllReduce(&K_edge[0], 12, MPI_SUM);
-    mpi.AllReduce(&AijAij_face[0], 6, MPI_SUM);
-    mpi.AllReduce(&AijAij_edge[0], 12, MPI_SUM);
-    mpi.AllReduce(&ricci_face[0], 6, MPI_SUM);
-    mpi.AllReduce(&ricci_edge[0], 12, MPI_SUM);
+
+  void finalize(const double * sums, const double * maxima)
+  {
+    const double tot_vol = sums[0], Ksq_vol = sums[1];
+    const double * face_area = sums + face_offset;
+    const double * K_face = face_area + 6;
+    const double * AijAij_face = face_area + 12;
+    const double * ricci_face = face_area + 18;
+    const double * edge_length = sums + edge_offset;
+    const double * K_edge = edge_length + 12;
+    const double * AijAij_edge = edge_length + 24;
+    const double * ricci_edge = edge_length + 36;
 #if USE_PROPER_TIME
-    mpi.AllReduce(&tau_face[0], 6, MPI_SUM);
-    mpi.AllReduce(&tau_edge[0], 12, MPI_SUM);
+    const double * tau_face = face_area + 24;
+    const double * tau_edge = edge_length + 48;
 #endif
-    mpi.AllReduce(&Ksq_vol, 1, MPI_SUM);
-  }
 
-  (*lstream).precision(7);
-  (*lstream)<<"**********Start outputing expansion info****** " <<"\n";
+    (*lstream).precision(7);
+    (*lstream)<<"**********Start outputing expansion info****** " <<"\n";
 
-  (*lstream)<<"Total vol is " <<tot_vol<<"\n";
+    (*lstream)<<"Total vol is " <<tot_vol<<"\n";
 
-  (*lstream)<<"6 faces areas are ";
-  for(int i = 0; i < 6; i++)
-    (*lstream)<<face_area[i]<<" ";
-  (*lstream)<<"\n";
+    (*lstream)<<"6 faces areas are ";
+    for(int i = 0; i < 6; i++)
+      (*lstream)<<face_area[i]<<" ";
+    (*lstream)<<"\n";
 
-  (*lstream)<<"Ksq on 6 faces areas are ";
-  for(int i = 0; i < 6; i++)
-    (*lstream)<<K_face[i] / face_area[i]<<" ";
-  (*lstream)<<"\n";
+    (*lstream)<<"Ksq on 6 faces areas are ";
+    for(int i = 0; i < 6; i++)
+      (*lstream)<<K_face[i] / face_area[i]<<" ";
+    (*lstream)<<"\n";
 
-  (*lstream)<<"AijAij on 6 faces areas are ";
-  for(int i = 0; i < 6; i++)
-    (*lstream)<<AijAij_face[i] / face_area[i]<<" ";
-  (*lstream)<<"\n";
+    (*lstream)<<"AijAij on 6 faces areas are ";
+    for(int i = 0; i < 6; i++)
+      (*lstream)<<AijAij_face[i] / face_area[i]<<" ";
+    (*lstream)<<"\n";
 
-  (*lstream)<<"Ricci on 6 faces areas are ";
-  for(int i = 0; i < 6; i++)
-    (*lstream)<<ricci_face[i] / face_area[i]<<" ";
-  (*lstream)<<"\n";
+    (*lstream)<<"Ricci on 6 faces areas are ";
+    for(int i = 0; i < 6; i++)
+      (*lstream)<<ricci_face[i] / face_area[i]<<" ";
+    (*lstream)<<"\n";
 
-  
 #if USE_PROPER_TIME
-  (*lstream)<<"Tau on 6 faces areas are ";
-  for(int i = 0; i < 6; i++)
-    (*lstream)<<tau_face[i] / face_area[i]<<" ";
-  (*lstream)<<"\n";  
+    (*lstream)<<"Tau on 6 faces areas are ";
+    for(int i = 0; i < 6; i++)
+      (*lstream)<<tau_face[i] / face_area[i]<<" ";
+    (*lstream)<<"\n";  
 #endif
 
-  
-  
-  (*lstream)<<"12 edges lengthes are ";
-  for(int i = 0; i < 12; i++)
-    (*lstream)<<edge_length[i]<<" ";
-  (*lstream)<<"\n";
-
-  (*lstream)<<"Ksq on 12 edges lengthes are ";
-  for(int i = 0; i < 12; i++)
-    (*lstream)<<K_edge[i] / edge_length[i]<<" ";
-  (*lstream)<<"\n";
-
-  (*lstream)<<"AijAij on 12 edges lengthes are ";
-  for(int i = 0; i < 12; i++)
-    (*lstream)<<AijAij_edge[i] / edge_length[i]<<" ";
-  (*lstream)<<"\n";
-
-  (*lstream)<<"Ricci on 12 edges lengthes are ";
-  for(int i = 0; i < 12; i++)
-    (*lstream)<<ricci_edge[i] / edge_length[i]<<" ";
-  (*lstream)<<"\n";
+    (*lstream)<<"12 edges lengthes are ";
+    for(int i = 0; i < 12; i++)
+      (*lstream)<<edge_length[i]<<" ";
+    (*lstream)<<"\n";
 
-  
-#if USE_PROPER_TIME
-  (*lstream)<<"Tau on 12 edges lengthes are ";
-  for(int i = 0; i < 12; i++)
-    (*lstream)<<tau_edge[i] / edge_length[i]<<" ";
-  (*lstream)<<"\n";  
-#endif
+    (*lstream)<<"Ksq on 12 edges lengthes are ";
+    for(int i = 0; i < 12; i++)
+      (*lstream)<<K_edge[i] / edge_length[i]<<" ";
+    (*lstream)<<"\n";
 
-  (*lstream)<<"Ksq inside the volume is ";
-  (*lstream)<<Ksq_vol / tot_vol<<" ";
-  (*lstream)<<"\n";
-  
-  
-  (*lstream)<<"**********Finish outputing expansion info****** " <<"\n";
-  
-}
-  
-void CosmoStatistic::output_conformal_avg(
-    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
-    BSSN *bssn,
-    idx_t weight_idx,
-    idx_t step_num,
-    real_t time)
-{
-  if(conformal_avg_interval == 0 || step_num % conformal_avg_interval != 0)
-    return;
-  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
-    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
-      hierarchy->getGridGeometry()));
-  TBOX_ASSERT(grid_geometry_);
-  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
-  const double * dx = &grid_geometry.getDx()[0];
+    (*lstream)<<"AijAij on 12 edges lengthes are ";
+    for(int i = 0; i < 12; i++)
+      (*lstream)<<AijAij_edge[i] / edge_length[i]<<" ";
+    (*lstream)<<"\n";
 
-  int output_num = static_cast<idx_t>(conformal_avg_list.size());
-  double *conformal_avg = new double[output_num];
+    (*lstream)<<"Ricci on 12 edges lengthes are ";
+    for(int i = 0; i < 12; i++)
+      (*lstream)<<ricci_edge[i] / edge_length[i]<<" ";
+    (*lstream)<<"\n";
 
-  arr_t * arrays = new arr_t[output_num];
+#if USE_PROPER_TIME
+    (*lstream)<<"Tau on 12 edges lengthes are ";
+    for(int i = 0; i < 12; i++)
+      (*lstream)<<tau_edge[i] / edge_length[i]<<" ";
+    (*lstream)<<"\n";  
+#endif
 
-  double tot_vol = 0;
+    (*lstream)<<"Ksq inside the volume is ";
+    (*lstream)<<Ksq_vol / tot_vol<<" ";
+    (*lstream)<<"\n";
 
-  for(int i = 0; i < output_num; i++) conformal_avg[i] = 0;
-  
-  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
-  {
-    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
+    (*lstream)<<"**********Finish outputing expansion info****** " <<"\n";
+  }
 
-    
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
-    {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
+ private:
+  BSSN *bssn;
+  idx_t weight_idx;
+  real_t min_radius;
+  std::ostream * lstream;
 
-      const hier::Box& box = patch->getBox();
+  real_t L[DIM], dx[DIM];
+  idx_t n_cells[DIM];
+  arr_t weight_array, DIFFchi, K, gamma[3][3], AijAij, ricci;
+#if USE_PROPER_TIME
+  arr_t tau;
+#endif
+};
 
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
+real_t CosmoStatistic::calculate_conformal_avg(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  BSSN *bssn,
+  idx_t weight_idx,
+  idx_t field_idx,
+  //calculating conformal avg only on boundary
+  bool only_on_bd,
+  double min_radius)
+{
+  real_t L[DIM];
+  get_domain_size(hierarchy, L);
 
-      bssn->initPData(patch);
+  std::shared_ptr<ConformalAvgKernel> kernel(
+    new ConformalAvgKernel(
+      bssn, weight_idx, std::vector<idx_t>(1, field_idx), L,
+      only_on_bd, min_radius, NULL, NULL));
 
-      bssn->initMDA(patch);
+  HierarchyReduction reduction;
+  reduction.addKernel(kernel, kernel->numSums(), 0);
+  reduction.sweep(hierarchy);
 
+  return kernel->getAvg()[0];
+}
 
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
+/**
+ * @brief register the expansion info with a reduction if it is due at
+ *        step_num, it is written to lstream when the reduction is swept
+ */
+void CosmoStatistic::addExpansionInfoKernel(
+  HierarchyReduction & reduction,
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  BSSN *bssn,
+  idx_t weight_idx,
+  idx_t step_num,
+  real_t min_radius)
+{
+  if( expansion_info_interval == 0 || step_num % expansion_info_interval != 0)
+    return;
 
-      arr_t DIFFchi_array = bssn->DIFFchi_a;
+  real_t L[DIM];
+  get_domain_size(hierarchy, L);
 
-      for(int i = 0; i < output_num; i ++)
-      {
-        std::shared_ptr<pdat::CellData<double> > var_cell_data(
-          SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-            patch->getPatchData(conformal_avg_idx[i])));
+  reduction.addKernel(
+    std::shared_ptr<ReductionKernel>(
+      new ExpansionInfoKernel(bssn, weight_idx, L, min_radius, lstream)),
+    ExpansionInfoKernel::n_sums, 0);
+}
 
-        arrays[i] = pdat::ArrayDataAccess::access<DIM, double>(
-          var_cell_data->getArrayData());
-      }
-      
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
-      
-      const double *dx = &patch_geom->getDx()[0];
+/**
+ * @brief register the conformal averages of conformal_avg_list with a
+ *        reduction if they are due at step_num, only cells outside
+ *        min_radius are counted (all cells for a negative min_radius)
+ */
+void CosmoStatistic::addConformalAvgKernel(
+  HierarchyReduction & reduction,
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  BSSN *bssn,
+  idx_t weight_idx,
+  idx_t step_num,
+  real_t min_radius)
+{
+  if(conformal_avg_interval == 0 || step_num % conformal_avg_interval != 0)
+    return;
 
-      
+  real_t L[DIM];
+  get_domain_size(hierarchy, L);
 
-#pragma omp parallel for collapse(2) reduction(+:tot_vol)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-            
-            if(weight_array(i,j,k) > 0)
-            {
-              tot_vol += weight_array(i, j, k) * 1.0 / pw3(DIFFchi_array(i, j, k) + 1.0);
-              #pragma omp critical
-              {
-                for(int var_id = 0; var_id < output_num; var_id++)
-                  conformal_avg[var_id] +=
-                    1.0 / pw3(DIFFchi_array(i, j, k) + 1.0) * arrays[var_id](i, j, k)
-                    * weight_array(i, j, k);
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&tot_vol, 1, MPI_SUM);
-    mpi.AllReduce(&conformal_avg[0], output_num, MPI_SUM);
-  }
+  std::shared_ptr<ConformalAvgKernel> kernel(
+    new ConformalAvgKernel(
+      bssn, weight_idx, conformal_avg_idx, L,
+      false, min_radius, lstream, &conformal_avg_list));
 
-  (*lstream)<<"Total vol is " << tot_vol<<"\n";
-  
-  for(int var_id = 0; var_id < output_num; var_id++)
-  {
-    (*lstream)<<"Conformal Avg for "<<conformal_avg_list[var_id]
-            <<" is "
-            <<std::setprecision(12)<<conformal_avg[var_id] / tot_vol<<"\n";
-  }
+  reduction.addKernel(kernel, kernel->numSums(), 0);
+}
 
+void CosmoStatistic::output_expansion_info(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    BSSN *bssn,
+    idx_t weight_idx,
+    idx_t step_num,
+    real_t time,
+    real_t min_radius)
+{
+  HierarchyReduction reduction;
+  addExpansionInfoKernel(
+    reduction, hierarchy, bssn, weight_idx, step_num, min_radius);
+  reduction.sweep(hierarchy);
+}
+  
+void CosmoStatistic::output_conformal_avg(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    BSSN *bssn,
+    idx_t weight_idx,
+    idx_t step_num,
+    real_t time)
+{
+  HierarchyReduction reduction;
+  addConformalAvgKernel(
+    reduction, hierarchy, bssn, weight_idx, step_num);
+  reduction.sweep(hierarchy);
 }
 
 // only do statistics on the sphere larger than min_radius
@@ -771,128 +528,10 @@ void CosmoStatistic::output_conformal_avg(
     real_t time,
     real_t min_radius)
 {
-  if(conformal_avg_interval == 0 || step_num % conformal_avg_interval != 0)
-    return;
-
-  std::shared_ptr<geom::CartesianGridGeometry> grid_geometry_(
-    SAMRAI_SHARED_PTR_CAST<geom::CartesianGridGeometry, hier::BaseGridGeometry>(
-      hierarchy->getGridGeometry()));
-  TBOX_ASSERT(grid_geometry_);
-  geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
-
-  const double * domain_lower = &grid_geometry.getXLower()[0];
-  const double * domain_upper = &grid_geometry.getXUpper()[0];
-
-  double L[DIM];
-  for(int i = 0 ; i < DIM; i++)
-    L[i] = domain_upper[i] - domain_lower[i];
-
-  const double * dx = &grid_geometry.getDx()[0];
-
-  int output_num = static_cast<idx_t>(conformal_avg_list.size());
-  double *conformal_avg = new double[output_num];
-
-  arr_t * arrays = new arr_t[output_num];
-
-  double tot_vol = 0;
-
-  for(int i = 0; i < output_num; i++) conformal_avg[i] = 0;
-  
-  for(int ln = 0; ln < hierarchy->getNumberOfLevels(); ln ++)
-  {
-    std::shared_ptr <hier::PatchLevel> level(hierarchy->getPatchLevel(ln));
-
-    
-    for( hier::PatchLevel::iterator pit(level->begin());
-         pit != level->end(); ++pit)
-    {
-      const std::shared_ptr<hier::Patch> & patch = *pit;
-
-      const hier::Box& box = patch->getBox();
-
-      const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
-        SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
-          patch->getPatchGeometry()));
-
-      bssn->initPData(patch);
-
-      bssn->initMDA(patch);
-
-
-      std::shared_ptr<pdat::CellData<double> > weight(
-        SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-          patch->getPatchData(weight_idx)));
-      
-      arr_t weight_array =
-        pdat::ArrayDataAccess::access<DIM, double>(
-          weight->getArrayData());
-
-      arr_t DIFFchi_array = bssn->DIFFchi_a;
-
-      for(int i = 0; i < output_num; i ++)
-      {
-        std::shared_ptr<pdat::CellData<double> > var_cell_data(
-          SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-            patch->getPatchData(conformal_avg_idx[i])));
-
-        arrays[i] = pdat::ArrayDataAccess::access<DIM, double>(
-          var_cell_data->getArrayData());
-      }
-      
-      const int * lower = &box.lower()[0];
-      const int * upper = &box.upper()[0];
-      
-      const double *dx = &patch_geom->getDx()[0];
-
-      
-
-#pragma omp parallel for collapse(2) reduction(+:tot_vol)
-      for(int k = lower[2]; k <= upper[2]; k++)
-      {
-        for(int j = lower[1]; j <= upper[1]; j++)
-        {
-          for(int i = lower[0]; i <= upper[0]; i++)
-          {
-
-            double xx = (dx[0] * ((real_t)i + 0.5)) - L[0] / 2.0 ;
-            double yy = (dx[1] * ((real_t)j + 0.5)) - L[1] / 2.0 ;
-            double zz = (dx[2] * ((real_t)k + 0.5)) - L[2] / 2.0 ;
-            double r = sqrt(pw2(xx) + pw2(yy) + pw2(zz));
-
-            if(weight_array(i,j,k) > 0 && r > min_radius)
-            {
-              tot_vol += weight_array(i, j, k) * 1.0 / pw3(DIFFchi_array(i, j, k) + 1.0);
-              #pragma omp critical
-              {
-                for(int var_id = 0; var_id < output_num; var_id++)
-                  conformal_avg[var_id] +=
-                    1.0 / pw3(DIFFchi_array(i, j, k) + 1.0) * arrays[var_id](i, j, k)
-                    * weight_array(i, j, k);
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-  const tbox::SAMRAI_MPI& mpi(hierarchy->getMPI());
-  mpi.Barrier();
-  if (mpi.getSize() > 1) {
-    mpi.AllReduce(&tot_vol, 1, MPI_SUM);
-    mpi.AllReduce(&conformal_avg[0], output_num, MPI_SUM);
-  }
-
-  (*lstream)<<"Total vol is " << tot_vol<<"\n";
-  
-  for(int var_id = 0; var_id < output_num; var_id++)
-  {
-    (*lstream)<<"Conformal Avg for "<<conformal_avg_list[var_id]
-            <<" is "
-            <<std::setprecision(12)<<conformal_avg[var_id] / tot_vol<<"\n";
-  }
-
+  HierarchyReduction reduction;
+  addConformalAvgKernel(
+    reduction, hierarchy, bssn, weight_idx, step_num, min_radius);
+  reduction.sweep(hierarchy);
 }
 
-
-
 }
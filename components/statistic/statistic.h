@@ -3,6 +3,7 @@
 
 #include "../../cosmo_includes.h"
 #include "../bssn/bssn.h"
+#include "hierarchy_reduction.h"
 
 using namespace SAMRAI;
 
@@ -49,6 +50,22 @@ class CosmoStatistic
     real_t min_radius);
 
   
+  void addConformalAvgKernel(
+    HierarchyReduction & reduction,
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    BSSN *bssn,
+    idx_t weight_idx,
+    idx_t step_num,
+    real_t min_radius = -1);
+
+  void addExpansionInfoKernel(
+    HierarchyReduction & reduction,
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    BSSN *bssn,
+    idx_t weight_idx,
+    idx_t step_num,
+    real_t min_radius);
+
   void output_expansion_info(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
     BSSN *bssn,
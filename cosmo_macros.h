@@ -258,6 +258,37 @@
 #endif
 
 
+// Low-storage (2N, Williamson form) RK only needs _a, _s and _p:
+// _s accumulates the stage increment, _a is updated in place and
+// _p keeps the start of the step for coarse-fine time interpolation
+#define LSRK_N_STAGES 5
+
+#if USE_BACKUP_FIELDS
+#define LSRK_ARRAY_ZERO(field, hcellmath)                \
+  hcellmath.setToScalar(field##_a_idx, 0, 0);  \
+  hcellmath.setToScalar(field##_s_idx, 0, 0);  \
+  hcellmath.setToScalar(field##_p_idx, 0, 0);  \
+  hcellmath.setToScalar(field##_b_idx, 0, 0)
+#else
+#define LSRK_ARRAY_ZERO(field, hcellmath)                \
+  hcellmath.setToScalar(field##_a_idx, 0, 0);  \
+  hcellmath.setToScalar(field##_s_idx, 0, 0);  \
+  hcellmath.setToScalar(field##_p_idx, 0, 0)
+#endif
+
+#if USE_BACKUP_FIELDS
+#define LSRK_ARRAY_ALLOC(field)                \
+  level->allocatePatchData(field##_a_idx);     \
+  level->allocatePatchData(field##_s_idx);     \
+  level->allocatePatchData(field##_p_idx);     \
+  level->allocatePatchData(field##_b_idx)
+#else
+#define LSRK_ARRAY_ALLOC(field)                \
+  level->allocatePatchData(field##_a_idx);     \
+  level->allocatePatchData(field##_s_idx);     \
+  level->allocatePatchData(field##_p_idx)
+#endif
+
 #define EXTRA_ARRAY_ZERO(field, hcellmath)                \
   hcellmath.setToScalar(field##_a_idx, 0, 0);  
 
@@ -309,6 +340,30 @@
       (field##_k2(i,j,k) + field##_k3(i,j,k))/4.0
 
 
+// RK4 dense output (McCorquodale & Colella 2011): k1..k4 of the coarser
+// step give the stage increments of a finer step that starts at theta and
+// lasts h, both in units of the coarser step; reduces to RK4_INIT_L/R_K*
+// for theta = 0, 1/2 and h = 1/2
+#define RK4_DENSE_F(field, theta)                                   \
+  ((1.0 - 3.0*(theta) + 2.0*(theta)*(theta)) * field##_k1(i,j,k)    \
+   + (2.0*(theta) - 2.0*(theta)*(theta))                            \
+   * (field##_k2(i,j,k) + field##_k3(i,j,k))                        \
+   + (2.0*(theta)*(theta) - (theta)) * field##_k4(i,j,k))
+
+#define RK4_INIT_K1(field, theta, h)  \
+  field##_s(i,j,k) = (h) * RK4_DENSE_F(field, theta)
+
+#define RK4_INIT_K2(field, theta, h)                          \
+  field##_s(i,j,k) = (h) * RK4_DENSE_F(field, (theta) + 0.5*(h))  \
+    - 0.5*(h)*(h)*(h) * (field##_k3(i,j,k) - field##_k2(i,j,k))
+
+#define RK4_INIT_K3(field, theta, h)                          \
+  field##_s(i,j,k) = (h) * RK4_DENSE_F(field, (theta) + 0.5*(h))  \
+    + 0.5*(h)*(h)*(h) * (field##_k3(i,j,k) - field##_k2(i,j,k))
+
+#define RK4_INIT_K4(field, theta, h)  \
+  field##_s(i,j,k) = (h) * RK4_DENSE_F(field, (theta) + (h))
+
 #define RK4_INIT_R_K1(field)  \
   field##_s(i,j,k) =  (field##_k2(i,j,k) + field##_k3(i,j,k)) / 4.0
 
@@ -325,6 +380,11 @@
 #define RK4_INIT_R_K4(field)  \
     field##_s(i,j,k) = field##_k4(i,j,k)/2.0
 
+// coarse-level increment feeding one low-storage RK stage of the finer
+// level, from linear interpolation in time between _p and _a
+#define LSRK_INIT_FIELD(field, coef)  \
+  field##_s(i,j,k) = (coef) * (field##_a(i,j,k) - field##_p(i,j,k))
+
 #define REGISTER_SPACE_REFINE_A(field, refiner,refine_op)       \
   refiner.registerRefine(field##_a_idx,                         \
                          field##_a_idx,                         \
@@ -337,12 +397,30 @@
                          field##_s_idx,                         \
                          refine_op)
 
+// registered without refine operator, the interpolation is done for
+// all components together by the fused refine strategy
+#define REGISTER_SPACE_REFINE_S_FUSED(field, refiner, fused_strategy) \
+  refiner.registerRefine(field##_s_idx,                               \
+                         field##_s_idx,                               \
+                         field##_s_idx,                               \
+                         std::shared_ptr<hier::RefineOperator>());    \
+  fused_strategy.addComponent(field##_s_idx)
+
 #define REGISTER_COARSEN_A(field,coarsener,coarsen_op)       \
   coarsener.registerCoarsen(field##_a_idx,                   \
                             field##_a_idx,                   \
                             coarsen_op,                      \
                             NULL)
 
+// registered without coarsen operator, the restriction is done for
+// all components together by the fused coarsen strategy
+#define REGISTER_COARSEN_A_FUSED(field, coarsener, fused_strategy)  \
+  coarsener.registerCoarsen(field##_a_idx,                          \
+                            field##_a_idx,                          \
+                            std::shared_ptr<hier::CoarsenOperator>(), \
+                            NULL);                                  \
+  fused_strategy.addComponent(field##_a_idx)
+
 
 #define RK4_FINALIZE_FIELD_1(field)      \
   field##_k1(i,j,k) =  field##_s(i,j,k);  \
@@ -361,9 +439,46 @@
   field##_a(i,j,k) =  field##_p(i,j,k) +                                  \
     (field##_k4(i,j,k) + 2.0*field##_k3(i,j,k) + 2.0*field##_k2(i,j,k) + field##_k1(i,j,k))/6.0  
 
+#define LSRK_FINALIZE_FIELD(field, B)  \
+  field##_a(i,j,k) += (B) * field##_s(i,j,k)
+
 #define COPY_A_TO_P(field)  \
   hcellmath.copyData(field##_p_idx, field##_a_idx, 0)
 
+#define COPY_A_TO_P_PT(field)  \
+  field##_p(i,j,k) = field##_a(i,j,k)
+
+// register rotation instead of copying _a to _p: _p takes over the patch
+// data of _a and the old _p patch data is parked in _spare, until
+// DETACH_A_FROM_P hands it back to _a right before _a is overwritten
+#define ROTATE_A_TO_P(field)                                    \
+  {                                                             \
+    std::shared_ptr<hier::PatchData> a_data(                    \
+      patch->getPatchData(field##_a_idx));                      \
+    std::shared_ptr<hier::PatchData> p_data(                    \
+      patch->getPatchData(field##_p_idx));                      \
+    if(a_data != p_data)                                        \
+    {                                                           \
+      patch->setPatchData(field##_spare_idx, p_data);           \
+      patch->setPatchData(field##_p_idx, a_data);               \
+    }                                                           \
+  }
+
+#define DETACH_A_FROM_P(field)                                  \
+  if(patch->checkAllocated(field##_spare_idx)                   \
+     && patch->getPatchData(field##_a_idx)                      \
+     == patch->getPatchData(field##_p_idx))                     \
+  {                                                             \
+    std::shared_ptr<hier::PatchData> spare_data(                \
+      patch->getPatchData(field##_spare_idx));                  \
+    patch->setPatchData(field##_a_idx, spare_data);             \
+    patch->deallocatePatchData(field##_spare_idx);              \
+  }
+
+#define SET_SPARE_TIME(field, to_t)                             \
+  if(patch->checkAllocated(field##_spare_idx))                  \
+    patch->getPatchData(field##_spare_idx)->setTime(to_t)
+
 #if USE_BACKUP_FIELDS
 #define COPY_P_TO_B(field)  \
   hcellmath.copyData(field##_b_idx, field##_p_idx, 0)
@@ -472,6 +587,29 @@
 #endif
 
 
+// only _a, _s and _p are allocated for the low-storage RK
+#if USE_BACKUP_FIELDS
+#define LSRK_PDATA_ALL_INIT(field)  \
+  PDATA_INIT(field, p);  \
+  PDATA_INIT(field, s);  \
+  PDATA_INIT(field, a);  \
+  PDATA_INIT(field, b)
+#define LSRK_MDA_ACCESS_ALL_INIT(field)  \
+  MDA_ACCESS_INIT(field, p);  \
+  MDA_ACCESS_INIT(field, a);  \
+  MDA_ACCESS_INIT(field, s);  \
+  MDA_ACCESS_INIT(field, b)
+#else
+#define LSRK_PDATA_ALL_INIT(field)  \
+  PDATA_INIT(field, p);  \
+  PDATA_INIT(field, s);  \
+  PDATA_INIT(field, a)
+#define LSRK_MDA_ACCESS_ALL_INIT(field)  \
+  MDA_ACCESS_INIT(field, p);  \
+  MDA_ACCESS_INIT(field, a);  \
+  MDA_ACCESS_INIT(field, s)
+#endif
+
 #define SET_PATCH_TIME(field, from_t, to_t)        \
   patch->getPatchData(field##_a_idx)->setTime(to_t); \
   patch->getPatchData(field##_p_idx)->setTime(from_t)  \
@@ -51,6 +51,9 @@ DustSim::DustSim(
 
   tbox::pout<<"Running 'dust' type simulation.\n";
 
+  if(bssnSim->use_low_storage_rk)
+    TBOX_ERROR("Low-storage RK is only supported by 'vacuum' simulations!\n");
+
     gradient_indicator_idx =
     variable_db->mapVariableAndContextToIndex(
       variable_db->getVariable(gradient_indicator), variable_db->getContext("ACTIVE"));
@@ -252,7 +255,8 @@ void DustSim::initializeLevelData(
    {
      if(step != starting_step)
        TBOX_ERROR("Level is initialized after 0 step!");
-     has_initial = initLevel(patch_hierarchy, ln);
+     if(!isRestartingFromCheckpoint())
+       has_initial = initLevel(patch_hierarchy, ln);
    }
    bssnSim->clearSrc(patch_hierarchy, ln);
    bssnSim->clearGen1(patch_hierarchy, ln);
@@ -327,6 +331,9 @@ void DustSim::initializeLevelData(
        "Can not get refine schedule, check your code!\n");
    }
  
+   // fields of a hierarchy rebuilt from a checkpoint
+   initLevelFromCheckpoint(patch_hierarchy, ln);
+
    bssnSim->copyAToP(hcellmath);
    
    level->getBoxLevel()->getMPI().Barrier();
@@ -344,6 +351,10 @@ void DustSim::applyGradientDetector(
    const bool initial_time,
    const bool uses_richardson_extrapolation)
 {
+  // rebuild the refined regions of a checkpoint when restarting from it
+  if(tagFromCheckpoint(hierarchy_, ln, tag_index))
+    return;
+
   NULL_USE(uses_richardson_extrapolation);
   NULL_USE(error_data_time);
   NULL_USE(initial_time);
@@ -567,7 +578,8 @@ void DustSim::RKEvolveLevel(
     bssnSim->K1FinalizePatch(patch);
     staticSim->addBSSNSrc(bssnSim,patch);
   }
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
   
   /**************Starting K2 *********************************/
   bssnSim->prepareForK2(coarser_level, to_t);
@@ -597,7 +609,8 @@ void DustSim::RKEvolveLevel(
     staticSim->addBSSNSrc(bssnSim, patch);
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
   
   /**************Starting K3 *********************************/
 
@@ -631,7 +644,8 @@ void DustSim::RKEvolveLevel(
     staticSim->addBSSNSrc(bssnSim,patch);
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
   
   /**************Starting K4 *********************************/
 
@@ -659,7 +673,8 @@ void DustSim::RKEvolveLevel(
     const std::shared_ptr<hier::Patch> & patch = *pit;
     bssnSim->K4FinalizePatch(patch);
   }
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 }
 
 /**
@@ -716,9 +731,20 @@ void DustSim::advanceLevel(
 
   math::HierarchyCellDataOpsReal<real_t> hcellmath(hierarchy,ln,ln);
 
-  bssnSim->set_norm(level);
-  
-  bssnSim->copyAToP(hcellmath);
+  // normalization and copy are fused into one sweep if requested,
+  // or the copy is replaced by rotating the _a and _p registers
+  if(bssnSim->rotate_rk_registers)
+  {
+    bssnSim->set_norm(level);
+    bssnSim->rotateAToP(level);
+  }
+  else if(bssnSim->fuse_rk_finalize)
+    bssnSim->normalizeAndCopyAToP(level);
+  else
+  {
+    bssnSim->set_norm(level);
+    bssnSim->copyAToP(hcellmath);
+  }
 
   bssnSim->setLevelTime(level, to_t, to_t);
 
@@ -739,8 +765,10 @@ void DustSim::resetHierarchyConfiguration(
   xfer::RefineAlgorithm pre_refiner, post_refiner;
   xfer::CoarsenAlgorithm coarsener(dim);  
   
-  bssnSim->registerRKRefiner(pre_refiner, space_refine_op);
-  bssnSim->registerCoarsenActive(coarsener,space_coarsen_op);
+  xfer::RefinePatchStrategy * pre_refine_strategy =
+    registerBSSNPreRefiner(pre_refiner);
+  xfer::CoarsenPatchStrategy * coarsen_strategy =
+    registerBSSNCoarsener(coarsener);
   bssnSim->registerRKRefinerActive(post_refiner, space_refine_op);
 
   for(int ln = 0; ln <= finest_level; ln++)
@@ -761,13 +789,14 @@ void DustSim::resetHierarchyConfiguration(
         //level,
         ln - 1,
         new_hierarchy,
-        (cosmoPS->is_time_dependent)?NULL:cosmoPS);
+        pre_refine_strategy);
     }
 
     // reset coarse and post_refine schedule
     if(ln < finest_level)
     {
-      coarsen_schedules[ln] = coarsener.createSchedule(level, new_hierarchy->getPatchLevel(ln+1));
+      coarsen_schedules[ln] = coarsener.createSchedule(
+        level, new_hierarchy->getPatchLevel(ln+1), coarsen_strategy);
       post_refine_schedules[ln] = post_refiner.createSchedule(level, NULL);
       
     }
@@ -50,6 +50,9 @@ DustFluidSim::DustFluidSim(
 
   tbox::pout<<"Running 'dust' type simulation.\n";
 
+  if(bssnSim->use_low_storage_rk)
+    TBOX_ERROR("Low-storage RK is only supported by 'vacuum' simulations!\n");
+
     gradient_indicator_idx =
     variable_db->mapVariableAndContextToIndex(
       variable_db->getVariable(gradient_indicator), variable_db->getContext("ACTIVE"));
@@ -279,7 +282,8 @@ void DustFluidSim::initializeLevelData(
    {
      if(step != starting_step)
        TBOX_ERROR("Level is initialized after 0 step!");
-     has_initial = initLevel(patch_hierarchy, ln);
+     if(!isRestartingFromCheckpoint())
+       has_initial = initLevel(patch_hierarchy, ln);
    }
    bssnSim->clearSrc(patch_hierarchy, ln);
    bssnSim->clearGen1(patch_hierarchy, ln);
@@ -362,6 +366,9 @@ void DustFluidSim::initializeLevelData(
        "Can not get refine schedule, check your code!\n");
    }
  
+   // fields of a hierarchy rebuilt from a checkpoint
+   initLevelFromCheckpoint(patch_hierarchy, ln);
+
    bssnSim->copyAToP(hcellmath);
    dustFluidSim->copyAToP(hcellmath);   
    level->getBoxLevel()->getMPI().Barrier();
@@ -379,6 +386,10 @@ void DustFluidSim::applyGradientDetector(
    const bool initial_time,
    const bool uses_richardson_extrapolation)
 {
+  // rebuild the refined regions of a checkpoint when restarting from it
+  if(tagFromCheckpoint(hierarchy_, ln, tag_index))
+    return;
+
   NULL_USE(uses_richardson_extrapolation);
   NULL_USE(error_data_time);
   NULL_USE(initial_time);
@@ -482,12 +493,22 @@ void DustFluidSim::outputDustFluidStep(
 #if USE_COSMOTRACE
   //    ray->printAll(hierarchy, ray->pc_idx);
 #endif
+  // constraint monitoring and statistics in one sweep of the hierarchy,
+  // the constraint kernel fills ricci / AijAij for the expansion info
+  HierarchyReduction diagnostics;
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  bssnSim->output_L2_H_constaint(
-    hierarchy, weight_idx, cosmoPS, 0.5);
+  bssnSim->addL2HConstraintKernel(
+    diagnostics, hierarchy, weight_idx, cosmoPS, 0.5);
   //  bssnSim->output_max_H_constaint(hierarchy, weight_idx);
+  cosmo_statistic->addExpansionInfoKernel(
+    diagnostics, hierarchy, bssnSim, weight_idx, step, max_horizon_radius);
+  cosmo_statistic->addConformalAvgKernel(
+    diagnostics, hierarchy, bssnSim, weight_idx, step, max_horizon_radius);
+  dustFluidSim->addWConstraintKernel(
+    diagnostics, bssnSim, hierarchy, weight_idx);
+  diagnostics.sweep(hierarchy);
  
   cosmo_io->registerVariablesWithPlotter(*visit_writer, step);
 #if !USE_COSMOTRACE  
@@ -495,14 +516,6 @@ void DustFluidSim::outputDustFluidStep(
 #else
   cosmo_io->dumpData(hierarchy, *visit_writer, step, cur_t, ray, vis_filename);
 #endif
-  cosmo_statistic->output_expansion_info(
-      hierarchy,
-      bssnSim, weight_idx, step, cur_t, max_horizon_radius);
-
-  cosmo_statistic->output_conformal_avg(
-    hierarchy,
-    bssnSim, weight_idx, step, cur_t, max_horizon_radius);
-  dustFluidSim->printWConstraint(bssnSim, hierarchy, weight_idx);
 }
 
 /**
@@ -925,7 +938,8 @@ void DustFluidSim::RKEvolveLevel(
 #endif
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
   
   /**************Starting K2 *********************************/
   #if USE_COSMOTRACE
@@ -996,7 +1010,8 @@ void DustFluidSim::RKEvolveLevel(
 #endif
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 
   /**************Starting K3 *********************************/
 #if USE_COSMOTRACE
@@ -1066,7 +1081,8 @@ void DustFluidSim::RKEvolveLevel(
 #endif
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 
   /**************Starting K4 *********************************/
 #if USE_COSMOTRACE
@@ -1133,7 +1149,8 @@ void DustFluidSim::RKEvolveLevel(
 #endif
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 
 }
 
@@ -1205,9 +1222,20 @@ void DustFluidSim::advanceLevel(
 
   math::HierarchyCellDataOpsReal<real_t> hcellmath(hierarchy,ln,ln);
 
-  bssnSim->set_norm(level);
-  
-  bssnSim->copyAToP(hcellmath);
+  // normalization and copy are fused into one sweep if requested,
+  // or the copy is replaced by rotating the _a and _p registers
+  if(bssnSim->rotate_rk_registers)
+  {
+    bssnSim->set_norm(level);
+    bssnSim->rotateAToP(level);
+  }
+  else if(bssnSim->fuse_rk_finalize)
+    bssnSim->normalizeAndCopyAToP(level);
+  else
+  {
+    bssnSim->set_norm(level);
+    bssnSim->copyAToP(hcellmath);
+  }
   dustFluidSim->copyAToP(hcellmath);
   
   bssnSim->setLevelTime(level, to_t, to_t);
@@ -1227,11 +1255,17 @@ void DustFluidSim::resetHierarchyConfiguration(
   post_refine_schedules.resize(finest_level + 1);
   coarsen_schedules.resize(finest_level + 1);
 
+#if USE_COSMOTRACE
+  ray->resetTransferSchedules();
+#endif
+
   xfer::RefineAlgorithm pre_refiner, post_refiner;
   xfer::CoarsenAlgorithm coarsener(dim);  
   
-  bssnSim->registerRKRefiner(pre_refiner, space_refine_op);
-  bssnSim->registerCoarsenActive(coarsener,space_coarsen_op);
+  xfer::RefinePatchStrategy * pre_refine_strategy =
+    registerBSSNPreRefiner(pre_refiner);
+  xfer::CoarsenPatchStrategy * coarsen_strategy =
+    registerBSSNCoarsener(coarsener);
   bssnSim->registerRKRefinerActive(post_refiner, space_refine_op);
 
   dustFluidSim->registerRKRefinerActive(post_refiner, space_refine_op);
@@ -1257,13 +1291,14 @@ void DustFluidSim::resetHierarchyConfiguration(
         //level,
         ln - 1,
         new_hierarchy,
-        (cosmoPS->is_time_dependent)?NULL:cosmoPS);
+        pre_refine_strategy);
     }
 
     // reset coarse and post_refine schedule
     if(ln < finest_level)
     {
-      coarsen_schedules[ln] = coarsener.createSchedule(level, new_hierarchy->getPatchLevel(ln+1));
+      coarsen_schedules[ln] = coarsener.createSchedule(
+        level, new_hierarchy->getPatchLevel(ln+1), coarsen_strategy);
       post_refine_schedules[ln] = post_refiner.createSchedule(level, NULL);
       
     }
@@ -59,6 +59,9 @@ ScalarSim::ScalarSim(
 
   tbox::pout<<"Running 'scalar' type simulation.\n";
 
+  if(bssnSim->use_low_storage_rk)
+    TBOX_ERROR("Low-storage RK is only supported by 'vacuum' simulations!\n");
+
   // adding all fields to a list
   bssnSim->addFieldsToList(variable_id_list);
 
@@ -139,7 +142,8 @@ void ScalarSim::setICs(
   }
 
   // regrid initial hierarchy if needed
-  while(!is_from_restart && regrid_at_beginning &&
+  while(!is_from_restart &&
+        (regrid_at_beginning || isRestartingFromCheckpoint()) &&
         hierarchy->getNumberOfLevels() < hierarchy->getMaxNumberOfLevels())
   {
     int pre_level_num = hierarchy->getNumberOfLevels();
@@ -319,7 +323,8 @@ void ScalarSim::initializeLevelData(
    {
      if(step != starting_step)
        TBOX_ERROR("Level is initialized after 0 step!");
-     has_initial = initLevel(patch_hierarchy, ln);
+     if(!isRestartingFromCheckpoint())
+       has_initial = initLevel(patch_hierarchy, ln);
    }
    bssnSim->clearSrc(patch_hierarchy, ln);
    bssnSim->clearGen1(patch_hierarchy, ln);
@@ -404,6 +409,9 @@ void ScalarSim::initializeLevelData(
        "Can not get refine schedule, check your code!\n");
    }
  
+   // fields of a hierarchy rebuilt from a checkpoint
+   initLevelFromCheckpoint(patch_hierarchy, ln);
+
    bssnSim->copyAToP(hcellmath);
    scalarSim->copyAToP(hcellmath);
    // if(use_AHFinder)
@@ -424,6 +432,10 @@ void ScalarSim::applyGradientDetector(
    const bool initial_time,
    const bool uses_richardson_extrapolation)
 {
+   // rebuild the refined regions of a checkpoint when restarting from it
+   if(tagFromCheckpoint(hierarchy_, ln, tag_index))
+     return;
+
    NULL_USE(uses_richardson_extrapolation);
    NULL_USE(error_data_time);
    NULL_USE(initial_time);
@@ -532,14 +544,16 @@ void ScalarSim::outputScalarStep(
 
   tbox::pout<<"step: "<<step<<"/"<<num_steps<<"\n";
   
-  bssnSim->output_L2_H_constaint(hierarchy, weight_idx, cosmoPS);
+  // constraint monitoring and statistics in one sweep of the hierarchy
+  HierarchyReduction diagnostics;
+  bssnSim->addL2HConstraintKernel(
+    diagnostics, hierarchy, weight_idx, cosmoPS);
+  cosmo_statistic->addConformalAvgKernel(
+    diagnostics, hierarchy, bssnSim, weight_idx, step);
+  diagnostics.sweep(hierarchy);
  
   cosmo_io->registerVariablesWithPlotter(*visit_writer, step);
   cosmo_io->dumpData(hierarchy, *visit_writer, step, cur_t);
-
-  cosmo_statistic->output_conformal_avg(
-    hierarchy,
-    bssnSim, weight_idx, step, cur_t);
 }
 
 /**
@@ -974,7 +988,8 @@ void ScalarSim::RKEvolveLevel(
     bssnSim->K1FinalizePatch(patch);
     scalarSim->K1FinalizePatch(patch);
     scalarSim->addBSSNSrc(bssnSim,patch, false);
-    bssnSim->set_norm(patch, false);
+    if(!bssnSim->fuse_rk_finalize)
+      bssnSim->set_norm(patch, false);
   }
   
   /**************Starting K2 *********************************/
@@ -1004,7 +1019,8 @@ void ScalarSim::RKEvolveLevel(
     bssnSim->K2FinalizePatch(patch);
     scalarSim->K2FinalizePatch(patch);
     scalarSim->addBSSNSrc(bssnSim, patch, false);
-    bssnSim->set_norm(patch, false);
+    if(!bssnSim->fuse_rk_finalize)
+      bssnSim->set_norm(patch, false);
 
   }
   
@@ -1034,7 +1050,8 @@ void ScalarSim::RKEvolveLevel(
     bssnSim->K3FinalizePatch(patch);
     scalarSim->K3FinalizePatch(patch);
     scalarSim->addBSSNSrc(bssnSim,patch, false);
-    bssnSim->set_norm(patch, false);
+    if(!bssnSim->fuse_rk_finalize)
+      bssnSim->set_norm(patch, false);
   }
   
   /**************Starting K4 *********************************/
@@ -1067,7 +1084,8 @@ void ScalarSim::RKEvolveLevel(
     
     scalarSim->K4FinalizePatch(patch);
     scalarSim->addBSSNSrc(bssnSim,patch, false);
-    bssnSim->set_norm(patch, false);
+    if(!bssnSim->fuse_rk_finalize)
+      bssnSim->set_norm(patch, false);
   }
 }
 
@@ -1125,9 +1143,20 @@ void ScalarSim::advanceLevel(
 
   math::HierarchyCellDataOpsReal<real_t> hcellmath(hierarchy,ln,ln);
 
-  bssnSim->set_norm(level);
-  
-  bssnSim->copyAToP(hcellmath);
+  // normalization and copy are fused into one sweep if requested,
+  // or the copy is replaced by rotating the _a and _p registers
+  if(bssnSim->rotate_rk_registers)
+  {
+    bssnSim->set_norm(level);
+    bssnSim->rotateAToP(level);
+  }
+  else if(bssnSim->fuse_rk_finalize)
+    bssnSim->normalizeAndCopyAToP(level);
+  else
+  {
+    bssnSim->set_norm(level);
+    bssnSim->copyAToP(hcellmath);
+  }
   scalarSim->copyAToP(hcellmath);
 
   bssnSim->setLevelTime(level, to_t, to_t);
@@ -1150,8 +1179,10 @@ void ScalarSim::resetHierarchyConfiguration(
   xfer::RefineAlgorithm pre_refiner, post_refiner;
   xfer::CoarsenAlgorithm coarsener(dim);  
   
-  bssnSim->registerRKRefiner(pre_refiner, space_refine_op);
-  bssnSim->registerCoarsenActive(coarsener,space_coarsen_op);
+  xfer::RefinePatchStrategy * pre_refine_strategy =
+    registerBSSNPreRefiner(pre_refiner);
+  xfer::CoarsenPatchStrategy * coarsen_strategy =
+    registerBSSNCoarsener(coarsener);
   bssnSim->registerRKRefinerActive(post_refiner, space_refine_op);
 
   scalarSim->registerRKRefinerActive(post_refiner, space_refine_op);
@@ -1176,13 +1207,14 @@ void ScalarSim::resetHierarchyConfiguration(
         //level,
         ln - 1,
         new_hierarchy,
-        (cosmoPS->is_time_dependent)?NULL:cosmoPS);
+        pre_refine_strategy);
     }
 
     // reset coarse and post_refine schedule
     if(ln < finest_level)
     {
-      coarsen_schedules[ln] = coarsener.createSchedule(level, new_hierarchy->getPatchLevel(ln+1));
+      coarsen_schedules[ln] = coarsener.createSchedule(
+        level, new_hierarchy->getPatchLevel(ln+1), coarsen_strategy);
       post_refine_schedules[ln] = post_refiner.createSchedule(level, NULL);
       
     }
@@ -77,7 +77,11 @@ CosmoSim::CosmoSim(
   freeze_time_evolution(cosmo_sim_db->getBoolWithDefault("freeze_time_evolution",false)),
   time_dependent_fields(cosmo_sim_db->getBoolWithDefault("time_dependent_fields",false)),
   scale_gradient_factor(cosmo_sim_db->getBoolWithDefault("scale_gradient_factor",false)),
-  use_absolute_tag_factor(cosmo_sim_db->getBoolWithDefault("use_absolute_tag_factor",false))
+  use_absolute_tag_factor(cosmo_sim_db->getBoolWithDefault("use_absolute_tag_factor",false)),
+  fused_refine(cosmo_sim_db->getBoolWithDefault("fused_refine",false)),
+  fused_coarsen(cosmo_sim_db->getBoolWithDefault("fused_coarsen",false)),
+  use_parallel_checkpoint(cosmo_sim_db->getBoolWithDefault("use_parallel_checkpoint",false)),
+  restart_checkpoint(cosmo_sim_db->getStringWithDefault("restart_checkpoint",""))
 {
   t_loop = tbox::TimerManager::getManager()->
     getTimer("loop");
@@ -91,7 +95,8 @@ CosmoSim::CosmoSim(
     hierarchy, dim,input_db->getDatabase("BSSN"), lstream,KO_damping_coefficient);
 
   // initializing IO object
-  cosmo_io = new CosmoIO(dim, input_db->getDatabase("IO"), lstream);
+  cosmo_io = new CosmoIO(
+    dim, input_db->getDatabase("IO"), lstream, vis_filename_in);
 
   //initializing statistic object
   cosmo_statistic = new CosmoStatistic(dim, input_db->getDatabase("CosmoStatistic"), lstream);
@@ -138,6 +143,30 @@ CosmoSim::CosmoSim(
   
   if(cosmo_sim_db->keyExists("save_steps"))
     save_steps = cosmo_sim_db->getIntegerVector("save_steps");
+
+  if(use_parallel_checkpoint || !restart_checkpoint.empty())
+  {
+#if USE_COSMOTRACE
+    TBOX_ERROR("Checkpoints do not store ray tracing particles yet!\n");
+#endif
+    checkpoint.reset(new Checkpoint(
+      simulation_type + comments,
+      cosmo_sim_db->getBoolWithDefault("incremental_checkpoint", false)));
+  }
+
+  // the hierarchy is rebuilt from the checkpoint while setting ICs
+  if(!restart_checkpoint.empty())
+  {
+    if(tbox::RestartManager::getManager()->isFromRestart())
+      TBOX_ERROR("Cannot restart from a checkpoint and a restart file at the same time!\n");
+
+    checkpoint->open(hierarchy->getMPI(), restart_checkpoint);
+
+    step = starting_step = checkpoint->getStep();
+    cur_t = starting_t = checkpoint->getTime();
+    bssnSim->K0 = checkpoint->getScalar("BSSNK0", bssnSim->K0);
+    has_found_horizon = checkpoint->getScalar("has_found_horizon", 0) != 0;
+  }
   #if !CAL_WEYL_SCALS
   if(calculate_Weyl_scalars == true)
     TBOX_ERROR("Calculate Weyl scalars is turned on, but NOT corresponding macros!");
@@ -191,6 +220,58 @@ void CosmoSim::setRefineCoarsenOps(
       lookupCoarsenOperator(ray->pc, "PARTICLE_COARSEN");
 #endif
   TBOX_ASSERT(space_coarsen_op);
+
+  if(fused_refine && refine_op_type != "CUBIC_REFINE")
+    TBOX_ERROR("fused_refine only supports refine_op_type = \"CUBIC_REFINE\"\n");
+}
+
+/**
+ * @brief register BSSN fields to the refiner filling ghosts before every
+ *  RK stage, either one by one with space_refine_op or all together
+ *  through the fused refine strategy
+ *
+ * @param pre_refiner
+ * @return patch strategy the schedules of pre_refiner have to be created with
+ */
+xfer::RefinePatchStrategy * CosmoSim::registerBSSNPreRefiner(
+  xfer::RefineAlgorithm& pre_refiner)
+{
+  xfer::RefinePatchStrategy * bd_strategy =
+    (cosmoPS->is_time_dependent)?NULL:cosmoPS;
+
+  if(!fused_refine)
+  {
+    bssnSim->registerRKRefiner(pre_refiner, space_refine_op);
+    return bd_strategy;
+  }
+
+  fused_refine_strategy.reset(
+    new geom::CartesianCellDoubleFusedRefineStrategy(bd_strategy));
+  bssnSim->registerRKRefinerFused(pre_refiner, *fused_refine_strategy);
+  return fused_refine_strategy.get();
+}
+
+/**
+ * @brief register BSSN fields to the coarsener restricting finer levels,
+ *  either one by one with space_coarsen_op or all together through the
+ *  fused coarsen strategy
+ *
+ * @param coarsener
+ * @return patch strategy the schedules of coarsener have to be created with
+ */
+xfer::CoarsenPatchStrategy * CosmoSim::registerBSSNCoarsener(
+  xfer::CoarsenAlgorithm& coarsener)
+{
+  if(!fused_coarsen)
+  {
+    bssnSim->registerCoarsenActive(coarsener, space_coarsen_op);
+    return NULL;
+  }
+
+  fused_coarsen_strategy.reset(
+    new geom::CartesianCellDoubleFusedCoarsenStrategy(coarsen_op_type));
+  bssnSim->registerCoarsenActiveFused(coarsener, *fused_coarsen_strategy);
+  return fused_coarsen_strategy.get();
 }
 
 /**
@@ -201,6 +282,10 @@ void CosmoSim::run(
 {
   tbox::plog<<"Running simulation...";
 
+  // the hierarchy has been rebuilt from it
+  if(checkpoint)
+    checkpoint->close();
+
   t_loop->start();
   while(step <= num_steps)
   {
@@ -208,11 +293,57 @@ void CosmoSim::run(
     step++;
     
   }
+  cosmo_io->waitForOutput();
   t_loop->stop();
 
   tbox::plog<<"\nEnding simulation.";
 }
 
+/**
+ * @brief write all fields registered for restart to a checkpoint, together
+ *        with the values putToRestart stores
+ */
+void CosmoSim::writeCheckpoint(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy)
+{
+  std::map<std::string, double> scalars;
+  scalars["BSSNK0"] = bssnSim->K0;
+  scalars["has_found_horizon"] = has_found_horizon;
+
+  checkpoint->write(hierarchy, variable_id_list, step, cur_t, scalars);
+}
+
+/**
+ * @brief when restarting from a checkpoint, tag the cells of level ln that
+ *        were refined in the checkpoint
+ * @return whether tags were set from the checkpoint
+ */
+bool CosmoSim::tagFromCheckpoint(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln, idx_t tag_index)
+{
+  if(!isRestartingFromCheckpoint())
+    return false;
+
+  checkpoint->tagLevel(hierarchy, ln, tag_index);
+  return true;
+}
+
+/**
+ * @brief when restarting from a checkpoint, overwrite the fields of level
+ *        ln with the checkpoint data covering it
+ * @return whether the level was read from the checkpoint
+ */
+bool CosmoSim::initLevelFromCheckpoint(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln)
+{
+  if(!isRestartingFromCheckpoint())
+    return false;
+
+  return checkpoint->readLevel(hierarchy, ln, variable_id_list);
+}
+
 void CosmoSim::calculateKAvg(
   const std::shared_ptr<hier::PatchHierarchy>& hierarchy)
 {
@@ -311,7 +442,12 @@ void CosmoSim::runCommonStepTasks(
       (std::find(save_steps.begin(), save_steps.end(), step) != save_steps.end()) ))
   {
     std::string restart_file_name = simulation_type + comments +".restart";
-    tbox::RestartManager::getManager()->writeRestartFile(restart_file_name, step);
+    // restart files are HDF5 too
+    cosmo_io->waitForOutput();
+    if(use_parallel_checkpoint)
+      writeCheckpoint(hierarchy);
+    else
+      tbox::RestartManager::getManager()->writeRestartFile(restart_file_name, step);
   }
 
   // since all neccecery levels were built when setting IC
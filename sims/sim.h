@@ -4,6 +4,7 @@
 #include "../cosmo_includes.h"
 #include "../components/bssn/bssn.h"
 #include "../components/IO/io.h"
+#include "../components/IO/checkpoint.h"
 #include "../components/statistic/statistic.h"
 #include "../cosmo_ps.h"
 #include "../cosmo_macros.h"
@@ -96,6 +97,10 @@ public:
   
   void setRefineCoarsenOps(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
+  xfer::RefinePatchStrategy * registerBSSNPreRefiner(
+    xfer::RefineAlgorithm& pre_refiner);
+  xfer::CoarsenPatchStrategy * registerBSSNCoarsener(
+    xfer::CoarsenAlgorithm& coarsener);
   void run(  const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
   void runCommonStepTasks(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
@@ -115,6 +120,19 @@ public:
   void computeVectorWeights(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
 
+  void writeCheckpoint(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy);
+  bool isRestartingFromCheckpoint()
+  {
+    return checkpoint && checkpoint->isOpen();
+  }
+  bool tagFromCheckpoint(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t ln, idx_t tag_index);
+  bool initLevelFromCheckpoint(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t ln);
+
 
   
   
@@ -207,6 +225,22 @@ public:
 
   bool use_absolute_tag_factor;
 
+  // interpolate all BSSN fields in one pass when filling RK stage ghosts
+  bool fused_refine;
+  std::shared_ptr<geom::CartesianCellDoubleFusedRefineStrategy>
+    fused_refine_strategy;
+
+  // restrict all BSSN fields in one pass after subcycling
+  bool fused_coarsen;
+  std::shared_ptr<geom::CartesianCellDoubleFusedCoarsenStrategy>
+    fused_coarsen_strategy;
+
+  // write checkpoints with Checkpoint instead of the SAMRAI restart manager
+  bool use_parallel_checkpoint;
+  // checkpoint file to restart from, empty when not restarting from one
+  std::string restart_checkpoint;
+  std::shared_ptr<Checkpoint> checkpoint;
+
   double gradient_scale_factor;
 
   
@@ -29,7 +29,12 @@ VacuumSim::VacuumSim(
   std::string vis_filename_in):CosmoSim(
     hierarchy,
     dim_in, input_db_in, l_stream_in, simulation_type_in, vis_filename_in),
-  cosmo_vacuum_db(input_db_in->getDatabase("VacuumSim"))
+  cosmo_vacuum_db(input_db_in->getDatabase("VacuumSim")),
+  adaptive_dt(cosmo_vacuum_db->getBoolWithDefault("adaptive_dt", false)),
+  dt_max_growth(cosmo_vacuum_db->getDoubleWithDefault("dt_max_growth", 1.1)),
+  subcycling_min_cells(cosmo_vacuum_db->getIntegerWithDefault("subcycling_min_cells", 0)),
+  last_dt(0),
+  overlap_ghost_exchange(cosmo_vacuum_db->getBoolWithDefault("overlap_ghost_exchange", false))
 {
 
   t_init->start();
@@ -78,6 +83,11 @@ VacuumSim::VacuumSim(
 
   if(tbox::RestartManager::getManager()->isFromRestart())
     getFromRestart();
+
+#if USE_COSMOTRACE
+  if(bssnSim->use_low_storage_rk)
+    TBOX_ERROR("Low-storage RK does not support ray tracing yet!\n");
+#endif
   
   t_init->stop();  
 }
@@ -253,11 +263,16 @@ bool VacuumSim::initLevel(
     double l = cosmo_vacuum_db->getDoubleWithDefault("l", 1);
     double sigma = cosmo_vacuum_db->getDoubleWithDefault("sigma", 3.5);
 
+    // solve on the distributed patches of level 0 instead of replicated grids
+    bool distributed_multigrid =
+      cosmo_vacuum_db->getBoolWithDefault("distributed_multigrid", false);
+
     if(!USE_BSSN_SHIFT)
       TBOX_ERROR("Must enable shift for blackhole simulation!\n");
     
     bssn_ic_kerr_BHL_CTT(hierarchy,ln, M, a, K_c, relaxation_tolerance
-                         , num_vcycles, max_depth, l, sigma);
+                         , num_vcycles, max_depth, l, sigma
+                         , distributed_multigrid);
     return true;
   }
   else if(ic_type == "static_BHL_CTT")
@@ -370,7 +385,8 @@ void VacuumSim::initializeLevelData(
      if(step != starting_step)
        TBOX_ERROR("Level is initialized after 0 step!");
 
-     has_initial = initLevel(patch_hierarchy, ln);
+     if(!isRestartingFromCheckpoint())
+       has_initial = initLevel(patch_hierarchy, ln);
    }
    
    bssnSim->clearSrc(patch_hierarchy, ln);
@@ -397,7 +413,6 @@ void VacuumSim::initializeLevelData(
    
    std::shared_ptr<xfer::RefineSchedule> refine_schedule;
 
-   level->getBoxLevel()->getMPI().Barrier();
    if (ln > 0 && (!has_initial))
    {
      /*
@@ -432,7 +447,6 @@ void VacuumSim::initializeLevelData(
                                 NULL);
      }
    }
-   level->getBoxLevel()->getMPI().Barrier();
      
 
    if (refine_schedule)
@@ -446,12 +460,14 @@ void VacuumSim::initializeLevelData(
        "Can not get refine schedule, check your code!\n");
    }
  
+   // fields of a hierarchy rebuilt from a checkpoint
+   initLevelFromCheckpoint(patch_hierarchy, ln);
+
    bssnSim->copyAToP(hcellmath);
 
    // if(use_AHFinder)
    //   horizon->copyAToP(hcellmath);
    
-   level->getBoxLevel()->getMPI().Barrier();
 }
 
 /**
@@ -466,6 +482,10 @@ void VacuumSim::applyGradientDetector(
    const bool initial_time,
    const bool uses_richardson_extrapolation)
 {
+  // rebuild the refined regions of a checkpoint when restarting from it
+  if(tagFromCheckpoint(hierarchy_, ln, tag_index))
+    return;
+
   // do not tag new grid when restarting
   if(tbox::RestartManager::getManager()->isFromRestart() && step == starting_step)
     return;
@@ -572,12 +592,20 @@ void VacuumSim::outputVacuumStep(
 #if USE_COSMOTRACE
     ray->printAll(hierarchy, ray->pc_idx);
 #endif
+  // constraint monitoring and statistics in one sweep of the hierarchy,
+  // the constraint kernel fills ricci / AijAij for the expansion info
+  HierarchyReduction diagnostics;
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  bssnSim->output_L2_H_constaint(
-    hierarchy, weight_idx, cosmoPS, 0.5);
+  bssnSim->addL2HConstraintKernel(
+    diagnostics, hierarchy, weight_idx, cosmoPS, 0.5);
   //  bssnSim->output_max_H_constaint(hierarchy, weight_idx);
+  cosmo_statistic->addExpansionInfoKernel(
+    diagnostics, hierarchy, bssnSim, weight_idx, step, max_horizon_radius);
+  cosmo_statistic->addConformalAvgKernel(
+    diagnostics, hierarchy, bssnSim, weight_idx, step, max_horizon_radius);
+  diagnostics.sweep(hierarchy);
  
   cosmo_io->registerVariablesWithPlotter(*visit_writer, step);
 #if !USE_COSMOTRACE  
@@ -585,13 +613,6 @@ void VacuumSim::outputVacuumStep(
 #else
   cosmo_io->dumpData(hierarchy, *visit_writer, step, cur_t, ray, vis_filename);
 #endif
-  cosmo_statistic->output_expansion_info(
-      hierarchy,
-      bssnSim, weight_idx, step, cur_t, max_horizon_radius);
-
-  cosmo_statistic->output_conformal_avg(
-    hierarchy,
-    bssnSim, weight_idx, step, cur_t, max_horizon_radius);
 
 }
 
@@ -618,7 +639,11 @@ void VacuumSim::runVacuumStep(
 }
 
 /**
- * @brief  get dt for each step, currently will return the same value
+ * @brief  get dt for each step and number of substeps of every level
+ *         each level l satisfies dt_l <= dt_frac * min(dx_l) / v_l, where
+ *         v_l = 1 or, with "adaptive_dt", the maximal characteristic speed
+ *         on that level; levels are subcycled by their refinement ratio
+ *         unless they are smaller than "subcycling_min_cells"
  *
  */  
 double VacuumSim::getDt(
@@ -629,11 +654,74 @@ double VacuumSim::getDt(
       hierarchy->getGridGeometry()));
   geom::CartesianGridGeometry& grid_geometry = *grid_geometry_;
 
-  return tbox::MathUtilities<double>::Min(
+  idx_t n_levels = hierarchy->getNumberOfLevels();
+
+  std::vector<double> level_dt(n_levels);
+  std::vector<idx_t> level_ratio(n_levels, 1);
+  level_substeps.assign(n_levels, 1);
+
+  double min_dx = tbox::MathUtilities<double>::Min(
     tbox::MathUtilities<double>::Min(grid_geometry.getDx()[0], grid_geometry.getDx()[1]),
-    grid_geometry.getDx()[2])
-    * dt_frac;
-  return (grid_geometry.getDx()[0]) * dt_frac;
+    grid_geometry.getDx()[2]);
+
+  double dt = 0, substeps = 1;
+  for(idx_t ln = 0; ln < n_levels; ln++)
+  {
+    const std::shared_ptr<hier::PatchLevel> level(
+      hierarchy->getPatchLevel(ln));
+
+    const hier::IntVector& ratio = level->getRatioToLevelZero();
+    double level_dx = min_dx / static_cast<double>(ratio.max());
+
+    if(ln > 0)
+    {
+      level_ratio[ln] = level->getRatioToCoarserLevel().max();
+      if(level->getGlobalNumberOfCells() >= subcycling_min_cells)
+        level_substeps[ln] = level_ratio[ln];
+    }
+    substeps *= level_substeps[ln];
+
+    double v = 1.0;
+    if(adaptive_dt)
+      v = tbox::MathUtilities<double>::Max(
+        bssnSim->maxCharacteristicSpeed(level), EPS);
+
+    level_dt[ln] = dt_frac * level_dx / v;
+
+    if(ln == 0 || level_dt[ln] * substeps < dt)
+      dt = level_dt[ln] * substeps;
+  }
+
+  if(adaptive_dt && last_dt > 0)
+    dt = tbox::MathUtilities<double>::Min(dt, last_dt * dt_max_growth);
+  last_dt = dt;
+
+  // subcycled levels only take as many substeps as their own CFL
+  // condition requires, but enough that every finer level can still meet
+  // its own with at most its full number of substeps
+  double parent_dt = dt;
+  for(idx_t ln = 1; ln < n_levels; ln++)
+  {
+    if(adaptive_dt && level_substeps[ln] > 1)
+    {
+      idx_t n = 1;
+      double finer_substeps = 1;
+      for(idx_t k = ln; k < n_levels; k++)
+      {
+        if(k > ln)
+          finer_substeps *= level_substeps[k];
+        n = tbox::MathUtilities<idx_t>::Max(
+          n, static_cast<idx_t>(
+            ceil(parent_dt / (level_dt[k] * finer_substeps) - EPS)));
+      }
+      level_substeps[ln] = tbox::MathUtilities<idx_t>::Min(n, level_ratio[ln]);
+    }
+    parent_dt /= level_substeps[ln];
+
+    TBOX_ASSERT(parent_dt <= level_dt[ln] * (1.0 + EPS));
+  }
+
+  return dt;
 }
 
 
@@ -691,38 +779,16 @@ void VacuumSim::RKEvolveLevel(
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  bssnSim->prepareForK1(coarser_level, to_t);
-  
-  for( hier::PatchLevel::iterator pit(level->begin());
-       pit != level->end(); ++pit)
-  {
-    const std::shared_ptr<hier::Patch> & patch = *pit;
-
-    //Evolve inner grids
-#if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-    bssnSim->RKEvolvePatch(patch, to_t - from_t);
+  bssnSim->prepareForK(coarser_level, 1, from_t, to_t);
 
-    // Evolve physical boundary
-    // would not do anything if boundary is time independent
-
-#if USE_COSMOTRACE
-    ray->RKEvolvePatch(patch, bssnSim,to_t - from_t);
-#endif
+  // evolve inner grids and physical boundary, then fill ghost cells
+  RKEvolveLevelRHS(level, ln, to_t - from_t, to_t);
 
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-    bssnSim->RKEvolvePatchBD(patch, to_t - from_t);
-  }
-
-  // fill ghost cells 
-  level->getBoxLevel()->getMPI().Barrier();
-  #if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-  pre_refine_schedules[ln]->fillData(to_t);
+  if(bssnSim->use_tiled_level)
+    bssnSim->KFinalizeLevelTiled(level, 1);
 
   for( hier::PatchLevel::iterator pit(level->begin());
        pit != level->end(); ++pit)
@@ -731,7 +797,8 @@ void VacuumSim::RKEvolveLevel(
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-    bssnSim->K1FinalizePatch(patch);    
+    if(!bssnSim->use_tiled_level)
+      bssnSim->K1FinalizePatch(patch);    
     addBSSNExtras(patch);
     //    ray->printAll(hierarchy, ray->pc_idx);
 #if USE_COSMOTRACE
@@ -740,43 +807,22 @@ void VacuumSim::RKEvolveLevel(
     //     ray->printAll(hierarchy, ray->pc_idx);
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 
   /**************Starting K2 *********************************/
   #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  bssnSim->prepareForK2(coarser_level, to_t);
-  
-  for( hier::PatchLevel::iterator pit(level->begin());
-       pit != level->end(); ++pit)
-  {
-    const std::shared_ptr<hier::Patch> & patch = *pit;
+  bssnSim->prepareForK(coarser_level, 2, from_t, to_t);
 
-    //Evolve inner grids
-    #if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-    bssnSim->RKEvolvePatch(patch, to_t - from_t);
-    //Evolve physical boundary
-    // would not do anything if boundary is time dependent
-#if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-    bssnSim->RKEvolvePatchBD(patch, to_t - from_t);
+  RKEvolveLevelRHS(level, ln, to_t - from_t, to_t);
 
 #if USE_COSMOTRACE
-    ray->RKEvolvePatch(patch, bssnSim,to_t - from_t);
-#endif
-
-  }
-
-  // fill ghost cells 
-  level->getBoxLevel()->getMPI().Barrier();
-  #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  pre_refine_schedules[ln]->fillData(to_t);
+  if(bssnSim->use_tiled_level)
+    bssnSim->KFinalizeLevelTiled(level, 2);
 
   for( hier::PatchLevel::iterator pit(level->begin());
        pit != level->end(); ++pit)
@@ -785,50 +831,30 @@ void VacuumSim::RKEvolveLevel(
     #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-    bssnSim->K2FinalizePatch(patch);
+    if(!bssnSim->use_tiled_level)
+      bssnSim->K2FinalizePatch(patch);
     addBSSNExtras(patch);
 #if USE_COSMOTRACE
     ray->K2FinalizePatch(patch);
 #endif
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 
   /**************Starting K3 *********************************/
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  bssnSim->prepareForK3(coarser_level, to_t);
-    
+  bssnSim->prepareForK(coarser_level, 3, from_t, to_t);
 
-  
-  for( hier::PatchLevel::iterator pit(level->begin());
-       pit != level->end(); ++pit)
-  {
-    const std::shared_ptr<hier::Patch> & patch = *pit;
+  RKEvolveLevelRHS(level, ln, to_t - from_t, to_t);
 
-    #if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-    bssnSim->RKEvolvePatch(patch, to_t - from_t);
-    //Evolve physical boundary
-    // would not do anything if boundary is time dependent
-#if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-    bssnSim->RKEvolvePatchBD(patch, to_t - from_t);
 #if USE_COSMOTRACE
-    ray->RKEvolvePatch(patch, bssnSim,to_t - from_t);
-#endif
-
-  }
-
-  // fill ghost cells 
-  level->getBoxLevel()->getMPI().Barrier();
-  #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  pre_refine_schedules[ln]->fillData(to_t);
+  if(bssnSim->use_tiled_level)
+    bssnSim->KFinalizeLevelTiled(level, 3);
 
   for( hier::PatchLevel::iterator pit(level->begin());
        pit != level->end(); ++pit)
@@ -837,20 +863,30 @@ void VacuumSim::RKEvolveLevel(
     #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-    bssnSim->K3FinalizePatch(patch);
+    if(!bssnSim->use_tiled_level)
+      bssnSim->K3FinalizePatch(patch);
     addBSSNExtras(patch);
 #if USE_COSMOTRACE
     ray->K3FinalizePatch(patch);
 #endif
   }
 
-  bssnSim->set_norm(level);
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
 
   /**************Starting K4 *********************************/
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-  bssnSim->prepareForK4(coarser_level, to_t);
+  bssnSim->prepareForK(coarser_level, 4, from_t, to_t);
+
+  RKEvolveLevelRHS(level, ln, to_t - from_t, to_t);
+
+#if USE_COSMOTRACE
+    if(freeze_time_evolution == false)
+#endif
+  if(bssnSim->use_tiled_level)
+    bssnSim->KFinalizeLevelTiled(level, 4);
 
   for( hier::PatchLevel::iterator pit(level->begin());
        pit != level->end(); ++pit)
@@ -859,43 +895,182 @@ void VacuumSim::RKEvolveLevel(
 #if USE_COSMOTRACE
     if(freeze_time_evolution == false)
 #endif
-    bssnSim->RKEvolvePatch(patch, to_t - from_t);
-    //Evolve physical boundary
-    // would not do anything if boundary is time dependent
+    if(!bssnSim->use_tiled_level)
+      bssnSim->K4FinalizePatch(patch);
+    addBSSNExtras(patch);
 #if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
+    ray->K4FinalizePatch(patch);
 #endif
-    bssnSim->RKEvolvePatchBD(patch, to_t - from_t);
+
+  }
+
+  if(!bssnSim->fuse_rk_finalize)
+    bssnSim->set_norm(level);
+
+}
+
+/**
+ * @brief evaluate the RHS of one RK stage on every patch of the level and
+ *        fill the ghost cells of the increments
+ * @details with "overlap_ghost_exchange" the cells near patch borders are
+ * evaluated first; the master thread then runs the ghost exchange while the
+ * other threads evaluate the deep interior of every patch, which no ghost
+ * cell is filled from. MPI is only called from the master thread.
+ * With the BSSN "tiled_level_executor" option the patches are cut into
+ * tiles and tiles of all patches are evolved as OpenMP tasks together.
+ *
+ * @param level
+ * @param level index
+ * @param time step
+ * @param ending time
+ */
+void VacuumSim::RKEvolveLevelRHS(
+  const std::shared_ptr<hier::PatchLevel> & level,
+  idx_t ln,
+  double dt,
+  double to_t)
+{
 #if USE_COSMOTRACE
-    ray->RKEvolvePatch(patch, bssnSim,to_t - from_t);
+  if(freeze_time_evolution == true)
+  {
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      ray->RKEvolvePatch(*pit, bssnSim, dt);
+    }
+    return;
+  }
 #endif
 
-  }
+  if(!overlap_ghost_exchange)
+  {
+    // inner grids, tiles of all patches are evolved together
+    if(bssnSim->use_tiled_level)
+      bssnSim->RKEvolveLevelTiled(level, dt);
 
-  // fill ghost cells 
-  level->getBoxLevel()->getMPI().Barrier();
-  #if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+
+      //Evolve inner grids
+      if(!bssnSim->use_tiled_level)
+        bssnSim->RKEvolvePatch(patch, dt);
+
+      // Evolve physical boundary
+      // would not do anything if boundary is time independent
+      bssnSim->RKEvolvePatchBD(patch, dt);
+#if USE_COSMOTRACE
+      ray->RKEvolvePatch(patch, bssnSim, dt);
 #endif
-  pre_refine_schedules[ln]->fillData(to_t);
+    }
+
+    // fill ghost cells 
+    pre_refine_schedules[ln]->fillData(to_t);
+    return;
+  }
 
   for( hier::PatchLevel::iterator pit(level->begin());
        pit != level->end(); ++pit)
   {
     const std::shared_ptr<hier::Patch> & patch = *pit;
+
+    bssnSim->RKEvolvePatchBorder(patch, dt);
+    bssnSim->RKEvolvePatchBD(patch, dt);
 #if USE_COSMOTRACE
-    if(freeze_time_evolution == false)
-#endif
-    bssnSim->K4FinalizePatch(patch);
-    addBSSNExtras(patch);
-#if USE_COSMOTRACE
-    ray->K4FinalizePatch(patch);
+    ray->RKEvolvePatch(patch, bssnSim, dt);
 #endif
+  }
+
+#pragma omp parallel
+  {
+#pragma omp master
+    {
+      pre_refine_schedules[ln]->fillData(to_t);
+    }
+
+    // picked up by a thread other than master unless running on one thread;
+    // with the tiled executor tiles of all patches are spawned at once,
+    // otherwise BSSN keeps the arrays of a single patch, so patches go one
+    // by one
+#pragma omp single nowait
+    {
+      if(bssnSim->use_tiled_level)
+        bssnSim->RKEvolveLevelTasks(level, dt, true);
+      else
+      {
+        for( hier::PatchLevel::iterator pit(level->begin());
+             pit != level->end(); ++pit)
+        {
+          const std::shared_ptr<hier::Patch> & patch = *pit;
+
+          bssnSim->initPData(patch);
+          bssnSim->initMDA(patch);
+
+          const std::shared_ptr<geom::CartesianPatchGeometry> patch_geom(
+            SAMRAI_SHARED_PTR_CAST<geom::CartesianPatchGeometry, hier::PatchGeometry>(
+              patch->getPatchGeometry()));
+
+          const real_t * dx = &(patch_geom->getDx())[0];
+
+          const hier::Box deep_box = bssnSim->getDeepInteriorBox(patch);
 
+          for(int k = deep_box.lower()[2]; k <= deep_box.upper()[2]; k++)
+          {
+#pragma omp task firstprivate(k)
+            {
+              hier::Box slab(deep_box);
+              slab.lower()[2] = k;
+              slab.upper()[2] = k;
+              bssnSim->RKEvolveBox(slab, dx, dt);
+            }
+          }
+#pragma omp taskwait
+        }
+      }
+    }
   }
+}
+
+/**
+ * @brief RK evolve one level with the low-storage scheme, which only uses
+ *        the _a, _s and _p registers of the BSSN fields
+ */
+void VacuumSim::RKEvolveLevelLowStorage(
+  const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+  idx_t ln,
+  double from_t,
+  double to_t)
+{
+  const std::shared_ptr<hier::PatchLevel> level(
+    hierarchy->getPatchLevel(ln));
+
+  const std::shared_ptr<hier::PatchLevel> coarser_level(
+    ((ln>0)?(hierarchy->getPatchLevel(ln-1)):NULL));
+
+  for(int stage = 0; stage < LSRK_N_STAGES; stage++)
+  {
+    bssnSim->setLSRKStage(stage);
+    bssnSim->prepareForLSRKStage(coarser_level, stage, to_t - from_t);
 
-  bssnSim->set_norm(level);
+    // evolve inner grids and physical boundary, then fill ghost cells
+    RKEvolveLevelRHS(level, ln, to_t - from_t, to_t);
 
+    if(bssnSim->use_tiled_level)
+      bssnSim->KFinalizeLevelTiled(level, stage);
+
+    for( hier::PatchLevel::iterator pit(level->begin());
+         pit != level->end(); ++pit)
+    {
+      const std::shared_ptr<hier::Patch> & patch = *pit;
+      if(!bssnSim->use_tiled_level)
+        bssnSim->LSRKFinalizePatch(patch, stage);
+      addBSSNExtras(patch);
+    }
+
+    if(!bssnSim->fuse_rk_finalize)
+      bssnSim->set_norm(level);
+  }
 }
 
 /**
@@ -928,17 +1103,24 @@ void VacuumSim::advanceLevel(
 #endif
   //  if(step == 54) TBOX_ERROR("HERE0");
 
-  RKEvolveLevel(hierarchy, ln, from_t, to_t);
+  if(bssnSim->use_low_storage_rk)
+    RKEvolveLevelLowStorage(hierarchy, ln, from_t, to_t);
+  else
+    RKEvolveLevel(hierarchy, ln, from_t, to_t);
 
-  level->getBoxLevel()->getMPI().Barrier();
   //if(step == 54) TBOX_ERROR("HERE1");
   // recursively advancing children levels
-  advanceLevel(hierarchy, ln+1, from_t, from_t + (to_t - from_t)/2.0);
-  //  if(step == 54) TBOX_ERROR("HERE2");
-  level->getBoxLevel()->getMPI().Barrier();
-  
-  advanceLevel(hierarchy, ln+1, from_t + (to_t - from_t)/2.0, to_t);
-  //  if(step == 54) TBOX_ERROR("HERE3");
+  if(ln < hierarchy->getNumberOfLevels() - 1)
+  {
+    idx_t n_substeps = level_substeps[ln+1];
+    for(idx_t s = 0; s < n_substeps; s++)
+    {
+      advanceLevel(hierarchy, ln+1,
+                   from_t + (to_t - from_t) * s / n_substeps,
+                   (s == n_substeps - 1) ?
+                   to_t : from_t + (to_t - from_t) * (s + 1) / n_substeps);
+    }
+  }
   //  TBOX_ERROR("here\n");
 
 #if USE_COSMOTRACE
@@ -948,10 +1130,12 @@ void VacuumSim::advanceLevel(
   // then update ghost cells through doing refinement if it has finer level
   if(ln < hierarchy->getNumberOfLevels() -1 )
   {
-    level->getBoxLevel()->getMPI().Barrier();
+#if USE_COSMOTRACE
+    // BSSN fields are not evolved, nothing changed on the finer level
+    if(freeze_time_evolution == false)
+#endif
     coarsen_schedules[ln]->coarsenData();
 
-    level->getBoxLevel()->getMPI().Barrier();
     post_refine_schedules[ln]->fillData(to_t);
   }
   //  if(step == 53) std::cout<<"here4\n"<<std::flush;
@@ -965,13 +1149,23 @@ void VacuumSim::advanceLevel(
 
   math::HierarchyCellDataOpsReal<real_t> hcellmath(hierarchy,ln,ln);
 
-  bssnSim->set_norm(level);
-  
-  bssnSim->copyAToP(hcellmath);
+  // normalization and copy are fused into one sweep if requested,
+  // or the copy is replaced by rotating the _a and _p registers
+  if(bssnSim->rotate_rk_registers)
+  {
+    bssnSim->set_norm(level);
+    bssnSim->rotateAToP(level);
+  }
+  else if(bssnSim->fuse_rk_finalize)
+    bssnSim->normalizeAndCopyAToP(level);
+  else
+  {
+    bssnSim->set_norm(level);
+    bssnSim->copyAToP(hcellmath);
+  }
 
   bssnSim->setLevelTime(level, to_t, to_t);
 
-  level->getBoxLevel()->getMPI().Barrier();
 }
 
 
@@ -985,11 +1179,17 @@ void VacuumSim::resetHierarchyConfiguration(
   post_refine_schedules.resize(finest_level + 1);
   coarsen_schedules.resize(finest_level + 1);
 
+#if USE_COSMOTRACE
+  ray->resetTransferSchedules();
+#endif
+
   xfer::RefineAlgorithm pre_refiner, post_refiner;
   xfer::CoarsenAlgorithm coarsener(dim);  
   
-  bssnSim->registerRKRefiner(pre_refiner, space_refine_op);
-  bssnSim->registerCoarsenActive(coarsener,space_coarsen_op);
+  xfer::RefinePatchStrategy * pre_refine_strategy =
+    registerBSSNPreRefiner(pre_refiner);
+  xfer::CoarsenPatchStrategy * coarsen_strategy =
+    registerBSSNCoarsener(coarsener);
   bssnSim->registerRKRefinerActive(post_refiner, space_refine_op);
 
   for(int ln = 0; ln <= finest_level; ln++)
@@ -1010,13 +1210,14 @@ void VacuumSim::resetHierarchyConfiguration(
         //level,
         ln - 1,
         new_hierarchy,
-        (cosmoPS->is_time_dependent)?NULL:cosmoPS);
+        pre_refine_strategy);
     }
 
     // reset coarse and post_refine schedule
     if(ln < finest_level)
     {
-      coarsen_schedules[ln] = coarsener.createSchedule(level, new_hierarchy->getPatchLevel(ln+1));
+      coarsen_schedules[ln] = coarsener.createSchedule(
+        level, new_hierarchy->getPatchLevel(ln+1), coarsen_strategy);
       post_refine_schedules[ln] = post_refiner.createSchedule(level, NULL);
       
     }
@@ -89,6 +89,16 @@ public:
   
   std::shared_ptr<tbox::Database> cosmo_vacuum_db;
 
+  // time step control, see getDt()
+  bool adaptive_dt;
+  real_t dt_max_growth;
+  idx_t subcycling_min_cells;
+  double last_dt;
+  std::vector<idx_t> level_substeps;
+
+  // evaluate deep patch interiors while ghost cells are exchanged
+  bool overlap_ghost_exchange;
+
   bool initLevel(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy, idx_t ln);
   void addBSSNExtras(
@@ -100,6 +110,16 @@ public:
     idx_t ln,
     double from_t,
     double to_t);
+  void RKEvolveLevelRHS(
+    const std::shared_ptr<hier::PatchLevel> & level,
+    idx_t ln,
+    double dt,
+    double to_t);
+  void RKEvolveLevelLowStorage(
+    const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
+    idx_t ln,
+    double from_t,
+    double to_t);
   void advanceLevel(
     const std::shared_ptr<hier::PatchHierarchy>& hierarchy,
     int ln,
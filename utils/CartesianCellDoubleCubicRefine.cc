@@ -12,6 +12,7 @@
 
 #include <float.h>
 #include <cmath>
+#include <algorithm>
 #include "SAMRAI/geom/CartesianPatchGeometry.h"
 #include "SAMRAI/hier/Index.h"
 #include "SAMRAI/pdat/CellData.h"
@@ -120,115 +121,153 @@ CartesianCellDoubleCubicRefine::refine(
    const int src_component,
    const hier::Box& fine_box,
    const hier::IntVector& ratio) const
+{
+   refineComponents(fine,
+      coarse,
+      std::vector<int>(1, dst_component),
+      std::vector<int>(1, src_component),
+      fine_box,
+      ratio);
+}
+
+void
+CartesianCellDoubleCubicRefine::refineComponents(
+   hier::Patch& fine,
+   const hier::Patch& coarse,
+   const std::vector<int>& dst_components,
+   const std::vector<int>& src_components,
+   const hier::Box& fine_box,
+   const hier::IntVector& ratio)
 {
    const tbox::Dimension& dim(fine.getDim());
    TBOX_ASSERT_DIM_OBJDIM_EQUALITY3(dim, coarse, fine_box, ratio);
+   TBOX_ASSERT(dst_components.size() == src_components.size());
+
+   if (!(dim == tbox::Dimension(3)))
+   {
+     TBOX_ERROR("CartesianCellDoubleCubicRefine error... \n"
+                << "dim > 3 not supported." << std::endl);
+   }
+
+   if (ratio[0] != 2 || ratio[1] != 2 || ratio[2] != 2)
+     TBOX_ERROR("relative position is not 0 or 1 when doing cubic interpolation");
+
+   const int n_comps = static_cast<int>(dst_components.size());
+
+   std::vector<MDA_Access<double, 3, MDA_OrderColMajor<3>> > carrays, farrays;
+   std::vector<hier::Box> fboxes;
+   int max_nxc = 0, max_nyc = 0, max_nyf = 0;
+   int k_lo = fine_box.upper()[2] + 1, k_hi = fine_box.lower()[2] - 1;
+
+   for (int c = 0; c < n_comps; c++)
+   {
+     std::shared_ptr<pdat::CellData<double> > cdata(
+       SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+         coarse.getPatchData(src_components[c])));
+     std::shared_ptr<pdat::CellData<double> > fdata(
+       SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+         fine.getPatchData(dst_components[c])));
+
+     TBOX_ASSERT(cdata);
+     TBOX_ASSERT(fdata);
+     TBOX_ASSERT(cdata->getDepth() == fdata->getDepth());
+
+     carrays.push_back(pdat::ArrayDataAccess::access<3, double>(
+                         cdata->getArrayData()));
+     farrays.push_back(pdat::ArrayDataAccess::access<3, double>(
+                         fdata->getArrayData()));
+
+     const hier::Box box(fine_box * fdata->getGhostBox());
+     fboxes.push_back(box);
+     if (box.empty()) continue;
+
+     // fine cell i lies over coarse cells floor(i/2) - 2 .. floor(i/2) + 1
+     // (even i) or floor(i/2) - 1 .. floor(i/2) + 2 (odd i)
+     max_nxc = std::max(max_nxc, (box.upper()[0] >> 1) - (box.lower()[0] >> 1) + 5);
+     max_nyc = std::max(max_nyc, (box.upper()[1] >> 1) - (box.lower()[1] >> 1) + 5);
+     max_nyf = std::max(max_nyf, box.upper()[1] - box.lower()[1] + 1);
+     k_lo = std::min(k_lo, box.lower()[2]);
+     k_hi = std::max(k_hi, box.upper()[2]);
+   }
+
+   if (k_lo > k_hi) return;
+
+   // CINT weights for fine cells sitting at 3/4 (even) and 1/4 (odd)
+   // of the way between their two nearest coarse cells
+   double w[2][4];
+   for (int p = 0; p < 2; p++)
+   {
+     const double u = (p == 0) ? (3.0 / 4.0) : (1.0 / 4.0);
+     w[p][0] = 0.5 * (u*u*(2.0 - u) - u);
+     w[p][1] = 0.5 * (u*u*(3.0*u - 5.0) + 2);
+     w[p][2] = 0.5 * (u*u*(4.0 - 3.0*u) + u);
+     w[p][3] = 0.5 * (u*u*(u - 1.0));
+   }
+
+   const int n_planes = k_hi - k_lo + 1;
 
-   std::shared_ptr<pdat::CellData<double> > cdata(
-      SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-         coarse.getPatchData(src_component)));
-   std::shared_ptr<pdat::CellData<double> > fdata(
-      SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
-         fine.getPatchData(dst_component)));
-   
-   TBOX_ASSERT(cdata);
-   TBOX_ASSERT(fdata);
-   TBOX_ASSERT(cdata->getDepth() == fdata->getDepth());
-
-   MDA_Access<double, 3, MDA_OrderColMajor<3>> carray(
-     pdat::ArrayDataAccess::access<3, double>(        
-       cdata->getArrayData()));
-
-   MDA_Access<double, 3, MDA_OrderColMajor<3>> farray(
-     pdat::ArrayDataAccess::access<3, double>(        
-       fdata->getArrayData()));
-
-   
-   const hier::Box cgbox(cdata->getGhostBox());
-
-   const std::shared_ptr<CartesianPatchGeometry> cgeom(
-      SAMRAI_SHARED_PTR_CAST<CartesianPatchGeometry, hier::PatchGeometry>(
-         coarse.getPatchGeometry()));
-   const std::shared_ptr<CartesianPatchGeometry> fgeom(
-      SAMRAI_SHARED_PTR_CAST<CartesianPatchGeometry, hier::PatchGeometry>(
-         fine.getPatchGeometry()));
-
-   TBOX_ASSERT(cgeom);
-   TBOX_ASSERT(fgeom);
-
-   const hier::Box coarse_box = hier::Box::coarsen(fine_box, ratio);
-   const int * ifirstc = &coarse_box.lower()[0];
-   const int * ilastc = &coarse_box.upper()[0];
-   const int * ifirstf = &fine_box.lower()[0];
-   const int * ilastf = &fine_box.upper()[0];
-   
-   // initialize interpolation coefficient,
-   // corresponds to u_{i-1}, u_{i} and u{i+1} respectively
-   // only apply to the case
-   // that interpolation ratio  = 2
-
-   
-   const double *cdx = &cgeom->getDx()[0];
-   
-   if ((dim == tbox::Dimension(3)))
+#pragma omp parallel
    {
-     #pragma omp parallel for collapse(2)
-     for(int k = ifirstf[2]; k <= ilastf[2]; k++)
+     // z-interpolated coarse xy plane and y-interpolated x lines
+     std::vector<double> f_z(max_nxc * max_nyc), f_yz(max_nxc * max_nyf);
+
+#pragma omp for collapse(2) schedule(dynamic)
+     for (int c = 0; c < n_comps; c++)
      {
-       for(int j = ifirstf[1]; j <= ilastf[1]; j++)
+       for (int kp = 0; kp < n_planes; kp++)
        {
-         for(int i = ifirstf[0]; i <= ilastf[0]; i++)
+         const hier::Box & box = fboxes[c];
+         const int k = k_lo + kp;
+         if (box.empty() || k < box.lower()[2] || k > box.upper()[2]) continue;
+
+         const MDA_Access<double, 3, MDA_OrderColMajor<3>> & carray = carrays[c];
+         MDA_Access<double, 3, MDA_OrderColMajor<3>> & farray = farrays[c];
+
+         const int * ifirstf = &box.lower()[0];
+         const int * ilastf = &box.upper()[0];
+
+         // lowest coarse cell of the stencil is floor(i/2) - 2 + (i & 1)
+         const int ic_lo = (ifirstf[0] >> 1) - 2 + (ifirstf[0] & 1);
+         const int ic_hi = (ilastf[0] >> 1) + 1 + (ilastf[0] & 1);
+         const int jc_lo = (ifirstf[1] >> 1) - 2 + (ifirstf[1] & 1);
+         const int jc_hi = (ilastf[1] >> 1) + 1 + (ilastf[1] & 1);
+         const int nxc = ic_hi - ic_lo + 1;
+
+         const int kc = (k >> 1) - 2 + (k & 1);
+         const double * wz = w[k & 1];
+
+         for (int jc = jc_lo; jc <= jc_hi; jc++)
+           for (int ic = ic_lo; ic <= ic_hi; ic++)
+             f_z[(jc - jc_lo) * nxc + ic - ic_lo] =
+               wz[0] * carray(ic, jc, kc) + wz[1] * carray(ic, jc, kc + 1)
+               + wz[2] * carray(ic, jc, kc + 2) + wz[3] * carray(ic, jc, kc + 3);
+
+         for (int j = ifirstf[1]; j <= ilastf[1]; j++)
+         {
+           const int jc = (j >> 1) - 2 + (j & 1) - jc_lo;
+           const double * wy = w[j & 1];
+           double * line = &f_yz[(j - ifirstf[1]) * nxc];
+           for (int ic = 0; ic < nxc; ic++)
+             line[ic] =
+               wy[0] * f_z[jc * nxc + ic] + wy[1] * f_z[(jc + 1) * nxc + ic]
+               + wy[2] * f_z[(jc + 2) * nxc + ic] + wy[3] * f_z[(jc + 3) * nxc + ic];
+         }
+
+         for (int j = ifirstf[1]; j <= ilastf[1]; j++)
          {
-           // generating corresponding coordinate on coarse mesh
-           int il = (i < 0) ? ((i+1) / ratio[0] - 1): (i / ratio[0]);
-           int jl = (j < 0) ? ((j+1) / ratio[1] - 1): (j / ratio[1]);
-           int kl = (k < 0) ? ((k+1) / ratio[2] - 1): (k / ratio[2]);
-
-           // get relative position to coarser points
-           // will be 0 or 1 for left or right
-           int pi  = 1 - i + il * ratio[0];
-           int pj  = 1 - j + jl * ratio[1];
-           int pk  = 1 - k + kl * ratio[2];
-
-           il -= pi;
-           jl -= pj;
-           kl -= pk;
-           
-           double id = (pi == 1) ? (3.0 / 4.0) : (1.0 / 4.0);
-           double jd = (pj == 1) ? (3.0 / 4.0) : (1.0 / 4.0);
-           double kd = (pk == 1) ? (3.0 / 4.0) : (1.0 / 4.0);
-                                   
-           if( (pi != 0 && pi != 1) || (pj != 0 && pj != 1) || (pk != 0 && pk != 1))
-             TBOX_ERROR("relative position is not 0 or 1 when doing quadratic interpolation");
-
-           farray(i,j,k) = 0;
-           double F_i_j_kd[16] = {0}, F_i_jd_kd[4] = {0};
-
-           for(int si=0; si<4; ++si)
-             for(int sj=0; sj<4; ++sj)
-             {
-               F_i_j_kd[si*4+sj] =
-                 CINT(kd,
-                      carray(il+si-1, jl+sj-1, kl-1), carray(il+si-1, jl+sj-1, kl+0),
-                      carray(il+si-1, jl+sj-1, kl+1), carray(il+si-1, jl+sj-1, kl+2));
-             }
-
-           for(int si=0; si<4; ++si)
-             F_i_jd_kd[si] = CINT(jd, F_i_j_kd[si*4+0], F_i_j_kd[si*4+1], F_i_j_kd[si*4+2], F_i_j_kd[si*4+3]);
-
-           
-           farray(i, j, k) = CINT(id, F_i_jd_kd[0], F_i_jd_kd[1], F_i_jd_kd[2], F_i_jd_kd[3]);
-           
+           const double * line = &f_yz[(j - ifirstf[1]) * nxc];
+           for (int i = ifirstf[0]; i <= ilastf[0]; i++)
+           {
+             const int ic = (i >> 1) - 2 + (i & 1) - ic_lo;
+             const double * wx = w[i & 1];
+             farray(i, j, k) =
+               wx[0] * line[ic] + wx[1] * line[ic + 1]
+               + wx[2] * line[ic + 2] + wx[3] * line[ic + 3];
+           }
          }
        }
      }
    }
-   else
-   {
-     TBOX_ERROR("CartesianCellDoubleCubicRefine error... \n"
-                << "dim > 3 not supported." << std::endl);
-   }
-
 }
 
 }
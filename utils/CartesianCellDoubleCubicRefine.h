@@ -20,6 +20,7 @@
 #include "SAMRAI/hier/Patch.h"
 
 #include <string>
+#include <vector>
 
 namespace SAMRAI {
 namespace geom {
@@ -110,6 +111,25 @@ public:
       const hier::Box& fine_box,
       const hier::IntVector& ratio) const;
 
+   /**
+    * Refine several components at once on a single fine box. The 1D
+    * interpolation weights are computed once and applied dimension by
+    * dimension (z, then y, then x), so partial sums are shared by all
+    * fine cells lying over the same coarse cells. Work is threaded over
+    * components and fine z planes. Only a refinement ratio of 2 is
+    * supported.
+    *
+    * @pre dst_components.size() == src_components.size()
+    */
+   static void
+   refineComponents(
+      hier::Patch& fine,
+      const hier::Patch& coarse,
+      const std::vector<int>& dst_components,
+      const std::vector<int>& src_components,
+      const hier::Box& fine_box,
+      const hier::IntVector& ratio);
+
 };
 
 }
@@ -0,0 +1,213 @@
+/*************************************************************************
+ *
+ * Description:   Coarsen patch strategy restricting a group of
+ *                cell-centered double components in one pass.
+ *
+ ************************************************************************/
+#include "CartesianCellDoubleFusedCoarsenStrategy.h"
+
+#include "SAMRAI/pdat/CellData.h"
+#include "SAMRAI/tbox/Utilities.h"
+
+#include <algorithm>
+
+namespace SAMRAI {
+namespace geom {
+
+CartesianCellDoubleFusedCoarsenStrategy::CartesianCellDoubleFusedCoarsenStrategy(
+   const std::string& op_name):
+  xfer::CoarsenPatchStrategy()
+{
+   if (op_name == "CONSERVATIVE_COARSEN" || op_name == "LINEAR_COARSEN")
+   {
+     d_weights.push_back(0.5);
+     d_weights.push_back(0.5);
+     d_offset = 0;
+   }
+   else if (op_name == "CUBIC_COARSEN")
+   {
+     // CINT(1/2, ...) of CartesianCellDoubleCubicCoarsen
+     d_weights.push_back(-1.0 / 16.0);
+     d_weights.push_back(9.0 / 16.0);
+     d_weights.push_back(9.0 / 16.0);
+     d_weights.push_back(-1.0 / 16.0);
+     d_offset = -1;
+   }
+   else
+   {
+     TBOX_ERROR("CartesianCellDoubleFusedCoarsenStrategy error...\n"
+                << "unsupported coarsen operator " << op_name << std::endl);
+   }
+}
+
+CartesianCellDoubleFusedCoarsenStrategy::~CartesianCellDoubleFusedCoarsenStrategy()
+{
+}
+
+void
+CartesianCellDoubleFusedCoarsenStrategy::addComponent(
+   const int component)
+{
+   d_components.push_back(component);
+}
+
+hier::IntVector
+CartesianCellDoubleFusedCoarsenStrategy::getCoarsenOpStencilWidth(
+   const tbox::Dimension& dim) const
+{
+   return hier::IntVector(dim, -d_offset);
+}
+
+void
+CartesianCellDoubleFusedCoarsenStrategy::preprocessCoarsen(
+   hier::Patch& coarse,
+   const hier::Patch& fine,
+   const hier::Box& coarse_box,
+   const hier::IntVector& ratio)
+{
+}
+
+void
+CartesianCellDoubleFusedCoarsenStrategy::postprocessCoarsen(
+   hier::Patch& coarse,
+   const hier::Patch& fine,
+   const hier::Box& coarse_box,
+   const hier::IntVector& ratio)
+{
+   const tbox::Dimension& dim(fine.getDim());
+
+   if (!(dim == tbox::Dimension(3)))
+   {
+     TBOX_ERROR("CartesianCellDoubleFusedCoarsenStrategy error...\n"
+                << "dim > 3 not supported." << std::endl);
+   }
+
+   if (ratio[0] != 2 || ratio[1] != 2 || ratio[2] != 2)
+     TBOX_ERROR("CartesianCellDoubleFusedCoarsenStrategy error...\n"
+                << "only refinement ratio 2 is supported." << std::endl);
+
+   const int n_comps = static_cast<int>(d_components.size());
+   const int n_w = static_cast<int>(d_weights.size());
+   const double * w = &d_weights[0];
+
+   if (coarse_box.empty() || n_comps == 0) return;
+
+   const int * ifirstc = &coarse_box.lower()[0];
+   const int * ilastc = &coarse_box.upper()[0];
+
+   const int nxc = ilastc[0] - ifirstc[0] + 1;
+   const int nyc = ilastc[1] - ifirstc[1] + 1;
+   const int nzc = ilastc[2] - ifirstc[2] + 1;
+
+   // fine cells read by the coarse box in x and y
+   const int if_lo = 2 * ifirstc[0] + d_offset;
+   const int jf_lo = 2 * ifirstc[1] + d_offset;
+   const int nxf = 2 * nxc + n_w - 2;
+   const int nyf = 2 * nyc + n_w - 2;
+
+   std::vector<double *> cptrs(n_comps);
+   std::vector<const double *> fptrs(n_comps);
+   std::vector<hier::Box> cboxes, fboxes;
+
+   for (int c = 0; c < n_comps; c++)
+   {
+     std::shared_ptr<pdat::CellData<double> > cdata(
+       SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+         coarse.getPatchData(d_components[c])));
+     std::shared_ptr<pdat::CellData<double> > fdata(
+       SAMRAI_SHARED_PTR_CAST<pdat::CellData<double>, hier::PatchData>(
+         fine.getPatchData(d_components[c])));
+
+     TBOX_ASSERT(cdata);
+     TBOX_ASSERT(fdata);
+
+     cptrs[c] = cdata->getPointer();
+     fptrs[c] = fdata->getPointer();
+     cboxes.push_back(cdata->getGhostBox());
+     fboxes.push_back(fdata->getGhostBox());
+   }
+
+#pragma omp parallel
+   {
+     // z-restricted fine xy plane and y-restricted x lines
+     std::vector<double> f_z(nxf * nyf), f_yz(nxf * nyc);
+
+#pragma omp for collapse(2) schedule(static)
+     for (int c = 0; c < n_comps; c++)
+     {
+       for (int kc = 0; kc < nzc; kc++)
+       {
+         const hier::Box & fgbox = fboxes[c];
+         const hier::Box & cgbox = cboxes[c];
+
+         // column-major strides of the ghost boxes
+         const long fsy = fgbox.upper()[0] - fgbox.lower()[0] + 1;
+         const long fsz = fsy * (fgbox.upper()[1] - fgbox.lower()[1] + 1);
+         const long csy = cgbox.upper()[0] - cgbox.lower()[0] + 1;
+         const long csz = csy * (cgbox.upper()[1] - cgbox.lower()[1] + 1);
+
+         const int kf_lo = 2 * (ifirstc[2] + kc) + d_offset;
+
+         const double * f = fptrs[c]
+           + (if_lo - fgbox.lower()[0])
+           + (jf_lo - fgbox.lower()[1]) * fsy
+           + (kf_lo - fgbox.lower()[2]) * fsz;
+
+         for (int jf = 0; jf < nyf; jf++)
+         {
+           double * out = &f_z[jf * nxf];
+           const double * in = f + jf * fsy;
+#pragma omp simd
+           for (int i = 0; i < nxf; i++)
+             out[i] = w[0] * in[i];
+           for (int s = 1; s < n_w; s++)
+           {
+             const double ws = w[s];
+             const double * in_s = in + s * fsz;
+#pragma omp simd
+             for (int i = 0; i < nxf; i++)
+               out[i] += ws * in_s[i];
+           }
+         }
+
+         for (int j = 0; j < nyc; j++)
+         {
+           double * out = &f_yz[j * nxf];
+           const double * in = &f_z[2 * j * nxf];
+#pragma omp simd
+           for (int i = 0; i < nxf; i++)
+             out[i] = w[0] * in[i];
+           for (int s = 1; s < n_w; s++)
+           {
+             const double ws = w[s];
+             const double * in_s = in + s * nxf;
+#pragma omp simd
+             for (int i = 0; i < nxf; i++)
+               out[i] += ws * in_s[i];
+           }
+         }
+
+         double * cp = cptrs[c]
+           + (ifirstc[0] - cgbox.lower()[0])
+           + (ifirstc[2] + kc - cgbox.lower()[2]) * csz;
+
+         for (int j = 0; j < nyc; j++)
+         {
+           const double * in = &f_yz[j * nxf];
+           double * out = cp + (ifirstc[1] + j - cgbox.lower()[1]) * csy;
+#pragma omp simd
+           for (int i = 0; i < nxc; i++)
+           {
+             double sum = 0;
+             for (int s = 0; s < n_w; s++)
+               sum += w[s] * in[2 * i + s];
+             out[i] = sum;
+           }
+         }
+       }
+     }
+   }
+}
+
+}
+}
@@ -0,0 +1,87 @@
+/*************************************************************************
+ *
+ * Description:   Coarsen patch strategy restricting a group of
+ *                cell-centered double components in one pass.
+ *
+ ************************************************************************/
+#ifndef included_geom_CartesianCellDoubleFusedCoarsenStrategy
+#define included_geom_CartesianCellDoubleFusedCoarsenStrategy
+
+#include "SAMRAI/SAMRAI_config.h"
+
+#include "SAMRAI/xfer/CoarsenPatchStrategy.h"
+#include "SAMRAI/hier/Box.h"
+#include "SAMRAI/hier/IntVector.h"
+#include "SAMRAI/hier/Patch.h"
+
+#include <string>
+#include <vector>
+
+namespace SAMRAI {
+namespace geom {
+
+/**
+ * Class CartesianCellDoubleFusedCoarsenStrategy restricts all of its
+ * components in postprocessCoarsen(). Components handled here should be
+ * registered to the coarsen algorithm with a null coarsen operator, so
+ * that SAMRAI leaves the restriction to this strategy and every coarse box
+ * is visited once for the whole group instead of once per component.
+ *
+ * The restriction is a tensor product of 1D stencils, applied dimension by
+ * dimension, threaded over components and coarse z planes, with the
+ * innermost loops running over contiguous memory. Supported operators are
+ * the 2x2x2 average ("CONSERVATIVE_COARSEN" on a uniform Cartesian mesh,
+ * "LINEAR_COARSEN") and "CUBIC_COARSEN".
+ *
+ * @see CartesianCellDoubleLinearCoarsen
+ * @see CartesianCellDoubleCubicCoarsen
+ */
+
+class CartesianCellDoubleFusedCoarsenStrategy:
+   public xfer::CoarsenPatchStrategy
+{
+public:
+   /**
+    * @param op_name name of the coarsen operator to reproduce
+    */
+   explicit CartesianCellDoubleFusedCoarsenStrategy(
+      const std::string& op_name);
+
+   virtual ~CartesianCellDoubleFusedCoarsenStrategy();
+
+   /**
+    * Add a component restricted from the same index on the fine patch.
+    */
+   void
+   addComponent(
+      const int component);
+
+   hier::IntVector
+   getCoarsenOpStencilWidth(
+      const tbox::Dimension& dim) const;
+
+   void
+   preprocessCoarsen(
+      hier::Patch& coarse,
+      const hier::Patch& fine,
+      const hier::Box& coarse_box,
+      const hier::IntVector& ratio);
+
+   void
+   postprocessCoarsen(
+      hier::Patch& coarse,
+      const hier::Patch& fine,
+      const hier::Box& coarse_box,
+      const hier::IntVector& ratio);
+
+private:
+   std::vector<int> d_components;
+
+   /// 1D stencil, coarse cell i reads fine cells 2i + d_offset, ...
+   std::vector<double> d_weights;
+   int d_offset;
+};
+
+}
+}
+#endif
@@ -0,0 +1,85 @@
+/*************************************************************************
+ *
+ * Description:   Refine patch strategy interpolating a group of
+ *                cell-centered double components in one pass.
+ *
+ ************************************************************************/
+#include "CartesianCellDoubleFusedRefineStrategy.h"
+#include "CartesianCellDoubleCubicRefine.h"
+
+#include <algorithm>
+
+namespace SAMRAI {
+namespace geom {
+
+CartesianCellDoubleFusedRefineStrategy::CartesianCellDoubleFusedRefineStrategy(
+   xfer::RefinePatchStrategy * boundary_strategy):
+  xfer::RefinePatchStrategy(),
+  d_boundary_strategy(boundary_strategy)
+{
+}
+
+CartesianCellDoubleFusedRefineStrategy::~CartesianCellDoubleFusedRefineStrategy()
+{
+}
+
+void
+CartesianCellDoubleFusedRefineStrategy::addComponent(
+   const int component)
+{
+   d_components.push_back(component);
+}
+
+void
+CartesianCellDoubleFusedRefineStrategy::setPhysicalBoundaryConditions(
+   hier::Patch& patch,
+   const double fill_time,
+   const hier::IntVector& ghost_width_to_fill)
+{
+   if (d_boundary_strategy)
+      d_boundary_strategy->setPhysicalBoundaryConditions(
+         patch, fill_time, ghost_width_to_fill);
+}
+
+hier::IntVector
+CartesianCellDoubleFusedRefineStrategy::getRefineOpStencilWidth(
+   const tbox::Dimension& dim) const
+{
+   hier::IntVector width(dim, 2);
+   if (d_boundary_strategy)
+   {
+      const hier::IntVector bd_width(
+         d_boundary_strategy->getRefineOpStencilWidth(dim));
+      for (int d = 0; d < dim.getValue(); d++)
+         width[d] = std::max(width[d], bd_width[d]);
+   }
+   return width;
+}
+
+void
+CartesianCellDoubleFusedRefineStrategy::preprocessRefine(
+   hier::Patch& fine,
+   const hier::Patch& coarse,
+   const hier::Box& fine_box,
+   const hier::IntVector& ratio)
+{
+   if (d_boundary_strategy)
+      d_boundary_strategy->preprocessRefine(fine, coarse, fine_box, ratio);
+}
+
+void
+CartesianCellDoubleFusedRefineStrategy::postprocessRefine(
+   hier::Patch& fine,
+   const hier::Patch& coarse,
+   const hier::Box& fine_box,
+   const hier::IntVector& ratio)
+{
+   CartesianCellDoubleCubicRefine::refineComponents(
+      fine, coarse, d_components, d_components, fine_box, ratio);
+
+   if (d_boundary_strategy)
+      d_boundary_strategy->postprocessRefine(fine, coarse, fine_box, ratio);
+}
+
+}
+}
@@ -0,0 +1,92 @@
+/*************************************************************************
+ *
+ * Description:   Refine patch strategy interpolating a group of
+ *                cell-centered double components in one pass.
+ *
+ ************************************************************************/
+#ifndef included_geom_CartesianCellDoubleFusedRefineStrategy
+#define included_geom_CartesianCellDoubleFusedRefineStrategy
+
+#include "SAMRAI/SAMRAI_config.h"
+
+#include "SAMRAI/xfer/RefinePatchStrategy.h"
+#include "SAMRAI/hier/Box.h"
+#include "SAMRAI/hier/IntVector.h"
+#include "SAMRAI/hier/Patch.h"
+
+#include <vector>
+
+namespace SAMRAI {
+namespace geom {
+
+/**
+ * Class CartesianCellDoubleFusedRefineStrategy refines all of its
+ * components with tricubic interpolation in postprocessRefine(), using
+ * CartesianCellDoubleCubicRefine::refineComponents(). Components handled
+ * here should be registered to the refine algorithm with a null refine
+ * operator, so that SAMRAI leaves the interpolation to this strategy and
+ * every fine box is visited once for the whole group instead of once per
+ * component.
+ *
+ * Physical boundary conditions and the pre/post processing hooks are
+ * forwarded to an optional boundary strategy.
+ *
+ * @see CartesianCellDoubleCubicRefine
+ */
+
+class CartesianCellDoubleFusedRefineStrategy:
+   public xfer::RefinePatchStrategy
+{
+public:
+   /**
+    * @param boundary_strategy strategy doing everything but the fused
+    *        interpolation, may be NULL
+    */
+   explicit CartesianCellDoubleFusedRefineStrategy(
+      xfer::RefinePatchStrategy * boundary_strategy = NULL);
+
+   virtual ~CartesianCellDoubleFusedRefineStrategy();
+
+   /**
+    * Add a component refined from the same index on the coarse patch.
+    */
+   void
+   addComponent(
+      const int component);
+
+   void
+   setPhysicalBoundaryConditions(
+      hier::Patch& patch,
+      const double fill_time,
+      const hier::IntVector& ghost_width_to_fill);
+
+   /**
+    * The tricubic stencil extends two cells outside the fine box.
+    */
+   hier::IntVector
+   getRefineOpStencilWidth(
+      const tbox::Dimension& dim) const;
+
+   void
+   preprocessRefine(
+      hier::Patch& fine,
+      const hier::Patch& coarse,
+      const hier::Box& fine_box,
+      const hier::IntVector& ratio);
+
+   void
+   postprocessRefine(
+      hier::Patch& fine,
+      const hier::Patch& coarse,
+      const hier::Box& fine_box,
+      const hier::IntVector& ratio);
+
+private:
+   xfer::RefinePatchStrategy * d_boundary_strategy;
+
+   std::vector<int> d_components;
+};
+
+}
+}
+#endif
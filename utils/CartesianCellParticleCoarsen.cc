@@ -121,8 +121,8 @@ CartesianCellParticleCoarsen::coarsen(
        TBOX_ERROR("Coarse index is not contained by patch data\n");
 
      // go through all particles
-     for(std::list<RKParticle>::iterator it=p->p_list.begin();
-         it != p->p_list.end(); ++it)
+     for(ParticleContainer::iterator it=p->begin();
+         it != p->end(); ++it)
      {
        ParticleContainer *cp = cdata->getItem(c_idx);
 
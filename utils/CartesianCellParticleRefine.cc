@@ -149,8 +149,8 @@ CartesianCellParticleRefine::refine(
 
      
      // go through all particles
-     for(std::list<RKParticle>::iterator it=p->p_list.begin();
-         it != p->p_list.end(); ++it)
+     for(ParticleContainer::iterator it=p->begin();
+         it != p->end(); ++it)
      {
        // calculating which finer cell the particle live in
        // by comparing its location of cell center
@@ -174,6 +174,16 @@ CartesianCellParticleRefine::refine(
          fdata->appendItem(p_idx, *fp);
        }
      }
+
+     // the finer cells were filled particle by particle, only keep the
+     // room their particles use
+     for(int si = 0; si < 2; si++)
+       for(int sj = 0; sj < 2; sj++)
+         for(int sk = 0; sk < 2; sk++)
+         {
+           ParticleContainer *fp = fdata->getItem(f_idx + hier::Index(si, sj, sk));
+           if(fp) fp->shrinkToFit();
+         }
      
 
    }
@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+from __future__ import print_function
+import h5py, sys, os, os.path, glob
+
+if len(sys.argv) != 2 or sys.argv[1] == "--help":
+  print("Usage: "+sys.argv[0]+" <directory>"+"""
+Describe the single-file plot dumps written with parallel_hdf5_output
+(<directory>/plot.<step>.h5) in an XDMF file, so visualization tools
+like VisIt or ParaView can open them.
+
+Every patch becomes a uniform grid reading its cells as a hyperslab of the
+per-level field datasets; the patches of a step form a spatial collection and
+the steps a temporal one. The output is written to <directory>/plots.xmf,
+which is the file to open (e.g. as DB in VisIt_script_to_extract_data.py).""")
+  sys.exit(1)
+
+dirname = sys.argv[1]
+filenames = sorted(glob.glob(os.path.join(dirname, 'plot.*.h5')))
+if not filenames:
+  print("No plot.*.h5 files found in '"+dirname+"'.", file=sys.stderr)
+  sys.exit(1)
+
+xml = """<?xml version="1.0" ?>
+<!DOCTYPE Xdmf SYSTEM "Xdmf.dtd" []>
+<Xdmf Version="2.0">
+  <Domain>
+    <Grid Name="plots" GridType="Collection" CollectionType="Temporal">"""
+
+for filename in filenames:
+  h5fn = os.path.basename(filename)
+  with h5py.File(filename, 'r') as h5:
+    xml += """
+      <Grid Name="step_%(step)d" GridType="Collection" CollectionType="Spatial">
+        <Time Value="%(time)r" />""" % {'step': h5.attrs['step'],
+                                        'time': float(h5.attrs['time'])}
+    for ln in range(h5.attrs['num_levels']):
+      group = 'level_%02d' % ln
+      patches = h5[group + '/patches'][...]
+      geometry = h5[group + '/geometry'][...]
+      fields = [f for f in h5[group].keys()
+                if f not in ('patches', 'geometry')]
+      for p in range(patches.shape[0]):
+        n = patches[p,3:6] - patches[p,0:3] + 1
+        n_cells = n[0] * n[1] * n[2]
+        xml += """
+        <Grid Name="level_%(ln)d_patch_%(p)d" GridType="Uniform">
+          <Topology TopologyType="3DCoRectMesh" Dimensions="%(nodes)s"/>
+          <Geometry GeometryType="ORIGIN_DXDYDZ">
+            <DataItem Dimensions="3" NumberType="Float" Precision="8" Format="XML">
+              %(origin)s
+            </DataItem>
+            <DataItem Dimensions="3" NumberType="Float" Precision="8" Format="XML">
+              %(dx)s
+            </DataItem>
+          </Geometry>""" % {
+          'ln': ln, 'p': p,
+          'nodes': "%d %d %d" % (n[2] + 1, n[1] + 1, n[0] + 1),
+          'origin': "%r %r %r" % tuple(geometry[p,2::-1]),
+          'dx': "%r %r %r" % tuple(geometry[p,5:2:-1])}
+        for field in fields:
+          xml += """
+          <Attribute Name="%(field)s" AttributeType="Scalar" Center="Cell">
+            <DataItem ItemType="HyperSlab" Dimensions="%(cells)s">
+              <DataItem Dimensions="3 1" Format="XML">%(offset)d 1 %(n)d</DataItem>
+              <DataItem Dimensions="%(total)d" NumberType="Float" Precision="8" Format="HDF">
+                %(h5fn)s:/%(group)s/%(field)s
+              </DataItem>
+            </DataItem>
+          </Attribute>""" % {
+            'field': field, 'group': group, 'h5fn': h5fn,
+            'cells': "%d %d %d" % (n[2], n[1], n[0]),
+            'offset': patches[p,7], 'n': n_cells,
+            'total': h5[group + '/' + field].shape[0]}
+        xml += """
+        </Grid>"""
+    xml += """
+      </Grid>"""
+
+xml += """
+    </Grid>
+  </Domain>
+</Xdmf>"""
+
+with open(os.path.join(dirname, 'plots.xmf'), 'w') as f:
+  f.write(xml)